@@ -0,0 +1,217 @@
+/**
+ * \file cpu_topology.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL cpu topology header.
+ *
+ * OSAL cpu topology discovery and task placement include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_CPU_TOPOLOGY__H
+#define LIBOSAL_CPU_TOPOLOGY__H
+
+#include <libosal/osal.h>
+#include <libosal/cpuset.h>
+#include <libosal/task.h>
+
+/** \defgroup cpu_topology_group CPU Topology
+ * The CPU topology describes packages, cores, SMT siblings, caches and
+ * NUMA nodes of the machine and the CPUs reserved for real-time work with
+ * the isolcpus and nohz_full kernel parameters. It is read from sysfs once
+ * at init, queries afterwards do not touch the file system.
+ *
+ * Cores and caches are identified by their lowest CPU number, so CPUs
+ * share a core or cache if they report the same first CPU for it.
+ *
+ * \ref osal_cpu_topology_pick finds a CPU for a task, e.g. an isolated
+ * CPU on another core which shares the L2 cache with the CPU of a
+ * producer task, and \ref osal_cpu_topology_place_task puts the result
+ * into task attributes.
+ *
+ * @{
+ */
+
+#define OSAL_CPU_TOPOLOGY_CACHES_MAX            8u              //!< \brief Maximum number of caches per CPU.
+
+#define OSAL_CPU_TOPOLOGY_CACHE_DATA            1u              //!< \brief Data cache.
+#define OSAL_CPU_TOPOLOGY_CACHE_INSTRUCTION     2u              //!< \brief Instruction cache.
+#define OSAL_CPU_TOPOLOGY_CACHE_UNIFIED         3u              //!< \brief Unified data and instruction cache.
+
+#define OSAL_CPU_TOPOLOGY_PICK_ISOLATED         0x00000001u     //!< \brief Only pick CPUs from isolcpus.
+#define OSAL_CPU_TOPOLOGY_PICK_NOHZ_FULL        0x00000002u     //!< \brief Only pick CPUs from nohz_full.
+#define OSAL_CPU_TOPOLOGY_PICK_WHOLE_CORE       0x00000004u     //!< \brief Only pick CPUs whose SMT siblings are all unused.
+#define OSAL_CPU_TOPOLOGY_PICK_SAME_NODE        0x00000008u     //!< \brief Only pick CPUs on the NUMA node of near_cpu.
+#define OSAL_CPU_TOPOLOGY_PICK_SAME_PACKAGE     0x00000010u     //!< \brief Only pick CPUs in the package of near_cpu.
+
+typedef struct osal_cpu_topology_cache {
+    osal_uint32_t level;                                        //!< \brief Cache level, 1 for L1.
+    osal_uint32_t type;                                         //!< \brief One of OSAL_CPU_TOPOLOGY_CACHE_*.
+    osal_uint64_t size;                                         //!< \brief Cache size in [byte].
+    osal_uint32_t line_size;                                    //!< \brief Coherency line size in [byte].
+    osal_uint32_t first_cpu;                                    //!< \brief Lowest CPU sharing the cache.
+} osal_cpu_topology_cache_t;                                    //!< \brief Cache of a CPU.
+
+typedef struct osal_cpu_topology_cpu {
+    osal_int32_t package;                                       //!< \brief Physical package id, -1 if the CPU is offline.
+    osal_int32_t core;                                          //!< \brief Core id as reported by the kernel.
+    osal_uint32_t core_first_cpu;                               //!< \brief Lowest SMT sibling, identifies the core.
+    osal_int32_t node;                                          //!< \brief NUMA node, -1 if unknown.
+    osal_uint32_t cache_cnt;                                    //!< \brief Number of valid caches.
+    osal_cpu_topology_cache_t caches[OSAL_CPU_TOPOLOGY_CACHES_MAX];  //!< \brief Caches of the CPU.
+} osal_cpu_topology_cpu_t;                                      //!< \brief Topology of one CPU.
+
+typedef struct osal_cpu_topology {
+    osal_uint32_t cpu_cnt;                                      //!< \brief Number of possible CPUs, entries of cpus.
+    osal_uint32_t package_cnt;                                  //!< \brief Number of packages with online CPUs.
+    osal_uint32_t core_cnt;                                     //!< \brief Number of cores with online CPUs.
+    osal_uint32_t node_cnt;                                     //!< \brief Number of NUMA nodes with online CPUs.
+    osal_cpuset_t online;                                       //!< \brief Online CPUs.
+    osal_cpuset_t isolated;                                     //!< \brief CPUs isolated with isolcpus.
+    osal_cpuset_t nohz_full;                                    //!< \brief CPUs running without scheduler tick.
+    osal_cpu_topology_cpu_t *cpus;                              //!< \brief Topology of each CPU, indexed by CPU number.
+} osal_cpu_topology_t;                                          //!< \brief CPU topology type.
+
+typedef struct osal_cpu_topology_pick {
+    osal_uint32_t flags;                                        //!< \brief Combination of OSAL_CPU_TOPOLOGY_PICK_*.
+    osal_uint32_t near_cpu;                                     //!< \brief CPU to place the task next to, used by
+                                                                //!<        cache_level and the SAME_* flags.
+    osal_uint32_t cache_level;                                  //!< \brief Cache level to share with near_cpu, 0 for none.
+    osal_cpuset_t exclude;                                      //!< \brief CPUs not to pick, e.g. used by other tasks.
+} osal_cpu_topology_pick_t;                                     //!< \brief CPU placement request.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Read the CPU topology.
+/*!
+ * \param[out]  topo    Pointer to osal cpu topology structure.
+ * \param[in]   root    sysfs system directory, NULL for /sys/devices/system.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_UNAVAILABLE             Topology not found below \p root.
+ * \retval OSAL_ERR_OUT_OF_MEMORY           CPU entries could not be allocated.
+ * \retval OSAL_ERR_OPERATION_FAILED        Malformed topology files.
+ */
+osal_retval_t osal_cpu_topology_init(osal_cpu_topology_t *topo, const osal_char_t *root);
+
+//! \brief Free the CPU topology.
+/*!
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_cpu_topology_destroy(osal_cpu_topology_t *topo);
+
+//! \brief Get the SMT siblings of a CPU.
+/*!
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ * \param[in]   cpu     CPU number.
+ * \param[out]  cpus    CPUs of the core, including \p cpu.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           \p cpu is not online.
+ */
+osal_retval_t osal_cpu_topology_get_core_cpus(const osal_cpu_topology_t *topo, osal_uint32_t cpu, osal_cpuset_t *cpus);
+
+//! \brief Get the CPUs in the package of a CPU.
+/*!
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ * \param[in]   cpu     CPU number.
+ * \param[out]  cpus    Online CPUs of the package, including \p cpu.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           \p cpu is not online.
+ */
+osal_retval_t osal_cpu_topology_get_package_cpus(const osal_cpu_topology_t *topo, osal_uint32_t cpu, osal_cpuset_t *cpus);
+
+//! \brief Get the CPUs of a NUMA node.
+/*!
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ * \param[in]   node    NUMA node.
+ * \param[out]  cpus    Online CPUs of the node.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_NOT_FOUND               No online CPU on \p node.
+ */
+osal_retval_t osal_cpu_topology_get_node_cpus(const osal_cpu_topology_t *topo, osal_int32_t node, osal_cpuset_t *cpus);
+
+//! \brief Get a cache of a CPU and the CPUs sharing it.
+/*!
+ * For level 1 the data cache is returned.
+ *
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ * \param[in]   cpu     CPU number.
+ * \param[in]   level   Cache level, 1 for L1.
+ * \param[out]  cache   Cache description. Can be NULL.
+ * \param[out]  cpus    CPUs sharing the cache, including \p cpu. Can be NULL.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           \p cpu is not online.
+ * \retval OSAL_ERR_NOT_FOUND               \p cpu has no data or unified cache of \p level.
+ */
+osal_retval_t osal_cpu_topology_get_cache(const osal_cpu_topology_t *topo, osal_uint32_t cpu, osal_uint32_t level,
+        osal_cpu_topology_cache_t *cache, osal_cpuset_t *cpus);
+
+//! \brief Pick a CPU for a task.
+/*!
+ * Picks the lowest online CPU which is not excluded and fulfills all
+ * requirements of \p pick. If cache_level or a SAME_* flag is given,
+ * near_cpu is never picked and counts as used for
+ * \ref OSAL_CPU_TOPOLOGY_PICK_WHOLE_CORE.
+ *
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ * \param[in]   pick    Placement request.
+ * \param[out]  cpu     Picked CPU.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           near_cpu is needed but not online.
+ * \retval OSAL_ERR_NOT_FOUND               No CPU fulfills the request.
+ */
+osal_retval_t osal_cpu_topology_pick(const osal_cpu_topology_t *topo, const osal_cpu_topology_pick_t *pick,
+        osal_uint32_t *cpu);
+
+//! \brief Place a task on a CPU.
+/*!
+ * Sets the CPU set of \p attr to \p cpu and binds the task memory to the
+ * NUMA node of \p cpu, together with their OSAL_TASK_ATTR__* flags. Name,
+ * policy and priority are left untouched.
+ *
+ * \param[in]       topo    Pointer to osal cpu topology structure.
+ * \param[in]       cpu     CPU number, e.g. from \ref osal_cpu_topology_pick.
+ * \param[in,out]   attr    Task attributes to pass to \ref osal_task_create.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           \p cpu is not online.
+ */
+osal_retval_t osal_cpu_topology_place_task(const osal_cpu_topology_t *topo, osal_uint32_t cpu, osal_task_attr_t *attr);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_CPU_TOPOLOGY__H */
+
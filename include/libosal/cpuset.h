@@ -0,0 +1,165 @@
+/**
+ * \file cpuset.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL cpu set header.
+ *
+ * OSAL cpu set include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_CPUSET__H
+#define LIBOSAL_CPUSET__H
+
+#include <libosal/osal.h>
+
+/** \defgroup cpuset_group CPU Sets
+ * A CPU set holds one bit per CPU number. Unlike the 32 bit
+ * \ref osal_task_sched_affinity_t it covers machines with more than 32
+ * CPUs. The set has a fixed size, so it can be copied and kept in task
+ * attributes without allocations.
+ *
+ * Iterate over the CPUs of a set with
+ *
+ *     for (cpu = osal_cpuset_next(&set, 0u); cpu < OSAL_CPUSET_SIZE; cpu = osal_cpuset_next(&set, cpu + 1u))
+ *
+ * @{
+ */
+
+#define OSAL_CPUSET_SIZE        4096u                           //!< \brief Number of CPUs a set can hold.
+#define OSAL_CPUSET_WORDS       (OSAL_CPUSET_SIZE / 64u)        //!< \brief Number of 64 bit words of a set.
+
+typedef struct osal_cpuset {
+    osal_uint64_t bits[OSAL_CPUSET_WORDS];                      //!< \brief CPU n is bit n % 64 of word n / 64.
+} osal_cpuset_t;                                                //!< \brief CPU set type.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Remove all CPUs from a set.
+/*!
+ * \param[out]  set     Pointer to cpu set.
+ */
+void osal_cpuset_zero(osal_cpuset_t *set);
+
+//! \brief Add a CPU to a set.
+/*!
+ * \param[in,out]   set     Pointer to cpu set.
+ * \param[in]       cpu     CPU number.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           \p cpu is not below \ref OSAL_CPUSET_SIZE.
+ */
+osal_retval_t osal_cpuset_set(osal_cpuset_t *set, osal_uint32_t cpu);
+
+//! \brief Remove a CPU from a set.
+/*!
+ * \param[in,out]   set     Pointer to cpu set.
+ * \param[in]       cpu     CPU number.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           \p cpu is not below \ref OSAL_CPUSET_SIZE.
+ */
+osal_retval_t osal_cpuset_clear(osal_cpuset_t *set, osal_uint32_t cpu);
+
+//! \brief Check if a CPU is in a set.
+/*!
+ * \param[in]   set     Pointer to cpu set.
+ * \param[in]   cpu     CPU number.
+ *
+ * \return OSAL_TRUE if \p cpu is in \p set, OSAL_FALSE otherwise.
+ */
+osal_bool_t osal_cpuset_isset(const osal_cpuset_t *set, osal_uint32_t cpu);
+
+//! \brief Count the CPUs in a set.
+/*!
+ * \param[in]   set     Pointer to cpu set.
+ *
+ * \return Number of CPUs in \p set.
+ */
+osal_uint32_t osal_cpuset_count(const osal_cpuset_t *set);
+
+//! \brief Find the next CPU in a set.
+/*!
+ * \param[in]   set     Pointer to cpu set.
+ * \param[in]   cpu     CPU number to start the search at.
+ *
+ * \return Lowest CPU number in \p set which is not below \p cpu,
+ *         \ref OSAL_CPUSET_SIZE if there is none.
+ */
+osal_uint32_t osal_cpuset_next(const osal_cpuset_t *set, osal_uint32_t cpu);
+
+//! \brief Intersect two sets.
+/*!
+ * \param[out]  dst     Pointer to result, may be one of the operands.
+ * \param[in]   a       Pointer to first cpu set.
+ * \param[in]   b       Pointer to second cpu set.
+ */
+void osal_cpuset_and(osal_cpuset_t *dst, const osal_cpuset_t *a, const osal_cpuset_t *b);
+
+//! \brief Unite two sets.
+/*!
+ * \param[out]  dst     Pointer to result, may be one of the operands.
+ * \param[in]   a       Pointer to first cpu set.
+ * \param[in]   b       Pointer to second cpu set.
+ */
+void osal_cpuset_or(osal_cpuset_t *dst, const osal_cpuset_t *a, const osal_cpuset_t *b);
+
+//! \brief Fill a set from a 32 bit affinity mask.
+/*!
+ * \param[out]  set         Pointer to cpu set.
+ * \param[in]   affinity    Bit n set for CPU n.
+ */
+void osal_cpuset_from_mask(osal_cpuset_t *set, osal_uint32_t affinity);
+
+//! \brief Get the first 32 CPUs of a set as affinity mask.
+/*!
+ * \param[in]   set     Pointer to cpu set.
+ *
+ * \return Bit n set for CPU n, CPUs from 32 on are dropped.
+ */
+osal_uint32_t osal_cpuset_to_mask(const osal_cpuset_t *set);
+
+//! \brief Parse a CPU list.
+/*!
+ * Parses the list format used by the linux kernel in sysfs and on the
+ * command line, e.g. "0-3,8,10-15:2". Trailing whitespace is ignored, an
+ * empty list gives an empty set.
+ *
+ * \param[out]  set     Pointer to cpu set.
+ * \param[in]   list    CPU list string.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           Malformed list or CPU out of range.
+ */
+osal_retval_t osal_cpuset_parse(osal_cpuset_t *set, const osal_char_t *list);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_CPUSET__H */
+
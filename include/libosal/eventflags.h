@@ -0,0 +1,159 @@
+/**
+ * \file eventflags.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL event flags header.
+ *
+ * OSAL event flags include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_EVENTFLAGS__H
+#define LIBOSAL_EVENTFLAGS__H
+
+#include <libosal/osal.h>
+#include <libosal/timer.h>
+
+/** \defgroup eventflags_group Event Flags
+ * An event flag group is a 32-bit word of independent flags. Tasks set and
+ * clear flags and wait until any or all flags of a mask are set. A single
+ * task can so wait for several event sources at once.
+ *
+ * The flags are kept in the structure itself, so an event flag group can be
+ * placed in shared memory. Setting flags only enters the kernel if a task is
+ * waiting for one of them.
+ *
+ * @{
+ */
+
+#define OSAL_EVENTFLAGS_ATTR__PROCESS_SHARED    0x00000020u     //!< \brief Process shared event flags.
+
+#define OSAL_EVENTFLAGS_WAIT__ANY               0x00000000u     //!< \brief Return if any flag of the mask is set.
+#define OSAL_EVENTFLAGS_WAIT__ALL               0x00000001u     //!< \brief Return if all flags of the mask are set.
+#define OSAL_EVENTFLAGS_WAIT__CLEAR             0x00000002u     //!< \brief Clear the flags of the mask on return.
+
+typedef osal_uint32_t osal_eventflags_attr_t;                   //!< \brief Event flags attribute type.
+
+typedef struct osal_eventflags {
+    osal_uint32_t flags;                                        //!< \brief Flag word, also used as futex.
+    osal_uint32_t waiters;                                      //!< \brief Number of waiting tasks.
+    osal_bool_t shared;                                         //!< \brief Process shared event flags.
+} osal_eventflags_t;                                            //!< \brief Event flags type.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Initialize event flags.
+/*!
+ * All flags are cleared initially.
+ *
+ * \param[in]   ef      Pointer to osal event flags structure.
+ * \param[in]   attr    Pointer to event flags attributes. Can be NULL.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_eventflags_init(osal_eventflags_t *ef, const osal_eventflags_attr_t *attr);
+
+//! \brief Set event flags.
+/*!
+ * Wakes all tasks waiting for one of the newly set flags.
+ *
+ * \param[in]   ef      Pointer to osal event flags structure.
+ * \param[in]   flags   Flags to set.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_eventflags_set(osal_eventflags_t *ef, osal_uint32_t flags);
+
+//! \brief Clear event flags.
+/*!
+ * \param[in]   ef      Pointer to osal event flags structure.
+ * \param[in]   flags   Flags to clear.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_eventflags_clear(osal_eventflags_t *ef, osal_uint32_t flags);
+
+//! \brief Get the current event flags.
+/*!
+ * \param[in]   ef      Pointer to osal event flags structure.
+ *
+ * \return Current flag word.
+ */
+osal_uint32_t osal_eventflags_get(osal_eventflags_t *ef);
+
+//! \brief Wait for event flags.
+/*!
+ * Blocks until any (\ref OSAL_EVENTFLAGS_WAIT__ANY) or all
+ * (\ref OSAL_EVENTFLAGS_WAIT__ALL) flags of \p mask are set. With
+ * \ref OSAL_EVENTFLAGS_WAIT__CLEAR the flags of \p mask are cleared in
+ * the same atomic step, so that each event is consumed by one waiter.
+ *
+ * \param[in]   ef      Pointer to osal event flags structure.
+ * \param[in]   mask    Flags to wait for, must not be 0.
+ * \param[in]   options OSAL_EVENTFLAGS_WAIT__* options.
+ * \param[out]  flags   Returns the flag word which satisfied the wait,
+ *                      before clearing. Can be NULL.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           Empty mask.
+ */
+osal_retval_t osal_eventflags_wait(osal_eventflags_t *ef, osal_uint32_t mask, osal_uint32_t options,
+        osal_uint32_t *flags);
+
+//! \brief Wait for event flags with timeout.
+/*!
+ * Like \ref osal_eventflags_wait, but returns OSAL_ERR_TIMEOUT if the flags are
+ * not set until the absolute timeout \p to is reached.
+ *
+ * \param[in]   ef      Pointer to osal event flags structure.
+ * \param[in]   mask    Flags to wait for, must not be 0.
+ * \param[in]   options OSAL_EVENTFLAGS_WAIT__* options.
+ * \param[out]  flags   Returns the flag word which satisfied the wait,
+ *                      before clearing. Can be NULL.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_TIMEOUT                 Flags not set until timeout.
+ * \retval OSAL_ERR_INVALID_PARAM           Empty mask.
+ */
+osal_retval_t osal_eventflags_timedwait(osal_eventflags_t *ef, osal_uint32_t mask, osal_uint32_t options,
+        osal_uint32_t *flags, const osal_timer_t *to);
+
+//! \brief Destroys event flags.
+/*!
+ * \param[in]   ef      Pointer to osal event flags structure.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_eventflags_destroy(osal_eventflags_t *ef);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_EVENTFLAGS__H */
+
@@ -51,15 +51,56 @@
 
 #define LIBOSAL_IO_SHM_MAX_MSG_SIZE 512     //!< \brief Maximum message size.
 
+#define LIBOSAL_IO_SHM_LOG_MAX_FORMATS  1024    //!< \brief Maximum number of \ref OSAL_LOG call sites per shm.
+#define LIBOSAL_IO_SHM_LOG_FORMAT_SIZE  65536   //!< \brief Size of shm area for \ref OSAL_LOG format strings.
+
+#define OSAL_LOG_MAX_ARGS               16u     //!< \brief Maximum number of arguments for \ref OSAL_LOG.
+
+//! \brief Deferred log call site, see \ref OSAL_LOG.
+typedef struct osal_log_site {
+    const osal_char_t *fmt;                     //!< \brief Format string, has to be static.
+    osal_uint32_t state;                        //!< \brief Registration state.
+    osal_uint32_t id;                           //!< \brief Format id in shm.
+    osal_uint32_t arg_cnt;                      //!< \brief Number of arguments incl. '*' width/precision.
+    osal_uint8_t arg_types[OSAL_LOG_MAX_ARGS];  //!< \brief Argument types parsed from format.
+} osal_log_site_t;
+
+//! \brief Log to shm without formatting on the caller.
+/*!
+ * Behaves like \ref osal_printf, but after \ref osal_io_shm_setup only the
+ * timestamp, a format id and the raw arguments are stored. The message is
+ * formatted by the reader (\ref osal_io_shm_get_record). The format has to
+ * be a string literal. Strings passed for '%s' are copied, formats with
+ * conversions depending on the caller's context (e.g. %n, %m, %ls, long
+ * double) or conversion specifications longer than 63 characters (each
+ * '*' counting as 11) are formatted on the caller instead. Identical
+ * formats share one entry in the shm, so writers restarted on an existing
+ * shm log reuse the formats of their last run.
+ */
+#define OSAL_LOG(fmt, ...) do { \
+    static osal_log_site_t osal_log_site__ = { (fmt), 0u, 0u, 0u, { 0u } }; \
+    (void)osal_log_write(&osal_log_site__, (fmt), ##__VA_ARGS__); \
+} while (0)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-//! \brief Get the current state of a created thread.
+//! \brief Format and print data.
 /*!
+ * If \ref osal_io_shm_setup was called, the message is formatted directly
+ * into the shared memory log ring. This is lock-free and safe to call from
+ * several tasks, it only enters the kernel to wake a waiting reader.
+ *
+ * If the shared memory log ring is full, the message is dropped and
+ * counted (\ref osal_io_shm_get_dropped) and OSAL_ERR_BUSY is returned,
+ * the caller never blocks. Without shm the function always returns
+ * OSAL_OK as before.
+ *
  * \param[in]   fmt     Print format.
  *
  * \return OK or ERROR_CODE.
+ * \retval OSAL_ERR_BUSY    Shared memory log ring is full, message dropped.
  */
 #ifdef LIBOSAL_BUILD_WIN32
 osal_retval_t osal_printf(const osal_char_t *fmt, ...);
@@ -67,6 +108,20 @@ osal_retval_t osal_printf(const osal_char_t *fmt, ...);
 osal_retval_t osal_printf(const osal_char_t *fmt, ...)  __attribute__ ((format (printf, 1, 2)));
 #endif
 
+//! \brief Log without formatting on the caller, use \ref OSAL_LOG.
+/*!
+ * \param[in]   site    Static call site.
+ * \param[in]   fmt     Print format, same as in site.
+ *
+ * \return OK or ERROR_CODE.
+ * \retval OSAL_ERR_BUSY    Shared memory log ring is full, message dropped.
+ */
+#ifdef LIBOSAL_BUILD_WIN32
+osal_retval_t osal_log_write(osal_log_site_t *site, const osal_char_t *fmt, ...);
+#else
+osal_retval_t osal_log_write(osal_log_site_t *site, const osal_char_t *fmt, ...)  __attribute__ ((format (printf, 2, 3)));
+#endif
+
 osal_int32_t osal_vfprintf(osal_file_t *stream, const osal_char_t *format, osal_va_list_t ap);
 
 //! \brief Write message to stdout
@@ -89,6 +144,8 @@ osal_retval_t osal_io_shm_setup(const osal_char_t *shm_name, const osal_size_t m
 
 //! \brief Get next message printed to shm.
 /*!
+ * Only one reader may fetch messages from a shm log at a time.
+ *
  * \param[out]   msg        Message to be returned.
  * \param[in]    to         Timeout when waiting if no message is available.
  *
@@ -97,6 +154,27 @@ osal_retval_t osal_io_shm_setup(const osal_char_t *shm_name, const osal_size_t m
 osal_retval_t osal_io_shm_get_message(osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE],
         const osal_timer_t *to);
 
+//! \brief Get next message printed or logged to shm.
+/*!
+ * Messages of \ref OSAL_LOG are formatted here. Only one reader may fetch
+ * messages from a shm log at a time.
+ *
+ * \param[out]   msg        Message to be returned.
+ * \param[out]   timestamp  Returns time of \ref OSAL_LOG in [ns], 0 for 
+ *                          \ref osal_printf messages. Can be NULL.
+ * \param[in]    to         Timeout when waiting if no message is available.
+ *
+ * \return OSAL_OK on success otherwise OSAL_ERR_UNAVAILABLE 
+ */
+osal_retval_t osal_io_shm_get_record(osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE],
+        osal_uint64_t *timestamp, const osal_timer_t *to);
+
+//! \brief Get number of messages dropped because the shm log ring was full.
+/*!
+ * \return Number of dropped messages since shm creation.
+ */
+osal_uint64_t osal_io_shm_get_dropped(void);
+
 #ifdef __cplusplus
 };
 #endif
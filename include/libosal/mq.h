@@ -54,6 +54,18 @@
  * Message queues are an asynchronous communication mechanism between two or more 
  * processes/tasks. They follow the publish/subscribe pattern.
  *
+ * When opened with \ref OSAL_MQ_ATTR__OFLAG__USERSPACE the queue is not a kernel
+ * object but a bounded lock-free multi-producer/multi-consumer ring placed in a
+ * shared memory object of the same name. Send and receive do not enter the kernel
+ * unless a receiver has to wait for a message, a sender for free space or either
+ * of them for a preempted task to finish handing over a slot. They never spin. The
+ * timeouts are absolute CLOCK_REALTIME times as for the kernel queues. Priorities
+ * are limited to 0 .. \ref OSAL_MQ_USERSPACE_PRIO_CNT - 1, higher priorities are
+ * received first, messages of equal priority in FIFO order. All participants have
+ * to use the flag, the shared memory object has to be removed with shm_unlink.
+ * max_messages is the capacity of the whole queue, shared by all priorities. The
+ * object holds max_messages message slots and a small index ring per priority.
+ *
  * @{
  */
 
@@ -63,11 +75,15 @@
 #define OSAL_MQ_ATTR__OFLAG__CREAT            0x00000008u   //!< \brief Message queue attribute flag create
 #define OSAL_MQ_ATTR__OFLAG__CLOEXEC          0x00000010u   //!< \brief Message queue attribute flag close execute
 #define OSAL_MQ_ATTR__OFLAG__EXCL             0x00000020u   //!< \brief Message queue attribute flag exclusive
+#define OSAL_MQ_ATTR__OFLAG__USERSPACE        0x00000040u   //!< \brief Message queue attribute flag lock-free userspace queue
+
+//! \brief Number of priorities supported by OSAL_MQ_ATTR__OFLAG__USERSPACE queues.
+#define OSAL_MQ_USERSPACE_PRIO_CNT            32u
 
 typedef struct osal_mq_attr {
     osal_uint32_t   oflags;                 //!< \brief Message queue open flags.
     osal_mode_t     mode;                   //!< \brief Message queue mode.
-    osal_size_t     max_messages;           //!< \brief Message queue maximum number of messages.
+    osal_size_t     max_messages;           //!< \brief Message queue maximum number of messages, over all priorities.
     osal_size_t     max_message_size;       //!< \brief Message queue maximum message size.
 } osal_mq_attr_t;                           //!< \brief Message queue attribute type.
 
@@ -33,6 +33,7 @@
 #define LIBOSAL_MUTEX__H
 
 #include <libosal/osal.h>
+#include <libosal/timer.h>
 
 #ifdef LIBOSAL_BUILD_POSIX
 #include <libosal/posix/mutex.h>
@@ -62,6 +63,16 @@
  * The mutexes are mutual exclusion locks which are commonly used to protect 
  * shared memory structures from concurrent access.
  *
+ * An \ref OSAL_MUTEX_ATTR__TYPE__ADAPTIVE mutex spins for a short time when
+ * it finds the mutex locked before it blocks. Critical sections which are
+ * only held for a few hundred nanoseconds are then handed over without a
+ * sleep and wakeup in the kernel. The number of spins is bounded and adapts
+ * itself to the number of attempts which were needed recently. On a single
+ * CPU system an adaptive mutex never spins. Adaptive mutexes behave like
+ * \ref OSAL_MUTEX_ATTR__TYPE__NORMAL mutexes otherwise and can be combined
+ * with \ref OSAL_MUTEX_ATTR__ROBUST, \ref OSAL_MUTEX_ATTR__PROCESS_SHARED and
+ * the priority protocols.
+ *
  * @{
  */
 
@@ -69,6 +80,7 @@
 #define OSAL_MUTEX_ATTR__TYPE__NORMAL           0x00000000u     //!< \brief Mutex normal (default) type.
 #define OSAL_MUTEX_ATTR__TYPE__ERRORCHECK       0x00000001u     //!< \brief Mutex with error checks.
 #define OSAL_MUTEX_ATTR__TYPE__RECURSIVE        0x00000002u     //!< \brief Mutex avoiding recursive deadlocks.
+#define OSAL_MUTEX_ATTR__TYPE__ADAPTIVE         0x00000003u     //!< \brief Mutex spinning shortly before blocking.
 
 #define OSAL_MUTEX_ATTR__ROBUST                 0x00000010u     //!< \brief Robust mutex (unlocks if owner died)
 #define OSAL_MUTEX_ATTR__PROCESS_SHARED         0x00000020u     //!< \brief Process shared mutex.
@@ -122,6 +134,28 @@ osal_retval_t osal_mutex_init(osal_mutex_t *mtx, const osal_mutex_attr_t *attr);
  */
 osal_retval_t osal_mutex_lock(osal_mutex_t *mtx);
 
+//! \brief Locks a mutex with timeout.
+/*!
+ * This function locks a mutex like \ref osal_mutex_lock but waits at most 
+ * until the absolute timeout \p to is reached. The timeout is based on the
+ * clock returned by \ref osal_timer_gettime, e.g. created with
+ * \ref osal_timer_init. If the mutex is available, it is locked even if the
+ * timeout has already passed.
+ *
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_TIMEOUT                 Timeout reached before mutex could be locked.
+ * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    Not enough system resources.
+ * \retval OSAL_ERR_INVALID_PARAM           Invalid input paratemer.
+ * \retval OSAL_ERR_NOT_RECOVERABLE         Mutex not recoverable.
+ * \retval OSAL_ERR_OWNER_DEAD              Old mutex owner dead (see ROBUST).
+ * \retval OSAL_ERR_DEAD_LOCK               Would dead-lock (see RECURSIVE).
+ * \retval OSAL_ERR_UNAVAILABLE             Other errors.
+ */
+osal_retval_t osal_mutex_timedlock(osal_mutex_t *mtx, const osal_timer_t *to);
+
 //! \brief Tries to lock a mutex.
 /*!
  * This function tries to lock a mutex. If it is available it locks the mutex 
@@ -152,6 +186,24 @@ osal_retval_t osal_mutex_trylock(osal_mutex_t *mtx);
  */
 osal_retval_t osal_mutex_unlock(osal_mutex_t *mtx);
 
+//! \brief Marks the state of a robust mutex consistent.
+/*!
+ * After \ref osal_mutex_lock, \ref osal_mutex_timedlock or
+ * \ref osal_mutex_trylock returned OSAL_ERR_OWNER_DEAD the caller owns the
+ * mutex, but the protected data may be inconsistent. Once it has been
+ * repaired, call this function before unlocking. A mutex unlocked without
+ * it becomes not recoverable. Platforms without robust mutexes have
+ * nothing to mark and return OSAL_OK.
+ *
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           Mutex not robust or not in inconsistent state.
+ * \retval OSAL_ERR_NOT_IMPLEMENTED         Robust mutexes not supported.
+ * \retval OSAL_ERR_OPERATION_FAILED        Other errors.
+ */
+osal_retval_t osal_mutex_consistent(osal_mutex_t *mtx);
+
 //! \brief Destroys a mutex.
 /*!
  * This function tries to destroy a mutex.
@@ -0,0 +1,171 @@
+/**
+ * \file periodic_task.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL periodic task header.
+ *
+ * OSAL periodic task include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_PERIODIC_TASK__H
+#define LIBOSAL_PERIODIC_TASK__H
+
+#include <libosal/osal.h>
+#include <libosal/binary_semaphore.h>
+#include <libosal/task.h>
+#include <libosal/timer.h>
+#include <libosal/trace.h>
+
+/** \defgroup periodic_task_group Periodic Tasks
+ *
+ * Run a handler cyclically on its own task.
+ *
+ * Releases are placed on a fixed grid of the timer clock, at every multiple
+ * of the period plus the phase offset. This way several periodic tasks with
+ * the same period keep their relative phase and the cycle does not drift by
+ * the handler's execution time. Every cycle the wakeup latency (time between
+ * release and handler start) and the execution time of the handler are
+ * recorded.
+ *
+ * @{
+ */
+
+#define OSAL_PERIODIC_TASK_OVERRUN__SKIP        0u  //!< \brief Drop missed releases, continue at next release in the future.
+#define OSAL_PERIODIC_TASK_OVERRUN__CATCH_UP    1u  //!< \brief Run missed releases back to back until the task is in time again.
+#define OSAL_PERIODIC_TASK_OVERRUN__SIGNAL      2u  //!< \brief Call overrun handler, then drop missed releases like \ref OSAL_PERIODIC_TASK_OVERRUN__SKIP.
+
+//! \brief Periodic task cycle handler.
+/*!
+ * \param[in]   arg     Argument passed to \ref osal_periodic_task_create.
+ *
+ * \return OSAL_OK to continue, any other value stops the periodic task.
+ */
+typedef osal_retval_t (*osal_periodic_task_handler_t)(osal_void_t *arg);
+
+//! \brief Periodic task overrun handler.
+/*!
+ * \param[in]   arg     Argument passed to \ref osal_periodic_task_create.
+ * \param[in]   missed  Number of releases passed during the overrunning cycle.
+ *
+ * \return OSAL_OK to continue, any other value stops the periodic task.
+ */
+typedef osal_retval_t (*osal_periodic_task_overrun_handler_t)(osal_void_t *arg, osal_uint64_t missed);
+
+typedef struct osal_periodic_task_attr {
+    osal_task_attr_t task_attr;                 //!< \brief Name, policy, priority and affinity of the task,
+                                                //!<        initialized with \ref osal_task_attr_init.
+    osal_uint64_t period;                       //!< \brief Cycle period in [ns].
+    osal_uint64_t phase;                        //!< \brief Release offset to a multiple of the period in [ns].
+    osal_uint64_t busy_wait;                    //!< \brief Wake up this many [ns] before release and busy-wait the rest, 0 to disable.
+    osal_uint32_t overrun_policy;               //!< \brief One of OSAL_PERIODIC_TASK_OVERRUN__*.
+    osal_periodic_task_overrun_handler_t overrun_handler;   //!< \brief Called with \ref OSAL_PERIODIC_TASK_OVERRUN__SIGNAL.
+    osal_trace_t *latency_trace;                //!< \brief Single producer trace of wakeup latency in [ns], can be NULL.
+    osal_trace_t *exec_trace;                   //!< \brief Single producer trace of handler execution time in [ns], can be NULL.
+} osal_periodic_task_attr_t;                    //!< \brief Periodic task attribute type.
+
+typedef struct osal_periodic_task_stats {
+    osal_uint64_t cycles;                       //!< \brief Number of handler calls.
+    osal_uint64_t overruns;                     //!< \brief Number of cycles which ended after the next release.
+    osal_uint64_t missed;                       //!< \brief Number of releases dropped by overrun policy.
+    osal_uint64_t max_latency;                  //!< \brief Maximum wakeup latency in [ns].
+    osal_uint64_t max_exec;                     //!< \brief Maximum handler execution time in [ns].
+} osal_periodic_task_stats_t;                   //!< \brief Periodic task statistics type.
+
+typedef struct osal_periodic_task {
+    osal_task_t task;                           //!< \brief Underlying task.
+    osal_periodic_task_attr_t attr;             //!< \brief Copy of attributes.
+    osal_periodic_task_handler_t handler;       //!< \brief Cycle handler.
+    osal_void_t *arg;                           //!< \brief Argument of handlers.
+    osal_uint32_t stop;                         //!< \brief Stop request.
+    osal_binary_semaphore_t stop_sem;           //!< \brief Posted on stop request, wakes the task sleeping for its release.
+    osal_retval_t result;                       //!< \brief Reason the cycle loop ended.
+    osal_periodic_task_stats_t stats;           //!< \brief Statistics, updated by the periodic task.
+} osal_periodic_task_t;                         //!< \brief Periodic task type.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Create and start a periodic task.
+/*!
+ * The first release is the next point of the period grid after the call.
+ * If traces are given, they are switched to \ref OSAL_TRACE_HISTOGRAM__VALUE
+ * mode, so that \ref osal_trace_get_percentiles returns latency and execution
+ * time percentiles.
+ *
+ * \param[in]   hdl     Pointer to periodic task structure.
+ * \param[in]   attr    Periodic task attributes.
+ * \param[in]   handler Handler to be called every cycle.
+ * \param[in]   arg     Pointer to argument passed to handlers.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           Zero period, unknown overrun policy, missing
+ *                                          overrun handler, busy-wait not shorter than period
+ *                                          or multi producer trace.
+ * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    System is out of resources.
+ * \retval OSAL_ERR_PERMISSION_DENIED       Permission denied for priority/policy.
+ * \retval OSAL_ERR_OPERATION_FAILED        Other errors.
+ */
+osal_retval_t osal_periodic_task_create(osal_periodic_task_t *hdl, const osal_periodic_task_attr_t *attr,
+        osal_periodic_task_handler_t handler, osal_void_t *arg);
+
+//! \brief Stop a periodic task and wait for it to end.
+/*!
+ * A running handler is not interrupted, the task ends after the current
+ * cycle. A task sleeping for its next release is woken up right away.
+ *
+ * \param[in]   hdl     Pointer to periodic task structure.
+ *
+ * \return OSAL_OK if the task ended on the stop request, otherwise the value
+ *         returned by the handler or overrun handler that stopped it.
+ */
+osal_retval_t osal_periodic_task_stop(osal_periodic_task_t *hdl);
+
+//! \brief Wait for a periodic task to end by itself.
+/*!
+ * \param[in]   hdl     Pointer to periodic task structure.
+ *
+ * \return Value returned by the handler or overrun handler that stopped the task.
+ */
+osal_retval_t osal_periodic_task_join(osal_periodic_task_t *hdl);
+
+//! \brief Get statistics of a periodic task.
+/*!
+ * May be called while the task is running.
+ *
+ * \param[in]   hdl     Pointer to periodic task structure.
+ * \param[out]  stats   Returns statistics.
+ *
+ * \return N/A
+ */
+void osal_periodic_task_get_stats(osal_periodic_task_t *hdl, osal_periodic_task_stats_t *stats);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_PERIODIC_TASK__H */
+
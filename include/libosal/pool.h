@@ -0,0 +1,252 @@
+/**
+ * \file pool.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL memory pool header.
+ *
+ * OSAL fixed-block memory pool include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_POOL__H
+#define LIBOSAL_POOL__H
+
+#include <libosal/osal.h>
+
+/** \defgroup pool_group Memory pool
+ * Fixed-size block allocator for real-time code paths. All blocks are carved
+ * from one region at initialization, allocating and freeing a block is a
+ * single lock-free operation on a free list and never enters the kernel.
+ *
+ * The free list is linked by block indices and its head carries a tag
+ * against the ABA problem. The pool contains no pointers, so the region may
+ * be a \ref osal_shm_map mapping and be used from several processes, the
+ * other processes use \ref osal_pool_attach.
+ *
+ * Tasks allocating and freeing at a high rate can use a
+ * \ref osal_pool_cache_t each. A cache keeps up to \ref OSAL_POOL_CACHE_SIZE
+ * blocks which it hands out without touching the shared free list. It moves
+ * half of its blocks at once from or to the free list. A cache belongs to a
+ * single task and has to be flushed before the task ends, or its blocks are
+ * lost.
+ *
+ * @{
+ */
+
+#define OSAL_POOL_ATTR__PREFAULT            0x00000001u     //!< \brief Touch all pages of the blocks at initialization.
+#define OSAL_POOL_ATTR__STATS               0x00000040u     //!< \brief Collect usage statistics.
+
+#define OSAL_POOL_CACHE_SIZE                32u             //!< \brief Maximum number of blocks in a task cache.
+
+typedef osal_uint32_t osal_pool_attr_t;                     //!< \brief Memory pool attribute type.
+
+//! \brief Pool control block, placed at the start of the region.
+typedef struct osal_pool_ctrl {
+    osal_uint32_t magic;                                    //!< \brief Initialization magic.
+    osal_uint32_t flags;                                    //!< \brief Pool attributes.
+    osal_uint32_t block_size;                               //!< \brief Size of one block in bytes (padded).
+    osal_uint32_t block_cnt;                                //!< \brief Number of blocks.
+    osal_uint8_t  pad0[OSAL_CACHE_LINE_SIZE - 16u];
+
+    osal_uint64_t head;                                     //!< \brief Free list head, tag and block index + 1.
+    osal_uint8_t  pad1[OSAL_CACHE_LINE_SIZE - 8u];
+
+    osal_uint32_t used;                                     //!< \brief Blocks currently allocated.
+    osal_uint32_t high_water;                               //!< \brief Maximum of used blocks.
+    osal_uint64_t failed;                                   //!< \brief Allocations failed on empty pool.
+    osal_uint8_t  pad2[OSAL_CACHE_LINE_SIZE - 16u];
+} osal_pool_ctrl_t;
+
+//! \brief Process local pool handle.
+typedef struct osal_pool {
+    osal_pool_ctrl_t *ctrl;                                 //!< \brief Control block in region.
+    osal_uint8_t *blocks;                                   //!< \brief First block in region.
+    osal_uint32_t block_size;                               //!< \brief Size of one block in bytes.
+    osal_uint32_t block_cnt;                                //!< \brief Number of blocks.
+    osal_void_t *mem_alloc;                                 //!< \brief Region allocated by \ref osal_pool_create.
+} osal_pool_t;
+
+//! \brief Task local block cache.
+typedef struct osal_pool_cache {
+    osal_pool_t *pool;                                      //!< \brief Pool the blocks belong to.
+    osal_uint32_t cnt;                                      //!< \brief Number of cached blocks.
+    osal_uint32_t idx[OSAL_POOL_CACHE_SIZE];                //!< \brief Indices of cached blocks.
+} osal_pool_cache_t;
+
+typedef struct osal_pool_stats {
+    osal_uint32_t block_size;                               //!< \brief Size of one block in bytes (padded).
+    osal_uint32_t block_cnt;                                //!< \brief Number of blocks.
+    osal_uint32_t used;                                     //!< \brief Blocks currently allocated.
+    osal_uint32_t high_water;                               //!< \brief Maximum of used blocks.
+    osal_uint64_t failed;                                   //!< \brief Allocations failed on empty pool.
+} osal_pool_stats_t;                                        //!< \brief Memory pool statistics type.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Get size of memory region needed for a pool.
+/*!
+ * \param[in]   block_size  Size of one block in bytes.
+ * \param[in]   block_cnt   Number of blocks.
+ *
+ * \return Needed size in bytes, 0 on invalid parameters or if the size
+ *         overflows osal_size_t.
+ */
+osal_size_t osal_pool_get_size(osal_size_t block_size, osal_uint32_t block_cnt);
+
+//! \brief Initialize a pool in a memory region.
+/*!
+ * This function formats the memory region \p mem with all blocks free. It
+ * has to be called exactly once by the creator of the region, other
+ * processes use \ref osal_pool_attach. The region should be cache line
+ * aligned.
+ *
+ * \param[out]  pool        Pointer to osal pool handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ * \param[in]   block_size  Size of one block in bytes.
+ * \param[in]   block_cnt   Number of blocks.
+ * \param[in]   attr        Pointer to pool attributes. Can be NULL.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       Invalid block size or count, size overflows
+ *                                      osal_size_t or region too small.
+ */
+osal_retval_t osal_pool_init(osal_pool_t *pool, osal_void_t *mem, osal_size_t mem_size,
+        osal_size_t block_size, osal_uint32_t block_cnt, const osal_pool_attr_t *attr);
+
+//! \brief Allocate a region and initialize a pool in it.
+/*!
+ * \param[out]  pool        Pointer to osal pool handle.
+ * \param[in]   block_size  Size of one block in bytes.
+ * \param[in]   block_cnt   Number of blocks.
+ * \param[in]   attr        Pointer to pool attributes. Can be NULL.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       Invalid block size or count.
+ * \retval OSAL_ERR_OUT_OF_MEMORY       Region could not be allocated.
+ */
+osal_retval_t osal_pool_create(osal_pool_t *pool, osal_size_t block_size, osal_uint32_t block_cnt,
+        const osal_pool_attr_t *attr);
+
+//! \brief Attach to a pool initialized by someone else.
+/*!
+ * \param[out]  pool        Pointer to osal pool handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_UNAVAILABLE         Region is not (yet) initialized.
+ * \retval OSAL_ERR_INVALID_PARAM       Region is too small for the pool found.
+ */
+osal_retval_t osal_pool_attach(osal_pool_t *pool, osal_void_t *mem, osal_size_t mem_size);
+
+//! \brief Destroys a pool handle.
+/*!
+ * Frees the region if it was allocated by \ref osal_pool_create.
+ *
+ * \param[in]   pool        Pointer to osal pool handle.
+ *
+ * \retval OSAL_OK                      On success.
+ */
+osal_retval_t osal_pool_destroy(osal_pool_t *pool);
+
+//! \brief Allocate a block.
+/*!
+ * \param[in]   pool        Pointer to osal pool handle.
+ * \param[out]  block       Returns pointer to the block.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_OUT_OF_MEMORY       All blocks are in use.
+ */
+osal_retval_t osal_pool_alloc(osal_pool_t *pool, osal_void_t **block);
+
+//! \brief Free a block.
+/*!
+ * \param[in]   pool        Pointer to osal pool handle.
+ * \param[in]   block       Block returned by \ref osal_pool_alloc.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       \p block is not a block of this pool.
+ */
+osal_retval_t osal_pool_free(osal_pool_t *pool, osal_void_t *block);
+
+//! \brief Get pool statistics.
+/*!
+ * Only available if the pool was initialized with \ref OSAL_POOL_ATTR__STATS.
+ * Blocks held by task caches count as used.
+ *
+ * \param[in]   pool        Pointer to osal pool handle.
+ * \param[out]  stats       Returns the statistics.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_UNAVAILABLE         Statistics are not enabled.
+ */
+osal_retval_t osal_pool_get_stats(osal_pool_t *pool, osal_pool_stats_t *stats);
+
+//! \brief Initialize a task local block cache.
+/*!
+ * \param[out]  cache       Pointer to osal pool cache.
+ * \param[in]   pool        Pointer to osal pool handle.
+ *
+ * \retval OSAL_OK                      On success.
+ */
+osal_retval_t osal_pool_cache_init(osal_pool_cache_t *cache, osal_pool_t *pool);
+
+//! \brief Allocate a block through a task cache.
+/*!
+ * \param[in]   cache       Pointer to osal pool cache.
+ * \param[out]  block       Returns pointer to the block.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_OUT_OF_MEMORY       All blocks are in use.
+ */
+osal_retval_t osal_pool_cache_alloc(osal_pool_cache_t *cache, osal_void_t **block);
+
+//! \brief Free a block through a task cache.
+/*!
+ * \param[in]   cache       Pointer to osal pool cache.
+ * \param[in]   block       Block of the cache's pool.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       \p block is not a block of this pool.
+ */
+osal_retval_t osal_pool_cache_free(osal_pool_cache_t *cache, osal_void_t *block);
+
+//! \brief Return all cached blocks to the pool.
+/*!
+ * \param[in]   cache       Pointer to osal pool cache.
+ *
+ * \retval OSAL_OK                      On success.
+ */
+osal_retval_t osal_pool_cache_flush(osal_pool_cache_t *cache);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_POOL__H */
+
@@ -31,12 +31,9 @@
 #ifndef LIBOSAL_POSIX_BINARY_SEMAPHORE__H
 #define LIBOSAL_POSIX_BINARY_SEMAPHORE__H
 
-#include <pthread.h>
-
 typedef struct osal_binary_semaphore {
-    pthread_mutex_t posix_mtx;
-    pthread_cond_t posix_cond;
-    int value;
+    osal_uint32_t value;        //!< \brief Futex word, 0 empty, 1 posted, 2 empty with possible waiters.
+    osal_bool_t shared;         //!< \brief Process shared semaphore.
 } osal_binary_semaphore_t;
 
 #endif /* LIBOSAL_POSIX_BINARY_SEMAPHORE__H */
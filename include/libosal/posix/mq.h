@@ -33,8 +33,16 @@
 
 #include <mqueue.h>
 
+struct posix_mq_us;
+
 typedef struct osal_mq {
-    mqd_t mq_desc;
+    mqd_t mq_desc;                  //!< \brief Kernel message queue descriptor.
+
+    osal_bool_t userspace;          //!< \brief OSAL_TRUE if opened with OSAL_MQ_ATTR__OFLAG__USERSPACE.
+    osal_uint32_t oflags;           //!< \brief Open flags of userspace queue.
+    int shm_fd;                     //!< \brief Shared memory descriptor of userspace queue.
+    osal_size_t shm_size;           //!< \brief Mapped size of userspace queue.
+    struct posix_mq_us *us;         //!< \brief Mapped userspace queue.
 } osal_mq_t;
 
 #endif /* LIBOSAL_POSIX_MQ__H */
@@ -35,6 +35,8 @@
 
 typedef struct osal_mutex {
     pthread_mutex_t posix_mtx;
+    osal_uint32_t spin_max;     //!< \brief Upper bound of lock attempts before blocking, 0 for non-adaptive mutexes.
+    osal_uint32_t spins;        //!< \brief Self-tuned number of lock attempts of adaptive mutexes.
 } osal_mutex_t;
 
 #endif /* LIBOSAL_POSIX_MUTEX__H */
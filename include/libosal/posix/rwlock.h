@@ -0,0 +1,57 @@
+/**
+ * \file posix/rwlock.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL reader-writer lock posix header.
+ *
+ * OSAL reader-writer lock posix include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_POSIX_RWLOCK__H
+#define LIBOSAL_POSIX_RWLOCK__H
+
+#include <libosal/mutex.h>
+#include <pthread.h>
+
+//! \brief Reader counter of one CPU, alone in its cache line.
+typedef struct osal_rwlock_slot {
+    osal_int32_t readers;                       //!< \brief Read locks taken minus released on this CPU.
+    osal_uint8_t pad[OSAL_CACHE_LINE_SIZE - 4u];
+} osal_rwlock_slot_t;
+
+typedef struct osal_rwlock {
+    osal_rwlock_attr_t attr;                    //!< \brief Reader-writer lock attributes.
+    pthread_rwlock_t posix_rwlock;              //!< \brief Used without priority inheritance and per-CPU readers.
+
+    osal_mutex_t wr_mtx;                        //!< \brief Serializes writers, readers block on it behind a writer.
+    osal_uint32_t state;                        //!< \brief Writer state, free, draining readers or locked.
+    osal_uint32_t drain;                        //!< \brief Futex word, bumped by readers leaving while a writer drains.
+    osal_int32_t readers;                       //!< \brief Number of readers without per-CPU counters.
+    osal_rwlock_slot_t *slots;                  //!< \brief Cache line aligned per-CPU reader counters.
+    osal_void_t *slots_mem;                     //!< \brief Allocated memory of per-CPU reader counters.
+    osal_uint32_t slot_cnt;                     //!< \brief Number of per-CPU reader counters.
+} osal_rwlock_t;
+
+#endif /* LIBOSAL_POSIX_RWLOCK__H */
+
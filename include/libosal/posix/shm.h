@@ -36,6 +36,8 @@
 typedef struct osal_shm {
     int fd;
     osal_size_t size;
+    osal_bool_t hugetlb;        //!< \brief Segment is backed by hugetlbfs.
+    osal_bool_t thp;            //!< \brief Advise transparent huge pages on map.
 } osal_shm_t;
 
 #endif /* LIBOSAL_POSIX_SHM__H */
@@ -31,10 +31,23 @@
 #ifndef LIBOSAL_POSIX_SPINLOCK__H
 #define LIBOSAL_POSIX_SPINLOCK__H
 
-#include <pthread.h>
+//! \brief Queue node of a waiter on a MCS spinlock.
+typedef struct osal_spinlock_mcs_node {
+    struct osal_spinlock_mcs_node *next;        //!< \brief Next waiter in queue.
+    osal_uint32_t locked;                       //!< \brief Waiter spins while set.
+    osal_uint32_t in_use;                       //!< \brief Node is queued on a spinlock.
+} osal_spinlock_mcs_node_t;
 
 typedef struct osal_spinlock {
-    pthread_spinlock_t posix_sl;
+    osal_uint32_t attr;                         //!< \brief Spinlock attributes.
+    osal_uint32_t word;                         //!< \brief Lock word of test-and-set spinlock.
+    osal_uint32_t ticket_next;                  //!< \brief Next ticket to draw.
+    osal_uint32_t ticket_owner;                 //!< \brief Ticket currently served.
+    osal_spinlock_mcs_node_t *mcs_tail;         //!< \brief Last waiter of MCS queue.
+    osal_spinlock_mcs_node_t *mcs_owner;        //!< \brief Queue node of MCS lock holder.
+    osal_uint32_t owner;                        //!< \brief Thread id of holder (ERRORCHECK and RECURSIVE).
+    osal_uint32_t count;                        //!< \brief Recursion depth (RECURSIVE).
+    osal_spinlock_stats_t stats;                //!< \brief Statistics (STATS).
 } osal_spinlock_t;
 
 #endif /* LIBOSAL_POSIX_SPINLOCK__H */
@@ -36,6 +36,7 @@
 
 #define LIBOSAL_CLOCK_MONOTONIC     CLOCK_MONOTONIC
 #define LIBOSAL_CLOCK_REALTIME      CLOCK_REALTIME
+#define LIBOSAL_CLOCK_TSC           (0x54534300)    //!< \brief Calibrated time stamp counter, see \ref osal_timer_set_clock_source.
 
 extern int global_clock_id;
 
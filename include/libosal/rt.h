@@ -0,0 +1,137 @@
+/**
+ * \file rt.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL real-time process setup header.
+ *
+ * OSAL real-time process setup include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_RT__H
+#define LIBOSAL_RT__H
+
+#include <libosal/osal.h>
+
+/** \defgroup rt_group Real-Time Setup
+ * A real-time process has to avoid page faults, heap trimming and deep
+ * processor idle states once its cyclic part is running. \ref osal_rt_setup
+ * performs the usual process wide preparations in one call at startup,
+ * before the real-time tasks are created.
+ *
+ * Most steps need privileges (CAP_IPC_LOCK, write access to
+ * /dev/cpu_dma_latency). Each step is tried independently, the result tells
+ * which steps failed and which of them for lack of privileges.
+ *
+ * @{
+ */
+
+#define OSAL_RT_SETUP__MLOCKALL                 0x00000001u     //!< \brief Lock current and future pages.
+#define OSAL_RT_SETUP__MALLOC_TUNING            0x00000002u     //!< \brief Disable heap trimming and mmap allocations.
+#define OSAL_RT_SETUP__HEAP_PREFAULT            0x00000004u     //!< \brief Prefault the heap reserve.
+#define OSAL_RT_SETUP__STACK_PREFAULT           0x00000008u     //!< \brief Prefault the stack of the calling task.
+#define OSAL_RT_SETUP__DMA_LATENCY              0x00000010u     //!< \brief Hold a cpu dma latency request.
+#define OSAL_RT_SETUP__ALL                      0x0000001Fu     //!< \brief All setup steps.
+
+#define OSAL_RT_SETUP_HEAP_RESERVE_DEFAULT      (8u * 1024u * 1024u)    //!< \brief Default heap reserve in bytes.
+#define OSAL_RT_SETUP_STACK_PREFAULT_DEFAULT    (256u * 1024u)          //!< \brief Default stack prefault in bytes.
+
+typedef struct osal_rt_setup_attr {
+    osal_uint32_t steps;                                        //!< \brief OSAL_RT_SETUP__* steps to perform.
+    osal_size_t heap_reserve;                                   //!< \brief Heap bytes to prefault.
+    osal_size_t stack_prefault;                                 //!< \brief Stack bytes to prefault.
+    osal_int32_t dma_latency;                                   //!< \brief Requested cpu dma latency in [us], usually 0.
+} osal_rt_setup_attr_t;                                         //!< \brief Real-time setup attributes.
+
+typedef struct osal_rt_setup_result {
+    osal_uint32_t done;                                         //!< \brief Steps which succeeded.
+    osal_uint32_t failed;                                       //!< \brief Steps which failed.
+    osal_uint32_t denied;                                       //!< \brief Failed steps due to missing privileges.
+} osal_rt_setup_result_t;                                       //!< \brief Real-time setup result.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Prepare the process for real-time operation.
+/*!
+ * Performs the requested steps in the order malloc tuning, mlockall, heap
+ * prefault, stack prefault and cpu dma latency request. A failing step does
+ * not stop the following ones.
+ *
+ * The heap reserve is allocated, touched and freed again. To keep it mapped,
+ * \ref OSAL_RT_SETUP__HEAP_PREFAULT always performs
+ * \ref OSAL_RT_SETUP__MALLOC_TUNING as well and fails if the tuning fails.
+ * Stacks of
+ * tasks created later are locked by \ref OSAL_RT_SETUP__MLOCKALL, their
+ * untouched parts have to be prefaulted by the task itself with
+ * \ref osal_rt_prefault_stack or at creation with
+ * \ref OSAL_TASK_ATTR__STACK_PREFAULT.
+ *
+ * The cpu dma latency request stays active until \ref osal_rt_release is
+ * called or the process exits.
+ *
+ * Concurrent calls of \ref osal_rt_setup and \ref osal_rt_release from
+ * several tasks are serialized.
+ *
+ * \param[in]   attr    Pointer to setup attributes. Can be NULL to perform
+ *                      all steps with the default sizes and latency 0.
+ * \param[out]  result  Returns the outcome of each step. Can be NULL.
+ *
+ * \retval OSAL_OK                          All requested steps succeeded.
+ * \retval OSAL_ERR_PERMISSION_DENIED       At least one step failed for lack of privileges.
+ * \retval OSAL_ERR_OPERATION_FAILED        At least one step failed for another reason.
+ * \retval OSAL_ERR_INVALID_PARAM           Unknown steps or negative latency.
+ */
+osal_retval_t osal_rt_setup(const osal_rt_setup_attr_t *attr, osal_rt_setup_result_t *result);
+
+//! \brief Prefault the stack of the calling task.
+/*!
+ * Touches \p size bytes below the current stack pointer, so that later
+ * stack growth up to this depth does not cause page faults.
+ *
+ * \param[in]   size    Number of stack bytes to prefault, has to be smaller
+ *                      than the remaining stack of the calling task.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_rt_prefault_stack(osal_size_t size);
+
+//! \brief Release the process wide real-time settings.
+/*!
+ * Drops the cpu dma latency request. If \ref osal_rt_setup locked the
+ * pages, all pages are unlocked, otherwise locks set by the application
+ * are kept.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_rt_release(void);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_RT__H */
+
@@ -0,0 +1,189 @@
+/**
+ * \file rwlock.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL reader-writer lock header.
+ *
+ * OSAL reader-writer lock include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_RWLOCK__H
+#define LIBOSAL_RWLOCK__H
+
+#include <libosal/osal.h>
+#include <libosal/timer.h>
+
+#define OSAL_RWLOCK_ATTR__PREFER_WRITER         0x00000001u     //!< \brief Waiting writers block new readers.
+#define OSAL_RWLOCK_ATTR__PROCESS_SHARED        0x00000020u     //!< \brief Process shared reader-writer lock.
+#define OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT     0x00000100u     //!< \brief Writers inherit the priority of blocked tasks.
+#define OSAL_RWLOCK_ATTR__PER_CPU               0x00001000u     //!< \brief Scalable per-CPU reader counters.
+
+typedef osal_uint32_t osal_rwlock_attr_t;                       //!< \brief Reader-writer lock attribute type.
+
+#ifdef LIBOSAL_BUILD_POSIX
+#include <libosal/posix/rwlock.h>
+#endif
+
+/** \defgroup rwlock_group Reader-Writer Lock
+ * A reader-writer lock is held either by any number of readers or by a
+ * single writer. It protects read-mostly data like parameter tables, where
+ * a mutex would needlessly serialize the readers.
+ *
+ * By default new readers may join while a writer is waiting, so a steady
+ * stream of readers can starve writers. With
+ * \ref OSAL_RWLOCK_ATTR__PREFER_WRITER a waiting writer blocks new readers.
+ * Read locks must then not be taken recursively, as the inner read lock
+ * would wait for the writer which waits for the outer read lock.
+ *
+ * With \ref OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT the writers are serialized
+ * by a priority inheritance mutex. Writers and readers blocked by a writer
+ * boost its priority. The readers holding the lock are not known to the
+ * system and can not be boosted by a waiting writer, so read sections should
+ * be short.
+ *
+ * With \ref OSAL_RWLOCK_ATTR__PER_CPU each CPU has its own cache line
+ * aligned reader counter. Uncontended read locks do not bounce a shared cache
+ * line between CPUs, write locks have to sum up all counters and are slower.
+ * Per-CPU reader-writer locks can not be process shared.
+ *
+ * Priority inheritance and per-CPU reader-writer locks always prefer writers.
+ *
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Initialize a reader-writer lock.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ * \param[in]   attr    Pointer to reader-writer lock attributes. Can be NULL
+ *                      for a default reader-writer lock.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    Not enough system resources.
+ * \retval OSAL_ERR_OUT_OF_MEMORY           System is out of memory.
+ * \retval OSAL_ERR_INVALID_PARAM           Invalid or unsupported attributes.
+ * \retval OSAL_ERR_UNAVAILABLE             Other errors.
+ */
+osal_retval_t osal_rwlock_init(osal_rwlock_t *rwl, const osal_rwlock_attr_t *attr);
+
+//! \brief Locks a reader-writer lock for reading.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    Maximum number of readers exceeded.
+ * \retval OSAL_ERR_DEAD_LOCK               Calling task holds the write lock.
+ * \retval OSAL_ERR_UNAVAILABLE             Other errors.
+ */
+osal_retval_t osal_rwlock_rdlock(osal_rwlock_t *rwl);
+
+//! \brief Tries to lock a reader-writer lock for reading.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_BUSY                    Lock is held or requested by a writer.
+ * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    Maximum number of readers exceeded.
+ * \retval OSAL_ERR_UNAVAILABLE             Other errors.
+ */
+osal_retval_t osal_rwlock_tryrdlock(osal_rwlock_t *rwl);
+
+//! \brief Locks a reader-writer lock for reading with timeout.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_TIMEOUT                 Lock not acquired until timeout.
+ * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    Maximum number of readers exceeded.
+ * \retval OSAL_ERR_DEAD_LOCK               Calling task holds the write lock.
+ * \retval OSAL_ERR_UNAVAILABLE             Other errors.
+ */
+osal_retval_t osal_rwlock_timedrdlock(osal_rwlock_t *rwl, const osal_timer_t *to);
+
+//! \brief Locks a reader-writer lock for writing.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_DEAD_LOCK               Calling task already holds the lock.
+ * \retval OSAL_ERR_UNAVAILABLE             Other errors.
+ */
+osal_retval_t osal_rwlock_wrlock(osal_rwlock_t *rwl);
+
+//! \brief Tries to lock a reader-writer lock for writing.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_BUSY                    Lock is held by readers or a writer.
+ * \retval OSAL_ERR_UNAVAILABLE             Other errors.
+ */
+osal_retval_t osal_rwlock_trywrlock(osal_rwlock_t *rwl);
+
+//! \brief Locks a reader-writer lock for writing with timeout.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_TIMEOUT                 Lock not acquired until timeout.
+ * \retval OSAL_ERR_DEAD_LOCK               Calling task already holds the lock.
+ * \retval OSAL_ERR_UNAVAILABLE             Other errors.
+ */
+osal_retval_t osal_rwlock_timedwrlock(osal_rwlock_t *rwl, const osal_timer_t *to);
+
+//! \brief Unlocks a reader-writer lock.
+/*!
+ * Releases a read or a write lock held by the calling task.
+ *
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_PERMISSION_DENIED       Lock not held by calling task.
+ * \retval OSAL_ERR_UNAVAILABLE             Other errors.
+ */
+osal_retval_t osal_rwlock_unlock(osal_rwlock_t *rwl);
+
+//! \brief Destroys a reader-writer lock.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_BUSY                    Lock is still held.
+ * \retval OSAL_ERR_UNAVAILABLE             Other errors.
+ */
+osal_retval_t osal_rwlock_destroy(osal_rwlock_t *rwl);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_RWLOCK__H */
+
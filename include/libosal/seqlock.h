@@ -0,0 +1,148 @@
+/**
+ * \file seqlock.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL sequence lock header.
+ *
+ * OSAL sequence lock include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_SEQLOCK__H
+#define LIBOSAL_SEQLOCK__H
+
+#include <libosal/osal.h>
+
+/** \defgroup seqlock_group Sequence Lock
+ * A sequence lock publishes data from one writer to any number of readers
+ * without ever blocking the writer. The writer makes the sequence counter odd,
+ * updates the data and makes the counter even again. Readers copy the data
+ * and retry if the counter was odd or changed meanwhile.
+ *
+ * The sequence lock contains no pointers and no kernel objects, so it can be
+ * placed in shared memory together with the data, e.g. in a region returned
+ * by \ref osal_shm_map. Readers only read the shared memory, a slow or
+ * crashed reader can not delay the writer.
+ *
+ * There must be only one writer at a time. A second writer entering while
+ * the first one is writing is refused with OSAL_ERR_BUSY instead of being
+ * blocked. Readers of a frequently updated, large data set may have to retry
+ * several times, so the data should be copied out with
+ * \ref osal_seqlock_read_copy and processed afterwards.
+ *
+ * @{
+ */
+
+typedef struct osal_seqlock {
+    osal_uint32_t seq;                                          //!< \brief Sequence counter, odd while writing.
+} osal_seqlock_t;                                               //!< \brief Sequence lock type.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Initialize a sequence lock.
+/*!
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_seqlock_init(osal_seqlock_t *sl);
+
+//! \brief Start updating the protected data.
+/*!
+ * Never blocks. Stores to the data must not move before this call.
+ *
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_BUSY                    Another writer is active.
+ */
+osal_retval_t osal_seqlock_write_begin(osal_seqlock_t *sl);
+
+//! \brief Finish updating the protected data.
+/*!
+ * Publishes the update to the readers.
+ *
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_PERMISSION_DENIED       No write in progress.
+ */
+osal_retval_t osal_seqlock_write_end(osal_seqlock_t *sl);
+
+//! \brief Start reading the protected data.
+/*!
+ * Waits while a writer is active.
+ *
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ *
+ * \return Sequence to pass to \ref osal_seqlock_read_retry.
+ */
+osal_uint32_t osal_seqlock_read_begin(const osal_seqlock_t *sl);
+
+//! \brief Check if the data read has to be discarded.
+/*!
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ * \param[in]   seq     Sequence returned by \ref osal_seqlock_read_begin.
+ *
+ * \retval OSAL_TRUE                        Data was modified while reading, read again.
+ * \retval OSAL_FALSE                       Data read is consistent.
+ */
+osal_bool_t osal_seqlock_read_retry(const osal_seqlock_t *sl, osal_uint32_t seq);
+
+//! \brief Copy data into the protected area as one update.
+/*!
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ * \param[out]  dst     Protected data.
+ * \param[in]   src     New data.
+ * \param[in]   size    Number of bytes to copy.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_BUSY                    Another writer is active.
+ */
+osal_retval_t osal_seqlock_write_copy(osal_seqlock_t *sl, osal_void_t *dst, const osal_void_t *src, 
+        osal_size_t size);
+
+//! \brief Copy a consistent snapshot of the protected area.
+/*!
+ * Retries until the copy was not disturbed by a writer.
+ *
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ * \param[out]  dst     Local copy.
+ * \param[in]   src     Protected data.
+ * \param[in]   size    Number of bytes to copy.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_seqlock_read_copy(const osal_seqlock_t *sl, osal_void_t *dst, const osal_void_t *src, 
+        osal_size_t size);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_SEQLOCK__H */
+
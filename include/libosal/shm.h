@@ -57,16 +57,26 @@
  *
  * Shared memory module
  *
+ * Large segments should not take their page faults at first touch from a
+ * real-time task. \ref OSAL_SHM_ATTR__FLAG__HUGEPAGES backs a segment with
+ * huge pages, this reduces the number of faults and TLB misses. All users
+ * of a segment have to pass this flag, because huge page backed segments
+ * may live in a different namespace. On map, \ref OSAL_SHM_MAP_ATTR__POPULATE
+ * lets the kernel populate the mapping, \ref OSAL_SHM_MAP_ATTR__PREFAULT
+ * does the same with several tasks for very large segments and
+ * \ref OSAL_SHM_MAP_ATTR__LOCKED keeps the pages resident.
+ *
  * @{
  */
 
-#define OSAL_SHM_ATTR__FLAG__MASK             0x0000003Fu       //!< \brief Shared memory attribute flag mask.
+#define OSAL_SHM_ATTR__FLAG__MASK             0x0000007Fu       //!< \brief Shared memory attribute flag mask.
 #define OSAL_SHM_ATTR__FLAG__RDONLY           0x00000001u       //!< \brief Shared memory attribute flag read-only.
 #define OSAL_SHM_ATTR__FLAG__RDWR             0x00000002u       //!< \brief Shared memory attribute flag read-write.
 #define OSAL_SHM_ATTR__FLAG__CREAT            0x00000004u       //!< \brief Shared memory attribute flag create.
 #define OSAL_SHM_ATTR__FLAG__EXCL             0x00000008u       //!< \brief Shared memory attribute flag exclusive.
 #define OSAL_SHM_ATTR__FLAG__TRUNC            0x00000010u       //!< \brief Shared memory attribute flag truncate. 
 #define OSAL_SHM_ATTR__FLAG__MAP              0x00000020u       //!< \brief Shared memory attribute flag mapable.
+#define OSAL_SHM_ATTR__FLAG__HUGEPAGES        0x00000040u       //!< \brief Shared memory attribute flag huge page backed.
 
 #define OSAL_SHM_ATTR__MODE__MASK             0xFFFF0000u       //!< \brief Shared memory attribute mode mask.
 #define OSAL_SHM_ATTR__MODE__SHIFT            16u               //!< \brief Shared memory attribute mode shift bits.
@@ -79,6 +89,10 @@
 #define OSAL_SHM_MAP_ATTR__SHARED             0x00000100u       //!< \brief Shared memory attribute shared.
 #define OSAL_SHM_MAP_ATTR__PRIVATE            0x00000200u       //!< \brief Shared memory attribute private.
 
+#define OSAL_SHM_MAP_ATTR__POPULATE           0x00001000u       //!< \brief Shared memory attribute populate page tables on map.
+#define OSAL_SHM_MAP_ATTR__LOCKED             0x00002000u       //!< \brief Shared memory attribute lock pages on map.
+#define OSAL_SHM_MAP_ATTR__PREFAULT           0x00004000u       //!< \brief Shared memory attribute prefault pages in parallel.
+
 typedef osal_uint32_t osal_shm_attr_t;                          //!< \brief Shared memory attribute type.
 typedef osal_uint32_t osal_shm_map_attr_t;                      //!< \brief Shared memory map attribute type.
 
@@ -88,6 +102,11 @@ extern "C" {
 
 //! \brief Initialize a shm.
 /*!
+ * With \ref OSAL_SHM_ATTR__FLAG__HUGEPAGES the segment is created on
+ * hugetlbfs and its size is rounded up to the huge page size. If no
+ * hugetlbfs is mounted or not enough huge pages are reserved, a regular
+ * segment is used instead and transparent huge pages are advised on map.
+ *
  * \param[in]   shm     Pointer to osal shm structure. Content is OS dependent.
  * \param[in]   name    Shared memory name.
  * \param[in]   attr    Pointer to initial shm attributes. Can be NULL then
@@ -100,6 +119,12 @@ osal_retval_t osal_shm_open(osal_shm_t *shm, const osal_char_t *name,  const osa
 
 //! \brief Map a shm.
 /*!
+ * \ref OSAL_SHM_MAP_ATTR__POPULATE populates the whole mapping in the
+ * calling task. \ref OSAL_SHM_MAP_ATTR__PREFAULT splits this work across
+ * several tasks for segments of many megabytes, without changing the
+ * segment contents. \ref OSAL_SHM_MAP_ATTR__LOCKED locks the mapping,
+ * if this fails the mapping is removed again.
+ *
  * \param[in]   shm     Pointer to osal shm structure. Content is OS dependent.
  * \param[in]   attr    Pointer to map attributes.
  * \param[out]  ptr     Pointer where to returned mapped data pointer.
@@ -116,6 +141,22 @@ osal_retval_t osal_shm_map(osal_shm_t *shm, const osal_shm_map_attr_t *attr, osa
  */
 osal_retval_t osal_shm_close(osal_shm_t *shm);
 
+//! \brief Remove a shm.
+/*!
+ * Removes the name of the segment, it is freed when the last user has
+ * closed and unmapped it. Pass the same attributes as to \ref osal_shm_open,
+ * with \ref OSAL_SHM_ATTR__FLAG__HUGEPAGES the segment is removed from
+ * hugetlbfs or, if it fell back to regular pages, from the regular
+ * namespace.
+ *
+ * \param[in]   name    Shared memory name.
+ * \param[in]   attr    Pointer to the shm attributes the segment was opened
+ *                      with. Can be NULL for a segment without huge pages.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_unlink(const osal_char_t *name, const osal_shm_attr_t *attr);
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,197 @@
+/**
+ * \file shm_ring.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL shared memory ring buffer header.
+ *
+ * OSAL lock-free single-producer/single-consumer ring buffer include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_SHM_RING__H
+#define LIBOSAL_SHM_RING__H
+
+#include <libosal/osal.h>
+#include <libosal/timer.h>
+
+/** \defgroup shm_ring_group Shared memory ring buffer
+ * Lock-free single-producer/single-consumer ring of fixed-size frames. The ring
+ * is placed in a caller provided memory region, usually one returned by
+ * \ref osal_shm_map, so that producer and consumer may live in different
+ * processes. Frames are written and read in place (zero-copy), the hot path
+ * does not enter the kernel.
+ *
+ * @{
+ */
+
+#define OSAL_SHM_RING_ATTR__BLOCKING        0x00000001u     //!< \brief Allow blocking waits on empty/full ring.
+
+typedef osal_uint32_t osal_shm_ring_attr_t;                 //!< \brief Shared memory ring attribute type.
+
+//! \brief Ring control block, placed at the start of the shared region.
+typedef struct osal_shm_ring_ctrl {
+    osal_uint32_t magic;                                    //!< \brief Initialization magic.
+    osal_uint32_t flags;                                    //!< \brief Ring attributes.
+    osal_uint32_t frame_size;                               //!< \brief Size of one frame in bytes (padded).
+    osal_uint32_t frame_cnt;                                //!< \brief Number of frames, power of 2.
+    osal_uint8_t  pad0[OSAL_CACHE_LINE_SIZE - 16u];
+
+    osal_uint32_t head;                                     //!< \brief Producer index, free running.
+    osal_uint32_t head_waiters;                             //!< \brief Consumer is waiting for data.
+    osal_uint8_t  pad1[OSAL_CACHE_LINE_SIZE - 8u];
+
+    osal_uint32_t tail;                                     //!< \brief Consumer index, free running.
+    osal_uint32_t tail_waiters;                             //!< \brief Producer is waiting for space.
+    osal_uint8_t  pad2[OSAL_CACHE_LINE_SIZE - 8u];
+} osal_shm_ring_ctrl_t;
+
+//! \brief Process local ring handle.
+typedef struct osal_shm_ring {
+    osal_shm_ring_ctrl_t *ctrl;                             //!< \brief Control block in shared region.
+    osal_uint8_t *frames;                                   //!< \brief First frame in shared region.
+    osal_uint32_t mask;                                     //!< \brief Index mask (frame_cnt - 1).
+    osal_uint32_t frame_size;                               //!< \brief Size of one frame in bytes.
+    osal_uint32_t cached_head;                              //!< \brief Consumer's last seen producer index.
+    osal_uint32_t cached_tail;                              //!< \brief Producer's last seen consumer index.
+} osal_shm_ring_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Get size of memory region needed for a ring.
+/*!
+ * \param[in]   frame_size  Size of one frame in bytes.
+ * \param[in]   frame_cnt   Number of frames, has to be a power of 2.
+ *
+ * \return Needed size in bytes, 0 on invalid parameters.
+ */
+osal_size_t osal_shm_ring_get_size(osal_size_t frame_size, osal_uint32_t frame_cnt);
+
+//! \brief Initialize a ring in a memory region.
+/*!
+ * This function formats the memory region \p mem as an empty ring. It has to
+ * be called exactly once by the creator of the region, the other side uses
+ * \ref osal_shm_ring_attach.
+ *
+ * \param[out]  ring        Pointer to osal shm ring handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ * \param[in]   frame_size  Size of one frame in bytes.
+ * \param[in]   frame_cnt   Number of frames, has to be a power of 2.
+ * \param[in]   attr        Pointer to ring attributes. Can be NULL.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       Invalid frame count/size or region too small.
+ */
+osal_retval_t osal_shm_ring_init(osal_shm_ring_t *ring, osal_void_t *mem, osal_size_t mem_size,
+        osal_size_t frame_size, osal_uint32_t frame_cnt, const osal_shm_ring_attr_t *attr);
+
+//! \brief Attach to a ring initialized by someone else.
+/*!
+ * \param[out]  ring        Pointer to osal shm ring handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_UNAVAILABLE         Region is not (yet) initialized.
+ * \retval OSAL_ERR_INVALID_PARAM       Region is too small for the ring found.
+ */
+osal_retval_t osal_shm_ring_attach(osal_shm_ring_t *ring, osal_void_t *mem, osal_size_t mem_size);
+
+//! \brief Reserve next free frame for writing (producer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ * \param[out]  frame       Returns pointer to the frame to be filled.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_BUSY                Ring is full.
+ */
+osal_retval_t osal_shm_ring_reserve(osal_shm_ring_t *ring, osal_void_t **frame);
+
+//! \brief Reserve next free frame for writing, wait if ring is full (producer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ * \param[out]  frame       Returns pointer to the frame to be filled.
+ * \param[in]   to          Absolute timeout, NULL waits forever.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_TIMEOUT             Ring still full after timeout.
+ * \retval OSAL_ERR_INVALID_PARAM       Ring was not created with \ref OSAL_SHM_RING_ATTR__BLOCKING.
+ */
+osal_retval_t osal_shm_ring_timedreserve(osal_shm_ring_t *ring, osal_void_t **frame, const osal_timer_t *to);
+
+//! \brief Publish the previously reserved frame (producer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ *
+ * \retval OSAL_OK                      On success.
+ */
+osal_retval_t osal_shm_ring_commit(osal_shm_ring_t *ring);
+
+//! \brief Get oldest published frame for reading (consumer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ * \param[out]  frame       Returns pointer to the frame to be read.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_NO_DATA             Ring is empty.
+ */
+osal_retval_t osal_shm_ring_peek(osal_shm_ring_t *ring, osal_void_t **frame);
+
+//! \brief Get oldest published frame, wait if ring is empty (consumer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ * \param[out]  frame       Returns pointer to the frame to be read.
+ * \param[in]   to          Absolute timeout, NULL waits forever.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_TIMEOUT             Ring still empty after timeout.
+ * \retval OSAL_ERR_INVALID_PARAM       Ring was not created with \ref OSAL_SHM_RING_ATTR__BLOCKING.
+ */
+osal_retval_t osal_shm_ring_timedpeek(osal_shm_ring_t *ring, osal_void_t **frame, const osal_timer_t *to);
+
+//! \brief Hand the previously peeked frame back to the producer (consumer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ *
+ * \retval OSAL_OK                      On success.
+ */
+osal_retval_t osal_shm_ring_release(osal_shm_ring_t *ring);
+
+//! \brief Get number of published but not yet released frames.
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ *
+ * \return Number of frames currently in the ring.
+ */
+osal_uint32_t osal_shm_ring_count(osal_shm_ring_t *ring);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_SHM_RING__H */
+
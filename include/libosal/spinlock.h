@@ -33,6 +33,13 @@
 
 #include <libosal/osal.h>
 
+typedef struct osal_spinlock_stats {
+    osal_uint64_t locks;                        //!< \brief Number of acquisitions.
+    osal_uint64_t contended;                    //!< \brief Number of acquisitions which had to wait.
+    osal_uint64_t spins;                        //!< \brief Number of polls while waiting in total.
+    osal_uint64_t max_spins;                    //!< \brief Maximum number of polls of a single acquisition.
+} osal_spinlock_stats_t;                        //!< \brief Spinlock statistics type.
+
 #ifdef LIBOSAL_BUILD_POSIX
 #include <libosal/posix/spinlock.h>
 #endif
@@ -61,6 +68,17 @@
  * waiting on a spinlock does an active/busy-wait and costs CPU-time, but does not have the 
  * side-effects of the OS-scheduler.
  *
+ * The waiting algorithm is selected with the OSAL_SPINLOCK_ATTR__ALGORITHM__* attributes:
+ *
+ * - \ref OSAL_SPINLOCK_ATTR__ALGORITHM__TAS polls a single lock word and backs off 
+ *   exponentially. Cheapest uncontended, but not fair.
+ * - \ref OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET hands the lock over in arrival order.
+ * - \ref OSAL_SPINLOCK_ATTR__ALGORITHM__MCS queues the waiters, every waiter polls its own
+ *   cache line. Fair and scales to many cores, but can not be process shared.
+ *
+ * Waiters which poll for a long time yield the CPU now and then, so that a preempted lock
+ * holder can make progress.
+ *
  * @{
  */
 
@@ -71,12 +89,18 @@
 
 #define OSAL_SPINLOCK_ATTR__ROBUST                 0x00000010u      //!< \brief Robust spinlock (unlocks if owner died).
 #define OSAL_SPINLOCK_ATTR__PROCESS_SHARED         0x00000020u      //!< \brief Process shared spinlock.
+#define OSAL_SPINLOCK_ATTR__STATS                  0x00000040u      //!< \brief Collect spinlock statistics.
 
 #define OSAL_SPINLOCK_ATTR__PROTOCOL__MASK         0x00000300u      //!< \brief Spinlock protocol mask.
 #define OSAL_SPINLOCK_ATTR__PROTOCOL__NONE         0x00000000u      //!< \brief Spinlock protocol default.
 #define OSAL_SPINLOCK_ATTR__PROTOCOL__INHERIT      0x00000100u      //!< \brief Spinlock inherit protocol.
 #define OSAL_SPINLOCK_ATTR__PROTOCOL__PROTECT      0x00000200u      //!< \brief Spinlock protect protocol.
 
+#define OSAL_SPINLOCK_ATTR__ALGORITHM__MASK        0x00003000u      //!< \brief Spinlock algorithm mask.
+#define OSAL_SPINLOCK_ATTR__ALGORITHM__TAS         0x00000000u      //!< \brief Test-and-test-and-set with exponential backoff (default).
+#define OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET      0x00001000u      //!< \brief Ticket lock, FIFO order.
+#define OSAL_SPINLOCK_ATTR__ALGORITHM__MCS         0x00002000u      //!< \brief MCS queue lock, FIFO order with local spinning.
+
 #define OSAL_SPINLOCK_ATTR__PRIOCEILING__MASK      0xFFFF0000u      //!< \brief Spinlock priority ceiling mask.
 #define OSAL_SPINLOCK_ATTR__PRIOCEILING__SHIFT     16u              //!< \brief Spinlock priority ceiling value.
 
@@ -91,6 +115,9 @@ extern "C" {
  * This function initializes a spinlock structure given by \p mtx. If no attributes
  * are given with \p attr a default spinlock is initiazed.
  *
+ * Spinlocks can not be robust and have no priority protocol, these attributes
+ * are rejected.
+ *
  * \param[in]   mtx     Pointer to osal spinlock structure. Content is OS dependent.
  * \param[in]   attr    Pointer to initial spinlock attributes. Can be NULL then
  *                      the defaults of the underlying spinlock will be used.
@@ -99,7 +126,8 @@ extern "C" {
  * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    Not enough system resources.
  * \retval OSAL_ERR_OUT_OF_MEMORY           System is out of memory.
  * \retval OSAL_ERR_PERMISSION_DENIED       Permission denied opening a shared mutex.
- * \retval OSAL_ERR_INVALID_PARAM           Invalid input parameter.
+ * \retval OSAL_ERR_INVALID_PARAM           Invalid input parameter, unsupported attribute
+ *                                          or process shared MCS spinlock.
  * \retval OSAL_ERR_UNAVAILABLE             Other errors. 
  */
 osal_retval_t osal_spinlock_init(osal_spinlock_t *mtx, const osal_spinlock_attr_t *attr);
@@ -121,6 +149,20 @@ osal_retval_t osal_spinlock_init(osal_spinlock_t *mtx, const osal_spinlock_attr_
  */
 osal_retval_t osal_spinlock_lock(osal_spinlock_t *mtx);
 
+//! \brief Tries to lock a spinlock.
+/*!
+ * This function locks the spinlock if it is available and returns immediately
+ * with OSAL_ERR_BUSY otherwise.
+ *
+ * \param[in]   mtx     Pointer to osal spinlock structure. Content is OS dependent.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_BUSY                    Spinlock is already locked.
+ * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    Too many MCS spinlocks held by calling task.
+ * \retval OSAL_ERR_DEAD_LOCK               Already locked by calling task (see ERRORCHECK).
+ */
+osal_retval_t osal_spinlock_trylock(osal_spinlock_t *mtx);
+
 //! \brief Unlocks a spinlock.
 /*!
  * This function tries to unlock a previously locked spinlock.
@@ -144,6 +186,19 @@ osal_retval_t osal_spinlock_unlock(osal_spinlock_t *mtx);
  */
 osal_retval_t osal_spinlock_destroy(osal_spinlock_t *mtx);
 
+//! \brief Get statistics of a spinlock.
+/*!
+ * Only available if the spinlock was initialized with \ref OSAL_SPINLOCK_ATTR__STATS.
+ * The values are updated by the lock holder, reading them concurrently is allowed.
+ *
+ * \param[in]   mtx     Pointer to osal spinlock structure. Content is OS dependent.
+ * \param[out]  stats   Returns statistics.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_UNAVAILABLE             Statistics not enabled for this spinlock.
+ */
+osal_retval_t osal_spinlock_get_stats(osal_spinlock_t *mtx, osal_spinlock_stats_t *stats);
+
 #ifdef __cplusplus
 };
 #endif
@@ -33,6 +33,7 @@
 #define LIBOSAL_TASK__H
 
 #include <libosal/osal.h>
+#include <libosal/cpuset.h>
 
 #ifdef LIBOSAL_BUILD_POSIX
 #include <libosal/posix/task.h>
@@ -66,16 +67,44 @@
 #define OSAL_SCHED_POLICY_OTHER         ((osal_uint32_t)0x00000003u)        //!< \brief Task scheduling policy other.
 
 #define TASK_NAME_LEN   64u                             //!< \brief Task maximum name length.
+#define OSAL_TASK_NUMA_NODES_MAX        64u             //!< \brief Number of NUMA nodes a task can be bound to.
+
+#define OSAL_TASK_ATTR__STACK_PREFAULT  0x00000001u     //!< \brief Lock and prefault the whole stack before the handler runs.
+#define OSAL_TASK_ATTR__NO_GUARD        0x00000002u     //!< \brief Create the stack without guard pages.
+#define OSAL_TASK_ATTR__CPUSET          0x00000004u     //!< \brief Field cpuset is set.
+#define OSAL_TASK_ATTR__NUMA_NODES      0x00000008u     //!< \brief Field numa_nodes is set.
+#define OSAL_TASK_ATTR__STACK           0x00000010u     //!< \brief Fields stack_size, stack and guard_size are set.
 
 typedef osal_uint32_t osal_task_sched_policy_t;         //!< \brief Type of scheduling policy.
 typedef osal_uint32_t osal_task_sched_priority_t;       //!< \brief Type of scheduling priority.
 typedef osal_uint32_t osal_task_sched_affinity_t;       //!< \brief Type of scheduling affinity.
 
+//! \brief Task attributes.
+/*!
+ * Initialize with \ref osal_task_attr_init before setting single fields,
+ * the structure grows with new attributes.
+ */
 typedef struct osal_task_attr {
     osal_char_t task_name[TASK_NAME_LEN];               //!< \brief Task name.
     osal_task_sched_policy_t   policy;                  //!< \brief Task policy.
     osal_task_sched_priority_t priority;                //!< \brief Task priority.
-    osal_task_sched_affinity_t affinity;                //!< \brief Task affinity.
+    osal_task_sched_affinity_t affinity;                //!< \brief Task affinity of the first 32 CPUs.
+    osal_cpuset_t cpuset;                               //!< \brief Task CPU set, used instead of affinity if not empty.
+                                                        //!<        Only read with OSAL_TASK_ATTR__CPUSET.
+    osal_uint64_t numa_nodes;                           //!< \brief Bit n binds the task and the memory it touches first
+                                                        //!<        to NUMA node n, 0 for no binding. The task runs on the
+                                                        //!<        CPUs of the nodes unless cpuset or affinity is given.
+                                                        //!<        Only read with OSAL_TASK_ATTR__NUMA_NODES.
+    osal_size_t stack_size;                             //!< \brief Stack size in [byte], 0 for the system default. At least
+                                                        //!<        PTHREAD_STACK_MIN if given. Only read with
+                                                        //!<        OSAL_TASK_ATTR__STACK.
+    osal_void_t *stack;                                 //!< \brief Caller provided stack of stack_size bytes, NULL to allocate
+                                                        //!<        it. Has to stay valid until the task is joined. Only
+                                                        //!<        read with OSAL_TASK_ATTR__STACK.
+    osal_size_t guard_size;                             //!< \brief Guard size in [byte] below the stack, 0 for the system
+                                                        //!<        default. Not used with a caller provided stack. Only
+                                                        //!<        read with OSAL_TASK_ATTR__STACK.
+    osal_uint32_t flags;                                //!< \brief Combination of OSAL_TASK_ATTR__*.
 } osal_task_attr_t;                                     //!< \brief Task attribute type.
 
 typedef void *(*osal_task_handler_t)(void *arg);        //!< \brief Task handler function template.
@@ -93,18 +122,42 @@ typedef osal_uint32_t osal_task_state_t;                //!< \brief Task state t
 extern "C" {
 #endif
 
+//! \brief Initialize task attributes with the defaults.
+/*!
+ * Every field is set to its default: no name, policy and priority of the
+ * calling thread, no affinity, cpu set or NUMA binding, system default
+ * stack and guard and no flags. Attributes passed to \ref osal_task_create
+ * have to be initialized with this function, set the wanted fields
+ * afterwards. cpuset, numa_nodes and the stack fields are only read if
+ * the matching OSAL_TASK_ATTR__* bit is set in flags.
+ *
+ * \param[out]  attr    Pointer to task attributes.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_task_attr_init(osal_task_attr_t *attr);
+
 //! \brief Create a task.
 /*!
+ * Stack, policy and priority are set before the task starts, so the task
+ * never runs with the defaults. A priority without policy uses the policy
+ * of the calling thread. With \ref OSAL_TASK_ATTR__STACK_PREFAULT the stack
+ * is locked into memory after the NUMA binding and before the handler is
+ * called, so the handler does not page fault on its stack. The lock stays
+ * on a caller provided stack after the task has ended.
+ *
  * \param[in]   hdl     Pointer to osal task structure. Content is OS dependent.
- * \param[in]   attr    Pointer to initial task attributes. Can be NULL then
- *                      the defaults of the underlying task will be used.
+ * \param[in]   attr    Pointer to initial task attributes, initialized with
+ *                      \ref osal_task_attr_init. Can be NULL then the
+ *                      defaults of the underlying task will be used.
  * \param[in]   handler Task handler to be executed.
  * \param[in]   arg     Pointer to argument passed to task handler.
  *
  * \retval OSAL_OK                          On success.
  * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    System is out of resources.
  * \retval OSAL_ERR_PERMISSION_DENIED       Permission denied for priority/policy.
- * \retval OSAL_ERR_INVALID_PARAM           Invalid input parameter.
+ * \retval OSAL_ERR_INVALID_PARAM           Invalid input parameter, e.g. a
+ *                                          stack below the system minimum.
  * \retval OSAL_ERR_OPERATION_FAILED        Other errors.
  */
 osal_retval_t osal_task_create(osal_task_t *hdl, const osal_task_attr_t *attr, 
@@ -144,7 +197,9 @@ osal_retval_t osal_task_get_hdl(osal_task_t *hdl);
 //! \brief Change the task attributes of the specified task.
 /*!
  * \param[in]   hdl     Pointer to osal task structure. Content is OS dependent.
- * \param[in]   attr    The thread's new attributes.
+ * \param[in]   attr    The thread's new attributes. NUMA nodes can only be
+ *                      set if \p hdl is the calling task. Stack attributes
+ *                      and flags are ignored, they only apply at creation.
  *
  *
  * \retval OSAL_OK                          On success.
@@ -157,7 +212,9 @@ osal_retval_t osal_task_set_task_attr(osal_task_t *hdl, osal_task_attr_t *attr);
 //! \brief Get the current task attributes of the specified task.
 /*!
  * \param[in]   hdl     Pointer to osal task structure. Content is OS dependent.
- * \param[out]  attr    The thread's current attributes.
+ * \param[out]  attr    The thread's current attributes. NUMA nodes are only
+ *                      reported if \p hdl is the calling task. Stack and
+ *                      guard size are reported, stack and flags are cleared.
  *
  * \retval OSAL_OK                          On success.
  * \retval OSAL_ERR_OPERATION_FAILED        Other errors.
@@ -245,6 +302,49 @@ osal_retval_t osal_task_set_affinity(osal_task_t *hdl,
 osal_retval_t osal_task_get_affinity(osal_task_t *hdl, 
                                         osal_task_sched_affinity_t *affinity);
 
+//! \brief Change the CPU set of the specified thread.
+/*!
+ * Unlike \ref osal_task_set_affinity this works for all CPU numbers below
+ * \ref OSAL_CPUSET_SIZE.
+ *
+ * \param[in]   hdl     Pointer to osal task structure. Content is OS dependent.
+ *                      If \p hdl is NULL, set CPU set for calling thread.
+ * \param[in]   cpuset  CPUs the thread may run on.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           Empty set, no online CPU in set or invalid task.
+ * \retval OSAL_ERR_NOT_IMPLEMENTED         Not implemented.
+ */
+osal_retval_t osal_task_set_cpuset(osal_task_t *hdl, const osal_cpuset_t *cpuset);
+
+//! \brief Get the CPU set of the specified thread.
+/*!
+ * \param[in]   hdl     Pointer to osal task structure. Content is OS dependent.
+ *                      If \p hdl is NULL, get CPU set of calling thread.
+ * \param[out]  cpuset  CPUs the thread may run on.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           Invalid task.
+ * \retval OSAL_ERR_NOT_IMPLEMENTED         Not implemented.
+ */
+osal_retval_t osal_task_get_cpuset(osal_task_t *hdl, osal_cpuset_t *cpuset);
+
+//! \brief Bind the calling thread and its memory to NUMA nodes.
+/*!
+ * The thread is restricted to the CPUs of the nodes and pages it touches
+ * first are allocated from the nodes only. Memory which is already
+ * allocated is not migrated, so call this before the thread allocates and
+ * prefaults its working set.
+ *
+ * \param[in]   numa_nodes  Bit n set for NUMA node n.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           No node given, node does not exist or has no memory.
+ * \retval OSAL_ERR_PERMISSION_DENIED       Insufficient permission to set memory policy.
+ * \retval OSAL_ERR_NOT_IMPLEMENTED         No NUMA support.
+ */
+osal_retval_t osal_task_bind_numa(osal_uint64_t numa_nodes);
+
 //! \brief Suspend a thread from running.
 /*!
  * \param[in]   hdl     Pointer to osal task structure. Content is OS dependent.
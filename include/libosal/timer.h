@@ -143,12 +143,38 @@ osal_retval_t osal_busy_wait_until_nsec(osal_uint64_t nsec);
 
 //! Globally sets the internal clock source used by the timer functions.
 /*!
+ * With \ref LIBOSAL_CLOCK_TSC (posix, x86_64 with invariant TSC) the time is
+ * read with rdtsc and converted to CLOCK_MONOTONIC nanoseconds by a fixed-point
+ * multiply. The TSC is calibrated between \ref osal_init and this call. The
+ * call blocks until 10 ms have passed since \ref osal_init, so select the
+ * clock during startup and not from a real-time loop. Reading the time never
+ * enters the kernel, call \ref osal_timer_tsc_resync periodically to follow
+ * CLOCK_MONOTONIC. Sleeps and timeouts use CLOCK_MONOTONIC. Without an
+ * invariant TSC CLOCK_MONOTONIC is selected, check with
+ * \ref osal_timer_get_clock_source.
  *
  * \param[in] clock_id    Clock id of the clock source according to the <time.h>
- *                        header of your plattform like CLOKC_REALTIME.
+ *                        header of your plattform like CLOKC_REALTIME, or
+ *                        LIBOSAL_CLOCK_TSC.
  */
 void osal_timer_set_clock_source(int clock_id);
 
+//! Steer the TSC clock back to CLOCK_MONOTONIC.
+/*!
+ * Compares the TSC time with CLOCK_MONOTONIC and adjusts the rate so that
+ * the error is gone after one second, without a jump in time. Between
+ * calls the TSC time runs at the rate calibrated since \ref osal_init.
+ * An error above half a second is stepped out if the TSC time is behind.
+ * If it is ahead, the TSC time runs at half rate until CLOCK_MONOTONIC has
+ * caught up, so it never goes backwards.
+ * Call it about once per second from a task which is not timing critical,
+ * it reads CLOCK_MONOTONIC a few times.
+ *
+ * \retval OSAL_OK                  On success.
+ * \retval OSAL_ERR_UNAVAILABLE     \ref LIBOSAL_CLOCK_TSC is not the clock source.
+ */
+osal_retval_t osal_timer_tsc_resync(void);
+
 //! Returns the internal clock source used by the timer functions.
 /*!
  *
@@ -0,0 +1,208 @@
+/**
+ * \file timer_service.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL timer service header.
+ *
+ * OSAL software timer service include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_TIMER_SERVICE__H
+#define LIBOSAL_TIMER_SERVICE__H
+
+#include <libosal/osal.h>
+#include <libosal/binary_semaphore.h>
+#include <libosal/mutex.h>
+#include <libosal/semaphore.h>
+#include <libosal/task.h>
+#include <libosal/timer.h>
+
+/** \defgroup timer_service_group Timer Service
+ * A timer service runs many software timers on a single task. Each timer
+ * either calls a handler or posts a semaphore when it expires, once or
+ * periodically.
+ *
+ * The timers are kept in a hierarchical timing wheel: \ref
+ * OSAL_TIMER_SERVICE_LEVELS levels of \ref OSAL_TIMER_SERVICE_SLOTS slots,
+ * a slot of level n spans \ref OSAL_TIMER_SERVICE_SLOTS ^ n ticks. Arming
+ * puts a timer into the slot list of its expiry tick and cancelling unlinks
+ * it, both take constant time regardless of the number of timers. When the
+ * lower level wraps around, the next slot of the level above is cascaded
+ * down. Timers further away than the wheel span are parked in the top level
+ * and cascaded until they are due.
+ *
+ * The service task does not wake up every tick, it sleeps until the next
+ * tick with an expiring timer or a cascade. Time is read from the clock
+ * selected with \ref osal_timer_set_clock_source, which has to be set before
+ * the service is created. Timers never expire early, they expire at the
+ * first tick boundary after their deadline.
+ *
+ * @{
+ */
+
+#define OSAL_TIMER_SERVICE_LEVELS               4u              //!< \brief Number of wheel levels.
+#define OSAL_TIMER_SERVICE_SLOTS                256u            //!< \brief Slots per wheel level, power of 2.
+#define OSAL_TIMER_SERVICE_RESOLUTION_DEFAULT   1000000u        //!< \brief Default tick length in [ns].
+
+//! \brief Timer handler, called on the service task.
+/*!
+ * The handler may arm and cancel timers, including its own. A periodic
+ * timer is already re-armed for its next expiry when the handler is called.
+ *
+ * \param[in]   arg     Argument passed to \ref osal_timer_service_timer_init.
+ */
+typedef void (*osal_timer_service_handler_t)(osal_void_t *arg);
+
+typedef struct osal_timer_service_timer {
+    struct osal_timer_service_timer *next;                  //!< \brief Next timer in slot list.
+    struct osal_timer_service_timer **pprev;                //!< \brief Link pointing to this timer, NULL if not armed.
+    osal_timer_service_handler_t handler;                   //!< \brief Called on expiry, NULL for semaphore timers.
+    osal_void_t *arg;                                       //!< \brief Argument of handler.
+    osal_semaphore_t *sem;                                  //!< \brief Posted on expiry, NULL for handler timers.
+    osal_uint64_t deadline;                                 //!< \brief Expiry time on the timer clock in [ns].
+    osal_uint64_t period;                                   //!< \brief Period in [ns], 0 for one-shot timers.
+    osal_uint64_t expires;                                  //!< \brief Expiry tick.
+    osal_uint32_t slot;                                     //!< \brief Level * slots + slot of the list the timer is in.
+} osal_timer_service_timer_t;                               //!< \brief Timer type.
+
+typedef struct osal_timer_service_attr {
+    osal_task_attr_t task_attr;                             //!< \brief Name, policy, priority and affinity of the service task,
+                                                            //!<        initialized with \ref osal_task_attr_init.
+    osal_uint64_t resolution;                               //!< \brief Tick length in [ns], 0 for \ref OSAL_TIMER_SERVICE_RESOLUTION_DEFAULT.
+} osal_timer_service_attr_t;                                //!< \brief Timer service attribute type.
+
+typedef struct osal_timer_service_stats {
+    osal_uint64_t expired;                                  //!< \brief Number of timer expiries.
+    osal_uint64_t missed;                                   //!< \brief Periods skipped by late periodic timers.
+    osal_uint64_t max_latency;                              //!< \brief Maximum time between deadline and expiry in [ns].
+} osal_timer_service_stats_t;                               //!< \brief Timer service statistics type.
+
+typedef struct osal_timer_service {
+    osal_mutex_t lock;                                      //!< \brief Protects wheel and timers.
+    osal_binary_semaphore_t wakeup;                         //!< \brief Wakes the service task on earlier expiries and stop.
+    osal_task_t task;                                       //!< \brief Service task.
+    osal_uint64_t resolution;                               //!< \brief Tick length in [ns].
+    osal_uint64_t start;                                    //!< \brief Time of tick 0 in [ns].
+    osal_uint64_t tick;                                     //!< \brief Next tick to process.
+    osal_uint64_t wakeup_tick;                              //!< \brief Tick the service task sleeps until.
+    osal_uint32_t run;                                      //!< \brief Cleared to stop the service task.
+    osal_timer_service_stats_t stats;                       //!< \brief Statistics, updated by the service task.
+    osal_timer_service_timer_t *expired;                    //!< \brief Timers of the current tick not yet handled.
+    osal_uint64_t used[OSAL_TIMER_SERVICE_LEVELS][OSAL_TIMER_SERVICE_SLOTS / 64u];  //!< \brief Bitmap of non-empty slots.
+    osal_timer_service_timer_t *slots[OSAL_TIMER_SERVICE_LEVELS][OSAL_TIMER_SERVICE_SLOTS];  //!< \brief Slot lists.
+} osal_timer_service_t;                                     //!< \brief Timer service type.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Create a timer service and start its task.
+/*!
+ * \param[out]  svc     Pointer to osal timer service structure.
+ * \param[in]   attr    Pointer to timer service attributes. Can be NULL for
+ *                      default task attributes and resolution.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_PERMISSION_DENIED       Permission denied for priority/policy.
+ * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    System is out of resources.
+ * \retval OSAL_ERR_OPERATION_FAILED        Other errors.
+ */
+osal_retval_t osal_timer_service_init(osal_timer_service_t *svc, const osal_timer_service_attr_t *attr);
+
+//! \brief Stop the service task and destroy the timer service.
+/*!
+ * Pending timers are dropped without expiring.
+ *
+ * \param[in]   svc     Pointer to osal timer service structure.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_timer_service_destroy(osal_timer_service_t *svc);
+
+//! \brief Initialize a timer calling a handler.
+/*!
+ * \param[out]  tmr     Pointer to timer.
+ * \param[in]   handler Handler called on expiry.
+ * \param[in]   arg     Argument passed to handler.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_timer_service_timer_init(osal_timer_service_timer_t *tmr,
+        osal_timer_service_handler_t handler, osal_void_t *arg);
+
+//! \brief Initialize a timer posting a semaphore.
+/*!
+ * \param[out]  tmr     Pointer to timer.
+ * \param[in]   sem     Semaphore posted on expiry.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_timer_service_timer_init_semaphore(osal_timer_service_timer_t *tmr, osal_semaphore_t *sem);
+
+//! \brief Arm a timer.
+/*!
+ * A pending timer is re-armed with the new timeout. Periodic timers expire
+ * on the grid deadline + n * period. If the service falls behind by more
+ * than a period, the missed expiries are skipped.
+ *
+ * \param[in]   svc     Pointer to osal timer service structure.
+ * \param[in]   tmr     Pointer to initialized timer.
+ * \param[in]   timeout Time until first expiry in [ns].
+ * \param[in]   period  Period in [ns], 0 for a one-shot timer.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_timer_service_arm(osal_timer_service_t *svc, osal_timer_service_timer_t *tmr,
+        osal_uint64_t timeout, osal_uint64_t period);
+
+//! \brief Cancel a timer.
+/*!
+ * The timer may be freed afterwards. Its handler may still be running on
+ * the service task if it was called just before.
+ *
+ * \param[in]   svc     Pointer to osal timer service structure.
+ * \param[in]   tmr     Pointer to timer.
+ *
+ * \retval OSAL_OK                          Pending timer cancelled.
+ * \retval OSAL_ERR_NOT_FOUND               Timer was not armed or already expired.
+ */
+osal_retval_t osal_timer_service_cancel(osal_timer_service_t *svc, osal_timer_service_timer_t *tmr);
+
+//! \brief Get statistics of a timer service.
+/*!
+ * \param[in]   svc     Pointer to osal timer service structure.
+ * \param[out]  stats   Returns statistics.
+ *
+ * \return N/A
+ */
+void osal_timer_service_get_stats(osal_timer_service_t *svc, osal_timer_service_stats_t *stats);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_TIMER_SERVICE__H */
+
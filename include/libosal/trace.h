@@ -40,9 +40,48 @@
 /** \defgroup trace_group Trace 
  * This module implements timing traces for use in realtime systems. 
  *
+ * A trace allocated with \ref osal_trace_alloc is a single producer trace,
+ * only one task may call \ref osal_trace_point on it. A trace allocated with
+ * \ref osal_trace_alloc_mp has one lock-free sub-buffer per registered task
+ * (see \ref osal_trace_register). Trace points into it only do stores to the
+ * calling task's sub-buffer, the oldest records are overwritten if the reader
+ * does not keep up. \ref osal_trace_read returns the records of all tasks
+ * merged by timestamp.
+ *
  * @{
  */
 
+#define OSAL_TRACE_HISTOGRAM_SUB_BITS   5u      //!< \brief Linear sub-buckets per power of 2 (log2), ~3% resolution.
+#define OSAL_TRACE_HISTOGRAM_SUB_CNT    (1u << OSAL_TRACE_HISTOGRAM_SUB_BITS)   //!< \brief Linear sub-buckets per power of 2.
+//! \brief Number of histogram buckets to cover the full 64-bit range.
+#define OSAL_TRACE_HISTOGRAM_BUCKETS    ((64u - OSAL_TRACE_HISTOGRAM_SUB_BITS + 1u) * OSAL_TRACE_HISTOGRAM_SUB_CNT)
+
+#define OSAL_TRACE_HISTOGRAM__INTERVAL  0u      //!< \brief Histogram of intervals between consecutive trace times (default).
+#define OSAL_TRACE_HISTOGRAM__VALUE     1u      //!< \brief Histogram of the traced values itself (relative traces).
+
+#define OSAL_TRACE_P50                  500000u //!< \brief 50th percentile in ppm.
+#define OSAL_TRACE_P90                  900000u //!< \brief 90th percentile in ppm.
+#define OSAL_TRACE_P99                  990000u //!< \brief 99th percentile in ppm.
+#define OSAL_TRACE_P999                 999000u //!< \brief 99.9th percentile in ppm.
+#define OSAL_TRACE_P9999                999900u //!< \brief 99.99th percentile in ppm.
+
+//! \brief Log-linear (HDR style) histogram.
+/*!
+ * Values below \ref OSAL_TRACE_HISTOGRAM_SUB_CNT have their own bucket, above
+ * every power of 2 is split into \ref OSAL_TRACE_HISTOGRAM_SUB_CNT linear
+ * buckets. Use \ref osal_trace_histogram_bucket_bounds to get the value range
+ * of a bucket.
+ */
+typedef struct osal_trace_histogram {
+    osal_uint64_t cnt;                  //!< number of samples.
+    osal_uint64_t min;                  //!< minimum sample.
+    osal_uint64_t max;                  //!< maximum sample.
+    osal_uint64_t sum;                  //!< sum of all samples.
+    osal_uint64_t buckets[OSAL_TRACE_HISTOGRAM_BUCKETS];    //!< sample count per bucket.
+} osal_trace_histogram_t;
+
+struct osal_trace_producer;
+
 typedef struct osal_trace {
     osal_uint32_t cnt;                  //!< number of measurements
     osal_uint32_t act_buf;              //!< actual number of double buffer
@@ -50,8 +89,24 @@ typedef struct osal_trace {
     osal_binary_semaphore_t sync_sem;   //!< sync when buffer is full.
     osal_uint64_t *time_in_ns[2];       //!< time double buffer.
     osal_uint64_t *tmp;                 //!< calculation buffer.
+
+    osal_uint32_t max_producers;        //!< number of producer sub-buffers, 0 for single producer trace.
+    osal_uint32_t producer_cnt;         //!< number of registered producers.
+    struct osal_trace_producer *producers;  //!< producer sub-buffers.
+    osal_void_t *producers_mem;         //!< allocated memory of producer sub-buffers.
+    osal_uint64_t generation;           //!< unique id of multi producer trace, validates cached producers.
+
+    osal_uint32_t hist_mode;            //!< histogram mode, OSAL_TRACE_HISTOGRAM__*.
+    osal_uint64_t hist_last;            //!< last trace time for interval histogram.
+    osal_trace_histogram_t *hist;       //!< streaming histogram (single producer trace).
 } osal_trace_t;                         //!< Trace structure.
 
+typedef struct osal_trace_record {
+    osal_uint64_t time;                 //!< trace time in [ns].
+    osal_uint32_t producer;             //!< producer id as returned by \ref osal_trace_register.
+    osal_uint32_t reserved;             //!< reserved.
+} osal_trace_record_t;                  //!< Multi producer trace record.
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -67,6 +122,60 @@ extern "C" {
  */
 osal_retval_t osal_trace_alloc(osal_trace_t **trace, osal_uint32_t cnt);
 
+//! \brief Allocate multi producer trace struct.
+/*!
+ * \param[out]  trace           Pointer to trace* where allocated trace struct is returned.
+ * \param[in]   max_producers   Maximum number of tasks registering to the trace.
+ * \param[in]   cnt             Number of samples per producer, rounded up to a power of 2.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       Zero producers or samples.
+ * \retval OSAL_ERR_OUT_OF_MEMORY       System out of memory.
+ */
+osal_retval_t osal_trace_alloc_mp(osal_trace_t **trace, osal_uint32_t max_producers, osal_uint32_t cnt);
+
+//! \brief Register calling task as producer of a multi producer trace.
+/*!
+ * Has to be called once by every task before it calls \ref osal_trace_point
+ * or \ref osal_trace_time on a multi producer trace, trace points of
+ * unregistered tasks are ignored. Registering twice returns the same id.
+ * A sub-buffer stays with its task until the trace is freed, the one of an
+ * exited task is not handed to a task started later.
+ *
+ * \param[in]   trace       Pointer to trace struct.
+ * \param[out]  producer    Returns producer id, can be NULL.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           Not a multi producer trace.
+ * \retval OSAL_ERR_SYSTEM_LIMIT_REACHED    All producer sub-buffers are in use.
+ */
+osal_retval_t osal_trace_register(osal_trace_t *trace, osal_uint32_t *producer);
+
+//! \brief Read records of a multi producer trace merged by timestamp.
+/*!
+ * Only one task may read a trace at a time. Records are only ordered
+ * among the ones already written when reading.
+ *
+ * \param[in]   trace       Pointer to trace struct.
+ * \param[out]  records     Buffer for returned records.
+ * \param[in]   max_records Size of \p records.
+ * \param[out]  read_cnt    Returns number of records stored in \p records.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_NO_DATA             No new records.
+ * \retval OSAL_ERR_INVALID_PARAM       Not a multi producer trace.
+ */
+osal_retval_t osal_trace_read(osal_trace_t *trace, osal_trace_record_t *records, 
+        osal_uint32_t max_records, osal_uint32_t *read_cnt);
+
+//! \brief Return number of records overwritten before they could be read.
+/*!
+ * \param[in]   trace   Pointer to multi producer trace struct.
+ *
+ * \return Number of lost records.
+ */
+osal_uint64_t osal_trace_get_lost(osal_trace_t *trace);
+
 //! \brief Free trace struct.
 /*!
  * \param[in]   trace   Pointer to trace struct to free.
@@ -110,8 +219,78 @@ osal_uint64_t osal_trace_get_last_time(osal_trace_t *trace);
  */
 osal_retval_t osal_trace_timedwait(osal_trace_t *trace, osal_timer_t *timeout);
 
+//! \brief Select what the streaming histogram records.
+/*!
+ * Every \ref osal_trace_time updates the trace's histogram in O(1). By
+ * default it records the interval to the previous trace time, with
+ * \ref OSAL_TRACE_HISTOGRAM__VALUE it records the traced value itself,
+ * which suits traces of durations analyzed by \ref osal_trace_analyze_rel.
+ * Changing the mode resets the histogram.
+ *
+ * \param[in]   trace   Pointer to trace struct.
+ * \param[in]   mode    OSAL_TRACE_HISTOGRAM__INTERVAL or OSAL_TRACE_HISTOGRAM__VALUE.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       Unknown mode.
+ */
+osal_retval_t osal_trace_set_histogram_mode(osal_trace_t *trace, osal_uint32_t mode);
+
+//! \brief Reset the streaming histogram.
+/*!
+ * Must not be called concurrently to trace points.
+ *
+ * \param[in]   trace   Pointer to trace struct.
+ *
+ * \return N/A
+ */
+void osal_trace_reset_histogram(osal_trace_t *trace);
+
+//! \brief Get a copy of the streaming histogram.
+/*!
+ * For multi producer traces the histograms of all producers are summed up.
+ * The copy is taken while tracing continues, so it may be off by the
+ * samples added during the copy.
+ *
+ * \param[in]   trace   Pointer to trace struct.
+ * \param[out]  hist    Returns histogram.
+ *
+ * \return N/A
+ */
+void osal_trace_get_histogram(osal_trace_t *trace, osal_trace_histogram_t *hist);
+
+//! \brief Get value range of a histogram bucket.
+/*!
+ * \param[in]   idx     Bucket index, smaller than \ref OSAL_TRACE_HISTOGRAM_BUCKETS.
+ * \param[out]  low     Returns lowest value counted in bucket.
+ * \param[out]  high    Returns highest value counted in bucket.
+ *
+ * \return N/A
+ */
+void osal_trace_histogram_bucket_bounds(osal_uint32_t idx, osal_uint64_t *low, osal_uint64_t *high);
+
+//! \brief Get percentiles from the streaming histogram.
+/*!
+ * The returned values are the upper bounds of the buckets the percentiles
+ * fall into (limited to the maximum sample), so they are never too optimistic.
+ *
+ * \param[in]   trace       Pointer to trace struct.
+ * \param[in]   ppm         Percentiles in parts per million, e.g. \ref OSAL_TRACE_P99.
+ * \param[out]  values      Returns one value per requested percentile.
+ * \param[in]   cnt         Number of requested percentiles.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_NO_DATA             No samples recorded yet.
+ * \retval OSAL_ERR_INVALID_PARAM       Percentile larger than 1000000 ppm.
+ * \retval OSAL_ERR_OUT_OF_MEMORY       Merging multi producer histograms failed.
+ */
+osal_retval_t osal_trace_get_percentiles(osal_trace_t *trace, const osal_uint32_t *ppm, 
+        osal_uint64_t *values, osal_uint32_t cnt);
+
 //! \brief Analyze trace and return average and jitters.
 /*!
+ * Multi producer traces have no time buffers, all values are returned 0.
+ * Use \ref osal_trace_analyze_ex to get an error for them.
+ *
  * \param[in]   trace   Pointer to trace struct.
  * \param[out]  avg     Return average time interval.
  * \param[out]  avg_jit Return average jitter (std-dev).
@@ -123,6 +302,9 @@ void osal_trace_analyze(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *
 
 //! \brief Analyze trace and return average and jitters.
 /*!
+ * Multi producer traces have no time buffers, all values are returned 0.
+ * Use \ref osal_trace_analyze_ex to get an error for them.
+ *
  * \param[in]   trace   Pointer to trace struct.
  * \param[out]  avg     Return average time interval.
  * \param[out]  avg_jit Return average jitter (std-dev).
@@ -135,8 +317,26 @@ void osal_trace_analyze(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *
 void osal_trace_analyze_min_max(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *avg_jit, 
         osal_uint64_t *max_jit, osal_uint64_t *min_val, osal_uint64_t *max_val);
 
+//! \brief Analyze trace and return average and jitters.
+/*!
+ * \param[in]   trace   Pointer to trace struct.
+ * \param[out]  avg     Return average time interval.
+ * \param[out]  avg_jit Return average jitter (std-dev).
+ * \param[out]  max_jit Return maximum jitter.
+ * \param[out]  min_val Return minimum interval value, can be NULL.
+ * \param[out]  max_val Return maximum interval value, can be NULL.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       Multi producer trace, use \ref osal_trace_read.
+ */
+osal_retval_t osal_trace_analyze_ex(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *avg_jit, 
+        osal_uint64_t *max_jit, osal_uint64_t *min_val, osal_uint64_t *max_val);
+
 //! \brief Analyze trace with relative timestamps and return average and jitters.
 /*!
+ * Multi producer traces have no time buffers, all values are returned 0.
+ * Use \ref osal_trace_analyze_rel_ex to get an error for them.
+ *
  * \param[in]   trace   Pointer to trace struct.
  * \param[out]  avg     Return average time interval.
  * \param[out]  avg_jit Return average jitter (std-dev).
@@ -148,6 +348,9 @@ void osal_trace_analyze_rel(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64
 
 //! \brief Analyze trace with relative timestamps and return average and jitters.
 /*!
+ * Multi producer traces have no time buffers, all values are returned 0.
+ * Use \ref osal_trace_analyze_rel_ex to get an error for them.
+ *
  * \param[in]   trace   Pointer to trace struct.
  * \param[out]  avg     Return average time interval.
  * \param[out]  avg_jit Return average jitter (std-dev).
@@ -160,6 +363,21 @@ void osal_trace_analyze_rel(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64
 void osal_trace_analyze_rel_min_max(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *avg_jit, 
         osal_uint64_t *max_jit, osal_uint64_t *min_val, osal_uint64_t *max_val);
 
+//! \brief Analyze trace with relative timestamps and return average and jitters.
+/*!
+ * \param[in]   trace   Pointer to trace struct.
+ * \param[out]  avg     Return average time interval.
+ * \param[out]  avg_jit Return average jitter (std-dev).
+ * \param[out]  max_jit Return maximum jitter.
+ * \param[out]  min_val Return minimum interval value, can be NULL.
+ * \param[out]  max_val Return maximum interval value, can be NULL.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       Multi producer trace, use \ref osal_trace_read.
+ */
+osal_retval_t osal_trace_analyze_rel_ex(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *avg_jit, 
+        osal_uint64_t *max_jit, osal_uint64_t *min_val, osal_uint64_t *max_val);
+
 #ifdef __cplusplus
 };
 #endif
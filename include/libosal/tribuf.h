@@ -0,0 +1,176 @@
+/**
+ * \file tribuf.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL triple buffer header.
+ *
+ * OSAL triple buffer include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_TRIBUF__H
+#define LIBOSAL_TRIBUF__H
+
+#include <libosal/osal.h>
+
+/** \defgroup tribuf_group Triple buffer
+ * Lock-free "latest value" channel from one producer to one consumer. Of the
+ * three frames the producer owns one, the consumer owns one and the third
+ * holds the last published frame. Publishing and reading swap the own frame
+ * with the third one in a single atomic exchange, so neither side ever waits
+ * for the other. The consumer always gets the most recent complete frame,
+ * older frames are silently overwritten.
+ *
+ * Like the \ref shm_ring_group the channel is placed in a caller provided
+ * memory region, either process local or one returned by \ref osal_shm_map.
+ * Frames are written and read in place.
+ *
+ * @{
+ */
+
+//! \brief Triple buffer control block, placed at the start of the region.
+typedef struct osal_tribuf_ctrl {
+    osal_uint32_t magic;                                    //!< \brief Initialization magic.
+    osal_uint32_t frame_size;                               //!< \brief Size of one frame in bytes (padded).
+    osal_uint8_t  pad0[OSAL_CACHE_LINE_SIZE - 8u];
+
+    osal_uint32_t latest;                                   //!< \brief Index of last published frame and fresh flag.
+    osal_uint8_t  pad1[OSAL_CACHE_LINE_SIZE - 4u];
+
+    osal_uint32_t write_idx;                                //!< \brief Frame owned by producer.
+    osal_uint32_t published;                                //!< \brief Number of published frames.
+    osal_uint8_t  pad2[OSAL_CACHE_LINE_SIZE - 8u];
+
+    osal_uint32_t read_idx;                                 //!< \brief Frame owned by consumer.
+    osal_uint8_t  pad3[OSAL_CACHE_LINE_SIZE - 4u];
+} osal_tribuf_ctrl_t;
+
+//! \brief Process local triple buffer handle.
+typedef struct osal_tribuf {
+    osal_tribuf_ctrl_t *ctrl;                               //!< \brief Control block in region.
+    osal_uint8_t *frames;                                   //!< \brief First frame in region.
+    osal_uint32_t frame_size;                               //!< \brief Size of one frame in bytes.
+} osal_tribuf_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Get size of memory region needed for a triple buffer.
+/*!
+ * \param[in]   frame_size  Size of one frame in bytes.
+ *
+ * \return Needed size in bytes, 0 on invalid parameters.
+ */
+osal_size_t osal_tribuf_get_size(osal_size_t frame_size);
+
+//! \brief Initialize a triple buffer in a memory region.
+/*!
+ * This function formats the memory region \p mem with three zeroed frames.
+ * It has to be called exactly once by the creator of the region, the other
+ * side uses \ref osal_tribuf_attach.
+ *
+ * \param[out]  tb          Pointer to osal triple buffer handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ * \param[in]   frame_size  Size of one frame in bytes.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       Invalid frame size or region too small.
+ */
+osal_retval_t osal_tribuf_init(osal_tribuf_t *tb, osal_void_t *mem, osal_size_t mem_size, osal_size_t frame_size);
+
+//! \brief Attach to a triple buffer initialized by someone else.
+/*!
+ * \param[out]  tb          Pointer to osal triple buffer handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_UNAVAILABLE         Region is not (yet) initialized.
+ * \retval OSAL_ERR_INVALID_PARAM       Region is too small for the triple buffer found.
+ */
+osal_retval_t osal_tribuf_attach(osal_tribuf_t *tb, osal_void_t *mem, osal_size_t mem_size);
+
+//! \brief Get the frame to be filled (producer).
+/*!
+ * The frame stays the same until \ref osal_tribuf_publish is called. It
+ * contains stale data, the producer has to write the whole frame.
+ *
+ * \param[in]   tb          Pointer to osal triple buffer handle.
+ * \param[out]  frame       Returns pointer to the frame to be filled.
+ *
+ * \retval OSAL_OK                      On success.
+ */
+osal_retval_t osal_tribuf_reserve(osal_tribuf_t *tb, osal_void_t **frame);
+
+//! \brief Publish the filled frame as the latest one (producer).
+/*!
+ * \param[in]   tb          Pointer to osal triple buffer handle.
+ *
+ * \retval OSAL_OK                      On success.
+ */
+osal_retval_t osal_tribuf_publish(osal_tribuf_t *tb);
+
+//! \brief Copy data into the producer frame and publish it (producer).
+/*!
+ * \param[in]   tb          Pointer to osal triple buffer handle.
+ * \param[in]   src         Data to publish.
+ * \param[in]   size        Number of bytes, at most the frame size.
+ *
+ * \retval OSAL_OK                      On success.
+ * \retval OSAL_ERR_INVALID_PARAM       Data larger than a frame.
+ */
+osal_retval_t osal_tribuf_write(osal_tribuf_t *tb, const osal_void_t *src, osal_size_t size);
+
+//! \brief Get the most recent published frame (consumer).
+/*!
+ * The frame stays valid and unchanged until the next call. If nothing was
+ * published since the last call, the previous frame is returned again.
+ *
+ * \param[in]   tb          Pointer to osal triple buffer handle.
+ * \param[out]  frame       Returns pointer to the most recent frame.
+ *
+ * \retval OSAL_OK                      A new frame was published since last call.
+ * \retval OSAL_ERR_NO_DATA             No new frame, \p frame is the previous one.
+ */
+osal_retval_t osal_tribuf_read(osal_tribuf_t *tb, osal_void_t **frame);
+
+//! \brief Get number of frames published so far.
+/*!
+ * Consumers may use it to detect how many frames were overwritten.
+ *
+ * \param[in]   tb          Pointer to osal triple buffer handle.
+ *
+ * \return Number of published frames, wraps around.
+ */
+osal_uint32_t osal_tribuf_published(osal_tribuf_t *tb);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_TRIBUF__H */
+
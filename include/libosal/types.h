@@ -65,6 +65,8 @@ typedef int64_t    osal_int64_t;        //!< \brief 64-bit signed type.
 
 typedef uint64_t   osal_mode_t;         //!< \brief mode type.
 
+#define OSAL_CACHE_LINE_SIZE    64u     //!< \brief Assumed cache line size for padding shared structures.
+
 typedef FILE       osal_file_t;
 typedef va_list    osal_va_list_t;
 
@@ -0,0 +1,221 @@
+/**
+ * \file workpool.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL work pool header.
+ *
+ * OSAL work-stealing work pool include header.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_WORKPOOL__H
+#define LIBOSAL_WORKPOOL__H
+
+#include <libosal/osal.h>
+#include <libosal/task.h>
+
+/** \defgroup workpool_group Work Pool
+ * A work pool splits computations of one cycle across several CPUs. It
+ * keeps a fixed set of worker tasks, so the cycle does not pay for task
+ * creation and does not need hand written semaphore handshakes.
+ *
+ * Jobs are spawned into a group and the spawning task waits for the group.
+ * Each worker owns a Chase-Lev deque: it pushes and takes its own jobs at
+ * the bottom without locking, idle workers steal from the top of other
+ * deques. A waiting task executes jobs itself instead of blocking, so
+ * nested fork-join and \ref osal_parallel_for inside jobs do not dead lock.
+ *
+ * Idle workers poll for work during a spin phase and then park on a futex.
+ * With a spin phase longer than the cycle time, workers stay hot and a
+ * fan-out/fan-in costs a few microseconds.
+ *
+ * Jobs may be spawned by the workers of the pool and by one further task at
+ * a time, usually the cyclic task which owns the pool.
+ *
+ * @{
+ */
+
+#define OSAL_WORKPOOL_WORKERS_MAX           32u             //!< \brief Maximum number of worker tasks.
+#define OSAL_WORKPOOL_DEQUE_SIZE            256u            //!< \brief Jobs per deque, a spawn into a full deque runs the job directly.
+#define OSAL_WORKPOOL_SPIN_NSEC_DEFAULT     50000u          //!< \brief Default spin phase of idle workers in [ns].
+
+//! \brief Work pool job handler.
+/*!
+ * \param[in]   arg     Argument passed to \ref osal_workpool_spawn.
+ */
+typedef void (*osal_workpool_handler_t)(osal_void_t *arg);
+
+//! \brief Parallel for range handler.
+/*!
+ * \param[in]   arg     Argument passed to \ref osal_parallel_for.
+ * \param[in]   begin   First index of the chunk.
+ * \param[in]   end     One past the last index of the chunk.
+ */
+typedef void (*osal_workpool_range_handler_t)(osal_void_t *arg, osal_size_t begin, osal_size_t end);
+
+//! \brief Group of jobs to wait for.
+typedef struct osal_workpool_group {
+    osal_uint32_t pending;                                  //!< \brief Unfinished jobs and waiter flag, also used as futex.
+} osal_workpool_group_t;
+
+//! \brief Job storage, provided by the spawner until the group is waited for.
+typedef struct osal_workpool_job {
+    osal_workpool_handler_t handler;                        //!< \brief Job handler.
+    osal_void_t *arg;                                       //!< \brief Argument of handler.
+    osal_workpool_group_t *group;                           //!< \brief Group the job belongs to.
+} osal_workpool_job_t;
+
+//! \brief Chase-Lev work-stealing deque.
+typedef struct osal_workpool_deque {
+    osal_int64_t top;                                       //!< \brief Steal end, advanced by thieves.
+    osal_uint8_t pad0[OSAL_CACHE_LINE_SIZE - 8u];
+    osal_int64_t bottom;                                    //!< \brief Owner end.
+    osal_uint8_t pad1[OSAL_CACHE_LINE_SIZE - 8u];
+    osal_workpool_job_t *jobs[OSAL_WORKPOOL_DEQUE_SIZE];    //!< \brief Job ring.
+} osal_workpool_deque_t;
+
+struct osal_workpool;
+
+typedef struct osal_workpool_worker {
+    osal_workpool_deque_t deque;                            //!< \brief Jobs spawned by this worker.
+    struct osal_workpool *pool;                             //!< \brief Pool the worker belongs to.
+    osal_task_t task;                                       //!< \brief Worker task.
+    osal_uint32_t index;                                    //!< \brief Index in pool, 0 is the spawning task.
+    osal_uint32_t seed;                                     //!< \brief Victim selection state.
+    osal_uint8_t pad[OSAL_CACHE_LINE_SIZE];
+} osal_workpool_worker_t;                                   //!< \brief Work pool worker type.
+
+typedef struct osal_workpool_attr {
+    osal_uint32_t worker_cnt;                               //!< \brief Number of worker tasks, the waiting task helps in addition.
+    osal_uint64_t spin_nsec;                                //!< \brief Time an idle worker polls for work before parking in [ns].
+    osal_task_attr_t task_attr;                             //!< \brief Policy, priority, stack size and name of the workers.
+                                                            //!<        Each worker is pinned to the next CPU of the cpu set
+                                                            //!<        or affinity mask, both empty for no pinning.
+                                                            //!<        Initialize with \ref osal_task_attr_init.
+} osal_workpool_attr_t;                                     //!< \brief Work pool attribute type.
+
+typedef struct osal_workpool {
+    osal_uint32_t work_seq;                                 //!< \brief Bumped on new work, idle workers park on it.
+    osal_uint32_t sleepers;                                 //!< \brief Number of parked or parking workers.
+    osal_uint32_t run;                                      //!< \brief Cleared to stop the workers.
+    osal_uint32_t worker_cnt;                               //!< \brief Number of worker tasks.
+    osal_uint64_t spin_nsec;                                //!< \brief Spin phase of idle workers in [ns].
+    osal_workpool_worker_t *workers;                        //!< \brief worker_cnt + 1 workers, [0] is the spawning task.
+    osal_void_t *workers_mem;                               //!< \brief Allocation of workers.
+} osal_workpool_t;                                          //!< \brief Work pool type.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Create a work pool and start its workers.
+/*!
+ * \param[out]  pool    Pointer to osal work pool structure.
+ * \param[in]   attr    Pointer to work pool attributes. Can be NULL for one
+ *                      worker per online CPU besides the calling one with
+ *                      default task attributes, each pinned to one of the
+ *                      CPUs the caller may run on.
+ *
+ * \retval OSAL_OK                          On success.
+ * \retval OSAL_ERR_INVALID_PARAM           No or too many workers, or a caller
+ *                                          provided stack.
+ * \retval OSAL_ERR_OUT_OF_MEMORY           Workers could not be allocated.
+ * \retval OSAL_ERR_PERMISSION_DENIED       Permission denied for priority/policy.
+ * \retval OSAL_ERR_OPERATION_FAILED        Worker tasks could not be created.
+ */
+osal_retval_t osal_workpool_init(osal_workpool_t *pool, const osal_workpool_attr_t *attr);
+
+//! \brief Stop the workers and free the work pool.
+/*!
+ * No jobs may be pending.
+ *
+ * \param[in]   pool    Pointer to osal work pool structure.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_workpool_destroy(osal_workpool_t *pool);
+
+//! \brief Initialize an empty job group.
+/*!
+ * \param[out]  group   Pointer to job group.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_workpool_group_init(osal_workpool_group_t *group);
+
+//! \brief Spawn a job.
+/*!
+ * The job is pushed to the deque of the calling task and may be executed
+ * by any worker. \p job has to stay valid until \ref osal_workpool_wait
+ * returned for \p group.
+ *
+ * \param[in]   pool    Pointer to osal work pool structure.
+ * \param[in]   group   Group to add the job to.
+ * \param[in]   job     Storage of the job.
+ * \param[in]   handler Job handler.
+ * \param[in]   arg     Argument passed to handler.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_workpool_spawn(osal_workpool_t *pool, osal_workpool_group_t *group,
+        osal_workpool_job_t *job, osal_workpool_handler_t handler, osal_void_t *arg);
+
+//! \brief Wait until all jobs of a group are finished.
+/*!
+ * The calling task executes jobs while waiting, it only parks after the
+ * spin phase if no job is left to take or steal.
+ *
+ * \param[in]   pool    Pointer to osal work pool structure.
+ * \param[in]   group   Group to wait for.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_workpool_wait(osal_workpool_t *pool, osal_workpool_group_t *group);
+
+//! \brief Run a handler over an index range in parallel.
+/*!
+ * The range is split in halves recursively down to chunks of at most
+ * \p grain indices, the halves are spawned so that idle workers steal the
+ * largest pieces. Returns when all chunks are done.
+ *
+ * \param[in]   pool    Pointer to osal work pool structure.
+ * \param[in]   begin   First index.
+ * \param[in]   end     One past the last index.
+ * \param[in]   grain   Maximum chunk size, 0 for one chunk per worker and
+ *                      the calling task.
+ * \param[in]   handler Handler called for each chunk.
+ * \param[in]   arg     Argument passed to handler.
+ *
+ * \retval OSAL_OK                          On success.
+ */
+osal_retval_t osal_parallel_for(osal_workpool_t *pool, osal_size_t begin, osal_size_t end, osal_size_t grain,
+        osal_workpool_range_handler_t handler, osal_void_t *arg);
+
+#ifdef __cplusplus
+};
+#endif
+
+/** @} */
+
+#endif /* LIBOSAL_WORKPOOL__H */
+
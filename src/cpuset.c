@@ -0,0 +1,301 @@
+/**
+ * \file cpuset.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL cpu set source.
+ *
+ * OSAL cpu set source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/cpuset.h>
+#include <assert.h>
+
+//! \brief Parse a decimal number, returns OSAL_FALSE if there is no digit.
+static osal_bool_t cpuset_parse_number(const osal_char_t **pos, osal_uint32_t *value) {
+    osal_bool_t ret = OSAL_FALSE;
+    osal_uint64_t tmp = 0u;
+
+    while ((**pos >= '0') && (**pos <= '9')) {
+        if (tmp <= OSAL_CPUSET_SIZE) {
+            tmp = (tmp * 10u) + (osal_uint64_t)(**pos - '0');
+        }
+
+        (*pos)++;
+        ret = OSAL_TRUE;
+    }
+
+    // values above the set size only have to stay out of range
+    *value = tmp > OSAL_CPUSET_SIZE ? OSAL_CPUSET_SIZE : (osal_uint32_t)tmp;
+
+    return ret;
+}
+
+//! \brief Remove all CPUs from a set.
+/*!
+ * \param[out]  set     Pointer to cpu set.
+ */
+void osal_cpuset_zero(osal_cpuset_t *set) {
+    assert(set != NULL);
+
+    for (osal_uint32_t i = 0u; i < OSAL_CPUSET_WORDS; ++i) {
+        set->bits[i] = 0u;
+    }
+}
+
+//! \brief Add a CPU to a set.
+/*!
+ * \param[in,out]   set     Pointer to cpu set.
+ * \param[in]       cpu     CPU number.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpuset_set(osal_cpuset_t *set, osal_uint32_t cpu) {
+    assert(set != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    if (cpu >= OSAL_CPUSET_SIZE) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        set->bits[cpu / 64u] |= (osal_uint64_t)1u << (cpu % 64u);
+    }
+
+    return ret;
+}
+
+//! \brief Remove a CPU from a set.
+/*!
+ * \param[in,out]   set     Pointer to cpu set.
+ * \param[in]       cpu     CPU number.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpuset_clear(osal_cpuset_t *set, osal_uint32_t cpu) {
+    assert(set != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    if (cpu >= OSAL_CPUSET_SIZE) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        set->bits[cpu / 64u] &= ~((osal_uint64_t)1u << (cpu % 64u));
+    }
+
+    return ret;
+}
+
+//! \brief Check if a CPU is in a set.
+/*!
+ * \param[in]   set     Pointer to cpu set.
+ * \param[in]   cpu     CPU number.
+ *
+ * \return OSAL_TRUE if \p cpu is in \p set, OSAL_FALSE otherwise.
+ */
+osal_bool_t osal_cpuset_isset(const osal_cpuset_t *set, osal_uint32_t cpu) {
+    assert(set != NULL);
+
+    osal_bool_t ret = OSAL_FALSE;
+
+    if ((cpu < OSAL_CPUSET_SIZE) && ((set->bits[cpu / 64u] & ((osal_uint64_t)1u << (cpu % 64u))) != 0u)) {
+        ret = OSAL_TRUE;
+    }
+
+    return ret;
+}
+
+//! \brief Count the CPUs in a set.
+/*!
+ * \param[in]   set     Pointer to cpu set.
+ *
+ * \return Number of CPUs in \p set.
+ */
+osal_uint32_t osal_cpuset_count(const osal_cpuset_t *set) {
+    assert(set != NULL);
+
+    osal_uint32_t cnt = 0u;
+
+    for (osal_uint32_t i = 0u; i < OSAL_CPUSET_WORDS; ++i) {
+        cnt += (osal_uint32_t)__builtin_popcountll(set->bits[i]);
+    }
+
+    return cnt;
+}
+
+//! \brief Find the next CPU in a set.
+/*!
+ * \param[in]   set     Pointer to cpu set.
+ * \param[in]   cpu     CPU number to start the search at.
+ *
+ * \return Lowest CPU number in \p set which is not below \p cpu,
+ *         \ref OSAL_CPUSET_SIZE if there is none.
+ */
+osal_uint32_t osal_cpuset_next(const osal_cpuset_t *set, osal_uint32_t cpu) {
+    assert(set != NULL);
+
+    osal_uint32_t ret = OSAL_CPUSET_SIZE;
+
+    if (cpu < OSAL_CPUSET_SIZE) {
+        osal_uint32_t word = cpu / 64u;
+        osal_uint64_t bits = set->bits[word] & (~(osal_uint64_t)0u << (cpu % 64u));
+
+        while ((bits == 0u) && (++word < OSAL_CPUSET_WORDS)) {
+            bits = set->bits[word];
+        }
+
+        if (bits != 0u) {
+            ret = (word * 64u) + (osal_uint32_t)__builtin_ctzll(bits);
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Intersect two sets.
+/*!
+ * \param[out]  dst     Pointer to result, may be one of the operands.
+ * \param[in]   a       Pointer to first cpu set.
+ * \param[in]   b       Pointer to second cpu set.
+ */
+void osal_cpuset_and(osal_cpuset_t *dst, const osal_cpuset_t *a, const osal_cpuset_t *b) {
+    assert(dst != NULL);
+    assert(a != NULL);
+    assert(b != NULL);
+
+    for (osal_uint32_t i = 0u; i < OSAL_CPUSET_WORDS; ++i) {
+        dst->bits[i] = a->bits[i] & b->bits[i];
+    }
+}
+
+//! \brief Unite two sets.
+/*!
+ * \param[out]  dst     Pointer to result, may be one of the operands.
+ * \param[in]   a       Pointer to first cpu set.
+ * \param[in]   b       Pointer to second cpu set.
+ */
+void osal_cpuset_or(osal_cpuset_t *dst, const osal_cpuset_t *a, const osal_cpuset_t *b) {
+    assert(dst != NULL);
+    assert(a != NULL);
+    assert(b != NULL);
+
+    for (osal_uint32_t i = 0u; i < OSAL_CPUSET_WORDS; ++i) {
+        dst->bits[i] = a->bits[i] | b->bits[i];
+    }
+}
+
+//! \brief Fill a set from a 32 bit affinity mask.
+/*!
+ * \param[out]  set         Pointer to cpu set.
+ * \param[in]   affinity    Bit n set for CPU n.
+ */
+void osal_cpuset_from_mask(osal_cpuset_t *set, osal_uint32_t affinity) {
+    assert(set != NULL);
+
+    osal_cpuset_zero(set);
+    set->bits[0] = affinity;
+}
+
+//! \brief Get the first 32 CPUs of a set as affinity mask.
+/*!
+ * \param[in]   set     Pointer to cpu set.
+ *
+ * \return Bit n set for CPU n, CPUs from 32 on are dropped.
+ */
+osal_uint32_t osal_cpuset_to_mask(const osal_cpuset_t *set) {
+    assert(set != NULL);
+
+    return (osal_uint32_t)(set->bits[0] & 0xFFFFFFFFu);
+}
+
+//! \brief Parse a CPU list.
+/*!
+ * \param[out]  set     Pointer to cpu set.
+ * \param[in]   list    CPU list string.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpuset_parse(osal_cpuset_t *set, const osal_char_t *list) {
+    assert(set != NULL);
+    assert(list != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    const osal_char_t *pos = list;
+
+    osal_cpuset_zero(set);
+
+    while ((ret == OSAL_OK) && (*pos != '\0') && (*pos != '\n') && (*pos != ' ')) {
+        osal_uint32_t first;
+        osal_uint32_t last;
+        osal_uint32_t stride = 1u;
+
+        if (cpuset_parse_number(&pos, &first) == OSAL_FALSE) {
+            ret = OSAL_ERR_INVALID_PARAM;
+        } else {
+            last = first;
+
+            if (*pos == '-') {
+                pos++;
+                if (cpuset_parse_number(&pos, &last) == OSAL_FALSE) {
+                    ret = OSAL_ERR_INVALID_PARAM;
+                } else if (*pos == ':') {
+                    pos++;
+                    if ((cpuset_parse_number(&pos, &stride) == OSAL_FALSE) || (stride == 0u)) {
+                        ret = OSAL_ERR_INVALID_PARAM;
+                    }
+                }
+            }
+        }
+
+        if (ret == OSAL_OK) {
+            if ((last < first) || (last >= OSAL_CPUSET_SIZE)) {
+                ret = OSAL_ERR_INVALID_PARAM;
+            } else {
+                for (osal_uint32_t cpu = first; cpu <= last; cpu += stride) {
+                    (void)osal_cpuset_set(set, cpu);
+                }
+
+                if (*pos == ',') {
+                    pos++;
+                    if ((*pos < '0') || (*pos > '9')) {
+                        ret = OSAL_ERR_INVALID_PARAM;
+                    }
+                }
+            }
+        }
+    }
+
+    while ((ret == OSAL_OK) && (*pos != '\0')) {
+        if ((*pos != '\n') && (*pos != ' ')) {
+            ret = OSAL_ERR_INVALID_PARAM;
+        }
+        pos++;
+    }
+
+    return ret;
+}
+
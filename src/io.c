@@ -44,57 +44,564 @@
 #include <assert.h>
         
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 
-#define LIBOSAL_IO_SHM_MAGIC        0x00AFFE00
+#define LIBOSAL_IO_SHM_MAGIC        0x00AFFE02
 
+#define IO_SHM_REC__TEXT            0u      //!< formatted message.
+#define IO_SHM_REC__LOG             1u      //!< deferred log, timestamp, format id and raw arguments.
+
+#define IO_LOG_ARG__INT             1u
+#define IO_LOG_ARG__LONG            2u
+#define IO_LOG_ARG__LLONG           3u
+#define IO_LOG_ARG__SIZE            4u
+#define IO_LOG_ARG__PTRDIFF         5u
+#define IO_LOG_ARG__INTMAX          6u
+#define IO_LOG_ARG__DOUBLE          7u
+#define IO_LOG_ARG__PTR             8u
+#define IO_LOG_ARG__STR             9u
+
+#define IO_LOG_SITE__NEW            0u
+#define IO_LOG_SITE__REGISTERING    1u
+#define IO_LOG_SITE__READY          2u
+#define IO_LOG_SITE__TEXT           3u      //!< format not supported, format on caller.
+
+#define IO_LOG_SPEC_SIZE            64u     //!< buffer for one specification with expanded '*'.
+#define IO_LOG_STAR_SIZE            11u     //!< maximum length of an expanded '*', "-2147483648".
+
+//! Length of specification after expanding '*', incl. terminating 0.
+#define IO_LOG_SPEC_EXPANDED(spec)  (((spec)->len - (spec)->star_cnt) + ((spec)->star_cnt * IO_LOG_STAR_SIZE) + 1u)
+
+//! Record in the shm log ring.
+/*!
+ * A record is committed by storing its ring position + 1 to \p seq last.
+ */
+typedef struct osal_io_shm_rec {
+    osal_uint64_t       seq;            //!< commit sequence, ring position + 1.
+    osal_uint32_t       size;           //!< bytes occupied in ring incl. header.
+    osal_uint32_t       len;            //!< message length without terminating 0.
+    osal_uint32_t       type;           //!< record type, IO_SHM_REC__*.
+    osal_uint32_t       reserved;
+    osal_char_t         msg[0];         //!< message.
+} osal_io_shm_rec_t;
+
+//! Payload of a deferred log record, followed by the arguments.
+/*!
+ * Scalar arguments take 8 bytes each, strings are stored with their
+ * length (including terminating 0) and padded to 8 bytes.
+ */
+typedef struct osal_io_shm_log {
+    osal_uint64_t       time;           //!< timestamp in [ns].
+    osal_uint32_t       fmt_id;         //!< format string id.
+    osal_uint32_t       arg_cnt;        //!< number of arguments.
+    osal_uint8_t        args[0];
+} osal_io_shm_log_t;
+
+//! One conversion specification of a format string.
+typedef struct io_log_spec {
+    const osal_char_t   *begin;         //!< '%' of specification.
+    osal_size_t         len;            //!< length of specification.
+    osal_uint32_t       star_cnt;       //!< '*' width/precision arguments before value.
+    osal_uint32_t       type;           //!< IO_LOG_ARG__*, 0 for no argument.
+} io_log_spec_t;
+
+//! Multi producer, single consumer ring of variable length records.
+/*!
+ * Writers reserve space by advancing \p head and format directly into the
+ * ring. A writer reserves room for the largest message and gives back the
+ * unused part if no one reserved after it in the meantime. The data area is
+ * followed by one maximum sized record of slack, so records never wrap.
+ */
 typedef struct osal_io_shm {
-	osal_uint32_t       magic;
+    osal_uint64_t       head;           //!< write reservation, free running bytes.
+    osal_uint64_t       dropped;        //!< messages dropped on full ring.
+    osal_uint8_t        pad0[OSAL_CACHE_LINE_SIZE - 16u];
+
+    osal_uint64_t       tail;           //!< read position, free running bytes.
+    osal_uint32_t       reader_waiting; //!< reader blocks on sem.
+    osal_uint32_t       reserved;
+    osal_uint8_t        pad1[OSAL_CACHE_LINE_SIZE - 16u];
+
+    osal_uint32_t       magic;
+    osal_uint32_t       max_record_size;
+    osal_uint64_t       size;           //!< size of data area without slack, power of 2.
     osal_size_t         max_messages;
     osal_size_t         max_message_size;
 
-	osal_mutex_t        mtx;
-	osal_semaphore_t    sem;
-	osal_bool_t         new_msg;
+    osal_semaphore_t    sem;
+
+    osal_uint32_t       fmt_cnt;        //!< allocated format ids.
+    osal_uint32_t       fmt_used;       //!< used bytes in fmt_strings.
+    osal_uint32_t       fmt_offsets[LIBOSAL_IO_SHM_LOG_MAX_FORMATS];    //!< offset + 1, 0 if not yet published.
+    osal_char_t         fmt_strings[LIBOSAL_IO_SHM_LOG_FORMAT_SIZE];    //!< deferred log format strings.
 
-    osal_uint32_t       act_printed;
-    osal_uint32_t       act_written;
-	char                msgs[0];
+    osal_uint64_t       data[0];
 } osal_io_shm_t;
 
 static osal_shm_t osal_io_shm;
 static osal_io_shm_t *osal_io_shm_buffer = NULL;
 
-// Get next message printed to shm.
-osal_retval_t osal_io_shm_get_message(osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE],
-        const osal_timer_t *to)
+#define IO_SHM_REC_SIZE(len)    (((osal_uint32_t)sizeof(osal_io_shm_rec_t) + (len) + 1u + 7u) & ~7u)
+
+static osal_uint64_t io_shm_ring_size(osal_size_t max_msgs, osal_size_t max_msg_size) {
+    osal_uint64_t size = 64u;
+
+    while (size < ((osal_uint64_t)max_msgs * IO_SHM_REC_SIZE(max_msg_size))) {
+        size <<= 1u;
+    }
+
+    return size;
+}
+
+static osal_io_shm_rec_t *io_shm_rec(osal_io_shm_t *shm, osal_uint64_t pos) {
+    return (osal_io_shm_rec_t *)((osal_uint8_t *)shm->data + (pos & (shm->size - 1u)));
+}
+
+//! Reserve room for a maximum sized record, one atomic operation.
+static osal_retval_t io_shm_reserve(osal_io_shm_t *shm, osal_uint64_t *pos) {
+    osal_retval_t ret = OSAL_OK;
+    osal_uint64_t head = __atomic_load_n(&shm->head, __ATOMIC_RELAXED);
+
+    do {
+        osal_uint64_t tail = __atomic_load_n(&shm->tail, __ATOMIC_ACQUIRE);
+        if (((head + shm->max_record_size) - tail) > shm->size) {
+            ret = OSAL_ERR_BUSY;
+            break;
+        }
+    } while (!__atomic_compare_exchange_n(&shm->head, &head, head + shm->max_record_size, 1, 
+                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+    if (ret == OSAL_OK) {
+        (*pos) = head;
+    } else {
+        __atomic_fetch_add(&shm->dropped, 1u, __ATOMIC_RELAXED);
+    }
+
+    return ret;
+}
+
+//! Give back unused space if possible and publish record.
+static void io_shm_commit(osal_io_shm_t *shm, osal_uint64_t pos, osal_uint32_t len, osal_uint32_t type) {
+    osal_io_shm_rec_t *rec = io_shm_rec(shm, pos);
+    osal_uint64_t expected = pos + shm->max_record_size;
+    osal_uint32_t size = IO_SHM_REC_SIZE(len);
+
+    // only succeeds if we are still the last reservation
+    if (!__atomic_compare_exchange_n(&shm->head, &expected, pos + size, 0, 
+                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        size = shm->max_record_size;
+    }
+
+    rec->size = size;
+    rec->len = len;
+    rec->type = type;
+
+    // store-load ordering against the reader announcing itself as waiter
+    __atomic_store_n(&rec->seq, pos + 1u, __ATOMIC_SEQ_CST);
+    if (__atomic_exchange_n(&shm->reader_waiting, 0u, __ATOMIC_SEQ_CST) != 0u) {
+        osal_semaphore_post(&shm->sem);
+    }
+}
+
+//! Parse next conversion specification, returns NULL at end of format.
+static const osal_char_t *io_log_next_spec(const osal_char_t *fmt, io_log_spec_t *spec, osal_retval_t *ret) {
+    const osal_char_t *p = strchr(fmt, '%');
+    osal_uint32_t length = 0u;      // 1 h, 2 hh, 3 l, 4 ll, 5 L, 6 j, 7 z, 8 t
+
+    if (p != NULL) {
+        spec->begin = p;
+        spec->star_cnt = 0u;
+        spec->type = 0u;
+        p++;
+
+        while ((*p != '\0') && (strchr("-+ #0'", *p) != NULL)) { p++; }
+        if (*p == '*') { spec->star_cnt++; p++; }
+        while ((*p >= '0') && (*p <= '9')) { p++; }
+        if (*p == '.') {
+            p++;
+            if (*p == '*') { spec->star_cnt++; p++; }
+            while ((*p >= '0') && (*p <= '9')) { p++; }
+        }
+
+        if (*p == 'h') { length = 1u; p++; if (*p == 'h') { length = 2u; p++; } }
+        else if (*p == 'l') { length = 3u; p++; if (*p == 'l') { length = 4u; p++; } }
+        else if ((*p == 'L') || (*p == 'q')) { length = (*p == 'L') ? 5u : 4u; p++; }
+        else if (*p == 'j') { length = 6u; p++; }
+        else if (*p == 'z') { length = 7u; p++; }
+        else if (*p == 't') { length = 8u; p++; }
+
+        switch (*p) {
+            case '%':
+                break;
+            case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+                switch (length) {
+                    case 3u: spec->type = IO_LOG_ARG__LONG; break;
+                    case 4u: spec->type = IO_LOG_ARG__LLONG; break;
+                    case 6u: spec->type = IO_LOG_ARG__INTMAX; break;
+                    case 7u: spec->type = IO_LOG_ARG__SIZE; break;
+                    case 8u: spec->type = IO_LOG_ARG__PTRDIFF; break;
+                    case 5u: (*ret) = OSAL_ERR_NOT_IMPLEMENTED; break;
+                    default: spec->type = IO_LOG_ARG__INT; break;
+                }
+                break;
+            case 'c':
+                spec->type = IO_LOG_ARG__INT;
+                if (length != 0u) { (*ret) = OSAL_ERR_NOT_IMPLEMENTED; }
+                break;
+            case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+                spec->type = IO_LOG_ARG__DOUBLE;
+                if (length == 5u) { (*ret) = OSAL_ERR_NOT_IMPLEMENTED; }
+                break;
+            case 'p':
+                spec->type = IO_LOG_ARG__PTR;
+                break;
+            case 's':
+                spec->type = IO_LOG_ARG__STR;
+                if (length != 0u) { (*ret) = OSAL_ERR_NOT_IMPLEMENTED; }
+                break;
+            default:
+                // %n, %m, wide characters, ... need the caller's context
+                (*ret) = OSAL_ERR_NOT_IMPLEMENTED;
+                break;
+        }
+
+        if (*p != '\0') { p++; }
+        spec->len = (osal_size_t)(p - spec->begin);
+    }
+
+    return p;
+}
+
+//! Register format string of a call site in the shm dictionary, identical formats share one id.
+static osal_retval_t io_log_register(osal_io_shm_t *shm, osal_log_site_t *site) {
+    osal_retval_t ret = OSAL_OK;
+    osal_uint32_t arg_cnt = 0u;
+    osal_uint32_t fixed_size = sizeof(osal_io_shm_log_t);
+    const osal_char_t *p = site->fmt;
+    io_log_spec_t spec;
+
+    while ((ret == OSAL_OK) && ((p = io_log_next_spec(p, &spec, &ret)) != NULL)) {
+        if ((arg_cnt + spec.star_cnt + (spec.type != 0u ? 1u : 0u)) > OSAL_LOG_MAX_ARGS) {
+            ret = OSAL_ERR_NOT_IMPLEMENTED;
+        } else if (IO_LOG_SPEC_EXPANDED(&spec) > IO_LOG_SPEC_SIZE) {
+            // reader could not rebuild it without cutting, format on caller
+            ret = OSAL_ERR_NOT_IMPLEMENTED;
+        } else {
+            for (osal_uint32_t i = 0u; i < spec.star_cnt; ++i) {
+                site->arg_types[arg_cnt++] = IO_LOG_ARG__INT;
+            }
+
+            if (spec.type != 0u) {
+                site->arg_types[arg_cnt++] = (osal_uint8_t)spec.type;
+            }
+        }
+    }
+
+    // every string needs at least 8 more bytes for its padded contents
+    for (osal_uint32_t i = 0u; i < arg_cnt; ++i) {
+        fixed_size += site->arg_types[i] == IO_LOG_ARG__STR ? 16u : 8u;
+    }
+
+    if (fixed_size > shm->max_message_size) {
+        ret = OSAL_ERR_NOT_IMPLEMENTED;
+    }
+
+    osal_bool_t found = OSAL_FALSE;
+
+    if (ret == OSAL_OK) {
+        // a restarted writer finds its formats from the last run
+        osal_uint32_t cnt = __atomic_load_n(&shm->fmt_cnt, __ATOMIC_RELAXED);
+        if (cnt > LIBOSAL_IO_SHM_LOG_MAX_FORMATS) {
+            cnt = LIBOSAL_IO_SHM_LOG_MAX_FORMATS;
+        }
+
+        for (osal_uint32_t id = 0u; (id < cnt) && (found == OSAL_FALSE); ++id) {
+            osal_uint32_t off = __atomic_load_n(&shm->fmt_offsets[id], __ATOMIC_ACQUIRE);
+            if ((off != 0u) && (strcmp(&shm->fmt_strings[off - 1u], site->fmt) == 0)) {
+                site->id = id;
+                site->arg_cnt = arg_cnt;
+                found = OSAL_TRUE;
+            }
+        }
+    }
+
+    if ((ret == OSAL_OK) && (found == OSAL_FALSE)) {
+        osal_uint32_t len = (osal_uint32_t)strlen(site->fmt) + 1u;
+        osal_uint32_t id = __atomic_fetch_add(&shm->fmt_cnt, 1u, __ATOMIC_RELAXED);
+        osal_uint32_t off = __atomic_fetch_add(&shm->fmt_used, len, __ATOMIC_RELAXED);
+
+        if ((id >= LIBOSAL_IO_SHM_LOG_MAX_FORMATS) || ((off + len) > LIBOSAL_IO_SHM_LOG_FORMAT_SIZE)) {
+            ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
+        } else {
+            memcpy(&shm->fmt_strings[off], site->fmt, len);
+            __atomic_store_n(&shm->fmt_offsets[id], off + 1u, __ATOMIC_RELEASE);
+
+            site->id = id;
+            site->arg_cnt = arg_cnt;
+        }
+    }
+
+    return ret;
+}
+
+//! Store raw arguments to deferred log record, returns payload length.
+static osal_uint32_t io_log_store_args(const osal_log_site_t *site, osal_io_shm_log_t *log, 
+        osal_size_t max_len, va_list va)
 {
-    osal_retval_t ret = OSAL_ERR_UNAVAILABLE;
+    osal_uint8_t *arg = log->args;
+    osal_uint8_t *end = (osal_uint8_t *)log + max_len;
+    osal_size_t needed = 0u;
+
+    for (osal_uint32_t i = 0u; i < site->arg_cnt; ++i) {
+        needed += site->arg_types[i] == IO_LOG_ARG__STR ? 16u : 8u;
+    }
+
+    for (osal_uint32_t i = 0u; i < site->arg_cnt; ++i) {
+        osal_uint64_t val = 0u;
+        const osal_char_t *str;
+        osal_size_t len;
+        double dbl;
+
+        needed -= site->arg_types[i] == IO_LOG_ARG__STR ? 16u : 8u;
+
+        switch (site->arg_types[i]) {
+            case IO_LOG_ARG__INT:     val = (osal_uint64_t)(osal_int64_t)va_arg(va, int); break;
+            case IO_LOG_ARG__LONG:    val = (osal_uint64_t)(osal_int64_t)va_arg(va, long); break;
+            case IO_LOG_ARG__LLONG:   val = (osal_uint64_t)va_arg(va, long long); break;
+            case IO_LOG_ARG__SIZE:    val = (osal_uint64_t)va_arg(va, size_t); break;
+            case IO_LOG_ARG__PTRDIFF: val = (osal_uint64_t)(osal_int64_t)va_arg(va, ptrdiff_t); break;
+            case IO_LOG_ARG__INTMAX:  val = (osal_uint64_t)va_arg(va, intmax_t); break;
+            case IO_LOG_ARG__PTR:     val = (osal_uint64_t)(uintptr_t)va_arg(va, void *); break;
+            case IO_LOG_ARG__DOUBLE:
+                dbl = va_arg(va, double);
+                memcpy(&val, &dbl, sizeof(val));
+                break;
+            case IO_LOG_ARG__STR:
+                str = va_arg(va, const osal_char_t *);
+                if (str == NULL) { str = "(null)"; }
+
+                // minimum sizes are checked at registration, strings get what is left
+                len = strlen(str);
+                if ((len + 1u) > ((((osal_size_t)(end - arg) - 8u) - needed) & ~(osal_size_t)7u)) {
+                    len = ((((osal_size_t)(end - arg) - 8u) - needed) & ~(osal_size_t)7u) - 1u;
+                }
+
+                val = len + 1u;
+                memcpy(arg + 8u, str, len);
+                arg[8u + len] = 0u;
+                break;
+            default:
+                break;
+        }
+
+        memcpy(arg, &val, sizeof(val));
+        arg += 8u;
+        if (site->arg_types[i] == IO_LOG_ARG__STR) {
+            arg += (val + 7u) & ~(osal_uint64_t)7u;
+        }
+    }
+
+    return (osal_uint32_t)(arg - (osal_uint8_t *)log);
+}
+
+//! Format deferred log record like printf would have done.
+static void io_log_format(osal_io_shm_t *shm, const osal_io_shm_log_t *log, osal_char_t *msg, osal_size_t size) {
+    osal_uint32_t off = 0u;
+    osal_size_t pos = 0u;
+
+    if (log->fmt_id < LIBOSAL_IO_SHM_LOG_MAX_FORMATS) {
+        off = __atomic_load_n(&shm->fmt_offsets[log->fmt_id], __ATOMIC_ACQUIRE);
+    }
+
+    if (off == 0u) {
+        (void)snprintf(msg, size, "<unknown log format %u>\n", log->fmt_id);
+    } else {
+        osal_retval_t ret = OSAL_OK;
+        const osal_char_t *fmt = &shm->fmt_strings[off - 1u];
+        const osal_char_t *p = fmt;
+        const osal_uint8_t *arg = log->args;
+        io_log_spec_t spec;
+
+        msg[0] = '\0';
+
+        while ((pos < size) && ((p = io_log_next_spec(fmt, &spec, &ret)) != NULL)) {
+            osal_char_t spec_buf[IO_LOG_SPEC_SIZE];
+            osal_size_t spec_len = 0u;
+            const osal_char_t *q = spec.begin;
+            osal_uint64_t val = 0u;
+            int len;
+
+            // literal text before specification
+            len = snprintf(&msg[pos], size - pos, "%.*s", (int)(spec.begin - fmt), fmt);
+            pos += (osal_size_t)len < (size - pos) ? (osal_size_t)len : (size - pos);
+
+            if (IO_LOG_SPEC_EXPANDED(&spec) > sizeof(spec_buf)) {
+                // rejected at registration, shm dictionary is corrupt
+                fmt = spec.begin;
+                break;
+            }
+
+            // replace '*' by stored width/precision
+            while (q < p) {
+                if (*q == '*') {
+                    osal_int64_t star;
+                    memcpy(&star, arg, sizeof(star));
+                    arg += 8u;
+
+                    if ((q > spec.begin) && (q[-1] == '.') && (star < 0)) {
+                        spec_len--;     // negative precision is taken as if omitted
+                    } else {
+                        spec_len += (osal_size_t)snprintf(&spec_buf[spec_len], 
+                                sizeof(spec_buf) - spec_len, "%d", (int)star);
+                    }
+                } else {
+                    spec_buf[spec_len++] = *q;
+                }
+                q++;
+            }
+            spec_buf[spec_len] = '\0';
+
+            if (spec.type != 0u) {
+                memcpy(&val, arg, sizeof(val));
+                arg += 8u;
+            }
+
+            if (pos < size) {
+                switch (spec.type) {
+                    case IO_LOG_ARG__INT:     len = snprintf(&msg[pos], size - pos, spec_buf, (int)(osal_int64_t)val); break;
+                    case IO_LOG_ARG__LONG:    len = snprintf(&msg[pos], size - pos, spec_buf, (long)(osal_int64_t)val); break;
+                    case IO_LOG_ARG__LLONG:   len = snprintf(&msg[pos], size - pos, spec_buf, (long long)val); break;
+                    case IO_LOG_ARG__SIZE:    len = snprintf(&msg[pos], size - pos, spec_buf, (size_t)val); break;
+                    case IO_LOG_ARG__PTRDIFF: len = snprintf(&msg[pos], size - pos, spec_buf, (ptrdiff_t)val); break;
+                    case IO_LOG_ARG__INTMAX:  len = snprintf(&msg[pos], size - pos, spec_buf, (intmax_t)val); break;
+                    case IO_LOG_ARG__PTR:     len = snprintf(&msg[pos], size - pos, spec_buf, (void *)(uintptr_t)val); break;
+                    case IO_LOG_ARG__DOUBLE: {
+                        double dbl;
+                        memcpy(&dbl, &val, sizeof(dbl));
+                        len = snprintf(&msg[pos], size - pos, spec_buf, dbl);
+                        break;
+                    }
+                    case IO_LOG_ARG__STR:
+                        len = snprintf(&msg[pos], size - pos, spec_buf, (const osal_char_t *)arg);
+                        arg += (val + 7u) & ~(osal_uint64_t)7u;
+                        break;
+                    default:
+                        len = snprintf(&msg[pos], size - pos, "%%");
+                        break;
+                }
+
+                pos += (osal_size_t)len < (size - pos) ? (osal_size_t)len : (size - pos);
+            }
+
+            fmt = p;
+        }
 
-    if (osal_io_shm_buffer->act_printed == osal_io_shm_buffer->act_written) {
-        if (to != NULL) {
-            (void)osal_semaphore_timedwait(&osal_io_shm_buffer->sem, to);
+        if (pos < size) {
+            (void)snprintf(&msg[pos], size - pos, "%s", fmt);
         }
     }
+}
+
+//! Copy or format oldest committed record, single reader.
+static osal_retval_t io_shm_read(osal_io_shm_t *shm, osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE],
+        osal_uint64_t *timestamp) 
+{
+    osal_retval_t ret = OSAL_ERR_UNAVAILABLE;
+    osal_uint64_t tail = __atomic_load_n(&shm->tail, __ATOMIC_RELAXED);
+    osal_io_shm_rec_t *rec = io_shm_rec(shm, tail);
+
+    if (    (__atomic_load_n(&shm->head, __ATOMIC_RELAXED) != tail) && 
+            (__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) == (tail + 1u))) {
+        osal_uint32_t size = rec->size;
+
+        if (rec->type == IO_SHM_REC__LOG) {
+            const osal_io_shm_log_t *log = (const osal_io_shm_log_t *)rec->msg;
+
+            io_log_format(shm, log, msg, LIBOSAL_IO_SHM_MAX_MSG_SIZE);
+            if (timestamp != NULL) {
+                (*timestamp) = log->time;
+            }
+        } else {
+            osal_uint32_t len = rec->len;
+
+            if (len >= LIBOSAL_IO_SHM_MAX_MSG_SIZE) {
+                len = LIBOSAL_IO_SHM_MAX_MSG_SIZE - 1u;
+            }
+
+            memcpy(msg, rec->msg, len);
+            msg[len] = '\0';
+
+            if (timestamp != NULL) {
+                (*timestamp) = 0u;
+            }
+        }
 
-    if (osal_io_shm_buffer->act_printed != osal_io_shm_buffer->act_written) {
-        osal_io_shm_buffer->act_printed = (osal_io_shm_buffer->act_printed + 1) % osal_io_shm_buffer->max_messages;
-        osal_char_t *tmp = osal_io_shm_buffer->msgs + (osal_io_shm_buffer->act_printed * osal_io_shm_buffer->max_message_size);
-        strncpy(msg, tmp, osal_io_shm_buffer->max_message_size);
+        __atomic_store_n(&rec->seq, 0u, __ATOMIC_RELAXED);
+        __atomic_store_n(&shm->tail, tail + size, __ATOMIC_RELEASE);
         ret = OSAL_OK;
     }
 
     return ret;
 }
 
+// Get next message printed or logged to shm.
+osal_retval_t osal_io_shm_get_record(osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE],
+        osal_uint64_t *timestamp, const osal_timer_t *to)
+{
+    assert(msg != NULL);
+
+    osal_retval_t ret = OSAL_ERR_UNAVAILABLE;
+
+    if (osal_io_shm_buffer != NULL) {
+        osal_retval_t wait_ret = OSAL_OK;
+        ret = io_shm_read(osal_io_shm_buffer, msg, timestamp);
+
+        // semaphore may hold surplus posts, wait until timeout really expired
+        while ((ret != OSAL_OK) && (to != NULL) && (wait_ret == OSAL_OK)) {
+            __atomic_store_n(&osal_io_shm_buffer->reader_waiting, 1u, __ATOMIC_SEQ_CST);
+
+            ret = io_shm_read(osal_io_shm_buffer, msg, timestamp);
+            if (ret != OSAL_OK) {
+                wait_ret = osal_semaphore_timedwait(&osal_io_shm_buffer->sem, to);
+                ret = io_shm_read(osal_io_shm_buffer, msg, timestamp);
+            }
+
+            __atomic_store_n(&osal_io_shm_buffer->reader_waiting, 0u, __ATOMIC_RELAXED);
+        }
+    }
+
+    return ret;
+}
+
+// Get next message printed to shm.
+osal_retval_t osal_io_shm_get_message(osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE],
+        const osal_timer_t *to)
+{
+    return osal_io_shm_get_record(msg, NULL, to);
+}
+
+// Get number of messages dropped because the shm ring was full.
+osal_uint64_t osal_io_shm_get_dropped(void) {
+    osal_uint64_t dropped = 0u;
+
+    if (osal_io_shm_buffer != NULL) {
+        dropped = __atomic_load_n(&osal_io_shm_buffer->dropped, __ATOMIC_RELAXED);
+    }
+
+    return dropped;
+}
+
 osal_retval_t osal_io_shm_setup(const osal_char_t *shm_name, const osal_size_t max_msgs, const osal_size_t max_msg_size) 
 {
     assert(shm_name != NULL);
 
     osal_shm_attr_t shm_attr_msr = OSAL_SHM_ATTR__FLAG__RDWR | OSAL_SHM_ATTR__FLAG__MAP;
     shm_attr_msr |= 0666 << OSAL_SHM_ATTR__MODE__SHIFT;
-    osal_size_t expected_shm_size = sizeof(osal_io_shm) + (max_msg_size * max_msgs);
+    osal_size_t expected_shm_size = sizeof(osal_io_shm_t) + 
+        io_shm_ring_size(max_msgs, max_msg_size) + IO_SHM_REC_SIZE(max_msg_size);
 
     osal_retval_t local_retval = osal_shm_open(&osal_io_shm, shm_name, &shm_attr_msr, expected_shm_size);
         
@@ -117,28 +624,34 @@ osal_retval_t osal_io_shm_setup(const osal_char_t *shm_name, const osal_size_t m
             osal_printf("osal_shm_map(%p, %p) returned error: %d\n", &osal_io_shm, &tmp, local_retval);
         } else {
             osal_printf("osal_io_shm: opened and mapped successfully!\n");
-            osal_io_shm_buffer = (osal_io_shm_t *)tmp;
+            osal_io_shm_t *shm = (osal_io_shm_t *)tmp;
     
-            if (osal_io_shm_buffer->magic == LIBOSAL_IO_SHM_MAGIC) {
+            if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) == LIBOSAL_IO_SHM_MAGIC) {
                 osal_printf("osal_io_shm: found magic, skipping initialization.\n");
-                osal_printf("osal_io_shm: maximum number of messages -> %" PRIu64 "\n", osal_io_shm_buffer->max_messages); 
-                osal_printf("osal_io_shm: maximum length of messages -> %" PRIu64 "\n", osal_io_shm_buffer->max_message_size); 
+                osal_printf("osal_io_shm: maximum number of messages -> %" PRIu64 "\n", shm->max_messages); 
+                osal_printf("osal_io_shm: maximum length of messages -> %" PRIu64 "\n", shm->max_message_size); 
             } else {
-                osal_io_shm_buffer->max_messages = max_msgs;
-                osal_io_shm_buffer->max_message_size = max_msg_size;
-
-                osal_io_shm_buffer->act_printed = 0;
-                osal_io_shm_buffer->act_written = 0;
-
-                osal_mutex_attr_t tmp_mutex_attr = OSAL_MUTEX_ATTR__ROBUST | OSAL_MUTEX_ATTR__PROCESS_SHARED;
-                osal_mutex_init(&osal_io_shm_buffer->mtx, &tmp_mutex_attr);
+                shm->max_messages = max_msgs;
+                shm->max_message_size = max_msg_size;
+                shm->max_record_size = IO_SHM_REC_SIZE(max_msg_size);
+                shm->size = io_shm_ring_size(max_msgs, max_msg_size);
+
+                shm->head = 0u;
+                shm->tail = 0u;
+                shm->dropped = 0u;
+                shm->reader_waiting = 0u;
+                shm->fmt_cnt = 0u;
+                shm->fmt_used = 0u;
+                memset(shm->fmt_offsets, 0, sizeof(shm->fmt_offsets));
+                memset(shm->data, 0, shm->size + shm->max_record_size);
 
                 osal_semaphore_attr_t tmp_semaphore_attr = OSAL_SEMAPHORE_ATTR__PROCESS_SHARED;
-                osal_semaphore_init(&osal_io_shm_buffer->sem, &tmp_semaphore_attr, 0);
+                osal_semaphore_init(&shm->sem, &tmp_semaphore_attr, 0);
 
-                osal_io_shm_buffer->magic = LIBOSAL_IO_SHM_MAGIC;
-                osal_io_shm_buffer->new_msg = 0;
+                __atomic_store_n(&shm->magic, LIBOSAL_IO_SHM_MAGIC, __ATOMIC_RELEASE);
             }
+
+            osal_io_shm_buffer = shm;
         }
     }
 
@@ -154,35 +667,98 @@ osal_retval_t osal_io_shm_setup(const osal_char_t *shm_name, const osal_size_t m
 osal_retval_t osal_printf(const osal_char_t *fmt, ...) {
     assert(fmt != NULL);
 
-    char buf[530];
-
     // cppcheck-suppress misra-c2012-17.1
     va_list va;
     osal_retval_t ret = OSAL_OK;
+    osal_io_shm_t *shm = osal_io_shm_buffer;
 
     // cppcheck-suppress misra-c2012-17.1
     va_start(va, fmt);
 
-    (void)vsnprintf(buf, sizeof(buf), fmt, va);
-    
+    if (shm != NULL) {
+        osal_uint64_t pos = 0u;
+
+        ret = io_shm_reserve(shm, &pos);
+        if (ret == OSAL_OK) {
+            osal_io_shm_rec_t *rec = io_shm_rec(shm, pos);
+            int len = vsnprintf(rec->msg, shm->max_message_size, fmt, va);
+
+            if (len < 0) {
+                len = 0;
+                rec->msg[0] = '\0';
+            } else if ((osal_size_t)len >= shm->max_message_size) {
+                len = (int)shm->max_message_size - 1;
+            }
+
+            io_shm_commit(shm, pos, (osal_uint32_t)len, IO_SHM_REC__TEXT);
+        }
+    } else {
+        char buf[530];
+
+        (void)vsnprintf(buf, sizeof(buf), fmt, va);
+        (void)osal_puts(buf);
+    }
+
     // cppcheck-suppress misra-c2012-17.1
     va_end(va);
 
-    if (osal_io_shm_buffer != NULL) {
-        osal_uint32_t next_write = (osal_io_shm_buffer->act_written + 1) % osal_io_shm_buffer->max_messages;
-        char *tmp = osal_io_shm_buffer->msgs + (next_write * osal_io_shm_buffer->max_message_size);
+    return ret;
+}
 
-        if (next_write == osal_io_shm_buffer->act_printed) {
-            osal_io_shm_buffer->act_printed = (osal_io_shm_buffer->act_printed + 1) % osal_io_shm_buffer->max_messages;
+//! \brief Log without formatting on the caller.
+/*!
+ * \param[in]   site    Call site, see \ref OSAL_LOG.
+ * \param[in]   fmt     Print format, same as site's format.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_log_write(osal_log_site_t *site, const osal_char_t *fmt, ...) {
+    assert(site != NULL);
+    assert(fmt != NULL);
+
+    // cppcheck-suppress misra-c2012-17.1
+    va_list va;
+    osal_retval_t ret = OSAL_OK;
+    osal_io_shm_t *shm = osal_io_shm_buffer;
+    osal_uint32_t state = __atomic_load_n(&site->state, __ATOMIC_ACQUIRE);
+
+    if ((shm != NULL) && (state == IO_LOG_SITE__NEW)) {
+        // first call of this site, only one task registers
+        if (__atomic_compare_exchange_n(&site->state, &state, IO_LOG_SITE__REGISTERING, 0, 
+                    __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            state = io_log_register(shm, site) == OSAL_OK ? IO_LOG_SITE__READY : IO_LOG_SITE__TEXT;
+            __atomic_store_n(&site->state, state, __ATOMIC_RELEASE);
         }
+    }
+
+    // cppcheck-suppress misra-c2012-17.1
+    va_start(va, fmt);
+
+    if ((shm != NULL) && (state == IO_LOG_SITE__READY)) {
+        osal_uint64_t pos = 0u;
 
-        strncpy(tmp, buf, osal_io_shm_buffer->max_message_size);
-        osal_io_shm_buffer->act_written = next_write;
-        osal_semaphore_post(&osal_io_shm_buffer->sem);
+        ret = io_shm_reserve(shm, &pos);
+        if (ret == OSAL_OK) {
+            osal_io_shm_rec_t *rec = io_shm_rec(shm, pos);
+            osal_io_shm_log_t *log = (osal_io_shm_log_t *)rec->msg;
+
+            log->time = osal_timer_gettime_nsec();
+            log->fmt_id = site->id;
+            log->arg_cnt = site->arg_cnt;
+
+            io_shm_commit(shm, pos, io_log_store_args(site, log, shm->max_message_size, va), IO_SHM_REC__LOG);
+        }
     } else {
-        (void)osal_puts(buf);
+        char buf[530];
+
+        // no shm, unsupported format or registration in progress
+        (void)vsnprintf(buf, sizeof(buf), fmt, va);
+        ret = osal_printf("%s", buf);
     }
 
+    // cppcheck-suppress misra-c2012-17.1
+    va_end(va);
+
     return ret;
 }
 
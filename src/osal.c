@@ -33,6 +33,10 @@
 
 #include <libosal/osal.h>
 
+#ifdef LIBOSAL_BUILD_POSIX
+#include "posix/tsc.h"
+#endif
+
 #ifdef LIBOSAL_BUILD_WIN32
 #define ATTR_CONSTRUCTOR_WEAK
 #else
@@ -41,6 +45,9 @@
 
 //! Initialize OSAL internals.
 void ATTR_CONSTRUCTOR_WEAK osal_init(void) {
+#ifdef LIBOSAL_BUILD_POSIX
+    posix_timer_tsc_init();
+#endif
 }
 
 //! Destroy OSAL internals.
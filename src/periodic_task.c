@@ -0,0 +1,246 @@
+/**
+ * \file periodic_task.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL periodic task source.
+ *
+ * OSAL periodic task source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/periodic_task.h>
+#include <assert.h>
+
+#if LIBOSAL_HAVE_STRING_H == 1
+#include <string.h>
+#endif
+
+//! \brief Get first release on the period grid after now.
+static osal_uint64_t periodic_first_release(const osal_periodic_task_attr_t *attr, osal_uint64_t now) {
+    osal_uint64_t next = now - (now % attr->period) + (attr->phase % attr->period);
+
+    while (next <= now) {
+        next += attr->period;
+    }
+
+    return next;
+}
+
+static void periodic_stat_max(osal_uint64_t *stat, osal_uint64_t value) {
+    if (value > __atomic_load_n(stat, __ATOMIC_RELAXED)) {
+        __atomic_store_n(stat, value, __ATOMIC_RELAXED);
+    }
+}
+
+static void periodic_stat_add(osal_uint64_t *stat, osal_uint64_t value) {
+    __atomic_store_n(stat, __atomic_load_n(stat, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+}
+
+//! \brief Sleep until \p release, returns OSAL_TRUE if woken by a stop request.
+static osal_bool_t periodic_wait_release(osal_periodic_task_t *hdl, osal_uint64_t release) {
+    osal_timer_t to;
+    to.sec = release / NSEC_PER_SEC;
+    to.nsec = release % NSEC_PER_SEC;
+
+    // a release in the past returns immediately
+    return osal_binary_semaphore_timedwait(&hdl->stop_sem, &to) == OSAL_OK ? OSAL_TRUE : OSAL_FALSE;
+}
+
+static osal_void_t *periodic_task_loop(osal_void_t *arg) {
+    osal_periodic_task_t *hdl = (osal_periodic_task_t *)arg;
+    const osal_periodic_task_attr_t *attr = &hdl->attr;
+    osal_retval_t ret = OSAL_OK;
+    osal_uint64_t next = periodic_first_release(attr, osal_timer_gettime_nsec());
+
+    while ((ret == OSAL_OK) && (__atomic_load_n(&hdl->stop, __ATOMIC_ACQUIRE) == 0u)) {
+        osal_bool_t stopped;
+
+        if (attr->busy_wait == 0u) {
+            stopped = periodic_wait_release(hdl, next);
+        } else {
+            stopped = periodic_wait_release(hdl, next - attr->busy_wait);
+            if (stopped == OSAL_FALSE) {
+                (void)osal_busy_wait_until_nsec(next);
+            }
+        }
+
+        // stop requested while waiting for the release
+        if ((stopped == OSAL_TRUE) || (__atomic_load_n(&hdl->stop, __ATOMIC_ACQUIRE) != 0u)) {
+            break;
+        }
+
+        osal_uint64_t start = osal_timer_gettime_nsec();
+        osal_uint64_t latency = start - next;
+
+        ret = hdl->handler(hdl->arg);
+
+        osal_uint64_t end = osal_timer_gettime_nsec();
+        osal_uint64_t exec = end - start;
+
+        if (attr->latency_trace != NULL) {
+            osal_trace_time(attr->latency_trace, latency);
+        }
+        if (attr->exec_trace != NULL) {
+            osal_trace_time(attr->exec_trace, exec);
+        }
+
+        periodic_stat_add(&hdl->stats.cycles, 1u);
+        periodic_stat_max(&hdl->stats.max_latency, latency);
+        periodic_stat_max(&hdl->stats.max_exec, exec);
+
+        next += attr->period;
+
+        if ((ret == OSAL_OK) && (end > next)) {
+            // releases next, next + period, ... up to end have already passed
+            osal_uint64_t missed = ((end - next) / attr->period) + 1u;
+
+            periodic_stat_add(&hdl->stats.overruns, 1u);
+
+            if (attr->overrun_policy == OSAL_PERIODIC_TASK_OVERRUN__SIGNAL) {
+                ret = attr->overrun_handler(hdl->arg, missed);
+            }
+
+            if (attr->overrun_policy != OSAL_PERIODIC_TASK_OVERRUN__CATCH_UP) {
+                next += missed * attr->period;
+                periodic_stat_add(&hdl->stats.missed, missed);
+            }
+        }
+    }
+
+    hdl->result = ret;
+    return NULL;
+}
+
+//! \brief Create and start a periodic task.
+/*!
+ * \param[in]   hdl     Pointer to periodic task structure.
+ * \param[in]   attr    Periodic task attributes.
+ * \param[in]   handler Handler to be called every cycle.
+ * \param[in]   arg     Pointer to argument passed to handlers.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_periodic_task_create(osal_periodic_task_t *hdl, const osal_periodic_task_attr_t *attr,
+        osal_periodic_task_handler_t handler, osal_void_t *arg)
+{
+    assert(hdl != NULL);
+    assert(attr != NULL);
+    assert(handler != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    if (    (attr->period == 0u) || (attr->busy_wait >= attr->period) ||
+            (attr->overrun_policy > OSAL_PERIODIC_TASK_OVERRUN__SIGNAL) ||
+            ((attr->overrun_policy == OSAL_PERIODIC_TASK_OVERRUN__SIGNAL) && (attr->overrun_handler == NULL)) ||
+            ((attr->latency_trace != NULL) && (attr->latency_trace->max_producers != 0u)) ||
+            ((attr->exec_trace != NULL) && (attr->exec_trace->max_producers != 0u))) {
+        // the periodic task is not registered to multi producer traces
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        (void)memset(hdl, 0, sizeof(osal_periodic_task_t));
+        hdl->attr       = *attr;
+        hdl->handler    = handler;
+        hdl->arg        = arg;
+        hdl->result     = OSAL_OK;
+
+        if (attr->latency_trace != NULL) {
+            (void)osal_trace_set_histogram_mode(attr->latency_trace, OSAL_TRACE_HISTOGRAM__VALUE);
+        }
+        if (attr->exec_trace != NULL) {
+            (void)osal_trace_set_histogram_mode(attr->exec_trace, OSAL_TRACE_HISTOGRAM__VALUE);
+        }
+
+        ret = osal_binary_semaphore_init(&hdl->stop_sem, NULL);
+    }
+
+    if (ret == OSAL_OK) {
+        // zero policy, priority and affinity keep the defaults
+        ret = osal_task_create(&hdl->task, &hdl->attr.task_attr, periodic_task_loop, hdl);
+        if (ret != OSAL_OK) {
+            (void)osal_binary_semaphore_destroy(&hdl->stop_sem);
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Stop a periodic task and wait for it to end.
+/*!
+ * \param[in]   hdl     Pointer to periodic task structure.
+ *
+ * \return OSAL_OK if the task ended on the stop request, otherwise the value
+ *         returned by the handler or overrun handler that stopped it.
+ */
+osal_retval_t osal_periodic_task_stop(osal_periodic_task_t *hdl) {
+    assert(hdl != NULL);
+
+    __atomic_store_n(&hdl->stop, 1u, __ATOMIC_RELEASE);
+
+    // wakes the task if it sleeps for its next release
+    (void)osal_binary_semaphore_post(&hdl->stop_sem);
+
+    return osal_periodic_task_join(hdl);
+}
+
+//! \brief Wait for a periodic task to end by itself.
+/*!
+ * \param[in]   hdl     Pointer to periodic task structure.
+ *
+ * \return Value returned by the handler or overrun handler that stopped the task.
+ */
+osal_retval_t osal_periodic_task_join(osal_periodic_task_t *hdl) {
+    assert(hdl != NULL);
+
+    osal_retval_t ret = osal_task_join(&hdl->task, NULL);
+
+    if (ret == OSAL_OK) {
+        (void)osal_binary_semaphore_destroy(&hdl->stop_sem);
+        ret = hdl->result;
+    }
+
+    return ret;
+}
+
+//! \brief Get statistics of a periodic task.
+/*!
+ * \param[in]   hdl     Pointer to periodic task structure.
+ * \param[out]  stats   Returns statistics.
+ *
+ * \return N/A
+ */
+void osal_periodic_task_get_stats(osal_periodic_task_t *hdl, osal_periodic_task_stats_t *stats) {
+    assert(hdl != NULL);
+    assert(stats != NULL);
+
+    stats->cycles       = __atomic_load_n(&hdl->stats.cycles, __ATOMIC_RELAXED);
+    stats->overruns     = __atomic_load_n(&hdl->stats.overruns, __ATOMIC_RELAXED);
+    stats->missed       = __atomic_load_n(&hdl->stats.missed, __ATOMIC_RELAXED);
+    stats->max_latency  = __atomic_load_n(&hdl->stats.max_latency, __ATOMIC_RELAXED);
+    stats->max_exec     = __atomic_load_n(&hdl->stats.max_exec, __ATOMIC_RELAXED);
+}
+
@@ -93,17 +93,9 @@ osal_retval_t osal_mutex_init(osal_mutex_t *mtx, const osal_mutex_attr_t *attr)
     return ret;
 }
 
-//! \brief Locks a mutex.
-/*!
- * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
- *
- * \return OK or ERROR_CODE.
- */
-osal_retval_t osal_mutex_lock(osal_mutex_t *mtx) {
-    assert(mtx != NULL);
-
+static osal_retval_t pikeos_mutex_lock(osal_mutex_t *mtx, P4_timeout_t timeout) {
     osal_retval_t ret = OSAL_OK;
-    int local_ret = p4_mutex_lock(&mtx->pikeos_mtx, P4_TIMEOUT_INFINITE);
+    int local_ret = p4_mutex_lock(&mtx->pikeos_mtx, timeout);
     if (local_ret != P4_E_OK) {
         switch (local_ret) {
             case P4_E_STATE:        // if the caller already owns the mutex (recursive 
@@ -147,6 +139,34 @@ osal_retval_t osal_mutex_lock(osal_mutex_t *mtx) {
     return ret;
 }
 
+//! \brief Locks a mutex.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_mutex_lock(osal_mutex_t *mtx) {
+    assert(mtx != NULL);
+
+    return pikeos_mutex_lock(mtx, P4_TIMEOUT_INFINITE);
+}
+
+//! \brief Locks a mutex with timeout.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_mutex_timedlock(osal_mutex_t *mtx, const osal_timer_t *to) {
+    assert(mtx != NULL);
+    assert(to != NULL);
+
+    P4_time_t timeout = to->sec * 1E9 + to->nsec;
+
+    return pikeos_mutex_lock(mtx, P4_TIMEOUT_ABS(timeout));
+}
+
 //! \brief Tries to lock a mutex.
 /*!
  * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
@@ -186,6 +206,22 @@ osal_retval_t osal_mutex_unlock(osal_mutex_t *mtx) {
     return ret;
 }
 
+//! \brief Marks the state of a robust mutex consistent.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_mutex_consistent(osal_mutex_t *mtx) {
+    assert(mtx != NULL);
+
+    // no robust mutexes, never reports a dead owner
+    (void)mtx;
+
+    osal_retval_t ret = OSAL_OK;
+    return ret;
+}
+
 //! \brief Destroys a mutex.
 /*!
  * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
@@ -198,4 +198,20 @@ osal_retval_t osal_shm_close(osal_shm_t *shm) {
     return ret;
 }
 
+//! \brief Remove a shm.
+/*!
+ * \param[in]   name    Shared memory name.
+ * \param[in]   attr    Pointer to the shm attributes the segment was opened
+ *                      with. Can be NULL for a segment without huge pages.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_unlink(const osal_char_t *name, const osal_shm_attr_t *attr) {
+    assert(name != NULL);
+
+    (void)name;
+    (void)attr;
+
+    return OSAL_ERR_NOT_IMPLEMENTED;
+}
 
@@ -35,15 +35,40 @@
 #include <libosal/osal.h>
 #include <libosal/binary_semaphore.h>
 #include <assert.h>
-#include <errno.h>
-#include <time.h>
 
-#define timespec_add(tvp, sec, nsec) { \
-    (tvp)->tv_nsec += (nsec); \
-    (tvp)->tv_sec += (sec); \
-    if ((tvp)->tv_nsec > (long int)1E9) { \
-        (tvp)->tv_nsec -= (long int)1E9; \
-        (tvp)->tv_sec++; } }
+#include "futex.h"
+
+#define POSIX_BINARY_SEMAPHORE_EMPTY     0u  //!< Not posted, nobody waiting.
+#define POSIX_BINARY_SEMAPHORE_POSTED    1u  //!< Posted.
+#define POSIX_BINARY_SEMAPHORE_WAITERS   2u  //!< Not posted, waiters may sleep on futex.
+
+//! Take the semaphore without blocking.
+static osal_bool_t posix_binary_semaphore_take(osal_binary_semaphore_t *sem) {
+    osal_uint32_t expected = POSIX_BINARY_SEMAPHORE_POSTED;
+
+    return __atomic_compare_exchange_n(&sem->value, &expected, POSIX_BINARY_SEMAPHORE_EMPTY, 0, 
+            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ? OSAL_TRUE : OSAL_FALSE;
+}
+
+//! Take the semaphore, sleep on the futex until posted or timeout.
+static osal_retval_t posix_binary_semaphore_wait(osal_binary_semaphore_t *sem, const osal_timer_t *to) {
+    osal_retval_t ret = OSAL_OK;
+
+    if (posix_binary_semaphore_take(sem) == OSAL_FALSE) {
+        // announce a waiter, this also takes a post which came in between. 
+        // the waiter mark may stay without waiters, costing a single wake 
+        // syscall on the next post.
+        while (__atomic_exchange_n(&sem->value, POSIX_BINARY_SEMAPHORE_WAITERS, __ATOMIC_ACQUIRE) != 
+                POSIX_BINARY_SEMAPHORE_POSTED) {
+            ret = posix_futex_wait(&sem->value, POSIX_BINARY_SEMAPHORE_WAITERS, to, sem->shared);
+            if (ret == OSAL_ERR_TIMEOUT) {
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
 
 //! \brief Initialize a binary_semaphore.
 /*!
@@ -57,19 +82,13 @@
 osal_retval_t osal_binary_semaphore_init(osal_binary_semaphore_t *sem, const osal_binary_semaphore_attr_t *attr) {
     assert(sem != NULL);
 
-    (void)attr;
-
-    sem->value = 0;
+    sem->value = POSIX_BINARY_SEMAPHORE_EMPTY;
+    sem->shared = OSAL_FALSE;
 
-    pthread_condattr_t cond_attr;
-    pthread_condattr_init(&cond_attr);
-    pthread_condattr_setclock(&cond_attr, osal_timer_get_clock_source());
+    if ((attr != NULL) && (((*attr) & OSAL_BINARY_SEMAPHORE_ATTR__PROCESS_SHARED) != 0u)) {
+        sem->shared = OSAL_TRUE;
+    }
 
-    pthread_mutexattr_t posix_attr;
-    pthread_mutexattr_init(&posix_attr);
-    pthread_mutexattr_setprotocol(&posix_attr, PTHREAD_PRIO_INHERIT);
-    pthread_mutex_init(&sem->posix_mtx, &posix_attr);
-    pthread_cond_init(&sem->posix_cond, &cond_attr);
     return OSAL_OK;
 }
 
@@ -82,14 +101,11 @@ osal_retval_t osal_binary_semaphore_init(osal_binary_semaphore_t *sem, const osa
 osal_retval_t osal_binary_semaphore_post(osal_binary_semaphore_t *sem) {
     assert(sem != NULL);
 
-    pthread_mutex_lock(&sem->posix_mtx);
-
-    if (sem->value == 0) {
-        sem->value = 1;
-        pthread_cond_signal(&sem->posix_cond);
+    if (__atomic_exchange_n(&sem->value, POSIX_BINARY_SEMAPHORE_POSTED, __ATOMIC_RELEASE) == 
+            POSIX_BINARY_SEMAPHORE_WAITERS) {
+        posix_futex_wake(&sem->value, 1u, sem->shared);
     }
 
-    pthread_mutex_unlock(&sem->posix_mtx);
     return OSAL_OK;
 }
 
@@ -102,16 +118,7 @@ osal_retval_t osal_binary_semaphore_post(osal_binary_semaphore_t *sem) {
 osal_retval_t osal_binary_semaphore_wait(osal_binary_semaphore_t *sem) {
     assert(sem != NULL);
 
-    pthread_mutex_lock(&sem->posix_mtx);
-
-    while (!sem->value) {
-        pthread_cond_wait(&sem->posix_cond, &sem->posix_mtx);
-    }
-
-    sem->value = 0;
-    
-    pthread_mutex_unlock(&sem->posix_mtx);
-    return OSAL_OK;
+    return posix_binary_semaphore_wait(sem, NULL);
 }
 
 //! \brief Wait for a binary_semaphore.
@@ -125,15 +132,9 @@ osal_retval_t osal_binary_semaphore_trywait(osal_binary_semaphore_t *sem) {
 
     osal_retval_t ret = OSAL_OK;
 
-    pthread_mutex_lock(&sem->posix_mtx);
-
-    if (sem->value == 0) {
+    if (posix_binary_semaphore_take(sem) == OSAL_FALSE) {
         ret = OSAL_ERR_BUSY;
-    } else {
-        sem->value = 0;
     }
-
-    pthread_mutex_unlock(&sem->posix_mtx);
     
     return ret;
 }
@@ -151,26 +152,9 @@ osal_retval_t osal_binary_semaphore_timedwait(osal_binary_semaphore_t *sem, cons
     osal_retval_t ret = OSAL_OK;
 
     if (to != NULL) {
-        struct timespec ts;
-        ts.tv_sec = to->sec;
-        ts.tv_nsec = to->nsec;
-
-        pthread_mutex_lock(&sem->posix_mtx);
-        while (!sem->value) {
-            int local_ret = pthread_cond_timedwait(&sem->posix_cond, &sem->posix_mtx, &ts);
-            if (local_ret == ETIMEDOUT) {
-                ret = OSAL_ERR_TIMEOUT;
-                break;
-            }
-        }
-
-        if (ret == OSAL_OK) {        
-            sem->value = 0;
-        }
-
-        pthread_mutex_unlock(&sem->posix_mtx);
+        ret = posix_binary_semaphore_wait(sem, to);
     } else {
-        if (sem->value == 0) {
+        if (posix_binary_semaphore_take(sem) == OSAL_FALSE) {
             ret = OSAL_ERR_TIMEOUT;
         }
     }
@@ -187,9 +171,6 @@ osal_retval_t osal_binary_semaphore_timedwait(osal_binary_semaphore_t *sem, cons
 osal_retval_t osal_binary_semaphore_destroy(osal_binary_semaphore_t *sem) {
     assert(sem != NULL);
 
-    pthread_mutex_destroy(&sem->posix_mtx);
-    pthread_cond_destroy(&sem->posix_cond);
-
+    // nothing allocated
     return OSAL_OK;
 }
-
@@ -0,0 +1,634 @@
+/**
+ * \file posix/cpu_topology.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL cpu topology posix source.
+ *
+ * OSAL cpu topology discovery from linux sysfs.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/cpu_topology.h>
+#include <assert.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POSIX_CPU_TOPOLOGY_ROOT         "/sys/devices/system"
+#define POSIX_CPU_TOPOLOGY_PATH_LEN     512u
+
+//! Longest sysfs line we read, a cpu list of 4096 CPUs without ranges still fits.
+#define POSIX_CPU_TOPOLOGY_LINE_LEN     (OSAL_CPUSET_SIZE * 5u)
+
+//! \brief Read the first line of a sysfs file below root, returns OSAL_FALSE if it does not exist.
+static osal_bool_t posix_cpu_topology_read(const osal_char_t *root, osal_char_t *buf, osal_size_t size,
+        const osal_char_t *fmt, ...)
+{
+    osal_bool_t ret = OSAL_FALSE;
+    osal_char_t path[POSIX_CPU_TOPOLOGY_PATH_LEN];
+    osal_char_t file[POSIX_CPU_TOPOLOGY_PATH_LEN];
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = vsnprintf(file, sizeof(file), fmt, ap);
+    va_end(ap);
+
+    if ((len > 0) && ((osal_size_t)len < sizeof(file))) {
+        len = snprintf(path, sizeof(path), "%s/%s", root, file);
+    }
+
+    if ((len > 0) && ((osal_size_t)len < sizeof(path))) {
+        FILE *fp = fopen(path, "r");
+
+        if (fp != NULL) {
+            if (fgets(buf, (int)size, fp) != NULL) {
+                buf[strcspn(buf, "\n")] = '\0';
+                ret = OSAL_TRUE;
+            }
+            (void)fclose(fp);
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Read a sysfs cpu list, a missing file gives an empty set.
+static osal_retval_t posix_cpu_topology_read_list(const osal_char_t *root, osal_char_t *buf, osal_size_t size,
+        osal_cpuset_t *set, const osal_char_t *file)
+{
+    osal_retval_t ret = OSAL_OK;
+
+    osal_cpuset_zero(set);
+    if (posix_cpu_topology_read(root, buf, size, "%s", file) == OSAL_TRUE) {
+        ret = osal_cpuset_parse(set, buf);
+    }
+
+    return ret;
+}
+
+//! \brief Read an optional sysfs cpu list, unset lists like "(null)" give an empty set.
+static void posix_cpu_topology_read_optional_list(const osal_char_t *root, osal_char_t *buf, osal_size_t size,
+        osal_cpuset_t *set, const osal_char_t *file)
+{
+    if (posix_cpu_topology_read_list(root, buf, size, set, file) != OSAL_OK) {
+        osal_cpuset_zero(set);
+    }
+}
+
+//! \brief Parse a sysfs cache size like "48K".
+static osal_uint64_t posix_cpu_topology_parse_size(const osal_char_t *str) {
+    osal_char_t *end = NULL;
+    osal_uint64_t size = strtoull(str, &end, 10);
+
+    if (end != NULL) {
+        if (*end == 'K') {
+            size *= 1024u;
+        } else if (*end == 'M') {
+            size *= 1024u * 1024u;
+        } else if (*end == 'G') {
+            size *= 1024u * 1024u * 1024u;
+        }
+    }
+
+    return size;
+}
+
+static osal_retval_t posix_cpu_topology_read_caches(const osal_char_t *root, osal_char_t *buf, osal_size_t size,
+        osal_uint32_t cpu, osal_cpu_topology_cpu_t *entry)
+{
+    osal_retval_t ret = OSAL_OK;
+    osal_bool_t more = OSAL_TRUE;
+
+    for (osal_uint32_t idx = 0u; (idx < OSAL_CPU_TOPOLOGY_CACHES_MAX) && (ret == OSAL_OK) && (more == OSAL_TRUE); ++idx) {
+        osal_cpu_topology_cache_t *cache = &entry->caches[entry->cache_cnt];
+        osal_cpuset_t shared;
+
+        // cache indices are contiguous
+        more = posix_cpu_topology_read(root, buf, size, "cpu/cpu%u/cache/index%u/level", cpu, idx);
+        if (more == OSAL_TRUE) {
+            cache->level = (osal_uint32_t)strtoul(buf, NULL, 10);
+
+            cache->type = OSAL_CPU_TOPOLOGY_CACHE_UNIFIED;
+            if (posix_cpu_topology_read(root, buf, size, "cpu/cpu%u/cache/index%u/type", cpu, idx) == OSAL_TRUE) {
+                if (strcmp(buf, "Data") == 0) {
+                    cache->type = OSAL_CPU_TOPOLOGY_CACHE_DATA;
+                } else if (strcmp(buf, "Instruction") == 0) {
+                    cache->type = OSAL_CPU_TOPOLOGY_CACHE_INSTRUCTION;
+                }
+            }
+
+            cache->size = 0u;
+            if (posix_cpu_topology_read(root, buf, size, "cpu/cpu%u/cache/index%u/size", cpu, idx) == OSAL_TRUE) {
+                cache->size = posix_cpu_topology_parse_size(buf);
+            }
+
+            cache->line_size = 0u;
+            if (posix_cpu_topology_read(root, buf, size, "cpu/cpu%u/cache/index%u/coherency_line_size", cpu, idx) == OSAL_TRUE) {
+                cache->line_size = (osal_uint32_t)strtoul(buf, NULL, 10);
+            }
+
+            // without sharing information the cache is private
+            cache->first_cpu = cpu;
+            if (posix_cpu_topology_read(root, buf, size, "cpu/cpu%u/cache/index%u/shared_cpu_list", cpu, idx) == OSAL_TRUE) {
+                ret = osal_cpuset_parse(&shared, buf);
+                if ((ret == OSAL_OK) && (osal_cpuset_count(&shared) > 0u)) {
+                    cache->first_cpu = osal_cpuset_next(&shared, 0u);
+                }
+            }
+
+            entry->cache_cnt++;
+        }
+    }
+
+    return ret;
+}
+
+static osal_retval_t posix_cpu_topology_read_cpu(const osal_char_t *root, osal_char_t *buf, osal_size_t size,
+        osal_uint32_t cpu, osal_cpu_topology_cpu_t *entry)
+{
+    osal_retval_t ret = OSAL_OK;
+    osal_cpuset_t siblings;
+
+    entry->package = 0;
+    if (posix_cpu_topology_read(root, buf, size, "cpu/cpu%u/topology/physical_package_id", cpu) == OSAL_TRUE) {
+        entry->package = (osal_int32_t)strtol(buf, NULL, 10);
+        if (entry->package < 0) {
+            entry->package = 0;
+        }
+    }
+
+    entry->core = (osal_int32_t)cpu;
+    if (posix_cpu_topology_read(root, buf, size, "cpu/cpu%u/topology/core_id", cpu) == OSAL_TRUE) {
+        entry->core = (osal_int32_t)strtol(buf, NULL, 10);
+    }
+
+    entry->core_first_cpu = cpu;
+    if (posix_cpu_topology_read(root, buf, size, "cpu/cpu%u/topology/thread_siblings_list", cpu) == OSAL_TRUE) {
+        ret = osal_cpuset_parse(&siblings, buf);
+        if ((ret == OSAL_OK) && (osal_cpuset_count(&siblings) > 0u)) {
+            entry->core_first_cpu = osal_cpuset_next(&siblings, 0u);
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        ret = posix_cpu_topology_read_caches(root, buf, size, cpu, entry);
+    }
+
+    return ret;
+}
+
+static osal_retval_t posix_cpu_topology_read_nodes(const osal_char_t *root, osal_char_t *buf, osal_size_t size,
+        osal_cpu_topology_t *topo)
+{
+    osal_retval_t ret = OSAL_OK;
+    osal_cpuset_t nodes;
+    osal_cpuset_t cpus;
+
+    // node ids use the same list format as cpus
+    ret = posix_cpu_topology_read_list(root, buf, size, &nodes, "node/online");
+
+    for (osal_uint32_t node = osal_cpuset_next(&nodes, 0u); (node < OSAL_CPUSET_SIZE) && (ret == OSAL_OK);
+            node = osal_cpuset_next(&nodes, node + 1u)) {
+        osal_cpuset_zero(&cpus);
+        if (posix_cpu_topology_read(root, buf, size, "node/node%u/cpulist", node) == OSAL_TRUE) {
+            ret = osal_cpuset_parse(&cpus, buf);
+        }
+
+        for (osal_uint32_t cpu = osal_cpuset_next(&cpus, 0u); (cpu < topo->cpu_cnt) && (ret == OSAL_OK);
+                cpu = osal_cpuset_next(&cpus, cpu + 1u)) {
+            topo->cpus[cpu].node = (osal_int32_t)node;
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Count packages, cores and nodes with online CPUs.
+static void posix_cpu_topology_count(osal_cpu_topology_t *topo) {
+    osal_cpuset_t packages;
+    osal_cpuset_t nodes;
+
+    osal_cpuset_zero(&packages);
+    osal_cpuset_zero(&nodes);
+    topo->core_cnt = 0u;
+
+    for (osal_uint32_t cpu = osal_cpuset_next(&topo->online, 0u); cpu < topo->cpu_cnt;
+            cpu = osal_cpuset_next(&topo->online, cpu + 1u)) {
+        const osal_cpu_topology_cpu_t *entry = &topo->cpus[cpu];
+
+        (void)osal_cpuset_set(&packages, (osal_uint32_t)entry->package);
+        if (entry->node >= 0) {
+            (void)osal_cpuset_set(&nodes, (osal_uint32_t)entry->node);
+        }
+        if (entry->core_first_cpu == cpu) {
+            topo->core_cnt++;
+        }
+    }
+
+    topo->package_cnt = osal_cpuset_count(&packages);
+    topo->node_cnt = osal_cpuset_count(&nodes);
+}
+
+static osal_bool_t posix_cpu_topology_is_online(const osal_cpu_topology_t *topo, osal_uint32_t cpu) {
+    return ((cpu < topo->cpu_cnt) && (topo->cpus[cpu].package >= 0)) ? OSAL_TRUE : OSAL_FALSE;
+}
+
+//! \brief Find the data or unified cache of a level.
+static const osal_cpu_topology_cache_t *posix_cpu_topology_find_cache(const osal_cpu_topology_cpu_t *entry,
+        osal_uint32_t level)
+{
+    const osal_cpu_topology_cache_t *ret = NULL;
+
+    for (osal_uint32_t i = 0u; (i < entry->cache_cnt) && (ret == NULL); ++i) {
+        if ((entry->caches[i].level == level) && (entry->caches[i].type != OSAL_CPU_TOPOLOGY_CACHE_INSTRUCTION)) {
+            ret = &entry->caches[i];
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Read the CPU topology.
+/*!
+ * \param[out]  topo    Pointer to osal cpu topology structure.
+ * \param[in]   root    sysfs system directory, NULL for /sys/devices/system.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpu_topology_init(osal_cpu_topology_t *topo, const osal_char_t *root) {
+    assert(topo != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_cpuset_t possible;
+    osal_char_t *buf;
+
+    (void)memset(topo, 0, sizeof(*topo));
+
+    if (root == NULL) {
+        root = POSIX_CPU_TOPOLOGY_ROOT;
+    }
+
+    buf = malloc(POSIX_CPU_TOPOLOGY_LINE_LEN);
+    if (buf == NULL) {
+        ret = OSAL_ERR_OUT_OF_MEMORY;
+    }
+
+    if (ret == OSAL_OK) {
+        if (posix_cpu_topology_read_list(root, buf, POSIX_CPU_TOPOLOGY_LINE_LEN, &topo->online, "cpu/online") != OSAL_OK) {
+            ret = OSAL_ERR_OPERATION_FAILED;
+        } else if (osal_cpuset_count(&topo->online) == 0u) {
+            ret = OSAL_ERR_UNAVAILABLE;
+        } else if (posix_cpu_topology_read_list(root, buf, POSIX_CPU_TOPOLOGY_LINE_LEN, &possible, "cpu/possible") != OSAL_OK) {
+            ret = OSAL_ERR_OPERATION_FAILED;
+        } else {
+            osal_cpuset_or(&possible, &possible, &topo->online);
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        for (osal_uint32_t cpu = osal_cpuset_next(&possible, 0u); cpu < OSAL_CPUSET_SIZE;
+                cpu = osal_cpuset_next(&possible, cpu + 1u)) {
+            topo->cpu_cnt = cpu + 1u;
+        }
+
+        topo->cpus = calloc(topo->cpu_cnt, sizeof(osal_cpu_topology_cpu_t));
+        if (topo->cpus == NULL) {
+            ret = OSAL_ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        for (osal_uint32_t cpu = 0u; cpu < topo->cpu_cnt; ++cpu) {
+            topo->cpus[cpu].package = -1;
+            topo->cpus[cpu].core = -1;
+            topo->cpus[cpu].core_first_cpu = cpu;
+            topo->cpus[cpu].node = -1;
+        }
+
+        for (osal_uint32_t cpu = osal_cpuset_next(&topo->online, 0u); (cpu < topo->cpu_cnt) && (ret == OSAL_OK);
+                cpu = osal_cpuset_next(&topo->online, cpu + 1u)) {
+            ret = posix_cpu_topology_read_cpu(root, buf, POSIX_CPU_TOPOLOGY_LINE_LEN, cpu, &topo->cpus[cpu]);
+        }
+
+        if (ret == OSAL_OK) {
+            ret = posix_cpu_topology_read_nodes(root, buf, POSIX_CPU_TOPOLOGY_LINE_LEN, topo);
+        }
+
+        if (ret == OSAL_OK) {
+            posix_cpu_topology_read_optional_list(root, buf, POSIX_CPU_TOPOLOGY_LINE_LEN, &topo->isolated, "cpu/isolated");
+            posix_cpu_topology_read_optional_list(root, buf, POSIX_CPU_TOPOLOGY_LINE_LEN, &topo->nohz_full, "cpu/nohz_full");
+            posix_cpu_topology_count(topo);
+        } else {
+            // parse errors of the files above
+            ret = OSAL_ERR_OPERATION_FAILED;
+        }
+    }
+
+    free(buf);
+
+    if ((ret != OSAL_OK) && (topo->cpus != NULL)) {
+        free(topo->cpus);
+        topo->cpus = NULL;
+    }
+
+    return ret;
+}
+
+//! \brief Free the CPU topology.
+/*!
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpu_topology_destroy(osal_cpu_topology_t *topo) {
+    assert(topo != NULL);
+
+    free(topo->cpus);
+    topo->cpus = NULL;
+    topo->cpu_cnt = 0u;
+
+    return OSAL_OK;
+}
+
+//! \brief Get the SMT siblings of a CPU.
+/*!
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ * \param[in]   cpu     CPU number.
+ * \param[out]  cpus    CPUs of the core, including \p cpu.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpu_topology_get_core_cpus(const osal_cpu_topology_t *topo, osal_uint32_t cpu, osal_cpuset_t *cpus) {
+    assert(topo != NULL);
+    assert(cpus != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    osal_cpuset_zero(cpus);
+
+    if (posix_cpu_topology_is_online(topo, cpu) == OSAL_FALSE) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        for (osal_uint32_t i = osal_cpuset_next(&topo->online, 0u); i < topo->cpu_cnt;
+                i = osal_cpuset_next(&topo->online, i + 1u)) {
+            if (topo->cpus[i].core_first_cpu == topo->cpus[cpu].core_first_cpu) {
+                (void)osal_cpuset_set(cpus, i);
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Get the CPUs in the package of a CPU.
+/*!
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ * \param[in]   cpu     CPU number.
+ * \param[out]  cpus    Online CPUs of the package, including \p cpu.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpu_topology_get_package_cpus(const osal_cpu_topology_t *topo, osal_uint32_t cpu, osal_cpuset_t *cpus) {
+    assert(topo != NULL);
+    assert(cpus != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    osal_cpuset_zero(cpus);
+
+    if (posix_cpu_topology_is_online(topo, cpu) == OSAL_FALSE) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        for (osal_uint32_t i = osal_cpuset_next(&topo->online, 0u); i < topo->cpu_cnt;
+                i = osal_cpuset_next(&topo->online, i + 1u)) {
+            if (topo->cpus[i].package == topo->cpus[cpu].package) {
+                (void)osal_cpuset_set(cpus, i);
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Get the CPUs of a NUMA node.
+/*!
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ * \param[in]   node    NUMA node.
+ * \param[out]  cpus    Online CPUs of the node.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpu_topology_get_node_cpus(const osal_cpu_topology_t *topo, osal_int32_t node, osal_cpuset_t *cpus) {
+    assert(topo != NULL);
+    assert(cpus != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    osal_cpuset_zero(cpus);
+
+    for (osal_uint32_t i = osal_cpuset_next(&topo->online, 0u); i < topo->cpu_cnt;
+            i = osal_cpuset_next(&topo->online, i + 1u)) {
+        if (topo->cpus[i].node == node) {
+            (void)osal_cpuset_set(cpus, i);
+        }
+    }
+
+    if (osal_cpuset_count(cpus) == 0u) {
+        ret = OSAL_ERR_NOT_FOUND;
+    }
+
+    return ret;
+}
+
+//! \brief Get a cache of a CPU and the CPUs sharing it.
+/*!
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ * \param[in]   cpu     CPU number.
+ * \param[in]   level   Cache level, 1 for L1.
+ * \param[out]  cache   Cache description. Can be NULL.
+ * \param[out]  cpus    CPUs sharing the cache, including \p cpu. Can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpu_topology_get_cache(const osal_cpu_topology_t *topo, osal_uint32_t cpu, osal_uint32_t level,
+        osal_cpu_topology_cache_t *cache, osal_cpuset_t *cpus)
+{
+    assert(topo != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    const osal_cpu_topology_cache_t *found = NULL;
+
+    if (cpus != NULL) {
+        osal_cpuset_zero(cpus);
+    }
+
+    if (posix_cpu_topology_is_online(topo, cpu) == OSAL_FALSE) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        found = posix_cpu_topology_find_cache(&topo->cpus[cpu], level);
+        if (found == NULL) {
+            ret = OSAL_ERR_NOT_FOUND;
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        if (cache != NULL) {
+            *cache = *found;
+        }
+
+        if (cpus != NULL) {
+            for (osal_uint32_t i = osal_cpuset_next(&topo->online, 0u); i < topo->cpu_cnt;
+                    i = osal_cpuset_next(&topo->online, i + 1u)) {
+                const osal_cpu_topology_cache_t *other = posix_cpu_topology_find_cache(&topo->cpus[i], level);
+
+                if ((other != NULL) && (other->first_cpu == found->first_cpu)) {
+                    (void)osal_cpuset_set(cpus, i);
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Pick a CPU for a task.
+/*!
+ * \param[in]   topo    Pointer to osal cpu topology structure.
+ * \param[in]   pick    Placement request.
+ * \param[out]  cpu     Picked CPU.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpu_topology_pick(const osal_cpu_topology_t *topo, const osal_cpu_topology_pick_t *pick,
+        osal_uint32_t *cpu)
+{
+    assert(topo != NULL);
+    assert(pick != NULL);
+    assert(cpu != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_cpuset_t candidates;
+    osal_cpuset_t used = pick->exclude;
+    osal_cpuset_t tmp;
+    osal_bool_t use_near = ((pick->cache_level != 0u) ||
+            ((pick->flags & (OSAL_CPU_TOPOLOGY_PICK_SAME_NODE | OSAL_CPU_TOPOLOGY_PICK_SAME_PACKAGE)) != 0u)) ?
+        OSAL_TRUE : OSAL_FALSE;
+
+    candidates = topo->online;
+
+    if ((pick->flags & OSAL_CPU_TOPOLOGY_PICK_ISOLATED) != 0u) {
+        osal_cpuset_and(&candidates, &candidates, &topo->isolated);
+    }
+
+    if ((pick->flags & OSAL_CPU_TOPOLOGY_PICK_NOHZ_FULL) != 0u) {
+        osal_cpuset_and(&candidates, &candidates, &topo->nohz_full);
+    }
+
+    if (use_near == OSAL_TRUE) {
+        if (posix_cpu_topology_is_online(topo, pick->near_cpu) == OSAL_FALSE) {
+            ret = OSAL_ERR_INVALID_PARAM;
+        } else {
+            (void)osal_cpuset_set(&used, pick->near_cpu);
+        }
+    }
+
+    if ((ret == OSAL_OK) && (pick->cache_level != 0u)) {
+        ret = osal_cpu_topology_get_cache(topo, pick->near_cpu, pick->cache_level, NULL, &tmp);
+        osal_cpuset_and(&candidates, &candidates, &tmp);
+    }
+
+    if ((ret == OSAL_OK) && ((pick->flags & OSAL_CPU_TOPOLOGY_PICK_SAME_NODE) != 0u)) {
+        (void)osal_cpu_topology_get_node_cpus(topo, topo->cpus[pick->near_cpu].node, &tmp);
+        osal_cpuset_and(&candidates, &candidates, &tmp);
+    }
+
+    if ((ret == OSAL_OK) && ((pick->flags & OSAL_CPU_TOPOLOGY_PICK_SAME_PACKAGE) != 0u)) {
+        ret = osal_cpu_topology_get_package_cpus(topo, pick->near_cpu, &tmp);
+        osal_cpuset_and(&candidates, &candidates, &tmp);
+    }
+
+    if (ret == OSAL_OK) {
+        ret = OSAL_ERR_NOT_FOUND;
+
+        for (osal_uint32_t i = osal_cpuset_next(&candidates, 0u); (i < topo->cpu_cnt) && (ret != OSAL_OK);
+                i = osal_cpuset_next(&candidates, i + 1u)) {
+            osal_bool_t free_core = OSAL_TRUE;
+
+            if ((pick->flags & OSAL_CPU_TOPOLOGY_PICK_WHOLE_CORE) != 0u) {
+                (void)osal_cpu_topology_get_core_cpus(topo, i, &tmp);
+                osal_cpuset_and(&tmp, &tmp, &used);
+                free_core = osal_cpuset_count(&tmp) == 0u ? OSAL_TRUE : OSAL_FALSE;
+            }
+
+            if ((osal_cpuset_isset(&used, i) == OSAL_FALSE) && (free_core == OSAL_TRUE)) {
+                *cpu = i;
+                ret = OSAL_OK;
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Place a task on a CPU.
+/*!
+ * \param[in]       topo    Pointer to osal cpu topology structure.
+ * \param[in]       cpu     CPU number, e.g. from \ref osal_cpu_topology_pick.
+ * \param[in,out]   attr    Task attributes to pass to \ref osal_task_create.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_cpu_topology_place_task(const osal_cpu_topology_t *topo, osal_uint32_t cpu, osal_task_attr_t *attr) {
+    assert(topo != NULL);
+    assert(attr != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    if (posix_cpu_topology_is_online(topo, cpu) == OSAL_FALSE) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        osal_int32_t node = topo->cpus[cpu].node;
+
+        attr->affinity = 0u;
+        osal_cpuset_zero(&attr->cpuset);
+        (void)osal_cpuset_set(&attr->cpuset, cpu);
+
+        attr->numa_nodes = 0u;
+        if ((node >= 0) && ((osal_uint32_t)node < OSAL_TASK_NUMA_NODES_MAX)) {
+            attr->numa_nodes = (osal_uint64_t)1u << (osal_uint32_t)node;
+        }
+
+        attr->flags |= OSAL_TASK_ATTR__CPUSET | OSAL_TASK_ATTR__NUMA_NODES;
+    }
+
+    return ret;
+}
+
@@ -0,0 +1,223 @@
+/**
+ * \file posix/eventflags.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL event flags posix source.
+ *
+ * OSAL event flags posix source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/eventflags.h>
+#include <assert.h>
+
+#include "futex.h"
+
+static osal_bool_t posix_eventflags_match(osal_uint32_t value, osal_uint32_t mask, osal_uint32_t options) {
+    osal_bool_t ret = OSAL_FALSE;
+
+    if ((options & OSAL_EVENTFLAGS_WAIT__ALL) != 0u) {
+        ret = (value & mask) == mask ? OSAL_TRUE : OSAL_FALSE;
+    } else {
+        ret = (value & mask) != 0u ? OSAL_TRUE : OSAL_FALSE;
+    }
+
+    return ret;
+}
+
+static osal_retval_t posix_eventflags_wait(osal_eventflags_t *ef, osal_uint32_t mask, osal_uint32_t options,
+        osal_uint32_t *flags, const osal_timer_t *to)
+{
+    osal_retval_t ret = OSAL_OK;
+    osal_bool_t waiting = OSAL_FALSE;
+    osal_bool_t done = OSAL_FALSE;
+    osal_uint32_t value = __atomic_load_n(&ef->flags, __ATOMIC_ACQUIRE);
+
+    if (mask == 0u) {
+        ret = OSAL_ERR_INVALID_PARAM;
+        done = OSAL_TRUE;
+    }
+
+    while (done == OSAL_FALSE) {
+        while ((ret == OSAL_OK) && (posix_eventflags_match(value, mask, options) == OSAL_FALSE)) {
+            if (waiting == OSAL_FALSE) {
+                // setters only wake if they see a waiter, check again after announcing
+                (void)__atomic_fetch_add(&ef->waiters, 1u, __ATOMIC_SEQ_CST);
+                waiting = OSAL_TRUE;
+            } else {
+                // only woken by setters of flags in our mask
+                ret = posix_futex_wait_bitset(&ef->flags, value, to, ef->shared, mask);
+            }
+
+            value = __atomic_load_n(&ef->flags, __ATOMIC_SEQ_CST);
+            if ((ret == OSAL_ERR_TIMEOUT) && (posix_eventflags_match(value, mask, options) == OSAL_TRUE)) {
+                ret = OSAL_OK;
+            }
+        }
+
+        if ((ret == OSAL_OK) && ((options & OSAL_EVENTFLAGS_WAIT__CLEAR) != 0u)) {
+            // consume atomically, retry if flags changed meanwhile
+            if (__atomic_compare_exchange_n(&ef->flags, &value, value & ~mask, 0,
+                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+                done = OSAL_TRUE;
+            }
+        } else {
+            done = OSAL_TRUE;
+        }
+    }
+
+    if (waiting == OSAL_TRUE) {
+        (void)__atomic_fetch_sub(&ef->waiters, 1u, __ATOMIC_RELAXED);
+    }
+
+    if ((ret == OSAL_OK) && (flags != NULL)) {
+        *flags = value;
+    }
+
+    return ret;
+}
+
+//! \brief Initialize event flags.
+/*!
+ * \param[in]   ef      Pointer to osal event flags structure.
+ * \param[in]   attr    Pointer to event flags attributes. Can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_eventflags_init(osal_eventflags_t *ef, const osal_eventflags_attr_t *attr) {
+    assert(ef != NULL);
+
+    ef->flags = 0u;
+    ef->waiters = 0u;
+    ef->shared = OSAL_FALSE;
+
+    if ((attr != NULL) && (((*attr) & OSAL_EVENTFLAGS_ATTR__PROCESS_SHARED) != 0u)) {
+        ef->shared = OSAL_TRUE;
+    }
+
+    return OSAL_OK;
+}
+
+//! \brief Set event flags.
+/*!
+ * \param[in]   ef      Pointer to osal event flags structure.
+ * \param[in]   flags   Flags to set.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_eventflags_set(osal_eventflags_t *ef, osal_uint32_t flags) {
+    assert(ef != NULL);
+
+    osal_uint32_t old = __atomic_fetch_or(&ef->flags, flags, __ATOMIC_SEQ_CST);
+    osal_uint32_t new_flags = flags & ~old;
+
+    if ((new_flags != 0u) && (__atomic_load_n(&ef->waiters, __ATOMIC_SEQ_CST) != 0u)) {
+        posix_futex_wake_bitset(&ef->flags, 0x7FFFFFFFu, ef->shared, new_flags);
+    }
+
+    return OSAL_OK;
+}
+
+//! \brief Clear event flags.
+/*!
+ * \param[in]   ef      Pointer to osal event flags structure.
+ * \param[in]   flags   Flags to clear.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_eventflags_clear(osal_eventflags_t *ef, osal_uint32_t flags) {
+    assert(ef != NULL);
+
+    (void)__atomic_fetch_and(&ef->flags, ~flags, __ATOMIC_RELEASE);
+
+    return OSAL_OK;
+}
+
+//! \brief Get the current event flags.
+/*!
+ * \param[in]   ef      Pointer to osal event flags structure.
+ *
+ * \return Current flag word.
+ */
+osal_uint32_t osal_eventflags_get(osal_eventflags_t *ef) {
+    assert(ef != NULL);
+
+    return __atomic_load_n(&ef->flags, __ATOMIC_ACQUIRE);
+}
+
+//! \brief Wait for event flags.
+/*!
+ * \param[in]   ef      Pointer to osal event flags structure.
+ * \param[in]   mask    Flags to wait for, must not be 0.
+ * \param[in]   options OSAL_EVENTFLAGS_WAIT__* options.
+ * \param[out]  flags   Returns the flag word which satisfied the wait,
+ *                      before clearing. Can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_eventflags_wait(osal_eventflags_t *ef, osal_uint32_t mask, osal_uint32_t options,
+        osal_uint32_t *flags)
+{
+    assert(ef != NULL);
+
+    return posix_eventflags_wait(ef, mask, options, flags, NULL);
+}
+
+//! \brief Wait for event flags with timeout.
+/*!
+ * \param[in]   ef      Pointer to osal event flags structure.
+ * \param[in]   mask    Flags to wait for, must not be 0.
+ * \param[in]   options OSAL_EVENTFLAGS_WAIT__* options.
+ * \param[out]  flags   Returns the flag word which satisfied the wait,
+ *                      before clearing. Can be NULL.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_eventflags_timedwait(osal_eventflags_t *ef, osal_uint32_t mask, osal_uint32_t options,
+        osal_uint32_t *flags, const osal_timer_t *to)
+{
+    assert(ef != NULL);
+    assert(to != NULL);
+
+    return posix_eventflags_wait(ef, mask, options, flags, to);
+}
+
+//! \brief Destroys event flags.
+/*!
+ * \param[in]   ef      Pointer to osal event flags structure.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_eventflags_destroy(osal_eventflags_t *ef) {
+    assert(ef != NULL);
+
+    // nothing allocated
+    return OSAL_OK;
+}
+
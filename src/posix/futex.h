@@ -0,0 +1,207 @@
+/**
+ * \file posix/futex.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL futex helpers.
+ *
+ * Internal wait/wake helpers on a 32-bit word. Used by the lock-free
+ * primitives to block only when there is really nothing to do.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_POSIX_FUTEX__H
+#define LIBOSAL_POSIX_FUTEX__H
+
+#include <libosal/osal.h>
+#include <libosal/timer.h>
+
+#include <errno.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <sched.h>
+#endif
+
+//! Wake-up selector matching every waiter.
+#define POSIX_FUTEX_BITSET_ANY  0xFFFFFFFFu
+
+//! \brief Wait until \p uaddr no longer contains \p val, timeout on \p clock_id.
+/*!
+ * Spurious wakeups are possible, callers have to re-check their condition.
+ *
+ * \param[in]   uaddr       Pointer to futex word.
+ * \param[in]   val         Expected value, only sleep if *uaddr still equals it.
+ * \param[in]   to          Absolute timeout on \p clock_id, NULL waits forever.
+ * \param[in]   clock_id    Clock of \p to.
+ * \param[in]   shared      OSAL_TRUE if the word may live in process shared memory.
+ * \param[in]   bitset      Only woken by \ref posix_futex_wake_bitset with an
+ *                          overlapping bitset, must not be 0.
+ *
+ * \retval OSAL_OK              Woken up, value changed or interrupted.
+ * \retval OSAL_ERR_TIMEOUT     Timeout \p to expired.
+ */
+static inline osal_retval_t posix_futex_wait_bitset_clock(osal_uint32_t *uaddr, osal_uint32_t val,
+        const osal_timer_t *to, int clock_id, osal_bool_t shared, osal_uint32_t bitset)
+{
+    osal_retval_t ret = OSAL_OK;
+
+#ifdef __linux__
+    int op = FUTEX_WAIT_BITSET;
+    struct timespec ts;
+    struct timespec *pts = NULL;
+
+    if (shared == OSAL_FALSE) {
+        op |= FUTEX_PRIVATE_FLAG;
+    }
+
+    if (to != NULL) {
+        if (clock_id == CLOCK_REALTIME) {
+            op |= FUTEX_CLOCK_REALTIME;
+            ts.tv_sec = to->sec;
+            ts.tv_nsec = to->nsec;
+        } else if (clock_id == CLOCK_MONOTONIC) {
+            ts.tv_sec = to->sec;
+            ts.tv_nsec = to->nsec;
+        } else {
+            // futex only knows CLOCK_REALTIME and CLOCK_MONOTONIC, convert
+            struct timespec act;
+            (void)clock_gettime(clock_id, &act);
+            osal_uint64_t to_nsec = osal_timer_to_nsec(to);
+            osal_uint64_t act_nsec = ((osal_uint64_t)act.tv_sec * NSEC_PER_SEC) + (osal_uint64_t)act.tv_nsec;
+            osal_uint64_t rel_nsec = to_nsec > act_nsec ? to_nsec - act_nsec : 0u;
+
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            ts.tv_sec += rel_nsec / NSEC_PER_SEC;
+            ts.tv_nsec += rel_nsec % NSEC_PER_SEC;
+            if (ts.tv_nsec >= NSEC_PER_SEC) {
+                ts.tv_nsec -= NSEC_PER_SEC;
+                ts.tv_sec++;
+            }
+        }
+
+        pts = &ts;
+    }
+
+    long local_ret = syscall(SYS_futex, uaddr, op, val, pts, NULL, bitset);
+    if ((local_ret == -1) && (errno == ETIMEDOUT)) {
+        ret = OSAL_ERR_TIMEOUT;
+    }
+#else
+    (void)val;
+    (void)shared;
+    (void)bitset;
+
+    struct timespec act;
+    (void)clock_gettime(clock_id, &act);
+
+    if ((to != NULL) && (((osal_uint64_t)act.tv_sec > to->sec) ||
+                (((osal_uint64_t)act.tv_sec == to->sec) && ((osal_uint64_t)act.tv_nsec >= to->nsec)))) {
+        ret = OSAL_ERR_TIMEOUT;
+    } else {
+        (void)sched_yield();
+    }
+#endif
+
+    return ret;
+}
+
+//! \brief Wait until \p uaddr no longer contains \p val, selective wake-up.
+/*!
+ * Spurious wakeups are possible, callers have to re-check their condition.
+ *
+ * \param[in]   uaddr   Pointer to futex word.
+ * \param[in]   val     Expected value, only sleep if *uaddr still equals it.
+ * \param[in]   to      Absolute timeout on the libosal clock, NULL waits forever.
+ * \param[in]   shared  OSAL_TRUE if the word may live in process shared memory.
+ * \param[in]   bitset  Only woken by \ref posix_futex_wake_bitset with an
+ *                      overlapping bitset, must not be 0.
+ *
+ * \retval OSAL_OK              Woken up, value changed or interrupted.
+ * \retval OSAL_ERR_TIMEOUT     Timeout \p to expired.
+ */
+static inline osal_retval_t posix_futex_wait_bitset(osal_uint32_t *uaddr, osal_uint32_t val,
+        const osal_timer_t *to, osal_bool_t shared, osal_uint32_t bitset)
+{
+    return posix_futex_wait_bitset_clock(uaddr, val, to, global_clock_id, shared, bitset);
+}
+
+//! \brief Wait until \p uaddr no longer contains \p val.
+/*!
+ * Spurious wakeups are possible, callers have to re-check their condition.
+ *
+ * \param[in]   uaddr   Pointer to futex word.
+ * \param[in]   val     Expected value, only sleep if *uaddr still equals it.
+ * \param[in]   to      Absolute timeout on the libosal clock, NULL waits forever.
+ * \param[in]   shared  OSAL_TRUE if the word may live in process shared memory.
+ *
+ * \retval OSAL_OK              Woken up, value changed or interrupted.
+ * \retval OSAL_ERR_TIMEOUT     Timeout \p to expired.
+ */
+static inline osal_retval_t posix_futex_wait(osal_uint32_t *uaddr, osal_uint32_t val,
+        const osal_timer_t *to, osal_bool_t shared)
+{
+    return posix_futex_wait_bitset(uaddr, val, to, shared, POSIX_FUTEX_BITSET_ANY);
+}
+
+//! \brief Wake up to \p cnt waiters sleeping on \p uaddr with overlapping bitset.
+/*!
+ * \param[in]   uaddr   Pointer to futex word.
+ * \param[in]   cnt     Maximum number of waiters to wake.
+ * \param[in]   shared  OSAL_TRUE if the word may live in process shared memory.
+ * \param[in]   bitset  Wake only waiters whose bitset overlaps, must not be 0.
+ */
+static inline void posix_futex_wake_bitset(osal_uint32_t *uaddr, osal_uint32_t cnt, 
+        osal_bool_t shared, osal_uint32_t bitset) 
+{
+#ifdef __linux__
+    int op = FUTEX_WAKE_BITSET;
+
+    if (shared == OSAL_FALSE) {
+        op |= FUTEX_PRIVATE_FLAG;
+    }
+
+    (void)syscall(SYS_futex, uaddr, op, (int)(cnt > 0x7FFFFFFFu ? 0x7FFFFFFFu : cnt), NULL, NULL, bitset);
+#else
+    (void)uaddr;
+    (void)cnt;
+    (void)shared;
+    (void)bitset;
+#endif
+}
+
+//! \brief Wake up to \p cnt waiters sleeping on \p uaddr.
+/*!
+ * \param[in]   uaddr   Pointer to futex word.
+ * \param[in]   cnt     Maximum number of waiters to wake.
+ * \param[in]   shared  OSAL_TRUE if the word may live in process shared memory.
+ */
+static inline void posix_futex_wake(osal_uint32_t *uaddr, osal_uint32_t cnt, osal_bool_t shared) {
+    posix_futex_wake_bitset(uaddr, cnt, shared, POSIX_FUTEX_BITSET_ANY);
+}
+
+#endif /* LIBOSAL_POSIX_FUTEX__H */
+
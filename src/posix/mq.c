@@ -39,173 +39,702 @@
 
 #include <fcntl.h>           /* For O_* constants */
 #include <sys/stat.h>        /* For mode constants */
+#include <sys/mman.h>
 #include <mqueue.h>
 #include <errno.h>
+#include <time.h>
+#include <string.h>
+#include <unistd.h>
 
+#include "futex.h"
 
-//! \brief Initialize a mq.
+/*
+ * Userspace message queue (OSAL_MQ_ATTR__OFLAG__USERSPACE)
+ *
+ * The messages live in one pool of max_messages slots. Slot indices are
+ * passed around in bounded MPMC rings with per-cell sequence numbers, one
+ * ring per priority and one holding the free slots. A cell at position pos
+ * is free for a producer if seq == pos and holds an index for a consumer if
+ * seq == pos + 1. A global message counter bounds the total number of
+ * messages to max_messages, so a sender which got a count always finds a
+ * free slot and never finds its priority ring full. prio_mask has a bit set
+ * for every possibly non-empty ring, receivers scan it from the highest
+ * priority down.
+ *
+ * Blocking is done on the recv_seq/send_seq futex words, which are only
+ * bumped if someone announced itself in recv_waiters/send_waiters.
+ *
+ * A cell may still be in the hands of a preempted task which claimed its
+ * position but did not publish it yet. Nobody spins on such a cell, the
+ * waiter sleeps on xfer_seq and the owner wakes it after publishing. A
+ * spinning high priority task would never let the owner run again.
+ *
+ * Timeouts are absolute CLOCK_REALTIME times like the ones of the kernel
+ * message queues.
+ */
+
+#define LIBOSAL_MQ_US_MAGIC         0x00A1F0E2u
+#define LIBOSAL_MQ_US_FREE_RING     OSAL_MQ_USERSPACE_PRIO_CNT
+
+//! Upper bound of one handover sleep, a lost wakeup only costs a recheck.
+#define LIBOSAL_MQ_US_XFER_WAIT_NSEC    1000000u
+
+typedef struct posix_mq_us_ring {
+    osal_uint32_t enqueue_pos;
+    osal_uint8_t  pad0[OSAL_CACHE_LINE_SIZE - 4u];
+    osal_uint32_t dequeue_pos;
+    osal_uint8_t  pad1[OSAL_CACHE_LINE_SIZE - 4u];
+} posix_mq_us_ring_t;
+
+typedef struct posix_mq_us_cell {
+    osal_uint32_t seq;
+    osal_uint32_t idx;
+} posix_mq_us_cell_t;
+
+typedef struct posix_mq_us_slot {
+    osal_uint32_t len;
+    osal_uint32_t reserved;
+    osal_char_t   data[];
+} posix_mq_us_slot_t;
+
+struct posix_mq_us {
+    osal_uint32_t magic;
+    osal_uint32_t max_messages;
+    osal_uint32_t max_message_size;
+    osal_uint32_t slot_size;
+    osal_uint32_t ring_mask;
+    osal_uint8_t  pad0[OSAL_CACHE_LINE_SIZE - 20u];
+
+    osal_uint32_t count;
+    osal_uint32_t prio_mask;
+    osal_uint8_t  pad1[OSAL_CACHE_LINE_SIZE - 8u];
+
+    osal_uint32_t recv_seq;
+    osal_uint32_t recv_waiters;
+    osal_uint8_t  pad2[OSAL_CACHE_LINE_SIZE - 8u];
+
+    osal_uint32_t send_seq;
+    osal_uint32_t send_waiters;
+    osal_uint8_t  pad3[OSAL_CACHE_LINE_SIZE - 8u];
+
+    osal_uint32_t xfer_seq;
+    osal_uint32_t xfer_waiters;
+    osal_uint8_t  pad4[OSAL_CACHE_LINE_SIZE - 8u];
+
+    posix_mq_us_ring_t rings[OSAL_MQ_USERSPACE_PRIO_CNT + 1u];     // priorities and free ring
+};
+
+//! \brief Size of the shared memory of a userspace queue.
+static osal_size_t posix_mq_us_size(osal_uint32_t ring_cnt, osal_uint32_t max_messages, osal_uint32_t slot_size) {
+    return sizeof(struct posix_mq_us) +
+        ((osal_size_t)(OSAL_MQ_USERSPACE_PRIO_CNT + 1u) * ring_cnt * sizeof(posix_mq_us_cell_t)) +
+        ((osal_size_t)max_messages * slot_size);
+}
+
+//! \brief Cell at position \p pos of ring \p ring.
+static posix_mq_us_cell_t *posix_mq_us_cell(struct posix_mq_us *us, osal_uint32_t ring, osal_uint32_t pos) {
+    osal_size_t idx = ((osal_size_t)ring * (us->ring_mask + 1u)) + (pos & us->ring_mask);
+    return &((posix_mq_us_cell_t *)&us[1])[idx];
+}
+
+//! \brief Message slot with index \p idx, the pool follows the last ring.
+static posix_mq_us_slot_t *posix_mq_us_slot(struct posix_mq_us *us, osal_uint32_t idx) {
+    osal_uint8_t *pool = (osal_uint8_t *)posix_mq_us_cell(us, OSAL_MQ_USERSPACE_PRIO_CNT + 1u, 0u);
+    return (posix_mq_us_slot_t *)(pool + ((osal_size_t)idx * us->slot_size));
+}
+
+//! \brief Sleep until a cell handover was published or \p to expired.
 /*!
- * \param[in]   mq      Pointer to osal mq structure. Content is OS dependent.
- * \param[in]   attr    Pointer to initial mq attributes. Can be NULL then
- *                      the defaults of the underlying mq will be used.
+ * The caller has read \p seq from xfer_seq and announced itself in
+ * xfer_waiters before its last check of the cell.
  *
- * \return OK or ERROR_CODE.
+ * \param[in]   us      Mapped userspace queue.
+ * \param[in]   seq     Value of xfer_seq before the last check.
+ * \param[in]   to      Absolute CLOCK_REALTIME timeout, NULL waits forever.
+ *
+ * \retval OSAL_OK              Woken up or bounded sleep over, check again.
+ * \retval OSAL_ERR_TIMEOUT     Timeout \p to expired.
  */
-osal_retval_t osal_mq_open(osal_mq_t *mq, const osal_char_t *name,  const osal_mq_attr_t *attr) {
-    assert(mq != NULL);
-    assert(name != NULL);
+static osal_retval_t posix_mq_us_xfer_wait(struct posix_mq_us *us, osal_uint32_t seq, const osal_timer_t *to) {
+    osal_retval_t ret = OSAL_OK;
+    struct timespec ts;
+    osal_timer_t bound;
+
+    (void)clock_gettime(CLOCK_REALTIME, &ts);
+    bound.sec = (osal_uint64_t)ts.tv_sec;
+    bound.nsec = (osal_uint64_t)ts.tv_nsec + LIBOSAL_MQ_US_XFER_WAIT_NSEC;
+    if (bound.nsec >= NSEC_PER_SEC) {
+        bound.nsec -= NSEC_PER_SEC;
+        bound.sec++;
+    }
+
+    if ((to != NULL) && ((to->sec < bound.sec) || ((to->sec == bound.sec) && (to->nsec <= bound.nsec)))) {
+        if (posix_futex_wait_bitset_clock(&us->xfer_seq, seq, to, CLOCK_REALTIME, 
+                    OSAL_TRUE, POSIX_FUTEX_BITSET_ANY) == OSAL_ERR_TIMEOUT) {
+            ret = OSAL_ERR_TIMEOUT;
+        }
+    } else {
+        (void)posix_futex_wait_bitset_clock(&us->xfer_seq, seq, &bound, CLOCK_REALTIME, 
+                OSAL_TRUE, POSIX_FUTEX_BITSET_ANY);
+    }
+
+    return ret;
+}
+
+//! \brief Wake the tasks waiting for a cell handover, called after publishing a cell.
+static void posix_mq_us_xfer_done(struct posix_mq_us *us) {
+    if (__atomic_load_n(&us->xfer_waiters, __ATOMIC_SEQ_CST) != 0u) {
+        __atomic_fetch_add(&us->xfer_seq, 1u, __ATOMIC_SEQ_CST);
+        posix_futex_wake(&us->xfer_seq, 0x7FFFFFFFu, OSAL_TRUE);
+    }
+}
+
+//! \brief Put slot index \p idx into ring \p ring_idx.
+/*!
+ * The message count guarantees a free cell, this only sleeps while a
+ * preempted consumer still owns it.
+ */
+static void posix_mq_us_push(struct posix_mq_us *us, osal_uint32_t ring_idx, osal_uint32_t idx) {
+    posix_mq_us_ring_t *ring = &us->rings[ring_idx];
+    posix_mq_us_cell_t *cell;
+    osal_uint32_t pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+
+    for (;;) {
+        cell = posix_mq_us_cell(us, ring_idx, pos);
+        osal_int32_t diff = (osal_int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - pos);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->enqueue_pos, &pos, pos + 1u, 1,
+                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else {
+            if (diff < 0) {
+                // a consumer is still taking the index out of this cell
+                osal_uint32_t seq = __atomic_load_n(&us->xfer_seq, __ATOMIC_SEQ_CST);
+
+                __atomic_fetch_add(&us->xfer_waiters, 1u, __ATOMIC_SEQ_CST);
+                if ((osal_int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_SEQ_CST) - pos) < 0) {
+                    (void)posix_mq_us_xfer_wait(us, seq, NULL);
+                }
+                __atomic_fetch_sub(&us->xfer_waiters, 1u, __ATOMIC_SEQ_CST);
+            }
 
+            pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->idx = idx;
+    __atomic_store_n(&cell->seq, pos + 1u, __ATOMIC_SEQ_CST);
+    posix_mq_us_xfer_done(us);
+}
+
+//! \brief Take the oldest slot index out of ring \p ring_idx, OSAL_ERR_NO_DATA if none is published.
+static osal_retval_t posix_mq_us_pop(struct posix_mq_us *us, osal_uint32_t ring_idx, osal_uint32_t *idx) {
     osal_retval_t ret = OSAL_OK;
-    
-    int oflags = 0;
-    int mode = 0;
-    struct mq_attr local_attr;
+    posix_mq_us_ring_t *ring = &us->rings[ring_idx];
+    posix_mq_us_cell_t *cell;
+    osal_uint32_t pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED);
+
+    for (;;) {
+        cell = posix_mq_us_cell(us, ring_idx, pos);
+        osal_int32_t diff = (osal_int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - (pos + 1u));
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->dequeue_pos, &pos, pos + 1u, 1,
+                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            ret = OSAL_ERR_NO_DATA;
+            break;
+        } else {
+            pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        *idx = cell->idx;
+        __atomic_store_n(&cell->seq, pos + us->ring_mask + 1u, __ATOMIC_SEQ_CST);
+        posix_mq_us_xfer_done(us);
+    }
+
+    return ret;
+}
+
+//! \brief Validate an absolute timeout like mq_timedsend does.
+static osal_retval_t posix_mq_us_check_timeout(const osal_timer_t *to) {
+    osal_retval_t ret = OSAL_OK;
+
+    if ((to != NULL) && (((osal_int64_t)to->sec < 0) || (to->nsec >= NSEC_PER_SEC))) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    }
+
+    return ret;
+}
+
+//! \brief Map errno of the shared memory calls to an osal error.
+static osal_retval_t posix_mq_us_shm_error(int err) {
+    osal_retval_t ret;
+
+    switch (err) {
+        case EACCES:
+        case EEXIST:
+            ret = OSAL_ERR_PERMISSION_DENIED;
+            break;
+        case EINVAL:
+        case ENAMETOOLONG:
+            ret = OSAL_ERR_INVALID_PARAM;
+            break;
+        case EMFILE:
+        case ENFILE:
+            ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
+            break;
+        case ENOENT:
+            ret = OSAL_ERR_NOT_FOUND;
+            break;
+        case ENOMEM:
+        case ENOSPC:
+        case EFBIG:
+            ret = OSAL_ERR_OUT_OF_MEMORY;
+            break;
+        default:
+            ret = OSAL_ERR_OPERATION_FAILED;
+            break;
+    }
+
+    return ret;
+}
+
+//! \brief Create or open a userspace queue in shared memory.
+static osal_retval_t posix_mq_us_open(osal_mq_t *mq, const osal_char_t *name, const osal_mq_attr_t *attr) {
+    osal_retval_t ret = OSAL_OK;
+    osal_bool_t creator = OSAL_FALSE;
+    osal_uint32_t ring_cnt = 1u;
+    osal_uint32_t slot_size = 0u;
+    osal_size_t size = 0u;
+    struct stat st;
+
+    mq->userspace = OSAL_TRUE;
+    mq->oflags = attr->oflags;
+    mq->shm_fd = -1;
+    mq->us = NULL;
+
+    if (attr->oflags & OSAL_MQ_ATTR__OFLAG__CREAT) {
+        if (    (attr->max_messages == 0u) || (attr->max_messages > 0x10000000u) ||
+                (attr->max_message_size == 0u) || (attr->max_message_size > 0x10000000u)) {
+            ret = OSAL_ERR_INVALID_PARAM;
+        } else {
+            while (ring_cnt < attr->max_messages) {
+                ring_cnt <<= 1u;
+            }
 
-    if (attr != 0) {
-        if (attr->oflags & OSAL_MQ_ATTR__OFLAG__RDONLY) {
-            oflags |= O_RDONLY;
+            slot_size = (osal_uint32_t)(sizeof(posix_mq_us_slot_t) + ((attr->max_message_size + 7u) & ~(osal_size_t)7u));
+            size = posix_mq_us_size(ring_cnt, (osal_uint32_t)attr->max_messages, slot_size);
+
+            mq->shm_fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, attr->mode);
+            if (mq->shm_fd != -1) {
+                creator = OSAL_TRUE;
+            } else if ((errno == EEXIST) && ((attr->oflags & OSAL_MQ_ATTR__OFLAG__EXCL) == 0u)) {
+                mq->shm_fd = shm_open(name, O_RDWR, 0);
+            }
         }
-        if (attr->oflags & OSAL_MQ_ATTR__OFLAG__WRONLY) {
-            oflags |= O_WRONLY;
-        } 
-        if (attr->oflags & OSAL_MQ_ATTR__OFLAG__RDWR) {
-            oflags |= O_RDWR;
+    } else {
+        mq->shm_fd = shm_open(name, O_RDWR, 0);
+    }
+
+    if (ret != OSAL_OK) {
+        // parameter error, nothing opened
+    } else if (mq->shm_fd == -1) {
+        ret = posix_mq_us_shm_error(errno);
+    } else if (creator == OSAL_TRUE) {
+        if (ftruncate(mq->shm_fd, size) == -1) {
+            ret = posix_mq_us_shm_error(errno);
         }
-        if (attr->oflags & OSAL_MQ_ATTR__OFLAG__CREAT) {
-            oflags |= O_CREAT;
+    } else if (fstat(mq->shm_fd, &st) == -1) {
+        ret = OSAL_ERR_OPERATION_FAILED;
+    } else if ((osal_size_t)st.st_size < sizeof(struct posix_mq_us)) {
+        // not a userspace queue or creator not done yet
+        ret = OSAL_ERR_OPERATION_FAILED;
+    } else {
+        size = (osal_size_t)st.st_size;
+    }
+
+    if (ret == OSAL_OK) {
+        void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, mq->shm_fd, 0);
+        if (mem == MAP_FAILED) {
+            ret = posix_mq_us_shm_error(errno);
+        } else {
+            mq->us = (struct posix_mq_us *)mem;
+            mq->shm_size = size;
         }
-        if (attr->oflags & OSAL_MQ_ATTR__OFLAG__EXCL) {
-            oflags |= O_EXCL;
+    }
+
+    if (ret == OSAL_OK) {
+        struct posix_mq_us *us = mq->us;
+
+        if (creator == OSAL_TRUE) {
+            osal_uint32_t ring;
+            osal_uint32_t pos;
+
+            us->max_messages        = (osal_uint32_t)attr->max_messages;
+            us->max_message_size    = (osal_uint32_t)attr->max_message_size;
+            us->slot_size           = slot_size;
+            us->ring_mask           = ring_cnt - 1u;
+
+            // only the index cells are set up, the message slots are not touched
+            for (ring = 0u; ring <= LIBOSAL_MQ_US_FREE_RING; ++ring) {
+                for (pos = 0u; pos < ring_cnt; ++pos) {
+                    posix_mq_us_cell(us, ring, pos)->seq = pos;
+                }
+            }
+
+            for (pos = 0u; pos < us->max_messages; ++pos) {
+                posix_mq_us_cell(us, LIBOSAL_MQ_US_FREE_RING, pos)->idx = pos;
+                posix_mq_us_cell(us, LIBOSAL_MQ_US_FREE_RING, pos)->seq = pos + 1u;
+            }
+            us->rings[LIBOSAL_MQ_US_FREE_RING].enqueue_pos = us->max_messages;
+
+            __atomic_store_n(&us->magic, LIBOSAL_MQ_US_MAGIC, __ATOMIC_RELEASE);
+        } else if (__atomic_load_n(&us->magic, __ATOMIC_ACQUIRE) != LIBOSAL_MQ_US_MAGIC) {
+            ret = OSAL_ERR_OPERATION_FAILED;
+        } else if (posix_mq_us_size(us->ring_mask + 1u, us->max_messages, us->slot_size) > size) {
+            ret = OSAL_ERR_OPERATION_FAILED;
+        }
+    }
+
+    if (ret != OSAL_OK) {
+        if (mq->us != NULL) {
+            (void)munmap(mq->us, mq->shm_size);
+            mq->us = NULL;
+        }
+        if (mq->shm_fd != -1) {
+            if (creator == OSAL_TRUE) {
+                (void)shm_unlink(name);
+            }
+            (void)close(mq->shm_fd);
+            mq->shm_fd = -1;
         }
+    }
+
+    return ret;
+}
 
-        mode = attr->mode;
+//! \brief Send on a userspace queue, \p to is an absolute CLOCK_REALTIME time or NULL.
+static osal_retval_t posix_mq_us_send(osal_mq_t *mq, const osal_char_t *msg, const osal_size_t msg_len,
+        const osal_uint32_t prio, const osal_timer_t *to)
+{
+    osal_retval_t ret = OSAL_OK;
+    struct posix_mq_us *us = mq->us;
 
-        local_attr.mq_maxmsg = attr->max_messages;    
-        local_attr.mq_msgsize = attr->max_message_size;
+    if (    ((mq->oflags & OSAL_MQ_ATTR__OFLAG__RDONLY) != 0u) ||
+            (msg_len > us->max_message_size) || (prio >= OSAL_MQ_USERSPACE_PRIO_CNT)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        ret = posix_mq_us_check_timeout(to);
     }
 
-    mq->mq_desc = mq_open(name, oflags, mode, &local_attr);
-	if (mq->mq_desc == (mqd_t)-1) {
-        switch (errno) {
-            case EACCES:        // The queue exists, but the caller does not have permission to open it in the specified mode.
-                                // name contained more than one slash.
-                ret = OSAL_ERR_PERMISSION_DENIED;
-                break;
-            case EEXIST:        // Both O_CREAT and O_EXCL were specified in oflag, but a queue with this name already exists.
-                ret = OSAL_ERR_PERMISSION_DENIED;
-                break;
-            case EINVAL:        // name doesn't follow the format in mq_overview(7).
-                                // O_CREAT was specified in oflag, and attr was not NULL, but attr->mq_maxmsg or attr->mq_msqsize 
-                                // was invalid.  Both of these fields must be greater than zero.  In  a  process  that  is  unprivileged
-                                // (does  not have the CAP_SYS_RESOURCE capability), attr->mq_maxmsg must be less than or equal to 
-                                // the msg_max limit, and attr->mq_msgsize must be less than or equal to the msgsize_max limit.  In ad-
-                                // dition, even in a privileged process, attr->mq_maxmsg cannot exceed the HARD_MAX limit. 
-                ret = OSAL_ERR_INVALID_PARAM;
-                break;
-            case EMFILE:        // The per-process limit on the number of open file and message queue descriptors has been reached (see
-                                // the description of RLIMIT_NOFILE in getrlimit(2)).
-                ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
-                break;
-            case ENAMETOOLONG:  // name was too long.
-                ret = OSAL_ERR_INVALID_PARAM;
-                break;
-            case ENFILE:        // The system-wide limit on the total number of open files and message queues has been reached.
-                ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
-                break;
-            case ENOENT:        // The O_CREAT flag was not specified in oflag, and no queue with this name exists.
-                                // name was just "/" followed by no other characters.
-                ret = OSAL_ERR_NOT_FOUND;
-                break;
-            case ENOMEM:        // Insufficient memory.
-                ret = OSAL_ERR_OUT_OF_MEMORY;
-                break;
-            case ENOSPC:        // Insufficient space for the creation of a new message queue.  This probably occurred because the 
-                                // queues_max limit was encountered; see mq_overview(7).
-                ret = OSAL_ERR_OUT_OF_MEMORY;
-                break;
-            default:
-                ret = OSAL_ERR_OPERATION_FAILED;
+    // reserve one message of the total queue capacity
+    while (ret == OSAL_OK) {
+        osal_uint32_t cnt = __atomic_load_n(&us->count, __ATOMIC_RELAXED);
+
+        if (cnt < us->max_messages) {
+            if (__atomic_compare_exchange_n(&us->count, &cnt, cnt + 1u, 1, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
                 break;
+            }
+        } else {
+            osal_uint32_t seq = __atomic_load_n(&us->send_seq, __ATOMIC_ACQUIRE);
+
+            __atomic_fetch_add(&us->send_waiters, 1u, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&us->count, __ATOMIC_SEQ_CST) >= us->max_messages) {
+                ret = posix_futex_wait_bitset_clock(&us->send_seq, seq, to, CLOCK_REALTIME, 
+                        OSAL_TRUE, POSIX_FUTEX_BITSET_ANY);
+            }
+            __atomic_fetch_sub(&us->send_waiters, 1u, __ATOMIC_SEQ_CST);
+        }
+    }
+
+    osal_uint32_t idx = 0u;
+
+    if (ret == OSAL_OK) {
+        // the count guarantees a free slot, its index may still be on the way back
+        osal_retval_t pop_ret = posix_mq_us_pop(us, LIBOSAL_MQ_US_FREE_RING, &idx);
+
+        while ((ret == OSAL_OK) && (pop_ret != OSAL_OK)) {
+            osal_uint32_t seq = __atomic_load_n(&us->xfer_seq, __ATOMIC_SEQ_CST);
+
+            __atomic_fetch_add(&us->xfer_waiters, 1u, __ATOMIC_SEQ_CST);
+            pop_ret = posix_mq_us_pop(us, LIBOSAL_MQ_US_FREE_RING, &idx);
+            if (pop_ret != OSAL_OK) {
+                ret = posix_mq_us_xfer_wait(us, seq, to);
+            }
+            __atomic_fetch_sub(&us->xfer_waiters, 1u, __ATOMIC_SEQ_CST);
+        }
+
+        if (ret != OSAL_OK) {
+            // give the reserved message back
+            __atomic_fetch_sub(&us->count, 1u, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&us->send_waiters, __ATOMIC_SEQ_CST) != 0u) {
+                __atomic_fetch_add(&us->send_seq, 1u, __ATOMIC_SEQ_CST);
+                posix_futex_wake(&us->send_seq, 1u, OSAL_TRUE);
+            }
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        posix_mq_us_slot_t *slot = posix_mq_us_slot(us, idx);
+
+        (void)memcpy(slot->data, msg, msg_len);
+        slot->len = (osal_uint32_t)msg_len;
+        posix_mq_us_push(us, prio, idx);
+
+        __atomic_fetch_or(&us->prio_mask, 1u << prio, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&us->recv_waiters, __ATOMIC_SEQ_CST) != 0u) {
+            __atomic_fetch_add(&us->recv_seq, 1u, __ATOMIC_SEQ_CST);
+            posix_futex_wake(&us->recv_seq, 1u, OSAL_TRUE);
         }
     }
 
     return ret;
 }
 
-//! \brief Send a message through message queue.
+//! \brief Receive the oldest message of priority \p prio and give its slot back.
+static osal_retval_t posix_mq_us_dequeue(struct posix_mq_us *us, osal_uint32_t prio,
+        osal_char_t *msg, osal_uint32_t *msg_prio)
+{
+    osal_retval_t ret;
+    osal_uint32_t idx;
+
+    ret = posix_mq_us_pop(us, prio, &idx);
+    if (ret == OSAL_OK) {
+        posix_mq_us_slot_t *slot = posix_mq_us_slot(us, idx);
+
+        (void)memcpy(msg, slot->data, slot->len);
+        if (msg_prio != NULL) {
+            *msg_prio = prio;
+        }
+
+        // give the slot back before the count, senders rely on finding it
+        posix_mq_us_push(us, LIBOSAL_MQ_US_FREE_RING, idx);
+
+        __atomic_fetch_sub(&us->count, 1u, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&us->send_waiters, __ATOMIC_SEQ_CST) != 0u) {
+            __atomic_fetch_add(&us->send_seq, 1u, __ATOMIC_SEQ_CST);
+            posix_futex_wake(&us->send_seq, 1u, OSAL_TRUE);
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Receive the oldest message of the highest non-empty priority without blocking.
+static osal_retval_t posix_mq_us_try_receive(struct posix_mq_us *us, osal_char_t *msg, osal_uint32_t *prio) {
+    osal_retval_t ret = OSAL_ERR_NO_DATA;
+    osal_uint32_t mask = __atomic_load_n(&us->prio_mask, __ATOMIC_SEQ_CST);
+
+    while ((ret == OSAL_ERR_NO_DATA) && (mask != 0u)) {
+        osal_uint32_t act_prio = 31u - (osal_uint32_t)__builtin_clz(mask);
+        osal_uint32_t bit = 1u << act_prio;
+
+        ret = posix_mq_us_dequeue(us, act_prio, msg, prio);
+        if (ret == OSAL_ERR_NO_DATA) {
+            // ring drained, clear its bit but restore it if a sender raced us
+            __atomic_fetch_and(&us->prio_mask, ~bit, __ATOMIC_SEQ_CST);
+
+            posix_mq_us_ring_t *ring = &us->rings[act_prio];
+            osal_uint32_t pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&posix_mq_us_cell(us, act_prio, pos)->seq, __ATOMIC_SEQ_CST) == (pos + 1u)) {
+                __atomic_fetch_or(&us->prio_mask, bit, __ATOMIC_SEQ_CST);
+                ret = posix_mq_us_dequeue(us, act_prio, msg, prio);
+            }
+        }
+
+        mask &= ~bit;
+    }
+
+    return ret;
+}
+
+//! \brief Receive from a userspace queue, \p to is an absolute CLOCK_REALTIME time or NULL.
+static osal_retval_t posix_mq_us_receive(osal_mq_t *mq, osal_char_t *msg, const osal_size_t msg_len,
+        osal_uint32_t *prio, const osal_timer_t *to)
+{
+    osal_retval_t ret = OSAL_OK;
+    struct posix_mq_us *us = mq->us;
+
+    if (((mq->oflags & OSAL_MQ_ATTR__OFLAG__WRONLY) != 0u) || (msg_len < us->max_message_size)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        ret = posix_mq_us_check_timeout(to);
+    }
+
+    while (ret == OSAL_OK) {
+        osal_uint32_t seq = __atomic_load_n(&us->recv_seq, __ATOMIC_ACQUIRE);
+
+        ret = posix_mq_us_try_receive(us, msg, prio);
+        if (ret != OSAL_ERR_NO_DATA) {
+            break;
+        }
+
+        __atomic_fetch_add(&us->recv_waiters, 1u, __ATOMIC_SEQ_CST);
+
+        ret = posix_mq_us_try_receive(us, msg, prio);
+        if ((ret == OSAL_ERR_NO_DATA) && (posix_futex_wait_bitset_clock(&us->recv_seq, seq, to, CLOCK_REALTIME, 
+                        OSAL_TRUE, POSIX_FUTEX_BITSET_ANY) == OSAL_ERR_TIMEOUT)) {
+            ret = posix_mq_us_try_receive(us, msg, prio);
+            if (ret == OSAL_ERR_NO_DATA) {
+                ret = OSAL_ERR_TIMEOUT;
+            }
+        }
+
+        __atomic_fetch_sub(&us->recv_waiters, 1u, __ATOMIC_SEQ_CST);
+
+        if (ret == OSAL_ERR_NO_DATA) {
+            // woken up, try again
+            ret = OSAL_OK;
+        } else {
+            break;
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Unmap and close a userspace queue.
+static osal_retval_t posix_mq_us_close(osal_mq_t *mq) {
+    osal_retval_t ret = OSAL_OK;
+
+    if ((munmap(mq->us, mq->shm_size) == -1) || (close(mq->shm_fd) == -1)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    }
+
+    mq->us = NULL;
+    mq->shm_fd = -1;
+
+    return ret;
+}
+
+
+//! \brief Initialize a mq.
 /*!
  * \param[in]   mq      Pointer to osal mq structure. Content is OS dependent.
- * \param[in]   msg     Pointer to message buffer.
- * \param[in]   msg_len Lenght of message to send.
- * \param[in]   prio    Send priority.
+ * \param[in]   attr    Pointer to initial mq attributes. Can be NULL then
+ *                      the defaults of the underlying mq will be used.
  *
  * \return OK or ERROR_CODE.
  */
-osal_retval_t osal_mq_send(osal_mq_t *mq, const osal_char_t *msg, const osal_size_t msg_len, const osal_uint32_t prio) {
+osal_retval_t osal_mq_open(osal_mq_t *mq, const osal_char_t *name,  const osal_mq_attr_t *attr) {
     assert(mq != NULL);
-    assert(msg != NULL);
+    assert(name != NULL);
 
     osal_retval_t ret = OSAL_OK;
-    int local_ret = mq_send(mq->mq_desc, msg, msg_len, prio);
-    if (local_ret == -1) {
-        switch (errno) {
-            case EAGAIN:    // The queue was full, and the O_NONBLOCK flag was set for the message queue description 
-                            // referred to by mqdes.
-	      /* this error case will not happen, because O_NONBLOCK flag cannot be set currently*/
-                ret = OSAL_ERR_BUSY;
-                break;
-            case EBADF:     // The descriptor specified in mqdes was invalid or not opened for writing.
-                ret = OSAL_ERR_INVALID_PARAM;
-                break;
-            case EINTR:     // The call was interrupted by a signal handler; see signal(7).
-                ret = OSAL_ERR_INTERRUPTED;
-                break;
-            case EINVAL:    // The call would have blocked, and abs_timeout was invalid, either because tv_sec 
-                            // was less than zero, or because tv_nsec was less than zero or greater than 1000 million.
-	      /* this error case will not happen, because no timeout is passed to this function. */
-                ret = OSAL_ERR_INVALID_PARAM;
-                break;
-            case EMSGSIZE:  // msg_len was greater than the mq_msgsize attribute of the message queue.
-                ret = OSAL_ERR_INVALID_PARAM;
-                break;
-            default:
-                ret = OSAL_ERR_OPERATION_FAILED;
-                break;
+    
+    int oflags = 0;
+    int mode = 0;
+    struct mq_attr local_attr;
+
+    if ((attr != NULL) && ((attr->oflags & OSAL_MQ_ATTR__OFLAG__USERSPACE) != 0u)) {
+        ret = posix_mq_us_open(mq, name, attr);
+    } else {
+        mq->userspace = OSAL_FALSE;
+        mq->us = NULL;
+
+        if (attr != 0) {
+            if (attr->oflags & OSAL_MQ_ATTR__OFLAG__RDONLY) {
+                oflags |= O_RDONLY;
+            }
+            if (attr->oflags & OSAL_MQ_ATTR__OFLAG__WRONLY) {
+                oflags |= O_WRONLY;
+            } 
+            if (attr->oflags & OSAL_MQ_ATTR__OFLAG__RDWR) {
+                oflags |= O_RDWR;
+            }
+            if (attr->oflags & OSAL_MQ_ATTR__OFLAG__CREAT) {
+                oflags |= O_CREAT;
+            }
+            if (attr->oflags & OSAL_MQ_ATTR__OFLAG__EXCL) {
+                oflags |= O_EXCL;
+            }
+
+            mode = attr->mode;
+
+            local_attr.mq_maxmsg = attr->max_messages;    
+            local_attr.mq_msgsize = attr->max_message_size;
+        }
+
+        mq->mq_desc = mq_open(name, oflags, mode, &local_attr);
+    	if (mq->mq_desc == (mqd_t)-1) {
+            switch (errno) {
+                case EACCES:        // The queue exists, but the caller does not have permission to open it in the specified mode.
+                                    // name contained more than one slash.
+                    ret = OSAL_ERR_PERMISSION_DENIED;
+                    break;
+                case EEXIST:        // Both O_CREAT and O_EXCL were specified in oflag, but a queue with this name already exists.
+                    ret = OSAL_ERR_PERMISSION_DENIED;
+                    break;
+                case EINVAL:        // name doesn't follow the format in mq_overview(7).
+                                    // O_CREAT was specified in oflag, and attr was not NULL, but attr->mq_maxmsg or attr->mq_msqsize 
+                                    // was invalid.  Both of these fields must be greater than zero.  In  a  process  that  is  unprivileged
+                                    // (does  not have the CAP_SYS_RESOURCE capability), attr->mq_maxmsg must be less than or equal to 
+                                    // the msg_max limit, and attr->mq_msgsize must be less than or equal to the msgsize_max limit.  In ad-
+                                    // dition, even in a privileged process, attr->mq_maxmsg cannot exceed the HARD_MAX limit. 
+                    ret = OSAL_ERR_INVALID_PARAM;
+                    break;
+                case EMFILE:        // The per-process limit on the number of open file and message queue descriptors has been reached (see
+                                    // the description of RLIMIT_NOFILE in getrlimit(2)).
+                    ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
+                    break;
+                case ENAMETOOLONG:  // name was too long.
+                    ret = OSAL_ERR_INVALID_PARAM;
+                    break;
+                case ENFILE:        // The system-wide limit on the total number of open files and message queues has been reached.
+                    ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
+                    break;
+                case ENOENT:        // The O_CREAT flag was not specified in oflag, and no queue with this name exists.
+                                    // name was just "/" followed by no other characters.
+                    ret = OSAL_ERR_NOT_FOUND;
+                    break;
+                case ENOMEM:        // Insufficient memory.
+                    ret = OSAL_ERR_OUT_OF_MEMORY;
+                    break;
+                case ENOSPC:        // Insufficient space for the creation of a new message queue.  This probably occurred because the 
+                                    // queues_max limit was encountered; see mq_overview(7).
+                    ret = OSAL_ERR_OUT_OF_MEMORY;
+                    break;
+                default:
+                    ret = OSAL_ERR_OPERATION_FAILED;
+                    break;
+            }
         }
     }
 
     return ret;
 }
 
-
 //! \brief Send a message through message queue.
 /*!
  * \param[in]   mq      Pointer to osal mq structure. Content is OS dependent.
  * \param[in]   msg     Pointer to message buffer.
  * \param[in]   msg_len Lenght of message to send.
  * \param[in]   prio    Send priority.
- * \param[in]   to      Timeout waiting if message queue is full.
  *
  * \return OK or ERROR_CODE.
  */
-osal_retval_t osal_mq_timedsend(osal_mq_t *mq, const osal_char_t *msg, const osal_size_t msg_len, 
-        const osal_uint32_t prio, const osal_timer_t *to) {
+osal_retval_t osal_mq_send(osal_mq_t *mq, const osal_char_t *msg, const osal_size_t msg_len, const osal_uint32_t prio) {
     assert(mq != NULL);
     assert(msg != NULL);
-    assert(to != NULL);
 
-    osal_retval_t ret = OSAL_ERR_INTERRUPTED;
-
-    struct timespec ts;
-    ts.tv_sec = to->sec;
-    ts.tv_nsec = to->nsec;
+    osal_retval_t ret = OSAL_OK;
 
-    while (ret == OSAL_ERR_INTERRUPTED) {
-        int local_ret = mq_timedsend(mq->mq_desc, msg, msg_len, prio, &ts);
+    if (mq->userspace == OSAL_TRUE) {
+        ret = posix_mq_us_send(mq, msg, msg_len, prio, NULL);
+    } else {
+        int local_ret = mq_send(mq->mq_desc, msg, msg_len, prio);
         if (local_ret == -1) {
             switch (errno) {
                 case EAGAIN:    // The queue was full, and the O_NONBLOCK flag was set for the message queue description 
                                 // referred to by mqdes.
+    	      /* this error case will not happen, because O_NONBLOCK flag cannot be set currently*/
                     ret = OSAL_ERR_BUSY;
                     break;
                 case EBADF:     // The descriptor specified in mqdes was invalid or not opened for writing.
@@ -216,21 +745,16 @@ osal_retval_t osal_mq_timedsend(osal_mq_t *mq, const osal_char_t *msg, const osa
                     break;
                 case EINVAL:    // The call would have blocked, and abs_timeout was invalid, either because tv_sec 
                                 // was less than zero, or because tv_nsec was less than zero or greater than 1000 million.
+    	      /* this error case will not happen, because no timeout is passed to this function. */
                     ret = OSAL_ERR_INVALID_PARAM;
                     break;
                 case EMSGSIZE:  // msg_len was greater than the mq_msgsize attribute of the message queue.
                     ret = OSAL_ERR_INVALID_PARAM;
                     break;
-                case ETIMEDOUT: // The call timed out before a message could be transferred.
-                    ret = OSAL_ERR_TIMEOUT;
-                    break;
                 default:
                     ret = OSAL_ERR_OPERATION_FAILED;
                     break;
             }
-        } else {
-            ret = OSAL_OK;
-            break;
         }
     }
 
@@ -238,47 +762,66 @@ osal_retval_t osal_mq_timedsend(osal_mq_t *mq, const osal_char_t *msg, const osa
 }
 
 
-//! \brief Receive a message through message queue.
+//! \brief Send a message through message queue.
 /*!
  * \param[in]   mq      Pointer to osal mq structure. Content is OS dependent.
- * \param[out]  msg     Pointer to message buffer.
- * \param[in]   msg_len Lenght of message to receive.
- * \param[out]  prio    Receive priority.
+ * \param[in]   msg     Pointer to message buffer.
+ * \param[in]   msg_len Lenght of message to send.
+ * \param[in]   prio    Send priority.
+ * \param[in]   to      Timeout waiting if message queue is full.
  *
  * \return OK or ERROR_CODE.
  */
-osal_retval_t osal_mq_receive(osal_mq_t *mq, osal_char_t *msg, const osal_size_t msg_len, osal_uint32_t *prio) {
+osal_retval_t osal_mq_timedsend(osal_mq_t *mq, const osal_char_t *msg, const osal_size_t msg_len, 
+        const osal_uint32_t prio, const osal_timer_t *to) {
     assert(mq != NULL);
     assert(msg != NULL);
+    assert(to != NULL);
 
-    osal_retval_t ret = OSAL_OK;
-    int local_ret = mq_receive(mq->mq_desc, msg, msg_len, prio);
-    if (local_ret == -1) {
-        switch (errno) {
-            case EAGAIN:    // The queue was full, and the O_NONBLOCK flag was set for the message queue description 
-                            // referred to by mqdes.
-                ret = OSAL_ERR_BUSY;
-                break;
-            case EBADF:     // The descriptor specified in mqdes was invalid or not opened for writing.
-                ret = OSAL_ERR_INVALID_PARAM;
-                break;
-            case EINTR:     // The call was interrupted by a signal handler; see signal(7).
-                ret = OSAL_ERR_INTERRUPTED;
-                break;
-            case EINVAL:    // The call would have blocked, and abs_timeout was invalid, either because tv_sec 
-                            // was less than zero, or because tv_nsec was less than zero or greater than 1000 million.
-	      /* this branch is never reached since the call does not use
-		 a timeout parameter. */
-                ret = OSAL_ERR_INVALID_PARAM;
-                break;
-            case EMSGSIZE:  // msg_len was greater than the mq_msgsize attribute of the message queue.
-                ret = OSAL_ERR_INVALID_PARAM;
-                break;
-            default:
-                ret = OSAL_ERR_OPERATION_FAILED;
+    osal_retval_t ret = OSAL_ERR_INTERRUPTED;
+
+    if (mq->userspace == OSAL_TRUE) {
+        ret = posix_mq_us_send(mq, msg, msg_len, prio, to);
+    } else {
+        struct timespec ts;
+        ts.tv_sec = to->sec;
+        ts.tv_nsec = to->nsec;
+
+        while (ret == OSAL_ERR_INTERRUPTED) {
+            int local_ret = mq_timedsend(mq->mq_desc, msg, msg_len, prio, &ts);
+            if (local_ret == -1) {
+                switch (errno) {
+                    case EAGAIN:    // The queue was full, and the O_NONBLOCK flag was set for the message queue description 
+                                    // referred to by mqdes.
+                        ret = OSAL_ERR_BUSY;
+                        break;
+                    case EBADF:     // The descriptor specified in mqdes was invalid or not opened for writing.
+                        ret = OSAL_ERR_INVALID_PARAM;
+                        break;
+                    case EINTR:     // The call was interrupted by a signal handler; see signal(7).
+                        ret = OSAL_ERR_INTERRUPTED;
+                        break;
+                    case EINVAL:    // The call would have blocked, and abs_timeout was invalid, either because tv_sec 
+                                    // was less than zero, or because tv_nsec was less than zero or greater than 1000 million.
+                        ret = OSAL_ERR_INVALID_PARAM;
+                        break;
+                    case EMSGSIZE:  // msg_len was greater than the mq_msgsize attribute of the message queue.
+                        ret = OSAL_ERR_INVALID_PARAM;
+                        break;
+                    case ETIMEDOUT: // The call timed out before a message could be transferred.
+                        ret = OSAL_ERR_TIMEOUT;
+                        break;
+                    default:
+                        ret = OSAL_ERR_OPERATION_FAILED;
+                        break;
+                }
+            } else {
+                ret = OSAL_OK;
                 break;
+            }
         }
     }
+
     return ret;
 }
 
@@ -289,24 +832,19 @@ osal_retval_t osal_mq_receive(osal_mq_t *mq, osal_char_t *msg, const osal_size_t
  * \param[out]  msg     Pointer to message buffer.
  * \param[in]   msg_len Lenght of message to receive.
  * \param[out]  prio    Receive priority.
- * \param[in]   to      Timeout waiting if message queue is full.
  *
  * \return OK or ERROR_CODE.
  */
-osal_retval_t osal_mq_timedreceive(osal_mq_t *mq, osal_char_t *msg, const osal_size_t msg_len, 
-        osal_uint32_t *prio, const osal_timer_t *to) {
+osal_retval_t osal_mq_receive(osal_mq_t *mq, osal_char_t *msg, const osal_size_t msg_len, osal_uint32_t *prio) {
     assert(mq != NULL);
     assert(msg != NULL);
-    assert(to != NULL);
 
-    osal_retval_t ret = OSAL_ERR_INTERRUPTED;
-
-    struct timespec ts;
-    ts.tv_sec = to->sec;
-    ts.tv_nsec = to->nsec;
+    osal_retval_t ret = OSAL_OK;
 
-    while (ret == OSAL_ERR_INTERRUPTED) {
-        int local_ret = mq_timedreceive(mq->mq_desc, msg, msg_len, prio, &ts);
+    if (mq->userspace == OSAL_TRUE) {
+        ret = posix_mq_us_receive(mq, msg, msg_len, prio, NULL);
+    } else {
+        int local_ret = mq_receive(mq->mq_desc, msg, msg_len, prio);
         if (local_ret == -1) {
             switch (errno) {
                 case EAGAIN:    // The queue was full, and the O_NONBLOCK flag was set for the message queue description 
@@ -321,23 +859,84 @@ osal_retval_t osal_mq_timedreceive(osal_mq_t *mq, osal_char_t *msg, const osal_s
                     break;
                 case EINVAL:    // The call would have blocked, and abs_timeout was invalid, either because tv_sec 
                                 // was less than zero, or because tv_nsec was less than zero or greater than 1000 million.
+    	      /* this branch is never reached since the call does not use
+    		 a timeout parameter. */
                     ret = OSAL_ERR_INVALID_PARAM;
                     break;
                 case EMSGSIZE:  // msg_len was greater than the mq_msgsize attribute of the message queue.
                     ret = OSAL_ERR_INVALID_PARAM;
                     break;
-                case ETIMEDOUT: // The call timed out before a message could be transferred.
-                    ret = OSAL_ERR_TIMEOUT;
-                    break;
                 default:
                     ret = OSAL_ERR_OPERATION_FAILED;
                     break;
             }
-        } else {
-            ret = OSAL_OK;
-            break;
         }
     }
+
+    return ret;
+}
+
+
+//! \brief Receive a message through message queue.
+/*!
+ * \param[in]   mq      Pointer to osal mq structure. Content is OS dependent.
+ * \param[out]  msg     Pointer to message buffer.
+ * \param[in]   msg_len Lenght of message to receive.
+ * \param[out]  prio    Receive priority.
+ * \param[in]   to      Timeout waiting if message queue is full.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_mq_timedreceive(osal_mq_t *mq, osal_char_t *msg, const osal_size_t msg_len, 
+        osal_uint32_t *prio, const osal_timer_t *to) {
+    assert(mq != NULL);
+    assert(msg != NULL);
+    assert(to != NULL);
+
+    osal_retval_t ret = OSAL_ERR_INTERRUPTED;
+
+    if (mq->userspace == OSAL_TRUE) {
+        ret = posix_mq_us_receive(mq, msg, msg_len, prio, to);
+    } else {
+        struct timespec ts;
+        ts.tv_sec = to->sec;
+        ts.tv_nsec = to->nsec;
+
+        while (ret == OSAL_ERR_INTERRUPTED) {
+            int local_ret = mq_timedreceive(mq->mq_desc, msg, msg_len, prio, &ts);
+            if (local_ret == -1) {
+                switch (errno) {
+                    case EAGAIN:    // The queue was full, and the O_NONBLOCK flag was set for the message queue description 
+                                    // referred to by mqdes.
+                        ret = OSAL_ERR_BUSY;
+                        break;
+                    case EBADF:     // The descriptor specified in mqdes was invalid or not opened for writing.
+                        ret = OSAL_ERR_INVALID_PARAM;
+                        break;
+                    case EINTR:     // The call was interrupted by a signal handler; see signal(7).
+                        ret = OSAL_ERR_INTERRUPTED;
+                        break;
+                    case EINVAL:    // The call would have blocked, and abs_timeout was invalid, either because tv_sec 
+                                    // was less than zero, or because tv_nsec was less than zero or greater than 1000 million.
+                        ret = OSAL_ERR_INVALID_PARAM;
+                        break;
+                    case EMSGSIZE:  // msg_len was greater than the mq_msgsize attribute of the message queue.
+                        ret = OSAL_ERR_INVALID_PARAM;
+                        break;
+                    case ETIMEDOUT: // The call timed out before a message could be transferred.
+                        ret = OSAL_ERR_TIMEOUT;
+                        break;
+                    default:
+                        ret = OSAL_ERR_OPERATION_FAILED;
+                        break;
+                }
+            } else {
+                ret = OSAL_OK;
+                break;
+            }
+        }
+    }
+
     return ret;
 }
 
@@ -352,10 +951,15 @@ osal_retval_t osal_mq_close(osal_mq_t *mq) {
     assert(mq != NULL);
 
     osal_retval_t ret = OSAL_OK;
-    int local_ret = mq_close(mq->mq_desc);
-    if (local_ret == -1) {
-        // only EBADF could be set
-        ret = OSAL_ERR_INVALID_PARAM;
+
+    if (mq->userspace == OSAL_TRUE) {
+        ret = posix_mq_us_close(mq);
+    } else {
+        int local_ret = mq_close(mq->mq_desc);
+        if (local_ret == -1) {
+            // only EBADF could be set
+            ret = OSAL_ERR_INVALID_PARAM;
+        }
     }
 
     return ret;
@@ -32,12 +32,94 @@
 #include <libosal/config.h>
 #endif
 
+#define _GNU_SOURCE             /* See feature_test_macros(7) */
+
 #include <libosal/osal.h>
 #include <libosal/mutex.h>
 
 #include <errno.h>
 #include <pthread.h>
 #include <assert.h>
+#include <time.h>
+
+#if LIBOSAL_HAVE_UNISTD_H == 1
+#include <unistd.h>
+#endif
+
+//! Upper bound of lock attempts of an adaptive mutex before it blocks.
+#define POSIX_MUTEX_SPIN_MAX    100u
+
+static inline void posix_mutex_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+//! Spin on an adaptive mutex.
+/*!
+ * Retries to lock the mutex up to twice the recent average plus some
+ * attempts, at most \ref POSIX_MUTEX_SPIN_MAX. The average follows the
+ * number of attempts needed, so a mutex whose owners hold it long stops
+ * wasting CPU time and a mutex with short critical sections spins longer.
+ *
+ * \return Result of the last pthread_mutex_trylock, EBUSY if the caller has
+ *         to block.
+ */
+static int posix_mutex_spin(osal_mutex_t *mtx) {
+    int posix_ret = pthread_mutex_trylock(&mtx->posix_mtx);
+
+    if (posix_ret == EBUSY) {
+        osal_int32_t spins = (osal_int32_t)__atomic_load_n(&mtx->spins, __ATOMIC_RELAXED);
+        osal_int32_t limit = (spins * 2) + 10;
+        osal_int32_t cnt = 0;
+
+        if (limit > (osal_int32_t)mtx->spin_max) {
+            limit = (osal_int32_t)mtx->spin_max;
+        }
+
+        while ((posix_ret == EBUSY) && (cnt < limit)) {
+            posix_mutex_cpu_relax();
+            posix_ret = pthread_mutex_trylock(&mtx->posix_mtx);
+            cnt++;
+        }
+
+        spins += (cnt - spins) / 8;
+        __atomic_store_n(&mtx->spins, (osal_uint32_t)spins, __ATOMIC_RELAXED);
+    }
+
+    return posix_ret;
+}
+
+//! Map the result of a blocking lock function.
+static osal_retval_t posix_mutex_lock_retval(int posix_ret) {
+    osal_retval_t ret;
+
+    if (posix_ret != 0) {
+        if (posix_ret == EAGAIN) {
+            ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
+        } else if (posix_ret == EINVAL) {
+            ret = OSAL_ERR_INVALID_PARAM; 
+#if LIBOSAL_HAVE_ENOTRECOVERABLE == 1
+        } else if (posix_ret == ENOTRECOVERABLE) {
+            ret = OSAL_ERR_NOT_RECOVERABLE;
+#endif
+        } else if (posix_ret == EOWNERDEAD) {
+            ret = OSAL_ERR_OWNER_DEAD;
+        } else if (posix_ret == EDEADLK) {
+            ret = OSAL_ERR_DEAD_LOCK;
+        } else if (posix_ret == ETIMEDOUT) {
+            ret = OSAL_ERR_TIMEOUT;
+        } else {
+            ret = OSAL_ERR_UNAVAILABLE;
+        }
+    } else {
+        ret = OSAL_OK;
+    }
+
+    return ret;
+}
 
 //! \brief Initialize a mutex.
 /*!
@@ -65,6 +147,9 @@ osal_retval_t osal_mutex_init(osal_mutex_t *mtx, const osal_mutex_attr_t *attr)
             pthread_mutexattr_settype(&posix_attr, PTHREAD_MUTEX_ERRORCHECK);
         } else if (((*attr) & OSAL_MUTEX_ATTR__TYPE__MASK) == OSAL_MUTEX_ATTR__TYPE__RECURSIVE) {
             pthread_mutexattr_settype(&posix_attr, PTHREAD_MUTEX_RECURSIVE);
+        } else if (((*attr) & OSAL_MUTEX_ATTR__TYPE__MASK) == OSAL_MUTEX_ATTR__TYPE__ADAPTIVE) {
+            // spinning is done here, it also works for robust and priority inheritance mutexes
+            pthread_mutexattr_settype(&posix_attr, PTHREAD_MUTEX_NORMAL);
         } else  {}
 
 #if LIBOSAL_HAVE_PTHREAD_MUTEXATTR_SETROBUST == 1
@@ -93,6 +178,18 @@ osal_retval_t osal_mutex_init(osal_mutex_t *mtx, const osal_mutex_attr_t *attr)
         pposix_attr = &posix_attr;
     }
 
+    mtx->spin_max = 0u;
+    mtx->spins = 0u;
+
+    if ((attr != NULL) && (((*attr) & OSAL_MUTEX_ATTR__TYPE__MASK) == OSAL_MUTEX_ATTR__TYPE__ADAPTIVE)) {
+#if LIBOSAL_HAVE_UNISTD_H == 1
+        // the owner cannot make progress while we spin on a single cpu
+        if (sysconf(_SC_NPROCESSORS_ONLN) > 1) {
+            mtx->spin_max = POSIX_MUTEX_SPIN_MAX;
+        }
+#endif
+    }
+
     posix_ret = pthread_mutex_init(&mtx->posix_mtx, pposix_attr);
 
     if (posix_ret != 0) {
@@ -123,31 +220,79 @@ osal_retval_t osal_mutex_init(osal_mutex_t *mtx, const osal_mutex_attr_t *attr)
 osal_retval_t osal_mutex_lock(osal_mutex_t *mtx) {
     assert(mtx != NULL);
 
-    osal_retval_t ret;
-    int posix_ret;
+    int posix_ret = EBUSY;
 
-    posix_ret = pthread_mutex_lock(&mtx->posix_mtx);
-    if (posix_ret != 0) {
-        if (posix_ret == EAGAIN) {
-            ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
-        } else if (posix_ret == EINVAL) {
-            ret = OSAL_ERR_INVALID_PARAM; 
-#if LIBOSAL_HAVE_ENOTRECOVERABLE == 1
-        } else if (posix_ret == ENOTRECOVERABLE) {
-            ret = OSAL_ERR_NOT_RECOVERABLE;
-#endif
-        } else if (posix_ret == EOWNERDEAD) {
-            ret = OSAL_ERR_OWNER_DEAD;
-        } else if (posix_ret == EDEADLK) {
-            ret = OSAL_ERR_DEAD_LOCK;
+    if (mtx->spin_max != 0u) {
+        posix_ret = posix_mutex_spin(mtx);
+    }
+
+    if (posix_ret == EBUSY) {
+        posix_ret = pthread_mutex_lock(&mtx->posix_mtx);
+    }
+
+    return posix_mutex_lock_retval(posix_ret);
+}
+
+//! \brief Locks a mutex with timeout.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_mutex_timedlock(osal_mutex_t *mtx, const osal_timer_t *to) {
+    assert(mtx != NULL);
+    assert(to != NULL);
+
+    int posix_ret = EBUSY;
+
+    if (mtx->spin_max != 0u) {
+        posix_ret = posix_mutex_spin(mtx);
+    }
+
+    if (posix_ret == EBUSY) {
+        struct timespec ts;
+        ts.tv_sec = to->sec;
+        ts.tv_nsec = to->nsec;
+
+        if (global_clock_id == CLOCK_REALTIME) {
+            posix_ret = pthread_mutex_timedlock(&mtx->posix_mtx, &ts);
         } else {
-            ret = OSAL_ERR_UNAVAILABLE;
+            posix_ret = EINVAL;
+
+#if LIBOSAL_HAVE_PTHREAD_MUTEX_CLOCKLOCK == 1
+            // older C libraries only know CLOCK_REALTIME for priority inheritance mutexes
+            posix_ret = pthread_mutex_clocklock(&mtx->posix_mtx, global_clock_id, &ts);
+#endif
+
+            if (posix_ret == EINVAL) {
+                // need to convert because pthread_mutex_timedlock needs absolute timeout based on CLOCK_REALTIME
+                osal_uint64_t to_nsec = osal_timer_to_nsec(to),
+                              act_nsec = osal_timer_gettime_nsec();
+
+                if (act_nsec >= to_nsec) {
+                    // timeout already in the past, only take an available mutex
+                    posix_ret = pthread_mutex_trylock(&mtx->posix_mtx);
+                    if (posix_ret == EBUSY) {
+                        posix_ret = ETIMEDOUT;
+                    }
+                } else {
+                    clock_gettime(CLOCK_REALTIME, &ts);
+                    ts.tv_sec += (to_nsec - act_nsec) / NSEC_PER_SEC;
+                    ts.tv_nsec += (to_nsec - act_nsec) % NSEC_PER_SEC;
+
+                    if (ts.tv_nsec >= NSEC_PER_SEC) {
+                        ts.tv_nsec -= NSEC_PER_SEC;
+                        ts.tv_sec++;
+                    }
+
+                    posix_ret = pthread_mutex_timedlock(&mtx->posix_mtx, &ts);
+                }
+            }
         }
-    } else {
-        ret = OSAL_OK;
     }
 
-    return ret;
+    return posix_mutex_lock_retval(posix_ret);
 }
 
 //! \brief Tries to lock a mutex.
@@ -212,6 +357,34 @@ osal_retval_t osal_mutex_unlock(osal_mutex_t *mtx) {
     return ret;
 }
 
+//! \brief Marks the state of a robust mutex consistent.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_mutex_consistent(osal_mutex_t *mtx) {
+    assert(mtx != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+#if LIBOSAL_HAVE_PTHREAD_MUTEXATTR_SETROBUST == 1
+    int posix_ret = pthread_mutex_consistent(&mtx->posix_mtx);
+    if (posix_ret != 0) {
+        if (posix_ret == EINVAL) {
+            ret = OSAL_ERR_INVALID_PARAM;
+        } else {
+            ret = OSAL_ERR_OPERATION_FAILED;
+        }
+    }
+#else
+    (void)mtx;
+    ret = OSAL_ERR_NOT_IMPLEMENTED;
+#endif
+
+    return ret;
+}
+
 //! \brief Destroys a mutex.
 /*!
  * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
@@ -0,0 +1,503 @@
+/**
+ * \file posix/pool.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL memory pool posix source.
+ *
+ * OSAL fixed-block memory pool posix source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/pool.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LIBOSAL_POOL_MAGIC          0x00B10C50u
+
+#define POSIX_POOL_TAG_SHIFT        32u
+#define POSIX_POOL_IDX(head)        ((osal_uint32_t)(head))     //!< Block index + 1, 0 for empty list.
+#define POSIX_POOL_NEXT_TAG(head)   ((((head) >> POSIX_POOL_TAG_SHIFT) + 1u) << POSIX_POOL_TAG_SHIFT)
+
+//! \brief Round block size up to keep every block 8-byte aligned.
+static osal_uint32_t posix_pool_block_size(osal_size_t block_size) {
+    if (block_size < sizeof(osal_uint64_t)) {
+        block_size = sizeof(osal_uint64_t);
+    }
+
+    return (osal_uint32_t)((block_size + 7u) & ~(osal_size_t)7u);
+}
+
+static void posix_pool_setup_handle(osal_pool_t *pool, osal_void_t *mem) {
+    pool->ctrl          = (osal_pool_ctrl_t *)mem;
+    pool->blocks        = (osal_uint8_t *)mem + sizeof(osal_pool_ctrl_t);
+    pool->block_size    = pool->ctrl->block_size;
+    pool->block_cnt     = pool->ctrl->block_cnt;
+}
+
+//! \brief Free list link in the first word of a free block, index + 1 of next block.
+static inline osal_uint32_t *posix_pool_link(osal_pool_t *pool, osal_uint32_t idx) {
+    return (osal_uint32_t *)&pool->blocks[(osal_size_t)(idx - 1u) * pool->block_size];
+}
+
+//! \brief Block index + 1 of a block pointer, 0 if it is not a block of the pool.
+static osal_uint32_t posix_pool_index(osal_pool_t *pool, osal_void_t *block) {
+    osal_uint32_t ret = 0u;
+    osal_uint8_t *ptr = (osal_uint8_t *)block;
+
+    if ((ptr >= pool->blocks) && (ptr < &pool->blocks[(osal_size_t)pool->block_cnt * pool->block_size])) {
+        osal_size_t off = (osal_size_t)(ptr - pool->blocks);
+
+        if ((off % pool->block_size) == 0u) {
+            ret = (osal_uint32_t)(off / pool->block_size) + 1u;
+        }
+    }
+
+    return ret;
+}
+
+static void posix_pool_stats_add(osal_pool_t *pool, osal_uint32_t cnt) {
+    if ((pool->ctrl->flags & OSAL_POOL_ATTR__STATS) != 0u) {
+        osal_uint32_t used = __atomic_add_fetch(&pool->ctrl->used, cnt, __ATOMIC_RELAXED);
+        osal_uint32_t high = __atomic_load_n(&pool->ctrl->high_water, __ATOMIC_RELAXED);
+
+        while ((used > high) && (__atomic_compare_exchange_n(&pool->ctrl->high_water, &high, used, 1,
+                        __ATOMIC_RELAXED, __ATOMIC_RELAXED) == 0)) {
+            // high reloaded by failed exchange
+        }
+    }
+}
+
+static void posix_pool_stats_failed(osal_pool_t *pool) {
+    if ((pool->ctrl->flags & OSAL_POOL_ATTR__STATS) != 0u) {
+        (void)__atomic_add_fetch(&pool->ctrl->failed, 1u, __ATOMIC_RELAXED);
+    }
+}
+
+static void posix_pool_stats_sub(osal_pool_t *pool, osal_uint32_t cnt) {
+    if ((pool->ctrl->flags & OSAL_POOL_ATTR__STATS) != 0u) {
+        (void)__atomic_sub_fetch(&pool->ctrl->used, cnt, __ATOMIC_RELAXED);
+    }
+}
+
+//! \brief Pop one block from the free list, returns index + 1 or 0 if empty.
+static osal_uint32_t posix_pool_pop(osal_pool_t *pool) {
+    osal_uint64_t head = __atomic_load_n(&pool->ctrl->head, __ATOMIC_ACQUIRE);
+    osal_uint64_t new_head = 0u;
+    osal_uint32_t idx = POSIX_POOL_IDX(head);
+
+    while (idx != 0u) {
+        // block may be taken meanwhile, then the tag has changed and the exchange fails
+        osal_uint32_t next = __atomic_load_n(posix_pool_link(pool, idx), __ATOMIC_RELAXED);
+        new_head = POSIX_POOL_NEXT_TAG(head) | next;
+
+        if (__atomic_compare_exchange_n(&pool->ctrl->head, &head, new_head, 1,
+                    __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        idx = POSIX_POOL_IDX(head);
+    }
+
+    return idx;
+}
+
+//! \brief Push a chain of blocks already linked from first to last onto the free list.
+static void posix_pool_push(osal_pool_t *pool, osal_uint32_t first, osal_uint32_t last) {
+    osal_uint64_t head = __atomic_load_n(&pool->ctrl->head, __ATOMIC_RELAXED);
+    osal_uint64_t new_head;
+
+    do {
+        __atomic_store_n(posix_pool_link(pool, last), POSIX_POOL_IDX(head), __ATOMIC_RELAXED);
+        new_head = POSIX_POOL_NEXT_TAG(head) | first;
+    } while (__atomic_compare_exchange_n(&pool->ctrl->head, &head, new_head, 1,
+                __ATOMIC_RELEASE, __ATOMIC_RELAXED) == 0);
+}
+
+//! \brief Get size of memory region needed for a pool.
+/*!
+ * \param[in]   block_size  Size of one block in bytes.
+ * \param[in]   block_cnt   Number of blocks.
+ *
+ * \return Needed size in bytes, 0 on invalid parameters or if the size
+ *         overflows osal_size_t.
+ */
+osal_size_t osal_pool_get_size(osal_size_t block_size, osal_uint32_t block_cnt) {
+    osal_size_t ret = 0u;
+
+    if ((block_size > 0u) && (block_size <= 0xFFFFFFF8u) && (block_cnt > 0u) && (block_cnt < 0xFFFFFFFFu)) {
+        osal_size_t size = posix_pool_block_size(block_size);
+
+        // blocks and control block have to fit into osal_size_t, e.g. on 32 bit
+        if (block_cnt <= ((SIZE_MAX - sizeof(osal_pool_ctrl_t)) / size)) {
+            ret = sizeof(osal_pool_ctrl_t) + (size * block_cnt);
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Initialize a pool in a memory region.
+/*!
+ * \param[out]  pool        Pointer to osal pool handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ * \param[in]   block_size  Size of one block in bytes.
+ * \param[in]   block_cnt   Number of blocks.
+ * \param[in]   attr        Pointer to pool attributes. Can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_init(osal_pool_t *pool, osal_void_t *mem, osal_size_t mem_size,
+        osal_size_t block_size, osal_uint32_t block_cnt, const osal_pool_attr_t *attr)
+{
+    assert(pool != NULL);
+    assert(mem != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_size_t needed = osal_pool_get_size(block_size, block_cnt);
+
+    if ((needed == 0u) || (needed > mem_size)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        osal_pool_ctrl_t *ctrl = (osal_pool_ctrl_t *)mem;
+
+        __atomic_store_n(&ctrl->magic, 0u, __ATOMIC_RELAXED);
+        memset(ctrl, 0, sizeof(osal_pool_ctrl_t));
+
+        ctrl->flags         = attr != NULL ? *attr : 0u;
+        ctrl->block_size    = posix_pool_block_size(block_size);
+        ctrl->block_cnt     = block_cnt;
+
+        posix_pool_setup_handle(pool, mem);
+        pool->mem_alloc     = NULL;
+
+        if ((ctrl->flags & OSAL_POOL_ATTR__PREFAULT) != 0u) {
+            // take all page faults now instead of on first use in a real-time path
+            memset(pool->blocks, 0, (osal_size_t)pool->block_size * pool->block_cnt);
+        }
+
+        for (osal_uint32_t idx = 1u; idx < block_cnt; ++idx) {
+            *posix_pool_link(pool, idx) = idx + 1u;
+        }
+        *posix_pool_link(pool, block_cnt) = 0u;
+        ctrl->head = 1u;
+
+        // publish initialized control block to attaching side
+        __atomic_store_n(&ctrl->magic, LIBOSAL_POOL_MAGIC, __ATOMIC_RELEASE);
+    }
+
+    return ret;
+}
+
+//! \brief Allocate a region and initialize a pool in it.
+/*!
+ * \param[out]  pool        Pointer to osal pool handle.
+ * \param[in]   block_size  Size of one block in bytes.
+ * \param[in]   block_cnt   Number of blocks.
+ * \param[in]   attr        Pointer to pool attributes. Can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_create(osal_pool_t *pool, osal_size_t block_size, osal_uint32_t block_cnt,
+        const osal_pool_attr_t *attr)
+{
+    assert(pool != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_size_t needed = osal_pool_get_size(block_size, block_cnt);
+    osal_void_t *mem_alloc = NULL;
+
+    if (needed == 0u) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        mem_alloc = malloc(needed + OSAL_CACHE_LINE_SIZE);
+        if (mem_alloc == NULL) {
+            ret = OSAL_ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        // blocks are cache line aligned like in a shared memory mapping
+        osal_size_t addr = (osal_size_t)(uintptr_t)mem_alloc;
+        addr = (addr + OSAL_CACHE_LINE_SIZE - 1u) & ~(osal_size_t)(OSAL_CACHE_LINE_SIZE - 1u);
+
+        ret = osal_pool_init(pool, (osal_void_t *)(uintptr_t)addr, needed, block_size, block_cnt, attr);
+        if (ret == OSAL_OK) {
+            pool->mem_alloc = mem_alloc;
+        } else {
+            free(mem_alloc);
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Attach to a pool initialized by someone else.
+/*!
+ * \param[out]  pool        Pointer to osal pool handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_attach(osal_pool_t *pool, osal_void_t *mem, osal_size_t mem_size) {
+    assert(pool != NULL);
+    assert(mem != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_pool_ctrl_t *ctrl = (osal_pool_ctrl_t *)mem;
+
+    if (mem_size < sizeof(osal_pool_ctrl_t)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else if (__atomic_load_n(&ctrl->magic, __ATOMIC_ACQUIRE) != LIBOSAL_POOL_MAGIC) {
+        ret = OSAL_ERR_UNAVAILABLE;
+    } else if (osal_pool_get_size(ctrl->block_size, ctrl->block_cnt) > mem_size) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        posix_pool_setup_handle(pool, mem);
+        pool->mem_alloc = NULL;
+    }
+
+    return ret;
+}
+
+//! \brief Destroys a pool handle.
+/*!
+ * \param[in]   pool        Pointer to osal pool handle.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_destroy(osal_pool_t *pool) {
+    assert(pool != NULL);
+
+    if (pool->mem_alloc != NULL) {
+        free(pool->mem_alloc);
+        pool->mem_alloc = NULL;
+    }
+
+    pool->ctrl = NULL;
+    pool->blocks = NULL;
+
+    return OSAL_OK;
+}
+
+//! \brief Allocate a block.
+/*!
+ * \param[in]   pool        Pointer to osal pool handle.
+ * \param[out]  block       Returns pointer to the block.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_alloc(osal_pool_t *pool, osal_void_t **block) {
+    assert(pool != NULL);
+    assert(block != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_uint32_t idx = posix_pool_pop(pool);
+
+    if (idx == 0u) {
+        posix_pool_stats_failed(pool);
+        ret = OSAL_ERR_OUT_OF_MEMORY;
+    } else {
+        posix_pool_stats_add(pool, 1u);
+        *block = posix_pool_link(pool, idx);
+    }
+
+    return ret;
+}
+
+//! \brief Free a block.
+/*!
+ * \param[in]   pool        Pointer to osal pool handle.
+ * \param[in]   block       Block returned by \ref osal_pool_alloc.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_free(osal_pool_t *pool, osal_void_t *block) {
+    assert(pool != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_uint32_t idx = posix_pool_index(pool, block);
+
+    if (idx == 0u) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        posix_pool_stats_sub(pool, 1u);
+        posix_pool_push(pool, idx, idx);
+    }
+
+    return ret;
+}
+
+//! \brief Get pool statistics.
+/*!
+ * \param[in]   pool        Pointer to osal pool handle.
+ * \param[out]  stats       Returns the statistics.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_get_stats(osal_pool_t *pool, osal_pool_stats_t *stats) {
+    assert(pool != NULL);
+    assert(stats != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    if ((pool->ctrl->flags & OSAL_POOL_ATTR__STATS) == 0u) {
+        ret = OSAL_ERR_UNAVAILABLE;
+    } else {
+        stats->block_size   = pool->block_size;
+        stats->block_cnt    = pool->block_cnt;
+        stats->used         = __atomic_load_n(&pool->ctrl->used, __ATOMIC_RELAXED);
+        stats->high_water   = __atomic_load_n(&pool->ctrl->high_water, __ATOMIC_RELAXED);
+        stats->failed       = __atomic_load_n(&pool->ctrl->failed, __ATOMIC_RELAXED);
+    }
+
+    return ret;
+}
+
+//! \brief Initialize a task local block cache.
+/*!
+ * \param[out]  cache       Pointer to osal pool cache.
+ * \param[in]   pool        Pointer to osal pool handle.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_cache_init(osal_pool_cache_t *cache, osal_pool_t *pool) {
+    assert(cache != NULL);
+    assert(pool != NULL);
+
+    cache->pool = pool;
+    cache->cnt = 0u;
+
+    return OSAL_OK;
+}
+
+//! \brief Allocate a block through a task cache.
+/*!
+ * \param[in]   cache       Pointer to osal pool cache.
+ * \param[out]  block       Returns pointer to the block.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_cache_alloc(osal_pool_cache_t *cache, osal_void_t **block) {
+    assert(cache != NULL);
+    assert(block != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_pool_t *pool = cache->pool;
+
+    if (cache->cnt == 0u) {
+        // refill half of the cache, keeps the next frees local too
+        osal_uint32_t idx = posix_pool_pop(pool);
+
+        while ((idx != 0u) && (cache->cnt < (OSAL_POOL_CACHE_SIZE / 2u))) {
+            cache->idx[cache->cnt++] = idx;
+
+            if (cache->cnt < (OSAL_POOL_CACHE_SIZE / 2u)) {
+                idx = posix_pool_pop(pool);
+            }
+        }
+
+        posix_pool_stats_add(pool, cache->cnt);
+    }
+
+    if (cache->cnt == 0u) {
+        posix_pool_stats_failed(pool);
+        ret = OSAL_ERR_OUT_OF_MEMORY;
+    } else {
+        *block = posix_pool_link(pool, cache->idx[--cache->cnt]);
+    }
+
+    return ret;
+}
+
+//! \brief Free a block through a task cache.
+/*!
+ * \param[in]   cache       Pointer to osal pool cache.
+ * \param[in]   block       Block of the cache's pool.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_cache_free(osal_pool_cache_t *cache, osal_void_t *block) {
+    assert(cache != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_pool_t *pool = cache->pool;
+    osal_uint32_t idx = posix_pool_index(pool, block);
+
+    if (idx == 0u) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        if (cache->cnt == OSAL_POOL_CACHE_SIZE) {
+            // give the older half back as one chain
+            osal_uint32_t spill = OSAL_POOL_CACHE_SIZE / 2u;
+
+            for (osal_uint32_t i = 0u; (i + 1u) < spill; ++i) {
+                *posix_pool_link(pool, cache->idx[i]) = cache->idx[i + 1u];
+            }
+
+            posix_pool_stats_sub(pool, spill);
+            posix_pool_push(pool, cache->idx[0], cache->idx[spill - 1u]);
+
+            (void)memmove(&cache->idx[0], &cache->idx[spill], (cache->cnt - spill) * sizeof(cache->idx[0]));
+            cache->cnt -= spill;
+        }
+
+        cache->idx[cache->cnt++] = idx;
+    }
+
+    return ret;
+}
+
+//! \brief Return all cached blocks to the pool.
+/*!
+ * \param[in]   cache       Pointer to osal pool cache.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_pool_cache_flush(osal_pool_cache_t *cache) {
+    assert(cache != NULL);
+
+    osal_pool_t *pool = cache->pool;
+
+    if (cache->cnt > 0u) {
+        for (osal_uint32_t i = 0u; (i + 1u) < cache->cnt; ++i) {
+            *posix_pool_link(pool, cache->idx[i]) = cache->idx[i + 1u];
+        }
+
+        posix_pool_stats_sub(pool, cache->cnt);
+        posix_pool_push(pool, cache->idx[0], cache->idx[cache->cnt - 1u]);
+        cache->cnt = 0u;
+    }
+
+    return OSAL_OK;
+}
+
@@ -0,0 +1,258 @@
+/**
+ * \file posix/rt.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL real-time process setup posix source.
+ *
+ * OSAL real-time process setup posix source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/rt.h>
+#include <assert.h>
+
+#include <alloca.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if LIBOSAL_HAVE_MALLOPT == 1
+#include <malloc.h>
+#endif
+
+#define POSIX_RT_DMA_LATENCY_DEV    "/dev/cpu_dma_latency"
+
+// the latency request is dropped by the kernel when the file is closed
+static int posix_rt_dma_latency_fd = -1;
+// only pages locked by osal_rt_setup are unlocked again
+static osal_bool_t posix_rt_mlocked = OSAL_FALSE;
+// serializes osal_rt_setup and osal_rt_release, guards the state above
+static pthread_mutex_t posix_rt_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static osal_size_t posix_rt_page_size(void) {
+    long page_size = sysconf(_SC_PAGESIZE);
+
+    return page_size > 0 ? (osal_size_t)page_size : 4096u;
+}
+
+//! \brief Touch one byte per page, volatile keeps the compiler from dropping the writes.
+static void posix_rt_touch(volatile osal_uint8_t *mem, osal_size_t size) {
+    osal_size_t page_size = posix_rt_page_size();
+
+    for (osal_size_t pos = 0u; pos < size; pos += page_size) {
+        mem[pos] = 0u;
+    }
+}
+
+//! \brief Record the outcome of a single setup step.
+static void posix_rt_step(osal_rt_setup_result_t *result, osal_uint32_t step, int local_errno) {
+    if (local_errno == 0) {
+        result->done |= step;
+    } else {
+        result->failed |= step;
+
+        // mlockall reports an exceeded RLIMIT_MEMLOCK without CAP_IPC_LOCK as ENOMEM
+        if ((local_errno == EPERM) || (local_errno == EACCES) ||
+                ((step == OSAL_RT_SETUP__MLOCKALL) && (local_errno == ENOMEM))) {
+            result->denied |= step;
+        }
+    }
+}
+
+static int posix_rt_malloc_tuning(void) {
+    int local_errno = 0;
+
+#if LIBOSAL_HAVE_MALLOPT == 1
+    // freed memory stays in the heap and large blocks do not get fresh mappings
+    if ((mallopt(M_TRIM_THRESHOLD, -1) != 1) || (mallopt(M_MMAP_MAX, 0) != 1)) {
+        local_errno = EINVAL;
+    }
+#else
+    local_errno = ENOSYS;
+#endif
+
+    return local_errno;
+}
+
+static int posix_rt_heap_prefault(osal_size_t size) {
+    int local_errno = 0;
+    osal_uint8_t *mem = (osal_uint8_t *)malloc(size);
+
+    if (mem == NULL) {
+        local_errno = ENOMEM;
+    } else {
+        posix_rt_touch(mem, size);
+        free(mem);
+    }
+
+    return local_errno;
+}
+
+static int posix_rt_dma_latency(osal_int32_t latency) {
+    int local_errno = 0;
+
+    if (posix_rt_dma_latency_fd == -1) {
+        posix_rt_dma_latency_fd = open(POSIX_RT_DMA_LATENCY_DEV, O_RDWR | O_CLOEXEC);
+        if (posix_rt_dma_latency_fd == -1) {
+            local_errno = errno;
+        }
+    }
+
+    // writing again to an open request only updates the latency
+    if (local_errno == 0) {
+        ssize_t written = write(posix_rt_dma_latency_fd, &latency, sizeof(latency));
+        if (written != (ssize_t)sizeof(latency)) {
+            local_errno = written == -1 ? errno : EIO;
+            (void)close(posix_rt_dma_latency_fd);
+            posix_rt_dma_latency_fd = -1;
+        }
+    }
+
+    return local_errno;
+}
+
+//! \brief Prepare the process for real-time operation.
+/*!
+ * \param[in]   attr    Pointer to setup attributes. Can be NULL to perform
+ *                      all steps with the default sizes and latency 0.
+ * \param[out]  result  Returns the outcome of each step. Can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rt_setup(const osal_rt_setup_attr_t *attr, osal_rt_setup_result_t *result) {
+    osal_retval_t ret = OSAL_OK;
+    osal_rt_setup_attr_t local_attr = {
+        .steps = OSAL_RT_SETUP__ALL,
+        .heap_reserve = OSAL_RT_SETUP_HEAP_RESERVE_DEFAULT,
+        .stack_prefault = OSAL_RT_SETUP_STACK_PREFAULT_DEFAULT,
+        .dma_latency = 0,
+    };
+    osal_rt_setup_result_t local_result = { 0u, 0u, 0u };
+
+    if (attr != NULL) {
+        local_attr = *attr;
+    }
+
+    if (((local_attr.steps & ~OSAL_RT_SETUP__ALL) != 0u) || (local_attr.dma_latency < 0)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        (void)pthread_mutex_lock(&posix_rt_lock);
+
+        // without tuning the prefaulted heap is handed back to the kernel on free
+        if ((local_attr.steps & OSAL_RT_SETUP__HEAP_PREFAULT) != 0u) {
+            local_attr.steps |= OSAL_RT_SETUP__MALLOC_TUNING;
+        }
+
+        if ((local_attr.steps & OSAL_RT_SETUP__MALLOC_TUNING) != 0u) {
+            posix_rt_step(&local_result, OSAL_RT_SETUP__MALLOC_TUNING, posix_rt_malloc_tuning());
+        }
+
+        if ((local_attr.steps & OSAL_RT_SETUP__MLOCKALL) != 0u) {
+            int local_errno = 0;
+            if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+                local_errno = errno;
+            } else {
+                posix_rt_mlocked = OSAL_TRUE;
+            }
+
+            posix_rt_step(&local_result, OSAL_RT_SETUP__MLOCKALL, local_errno);
+        }
+
+        if ((local_attr.steps & OSAL_RT_SETUP__HEAP_PREFAULT) != 0u) {
+            posix_rt_step(&local_result, OSAL_RT_SETUP__HEAP_PREFAULT,
+                    (local_result.failed & OSAL_RT_SETUP__MALLOC_TUNING) != 0u ? ENOSYS :
+                    posix_rt_heap_prefault(local_attr.heap_reserve));
+        }
+
+        if ((local_attr.steps & OSAL_RT_SETUP__STACK_PREFAULT) != 0u) {
+            (void)osal_rt_prefault_stack(local_attr.stack_prefault);
+            posix_rt_step(&local_result, OSAL_RT_SETUP__STACK_PREFAULT, 0);
+        }
+
+        if ((local_attr.steps & OSAL_RT_SETUP__DMA_LATENCY) != 0u) {
+            posix_rt_step(&local_result, OSAL_RT_SETUP__DMA_LATENCY,
+                    posix_rt_dma_latency(local_attr.dma_latency));
+        }
+
+        (void)pthread_mutex_unlock(&posix_rt_lock);
+
+        if (local_result.denied != 0u) {
+            ret = OSAL_ERR_PERMISSION_DENIED;
+        } else if (local_result.failed != 0u) {
+            ret = OSAL_ERR_OPERATION_FAILED;
+        }
+    }
+
+    if (result != NULL) {
+        *result = local_result;
+    }
+
+    return ret;
+}
+
+//! \brief Prefault the stack of the calling task.
+/*!
+ * \param[in]   size    Number of stack bytes to prefault, has to be smaller
+ *                      than the remaining stack of the calling task.
+ *
+ * \return OK or ERROR_CODE.
+ */
+__attribute__((noinline)) osal_retval_t osal_rt_prefault_stack(osal_size_t size) {
+    if (size > 0u) {
+        volatile osal_uint8_t *stack = (volatile osal_uint8_t *)alloca(size);
+        posix_rt_touch(stack, size);
+    }
+
+    return OSAL_OK;
+}
+
+//! \brief Release the process wide real-time settings.
+/*!
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rt_release(void) {
+    (void)pthread_mutex_lock(&posix_rt_lock);
+
+    if (posix_rt_dma_latency_fd != -1) {
+        (void)close(posix_rt_dma_latency_fd);
+        posix_rt_dma_latency_fd = -1;
+    }
+
+    if (posix_rt_mlocked == OSAL_TRUE) {
+        (void)munlockall();
+        posix_rt_mlocked = OSAL_FALSE;
+    }
+
+    (void)pthread_mutex_unlock(&posix_rt_lock);
+
+    return OSAL_OK;
+}
+
@@ -0,0 +1,510 @@
+/**
+ * \file posix/rwlock.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL reader-writer lock posix source.
+ *
+ * OSAL reader-writer lock posix source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#define _GNU_SOURCE
+
+#include <libosal/osal.h>
+#include <libosal/rwlock.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "futex.h"
+
+#define POSIX_RWLOCK_ATTR__ALL          (OSAL_RWLOCK_ATTR__PREFER_WRITER | OSAL_RWLOCK_ATTR__PROCESS_SHARED | \
+                                         OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT | OSAL_RWLOCK_ATTR__PER_CPU)
+
+#if LIBOSAL_HAVE_PTHREAD_RWLOCKATTR_SETKIND_NP == 1
+#define POSIX_RWLOCK_ATTR__OWN          (OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT | OSAL_RWLOCK_ATTR__PER_CPU)
+#else
+//! Without pthread writer preference the own lock is used, it always prefers writers.
+#define POSIX_RWLOCK_ATTR__OWN          (OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT | OSAL_RWLOCK_ATTR__PER_CPU | \
+                                         OSAL_RWLOCK_ATTR__PREFER_WRITER)
+#endif
+
+//! Lock is implemented here instead of using a pthread rwlock.
+#define POSIX_RWLOCK_OWN(rwl)           (((rwl)->attr & POSIX_RWLOCK_ATTR__OWN) != 0u)
+#define POSIX_RWLOCK_SHARED(rwl)        (((rwl)->attr & OSAL_RWLOCK_ATTR__PROCESS_SHARED) != 0u ? OSAL_TRUE : OSAL_FALSE)
+
+#define POSIX_RWLOCK_STATE__FREE        0u      //!< No writer, readers may enter.
+#define POSIX_RWLOCK_STATE__DRAINING    1u      //!< Writer waits for readers to leave.
+#define POSIX_RWLOCK_STATE__LOCKED      2u      //!< Locked by writer.
+
+static osal_retval_t posix_rwlock_retval(int posix_ret) {
+    osal_retval_t ret = OSAL_OK;
+
+    if (posix_ret == 0) {
+        ret = OSAL_OK;
+    } else if (posix_ret == EBUSY) {
+        ret = OSAL_ERR_BUSY;
+    } else if (posix_ret == ETIMEDOUT) {
+        ret = OSAL_ERR_TIMEOUT;
+    } else if (posix_ret == EDEADLK) {
+        ret = OSAL_ERR_DEAD_LOCK;
+    } else if (posix_ret == EAGAIN) {
+        ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
+    } else if (posix_ret == ENOMEM) {
+        ret = OSAL_ERR_OUT_OF_MEMORY;
+    } else if (posix_ret == EPERM) {
+        ret = OSAL_ERR_PERMISSION_DENIED;
+    } else if (posix_ret == EINVAL) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        ret = OSAL_ERR_UNAVAILABLE;
+    }
+
+    return ret;
+}
+
+static int posix_rwlock_pthread_timedlock(osal_rwlock_t *rwl, const osal_timer_t *to, osal_bool_t write) {
+    int posix_ret = EINVAL;
+    struct timespec ts;
+    ts.tv_sec = to->sec;
+    ts.tv_nsec = to->nsec;
+
+    if (global_clock_id == CLOCK_REALTIME) {
+        posix_ret = write == OSAL_TRUE ? pthread_rwlock_timedwrlock(&rwl->posix_rwlock, &ts) : 
+            pthread_rwlock_timedrdlock(&rwl->posix_rwlock, &ts);
+    } else {
+#if LIBOSAL_HAVE_PTHREAD_RWLOCK_CLOCKRDLOCK == 1
+        posix_ret = write == OSAL_TRUE ? pthread_rwlock_clockwrlock(&rwl->posix_rwlock, global_clock_id, &ts) : 
+            pthread_rwlock_clockrdlock(&rwl->posix_rwlock, global_clock_id, &ts);
+#endif
+
+        if (posix_ret == EINVAL) {
+            // need to convert because pthread_rwlock_timed*lock needs absolute timeout based on CLOCK_REALTIME
+            osal_uint64_t to_nsec = osal_timer_to_nsec(to),
+                          act_nsec = osal_timer_gettime_nsec();
+
+            if (act_nsec >= to_nsec) {
+                posix_ret = write == OSAL_TRUE ? pthread_rwlock_trywrlock(&rwl->posix_rwlock) : 
+                    pthread_rwlock_tryrdlock(&rwl->posix_rwlock);
+                if (posix_ret == EBUSY) {
+                    posix_ret = ETIMEDOUT;
+                }
+            } else {
+                clock_gettime(CLOCK_REALTIME, &ts);
+                ts.tv_sec += (to_nsec - act_nsec) / NSEC_PER_SEC;
+                ts.tv_nsec += (to_nsec - act_nsec) % NSEC_PER_SEC;
+
+                if (ts.tv_nsec >= NSEC_PER_SEC) {
+                    ts.tv_nsec -= NSEC_PER_SEC;
+                    ts.tv_sec++;
+                }
+
+                posix_ret = write == OSAL_TRUE ? pthread_rwlock_timedwrlock(&rwl->posix_rwlock, &ts) : 
+                    pthread_rwlock_timedrdlock(&rwl->posix_rwlock, &ts);
+            }
+        }
+    }
+
+    return posix_ret;
+}
+
+//! Reader counter of the calling task's CPU.
+static osal_int32_t *posix_rwlock_reader_slot(osal_rwlock_t *rwl) {
+    osal_int32_t *cnt = &rwl->readers;
+
+    if (rwl->slots != NULL) {
+        int cpu = sched_getcpu();
+        if (cpu < 0) {
+            cpu = 0;
+        }
+
+        // a task may migrate and unlock on another CPU, only the sum is meaningful
+        cnt = &rwl->slots[(osal_uint32_t)cpu % rwl->slot_cnt].readers;
+    }
+
+    return cnt;
+}
+
+//! Sum of readers, counters are seen after the writer announced itself.
+static osal_int32_t posix_rwlock_reader_sum(osal_rwlock_t *rwl) {
+    osal_int32_t sum = 0;
+
+    if (rwl->slots != NULL) {
+        for (osal_uint32_t i = 0u; i < rwl->slot_cnt; ++i) {
+            sum += __atomic_load_n(&rwl->slots[i].readers, __ATOMIC_SEQ_CST);
+        }
+    } else {
+        sum = __atomic_load_n(&rwl->readers, __ATOMIC_SEQ_CST);
+    }
+
+    return sum;
+}
+
+static void posix_rwlock_reader_leave(osal_rwlock_t *rwl, osal_int32_t *cnt) {
+    (void)__atomic_fetch_sub(cnt, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&rwl->state, __ATOMIC_SEQ_CST) == POSIX_RWLOCK_STATE__DRAINING) {
+        (void)__atomic_fetch_add(&rwl->drain, 1u, __ATOMIC_SEQ_CST);
+        posix_futex_wake(&rwl->drain, 1u, POSIX_RWLOCK_SHARED(rwl));
+    }
+}
+
+static osal_retval_t posix_rwlock_own_rdlock(osal_rwlock_t *rwl, const osal_timer_t *to, osal_bool_t try_only) {
+    osal_retval_t ret = OSAL_OK;
+    osal_bool_t locked = OSAL_FALSE;
+
+    while ((ret == OSAL_OK) && (locked == OSAL_FALSE)) {
+        osal_int32_t *cnt = posix_rwlock_reader_slot(rwl);
+
+        // announce first, a writer setting its state afterwards sees us
+        (void)__atomic_fetch_add(cnt, 1, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&rwl->state, __ATOMIC_SEQ_CST) == POSIX_RWLOCK_STATE__FREE) {
+            locked = OSAL_TRUE;
+        } else {
+            // back off on the same counter, writer may be summing up right now
+            posix_rwlock_reader_leave(rwl, cnt);
+
+            if (try_only == OSAL_TRUE) {
+                ret = OSAL_ERR_BUSY;
+            } else {
+                // writer holds the mutex until it unlocks, with priority inheritance this boosts it
+                ret = to == NULL ? osal_mutex_lock(&rwl->wr_mtx) : osal_mutex_timedlock(&rwl->wr_mtx, to);
+                if (ret == OSAL_OK) {
+                    ret = osal_mutex_unlock(&rwl->wr_mtx);
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+static osal_retval_t posix_rwlock_own_wrlock(osal_rwlock_t *rwl, const osal_timer_t *to, osal_bool_t try_only) {
+    osal_retval_t ret;
+
+    if (try_only == OSAL_TRUE) {
+        ret = osal_mutex_trylock(&rwl->wr_mtx);
+    } else if (to == NULL) {
+        ret = osal_mutex_lock(&rwl->wr_mtx);
+    } else {
+        ret = osal_mutex_timedlock(&rwl->wr_mtx, to);
+    }
+
+    if (ret == OSAL_OK) {
+        osal_uint32_t seq = __atomic_load_n(&rwl->drain, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&rwl->state, POSIX_RWLOCK_STATE__DRAINING, __ATOMIC_SEQ_CST);
+
+        while ((ret == OSAL_OK) && (posix_rwlock_reader_sum(rwl) != 0)) {
+            if (try_only == OSAL_TRUE) {
+                ret = OSAL_ERR_BUSY;
+            } else {
+                ret = posix_futex_wait(&rwl->drain, seq, to, POSIX_RWLOCK_SHARED(rwl));
+                if ((ret == OSAL_ERR_TIMEOUT) && (posix_rwlock_reader_sum(rwl) == 0)) {
+                    ret = OSAL_OK;
+                }
+
+                seq = __atomic_load_n(&rwl->drain, __ATOMIC_SEQ_CST);
+            }
+        }
+
+        if (ret == OSAL_OK) {
+            __atomic_store_n(&rwl->state, POSIX_RWLOCK_STATE__LOCKED, __ATOMIC_SEQ_CST);
+        } else {
+            // let readers which backed off in again
+            __atomic_store_n(&rwl->state, POSIX_RWLOCK_STATE__FREE, __ATOMIC_SEQ_CST);
+            (void)osal_mutex_unlock(&rwl->wr_mtx);
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Initialize a reader-writer lock.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ * \param[in]   attr    Pointer to reader-writer lock attributes. Can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rwlock_init(osal_rwlock_t *rwl, const osal_rwlock_attr_t *attr) {
+    assert(rwl != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    memset(rwl, 0, sizeof(osal_rwlock_t));
+    if (attr != NULL) {
+        rwl->attr = *attr;
+    }
+
+    if (((rwl->attr & ~POSIX_RWLOCK_ATTR__ALL) != 0u) ||
+            (((rwl->attr & OSAL_RWLOCK_ATTR__PER_CPU) != 0u) && 
+             ((rwl->attr & OSAL_RWLOCK_ATTR__PROCESS_SHARED) != 0u))) {
+        // per-CPU counters are allocated and can not be shared
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else if (POSIX_RWLOCK_OWN(rwl)) {
+        osal_mutex_attr_t mtx_attr = OSAL_MUTEX_ATTR__TYPE__NORMAL;
+
+        if ((rwl->attr & OSAL_RWLOCK_ATTR__PROCESS_SHARED) != 0u) {
+            mtx_attr |= OSAL_MUTEX_ATTR__PROCESS_SHARED;
+        }
+        if ((rwl->attr & OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT) != 0u) {
+            mtx_attr |= OSAL_MUTEX_ATTR__PROTOCOL__INHERIT;
+        }
+
+        ret = osal_mutex_init(&rwl->wr_mtx, &mtx_attr);
+
+        if ((ret == OSAL_OK) && ((rwl->attr & OSAL_RWLOCK_ATTR__PER_CPU) != 0u)) {
+            long cpus = sysconf(_SC_NPROCESSORS_CONF);
+            rwl->slot_cnt = cpus > 0 ? (osal_uint32_t)cpus : 1u;
+
+            // counters are cache line aligned to avoid false sharing between CPUs
+            rwl->slots_mem = malloc((sizeof(osal_rwlock_slot_t) * rwl->slot_cnt) + OSAL_CACHE_LINE_SIZE);
+            if (rwl->slots_mem == NULL) {
+                (void)osal_mutex_destroy(&rwl->wr_mtx);
+                ret = OSAL_ERR_OUT_OF_MEMORY;
+            } else {
+                osal_size_t addr = (osal_size_t)(uintptr_t)rwl->slots_mem;
+                addr = (addr + OSAL_CACHE_LINE_SIZE - 1u) & ~(osal_size_t)(OSAL_CACHE_LINE_SIZE - 1u);
+                rwl->slots = (osal_rwlock_slot_t *)(uintptr_t)addr;
+                memset(rwl->slots, 0, sizeof(osal_rwlock_slot_t) * rwl->slot_cnt);
+            }
+        }
+    } else {
+        pthread_rwlockattr_t posix_attr;
+        int posix_ret = pthread_rwlockattr_init(&posix_attr);
+
+        if ((posix_ret == 0) && ((rwl->attr & OSAL_RWLOCK_ATTR__PROCESS_SHARED) != 0u)) {
+            posix_ret = pthread_rwlockattr_setpshared(&posix_attr, PTHREAD_PROCESS_SHARED);
+        }
+
+#if LIBOSAL_HAVE_PTHREAD_RWLOCKATTR_SETKIND_NP == 1
+        if ((posix_ret == 0) && ((rwl->attr & OSAL_RWLOCK_ATTR__PREFER_WRITER) != 0u)) {
+            posix_ret = pthread_rwlockattr_setkind_np(&posix_attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+        }
+#endif
+
+        if (posix_ret == 0) {
+            posix_ret = pthread_rwlock_init(&rwl->posix_rwlock, &posix_attr);
+        }
+
+        (void)pthread_rwlockattr_destroy(&posix_attr);
+        ret = posix_rwlock_retval(posix_ret);
+    }
+
+    return ret;
+}
+
+//! \brief Locks a reader-writer lock for reading.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rwlock_rdlock(osal_rwlock_t *rwl) {
+    assert(rwl != NULL);
+
+    osal_retval_t ret;
+
+    if (POSIX_RWLOCK_OWN(rwl)) {
+        ret = posix_rwlock_own_rdlock(rwl, NULL, OSAL_FALSE);
+    } else {
+        ret = posix_rwlock_retval(pthread_rwlock_rdlock(&rwl->posix_rwlock));
+    }
+
+    return ret;
+}
+
+//! \brief Tries to lock a reader-writer lock for reading.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rwlock_tryrdlock(osal_rwlock_t *rwl) {
+    assert(rwl != NULL);
+
+    osal_retval_t ret;
+
+    if (POSIX_RWLOCK_OWN(rwl)) {
+        ret = posix_rwlock_own_rdlock(rwl, NULL, OSAL_TRUE);
+    } else {
+        ret = posix_rwlock_retval(pthread_rwlock_tryrdlock(&rwl->posix_rwlock));
+    }
+
+    return ret;
+}
+
+//! \brief Locks a reader-writer lock for reading with timeout.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rwlock_timedrdlock(osal_rwlock_t *rwl, const osal_timer_t *to) {
+    assert(rwl != NULL);
+    assert(to != NULL);
+
+    osal_retval_t ret;
+
+    if (POSIX_RWLOCK_OWN(rwl)) {
+        ret = posix_rwlock_own_rdlock(rwl, to, OSAL_FALSE);
+    } else {
+        ret = posix_rwlock_retval(posix_rwlock_pthread_timedlock(rwl, to, OSAL_FALSE));
+    }
+
+    return ret;
+}
+
+//! \brief Locks a reader-writer lock for writing.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rwlock_wrlock(osal_rwlock_t *rwl) {
+    assert(rwl != NULL);
+
+    osal_retval_t ret;
+
+    if (POSIX_RWLOCK_OWN(rwl)) {
+        ret = posix_rwlock_own_wrlock(rwl, NULL, OSAL_FALSE);
+    } else {
+        ret = posix_rwlock_retval(pthread_rwlock_wrlock(&rwl->posix_rwlock));
+    }
+
+    return ret;
+}
+
+//! \brief Tries to lock a reader-writer lock for writing.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rwlock_trywrlock(osal_rwlock_t *rwl) {
+    assert(rwl != NULL);
+
+    osal_retval_t ret;
+
+    if (POSIX_RWLOCK_OWN(rwl)) {
+        ret = posix_rwlock_own_wrlock(rwl, NULL, OSAL_TRUE);
+    } else {
+        ret = posix_rwlock_retval(pthread_rwlock_trywrlock(&rwl->posix_rwlock));
+    }
+
+    return ret;
+}
+
+//! \brief Locks a reader-writer lock for writing with timeout.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rwlock_timedwrlock(osal_rwlock_t *rwl, const osal_timer_t *to) {
+    assert(rwl != NULL);
+    assert(to != NULL);
+
+    osal_retval_t ret;
+
+    if (POSIX_RWLOCK_OWN(rwl)) {
+        ret = posix_rwlock_own_wrlock(rwl, to, OSAL_FALSE);
+    } else {
+        ret = posix_rwlock_retval(posix_rwlock_pthread_timedlock(rwl, to, OSAL_TRUE));
+    }
+
+    return ret;
+}
+
+//! \brief Unlocks a reader-writer lock.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rwlock_unlock(osal_rwlock_t *rwl) {
+    assert(rwl != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    if (POSIX_RWLOCK_OWN(rwl)) {
+        // while write locked there are no readers, so the caller is the writer
+        if (__atomic_load_n(&rwl->state, __ATOMIC_SEQ_CST) == POSIX_RWLOCK_STATE__LOCKED) {
+            __atomic_store_n(&rwl->state, POSIX_RWLOCK_STATE__FREE, __ATOMIC_SEQ_CST);
+            ret = osal_mutex_unlock(&rwl->wr_mtx);
+        } else if (posix_rwlock_reader_sum(rwl) <= 0) {
+            // neither write locked nor read locked
+            ret = OSAL_ERR_PERMISSION_DENIED;
+        } else {
+            posix_rwlock_reader_leave(rwl, posix_rwlock_reader_slot(rwl));
+        }
+    } else {
+        ret = posix_rwlock_retval(pthread_rwlock_unlock(&rwl->posix_rwlock));
+    }
+
+    return ret;
+}
+
+//! \brief Destroys a reader-writer lock.
+/*!
+ * \param[in]   rwl     Pointer to osal reader-writer lock structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_rwlock_destroy(osal_rwlock_t *rwl) {
+    assert(rwl != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    if (POSIX_RWLOCK_OWN(rwl)) {
+        if ((__atomic_load_n(&rwl->state, __ATOMIC_SEQ_CST) != POSIX_RWLOCK_STATE__FREE) ||
+                (posix_rwlock_reader_sum(rwl) != 0)) {
+            ret = OSAL_ERR_BUSY;
+        } else {
+            ret = osal_mutex_destroy(&rwl->wr_mtx);
+
+            if (rwl->slots_mem != NULL) {
+                free(rwl->slots_mem);
+                rwl->slots_mem = NULL;
+                rwl->slots = NULL;
+            }
+        }
+    } else {
+        ret = posix_rwlock_retval(pthread_rwlock_destroy(&rwl->posix_rwlock));
+    }
+
+    return ret;
+}
+
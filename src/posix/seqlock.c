@@ -0,0 +1,209 @@
+/**
+ * \file posix/seqlock.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL sequence lock posix source.
+ *
+ * OSAL sequence lock posix source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/seqlock.h>
+
+#include <assert.h>
+#include <sched.h>
+#include <string.h>
+
+//! Yield the CPU after this many polls of an odd sequence, the writer may have been preempted.
+#define POSIX_SEQLOCK_YIELD_POLLS       1024u
+
+static inline void posix_seqlock_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+//! Copy between the sequence fences, a torn copy is detected by the reader's retry.
+static inline void posix_seqlock_copy(osal_void_t *dst, const osal_void_t *src, osal_size_t size) {
+    // the fences also keep the compiler from moving the copy out of the section
+    (void)memcpy(dst, src, size);
+}
+
+//! \brief Initialize a sequence lock.
+/*!
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_seqlock_init(osal_seqlock_t *sl) {
+    assert(sl != NULL);
+
+    __atomic_store_n(&sl->seq, 0u, __ATOMIC_RELEASE);
+
+    return OSAL_OK;
+}
+
+//! \brief Start updating the protected data.
+/*!
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_seqlock_write_begin(osal_seqlock_t *sl) {
+    assert(sl != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_uint32_t seq = __atomic_load_n(&sl->seq, __ATOMIC_RELAXED);
+
+    if (((seq & 1u) != 0u) || 
+            (__atomic_compare_exchange_n(&sl->seq, &seq, seq + 1u, 0, 
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED) == 0)) {
+        ret = OSAL_ERR_BUSY;
+    } else {
+        // odd sequence has to be visible before any data store
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    return ret;
+}
+
+//! \brief Finish updating the protected data.
+/*!
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_seqlock_write_end(osal_seqlock_t *sl) {
+    assert(sl != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_uint32_t seq = __atomic_load_n(&sl->seq, __ATOMIC_RELAXED);
+
+    if ((seq & 1u) == 0u) {
+        ret = OSAL_ERR_PERMISSION_DENIED;
+    } else {
+        __atomic_store_n(&sl->seq, seq + 1u, __ATOMIC_RELEASE);
+    }
+
+    return ret;
+}
+
+//! \brief Start reading the protected data.
+/*!
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ *
+ * \return Sequence to pass to \ref osal_seqlock_read_retry.
+ */
+osal_uint32_t osal_seqlock_read_begin(const osal_seqlock_t *sl) {
+    assert(sl != NULL);
+
+    osal_uint32_t polls = 0u;
+    osal_uint32_t seq = __atomic_load_n(&sl->seq, __ATOMIC_ACQUIRE);
+
+    while ((seq & 1u) != 0u) {
+        if (++polls >= POSIX_SEQLOCK_YIELD_POLLS) {
+            polls = 0u;
+            (void)sched_yield();
+        } else {
+            posix_seqlock_cpu_relax();
+        }
+
+        seq = __atomic_load_n(&sl->seq, __ATOMIC_ACQUIRE);
+    }
+
+    return seq;
+}
+
+//! \brief Check if the data read has to be discarded.
+/*!
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ * \param[in]   seq     Sequence returned by \ref osal_seqlock_read_begin.
+ *
+ * \return OSAL_TRUE if data has to be read again.
+ */
+osal_bool_t osal_seqlock_read_retry(const osal_seqlock_t *sl, osal_uint32_t seq) {
+    assert(sl != NULL);
+
+    // data loads must not move after the sequence check
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&sl->seq, __ATOMIC_RELAXED) != seq ? OSAL_TRUE : OSAL_FALSE;
+}
+
+//! \brief Copy data into the protected area as one update.
+/*!
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ * \param[out]  dst     Protected data.
+ * \param[in]   src     New data.
+ * \param[in]   size    Number of bytes to copy.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_seqlock_write_copy(osal_seqlock_t *sl, osal_void_t *dst, const osal_void_t *src, 
+        osal_size_t size) 
+{
+    assert(sl != NULL);
+    assert((dst != NULL) && (src != NULL));
+
+    osal_retval_t ret = osal_seqlock_write_begin(sl);
+
+    if (ret == OSAL_OK) {
+        posix_seqlock_copy(dst, src, size);
+        ret = osal_seqlock_write_end(sl);
+    }
+
+    return ret;
+}
+
+//! \brief Copy a consistent snapshot of the protected area.
+/*!
+ * \param[in]   sl      Pointer to osal sequence lock structure.
+ * \param[out]  dst     Local copy.
+ * \param[in]   src     Protected data.
+ * \param[in]   size    Number of bytes to copy.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_seqlock_read_copy(const osal_seqlock_t *sl, osal_void_t *dst, const osal_void_t *src, 
+        osal_size_t size) 
+{
+    assert(sl != NULL);
+    assert((dst != NULL) && (src != NULL));
+
+    osal_uint32_t seq;
+
+    do {
+        seq = osal_seqlock_read_begin(sl);
+        posix_seqlock_copy(dst, src, size);
+    } while (osal_seqlock_read_retry(sl, seq) == OSAL_TRUE);
+
+    return OSAL_OK;
+}
+
@@ -41,12 +41,182 @@
 #include <sys/mman.h>
 #endif
 
+#ifdef LIBOSAL_HAVE_SYS_VFS_H
+#include <sys/vfs.h>
+#endif
+
 #include <sys/types.h>
 #include <sys/stat.h>        /* For mode constants */
 #include <fcntl.h>           /* For O_* constants */
 #include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
 #include <unistd.h>
 
+#define POSIX_SHM_HUGETLBFS_DIR         "/dev/hugepages"
+#define POSIX_SHM_HUGETLBFS_MAGIC       0x958458f6
+
+#define POSIX_SHM_PREFAULT_CHUNK        (64u * 1024u * 1024u)   // minimum bytes per prefault task
+#define POSIX_SHM_PREFAULT_TASKS_MAX    16
+
+typedef struct posix_shm_prefault {
+    osal_uint8_t *start;
+    osal_size_t len;
+    int prot;
+    pthread_t tid;
+    osal_bool_t started;
+} posix_shm_prefault_t;
+
+//! \brief Build the hugetlbfs path of a segment, -1 with errno ENAMETOOLONG if it does not fit.
+static int posix_shm_hugetlbfs_path(const osal_char_t *name, char *path, osal_size_t len) {
+    int ret = 0;
+
+    if (snprintf(path, len, "%s/%s", POSIX_SHM_HUGETLBFS_DIR, (name[0] == '/') ? &name[1] : name) >= (int)len) {
+        errno = ENAMETOOLONG;
+        ret = -1;
+    }
+
+    return ret;
+}
+
+//! \brief Open a segment on hugetlbfs, -1 with errno ENODEV if huge pages are not available.
+static int posix_shm_open_hugetlbfs(const osal_char_t *name, int oflag, mode_t mode, osal_size_t size) {
+    int fd = -1;
+
+#ifdef LIBOSAL_HAVE_SYS_VFS_H
+    struct statfs fs;
+    char path[PATH_MAX];
+
+    if ((statfs(POSIX_SHM_HUGETLBFS_DIR, &fs) != 0) || (fs.f_type != POSIX_SHM_HUGETLBFS_MAGIC) || (fs.f_bsize <= 0)) {
+        errno = ENODEV;
+    } else if (posix_shm_hugetlbfs_path(name, path, sizeof(path)) == 0) {
+        fd = open(path, oflag | O_CLOEXEC, mode);
+    }
+
+    if (fd != -1) {
+        osal_size_t page_size = (osal_size_t)fs.f_bsize;
+        osal_bool_t created = OSAL_FALSE;
+        struct stat buf;
+        int local_errno = 0;
+
+        if (fstat(fd, &buf) != 0) {
+            local_errno = errno;
+        } else if (buf.st_size == 0) {
+            // hugetlbfs only accepts multiples of the huge page size
+            size = ((size + page_size - 1u) / page_size) * page_size;
+            if (ftruncate(fd, size) != 0) {
+                local_errno = errno;
+            } else {
+                created = OSAL_TRUE;
+            }
+        } else {
+            size = buf.st_size;
+        }
+
+        if (local_errno == 0) {
+            // shared mappings reserve their huge pages, fails now instead of at first touch
+            void *probe = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (probe == MAP_FAILED) {
+                local_errno = (errno == ENOMEM) ? ENODEV : errno;
+            } else {
+                (void)munmap(probe, size);
+            }
+        }
+
+        if (local_errno != 0) {
+            if (created == OSAL_TRUE) {
+                (void)unlink(path);
+            }
+
+            (void)close(fd);
+            fd = -1;
+            errno = local_errno;
+        }
+    }
+#else
+    (void)name;
+    (void)oflag;
+    (void)mode;
+    (void)size;
+    errno = ENODEV;
+#endif
+
+    return fd;
+}
+
+//! \brief Fault in a range of a mapping without changing its contents.
+static void *posix_shm_prefault_range(void *arg) {
+    posix_shm_prefault_t *range = (posix_shm_prefault_t *)arg;
+    int local_retval = -1;
+
+#if defined(MADV_POPULATE_WRITE) && defined(MADV_POPULATE_READ)
+    local_retval = madvise(range->start, range->len,
+            ((range->prot & PROT_WRITE) != 0) ? MADV_POPULATE_WRITE : MADV_POPULATE_READ);
+#endif
+
+    if (local_retval != 0) {
+        // kernel without populate advice, touch one byte per page
+        osal_size_t page_size = (osal_size_t)sysconf(_SC_PAGESIZE);
+
+        for (osal_size_t pos = 0u; pos < range->len; pos += page_size) {
+            if ((range->prot & PROT_WRITE) != 0) {
+                (void)__atomic_fetch_or(&range->start[pos], 0u, __ATOMIC_RELAXED);
+            } else {
+                (void)__atomic_load_n(&range->start[pos], __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+//! \brief Prefault a mapping, large mappings are split across several tasks.
+static void posix_shm_prefault(osal_uint8_t *start, osal_size_t len, int prot) {
+    posix_shm_prefault_t ranges[POSIX_SHM_PREFAULT_TASKS_MAX];
+    osal_size_t page_size = (osal_size_t)sysconf(_SC_PAGESIZE);
+    osal_size_t tasks = len / POSIX_SHM_PREFAULT_CHUNK;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if ((cpus > 0) && (tasks > (osal_size_t)cpus)) {
+        tasks = (osal_size_t)cpus;
+    }
+    if (tasks > POSIX_SHM_PREFAULT_TASKS_MAX) {
+        tasks = POSIX_SHM_PREFAULT_TASKS_MAX;
+    }
+    if (tasks == 0u) {
+        tasks = 1u;
+    }
+
+    osal_size_t chunk = (((len / tasks) + page_size - 1u) / page_size) * page_size;
+    osal_size_t pos = 0u;
+
+    for (osal_size_t i = 0u; i < tasks; ++i) {
+        ranges[i].start = &start[pos];
+        ranges[i].len = (len - pos) < chunk ? (len - pos) : chunk;
+        ranges[i].prot = prot;
+        ranges[i].started = OSAL_FALSE;
+        pos += ranges[i].len;
+
+        // the caller takes the first range and any range without a task
+        if ((i > 0u) && (pthread_create(&ranges[i].tid, NULL, posix_shm_prefault_range, &ranges[i]) == 0)) {
+            ranges[i].started = OSAL_TRUE;
+        }
+    }
+
+    for (osal_size_t i = 0u; i < tasks; ++i) {
+        if (ranges[i].started == OSAL_FALSE) {
+            (void)posix_shm_prefault_range(&ranges[i]);
+        }
+    }
+
+    for (osal_size_t i = 1u; i < tasks; ++i) {
+        if (ranges[i].started == OSAL_TRUE) {
+            (void)pthread_join(ranges[i].tid, NULL);
+        }
+    }
+}
+
 //! \brief Initialize a shm.
 /*!
  * \param[in]   shm     Pointer to osal shm structure. Content is OS dependent.
@@ -88,7 +258,26 @@ osal_retval_t osal_shm_open(osal_shm_t *shm, const osal_char_t *name,  const osa
         }
     }
 
-    int local_retval = shm_open(name, oflag, mode);
+    osal_bool_t hugepages = ((attr != NULL) && (((*attr) & OSAL_SHM_ATTR__FLAG__HUGEPAGES) != 0u)) ? OSAL_TRUE : OSAL_FALSE;
+    int local_retval = -1;
+    shm->hugetlb = OSAL_FALSE;
+    shm->thp = OSAL_FALSE;
+
+    if (hugepages == OSAL_TRUE) {
+        local_retval = posix_shm_open_hugetlbfs(name, oflag, mode, size);
+
+        if (local_retval != -1) {
+            shm->hugetlb = OSAL_TRUE;
+        } else if ((errno == ENODEV) || (errno == ENOENT)) {
+            // no huge pages or segment was created without them
+            shm->thp = OSAL_TRUE;
+        }
+    }
+
+    if ((hugepages == OSAL_FALSE) || (shm->thp == OSAL_TRUE)) {
+        local_retval = shm_open(name, oflag, mode);
+    }
+
     if (local_retval > 0) {
         shm->fd = local_retval;
 
@@ -175,6 +364,11 @@ osal_retval_t osal_shm_map(osal_shm_t *shm, const osal_shm_map_attr_t *attr, osa
         if ((*attr & OSAL_SHM_MAP_ATTR__PRIVATE) != 0u) {
             flags |= MAP_PRIVATE;
         }
+#ifdef MAP_POPULATE
+        if ((*attr & OSAL_SHM_MAP_ATTR__POPULATE) != 0u) {
+            flags |= MAP_POPULATE;
+        }
+#endif
     }
 
     *ptr = mmap(NULL, shm->size, prot, flags, shm->fd, 0);
@@ -230,6 +424,35 @@ osal_retval_t osal_shm_map(osal_shm_t *shm, const osal_shm_map_attr_t *attr, osa
                 ret = OSAL_ERR_OPERATION_FAILED;
                 break;
         }
+    } else {
+#ifdef MADV_HUGEPAGE
+        if (shm->thp == OSAL_TRUE) {
+            // best effort, depends on the system transparent huge page settings
+            (void)madvise(*ptr, shm->size, MADV_HUGEPAGE);
+        }
+#endif
+
+        if ((attr != NULL) && ((*attr & OSAL_SHM_MAP_ATTR__PREFAULT) != 0u) && ((prot & (PROT_READ | PROT_WRITE)) != 0)) {
+            posix_shm_prefault((osal_uint8_t *)*ptr, shm->size, prot);
+        }
+
+        if ((attr != NULL) && ((*attr & OSAL_SHM_MAP_ATTR__LOCKED) != 0u) && (mlock(*ptr, shm->size) != 0)) {
+            switch (errno) {
+                case ENOMEM:    // RLIMIT_MEMLOCK exceeded without CAP_IPC_LOCK
+                case EPERM:     // not privileged
+                    ret = OSAL_ERR_PERMISSION_DENIED;
+                    break;
+                case EAGAIN:    // some pages could not be locked
+                    ret = OSAL_ERR_OUT_OF_MEMORY;
+                    break;
+                default:
+                    ret = OSAL_ERR_OPERATION_FAILED;
+                    break;
+            }
+
+            (void)munmap(*ptr, shm->size);
+            *ptr = NULL;
+        }
     }
 
     return ret;
@@ -250,4 +473,54 @@ osal_retval_t osal_shm_close(osal_shm_t *shm) {
     return ret;
 }
 
+//! \brief Remove a shm.
+/*!
+ * \param[in]   name    Shared memory name.
+ * \param[in]   attr    Pointer to the shm attributes the segment was opened
+ *                      with. Can be NULL for a segment without huge pages.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_unlink(const osal_char_t *name, const osal_shm_attr_t *attr) {
+    assert(name != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    int local_retval = -1;
+
+    if ((attr != NULL) && (((*attr) & OSAL_SHM_ATTR__FLAG__HUGEPAGES) != 0u)) {
+        char path[PATH_MAX];
+
+        if (posix_shm_hugetlbfs_path(name, path, sizeof(path)) == 0) {
+            local_retval = unlink(path);
+        }
+
+        if ((local_retval != 0) && (errno == ENOENT)) {
+            // segment fell back to regular pages at open
+            local_retval = shm_unlink(name);
+        }
+    } else {
+        local_retval = shm_unlink(name);
+    }
+
+    if (local_retval != 0) {
+        switch (errno) {
+            case EACCES:        // The caller does not have permission to unlink this shared memory object.
+            case EPERM:
+                ret = OSAL_ERR_PERMISSION_DENIED;
+                break;
+            case ENAMETOOLONG:  // The length of name exceeds PATH_MAX.
+            case EINVAL:
+                ret = OSAL_ERR_INVALID_PARAM;
+                break;
+            case ENOENT:        // An attempt was to made to shm_unlink() a name that does not exist.
+                ret = OSAL_ERR_NOT_FOUND;
+                break;
+            default:
+                ret = OSAL_ERR_OPERATION_FAILED;
+                break;
+        }
+    }
+
+    return ret;
+}
 
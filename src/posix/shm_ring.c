@@ -0,0 +1,346 @@
+/**
+ * \file posix/shm_ring.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL shared memory ring buffer posix source.
+ *
+ * OSAL lock-free single-producer/single-consumer ring buffer posix source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/shm_ring.h>
+
+#include "futex.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define LIBOSAL_SHM_RING_MAGIC      0x0051A6E0u
+
+//! \brief Round frame size up to keep every frame 8-byte aligned.
+static osal_uint32_t posix_shm_ring_frame_size(osal_size_t frame_size) {
+    return (osal_uint32_t)((frame_size + 7u) & ~(osal_size_t)7u);
+}
+
+static void posix_shm_ring_setup_handle(osal_shm_ring_t *ring, osal_void_t *mem) {
+    ring->ctrl          = (osal_shm_ring_ctrl_t *)mem;
+    ring->frames        = (osal_uint8_t *)mem + sizeof(osal_shm_ring_ctrl_t);
+    ring->mask          = ring->ctrl->frame_cnt - 1u;
+    ring->frame_size    = ring->ctrl->frame_size;
+    ring->cached_head   = __atomic_load_n(&ring->ctrl->head, __ATOMIC_ACQUIRE);
+    ring->cached_tail   = __atomic_load_n(&ring->ctrl->tail, __ATOMIC_ACQUIRE);
+}
+
+//! \brief Get size of memory region needed for a ring.
+/*!
+ * \param[in]   frame_size  Size of one frame in bytes.
+ * \param[in]   frame_cnt   Number of frames, has to be a power of 2.
+ *
+ * \return Needed size in bytes, 0 on invalid parameters.
+ */
+osal_size_t osal_shm_ring_get_size(osal_size_t frame_size, osal_uint32_t frame_cnt) {
+    osal_size_t ret = 0u;
+
+    if (    (frame_size > 0u) && (frame_size <= 0xFFFFFFF8u) &&
+            (frame_cnt > 0u) && ((frame_cnt & (frame_cnt - 1u)) == 0u)) {
+        ret = sizeof(osal_shm_ring_ctrl_t) + ((osal_size_t)posix_shm_ring_frame_size(frame_size) * frame_cnt);
+    }
+
+    return ret;
+}
+
+//! \brief Initialize a ring in a memory region.
+/*!
+ * \param[out]  ring        Pointer to osal shm ring handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ * \param[in]   frame_size  Size of one frame in bytes.
+ * \param[in]   frame_cnt   Number of frames, has to be a power of 2.
+ * \param[in]   attr        Pointer to ring attributes. Can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_ring_init(osal_shm_ring_t *ring, osal_void_t *mem, osal_size_t mem_size,
+        osal_size_t frame_size, osal_uint32_t frame_cnt, const osal_shm_ring_attr_t *attr)
+{
+    assert(ring != NULL);
+    assert(mem != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_size_t needed = osal_shm_ring_get_size(frame_size, frame_cnt);
+
+    if ((needed == 0u) || (needed > mem_size)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        osal_shm_ring_ctrl_t *ctrl = (osal_shm_ring_ctrl_t *)mem;
+
+        __atomic_store_n(&ctrl->magic, 0u, __ATOMIC_RELAXED);
+        memset(ctrl, 0, sizeof(osal_shm_ring_ctrl_t));
+
+        ctrl->flags         = attr != NULL ? *attr : 0u;
+        ctrl->frame_size    = posix_shm_ring_frame_size(frame_size);
+        ctrl->frame_cnt     = frame_cnt;
+
+        // publish initialized control block to attaching side
+        __atomic_store_n(&ctrl->magic, LIBOSAL_SHM_RING_MAGIC, __ATOMIC_RELEASE);
+
+        posix_shm_ring_setup_handle(ring, mem);
+    }
+
+    return ret;
+}
+
+//! \brief Attach to a ring initialized by someone else.
+/*!
+ * \param[out]  ring        Pointer to osal shm ring handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_ring_attach(osal_shm_ring_t *ring, osal_void_t *mem, osal_size_t mem_size) {
+    assert(ring != NULL);
+    assert(mem != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_shm_ring_ctrl_t *ctrl = (osal_shm_ring_ctrl_t *)mem;
+
+    if (mem_size < sizeof(osal_shm_ring_ctrl_t)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else if (__atomic_load_n(&ctrl->magic, __ATOMIC_ACQUIRE) != LIBOSAL_SHM_RING_MAGIC) {
+        ret = OSAL_ERR_UNAVAILABLE;
+    } else if (osal_shm_ring_get_size(ctrl->frame_size, ctrl->frame_cnt) > mem_size) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        posix_shm_ring_setup_handle(ring, mem);
+    }
+
+    return ret;
+}
+
+//! \brief Reserve next free frame for writing (producer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ * \param[out]  frame       Returns pointer to the frame to be filled.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_ring_reserve(osal_shm_ring_t *ring, osal_void_t **frame) {
+    assert(ring != NULL);
+    assert(frame != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_uint32_t head = __atomic_load_n(&ring->ctrl->head, __ATOMIC_RELAXED);
+
+    if ((head - ring->cached_tail) > ring->mask) {
+        // only touch the consumer's cache line if our snapshot says full
+        ring->cached_tail = __atomic_load_n(&ring->ctrl->tail, __ATOMIC_ACQUIRE);
+
+        if ((head - ring->cached_tail) > ring->mask) {
+            ret = OSAL_ERR_BUSY;
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        *frame = &ring->frames[(osal_size_t)(head & ring->mask) * ring->frame_size];
+    }
+
+    return ret;
+}
+
+//! \brief Reserve next free frame for writing, wait if ring is full (producer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ * \param[out]  frame       Returns pointer to the frame to be filled.
+ * \param[in]   to          Absolute timeout, NULL waits forever.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_ring_timedreserve(osal_shm_ring_t *ring, osal_void_t **frame, const osal_timer_t *to) {
+    assert(ring != NULL);
+    assert(frame != NULL);
+
+    osal_retval_t ret;
+
+    if ((ring->ctrl->flags & OSAL_SHM_RING_ATTR__BLOCKING) == 0u) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        while ((ret = osal_shm_ring_reserve(ring, frame)) == OSAL_ERR_BUSY) {
+            osal_uint32_t tail = ring->cached_tail;
+
+            __atomic_store_n(&ring->ctrl->tail_waiters, 1u, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&ring->ctrl->tail, __ATOMIC_SEQ_CST) == tail) {
+                ret = posix_futex_wait(&ring->ctrl->tail, tail, to, OSAL_TRUE);
+            }
+            __atomic_store_n(&ring->ctrl->tail_waiters, 0u, __ATOMIC_RELAXED);
+
+            if (ret == OSAL_ERR_TIMEOUT) {
+                if (osal_shm_ring_reserve(ring, frame) == OSAL_OK) {
+                    ret = OSAL_OK;
+                }
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Publish the previously reserved frame (producer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_ring_commit(osal_shm_ring_t *ring) {
+    assert(ring != NULL);
+
+    osal_shm_ring_ctrl_t *ctrl = ring->ctrl;
+    osal_uint32_t head = __atomic_load_n(&ctrl->head, __ATOMIC_RELAXED);
+
+    if ((ctrl->flags & OSAL_SHM_RING_ATTR__BLOCKING) == 0u) {
+        __atomic_store_n(&ctrl->head, head + 1u, __ATOMIC_RELEASE);
+    } else {
+        // store-load ordering against the consumer announcing itself as waiter
+        __atomic_store_n(&ctrl->head, head + 1u, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&ctrl->head_waiters, __ATOMIC_SEQ_CST) != 0u) {
+            posix_futex_wake(&ctrl->head, 1u, OSAL_TRUE);
+        }
+    }
+
+    return OSAL_OK;
+}
+
+//! \brief Get oldest published frame for reading (consumer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ * \param[out]  frame       Returns pointer to the frame to be read.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_ring_peek(osal_shm_ring_t *ring, osal_void_t **frame) {
+    assert(ring != NULL);
+    assert(frame != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_uint32_t tail = __atomic_load_n(&ring->ctrl->tail, __ATOMIC_RELAXED);
+
+    if (ring->cached_head == tail) {
+        // only touch the producer's cache line if our snapshot says empty
+        ring->cached_head = __atomic_load_n(&ring->ctrl->head, __ATOMIC_ACQUIRE);
+
+        if (ring->cached_head == tail) {
+            ret = OSAL_ERR_NO_DATA;
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        *frame = &ring->frames[(osal_size_t)(tail & ring->mask) * ring->frame_size];
+    }
+
+    return ret;
+}
+
+//! \brief Get oldest published frame, wait if ring is empty (consumer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ * \param[out]  frame       Returns pointer to the frame to be read.
+ * \param[in]   to          Absolute timeout, NULL waits forever.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_ring_timedpeek(osal_shm_ring_t *ring, osal_void_t **frame, const osal_timer_t *to) {
+    assert(ring != NULL);
+    assert(frame != NULL);
+
+    osal_retval_t ret;
+
+    if ((ring->ctrl->flags & OSAL_SHM_RING_ATTR__BLOCKING) == 0u) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        while ((ret = osal_shm_ring_peek(ring, frame)) == OSAL_ERR_NO_DATA) {
+            osal_uint32_t head = ring->cached_head;
+
+            __atomic_store_n(&ring->ctrl->head_waiters, 1u, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&ring->ctrl->head, __ATOMIC_SEQ_CST) == head) {
+                ret = posix_futex_wait(&ring->ctrl->head, head, to, OSAL_TRUE);
+            }
+            __atomic_store_n(&ring->ctrl->head_waiters, 0u, __ATOMIC_RELAXED);
+
+            if (ret == OSAL_ERR_TIMEOUT) {
+                if (osal_shm_ring_peek(ring, frame) == OSAL_OK) {
+                    ret = OSAL_OK;
+                }
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Hand the previously peeked frame back to the producer (consumer).
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_shm_ring_release(osal_shm_ring_t *ring) {
+    assert(ring != NULL);
+
+    osal_shm_ring_ctrl_t *ctrl = ring->ctrl;
+    osal_uint32_t tail = __atomic_load_n(&ctrl->tail, __ATOMIC_RELAXED);
+
+    if ((ctrl->flags & OSAL_SHM_RING_ATTR__BLOCKING) == 0u) {
+        __atomic_store_n(&ctrl->tail, tail + 1u, __ATOMIC_RELEASE);
+    } else {
+        // store-load ordering against the producer announcing itself as waiter
+        __atomic_store_n(&ctrl->tail, tail + 1u, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&ctrl->tail_waiters, __ATOMIC_SEQ_CST) != 0u) {
+            posix_futex_wake(&ctrl->tail, 1u, OSAL_TRUE);
+        }
+    }
+
+    return OSAL_OK;
+}
+
+//! \brief Get number of published but not yet released frames.
+/*!
+ * \param[in]   ring        Pointer to osal shm ring handle.
+ *
+ * \return Number of frames currently in the ring.
+ */
+osal_uint32_t osal_shm_ring_count(osal_shm_ring_t *ring) {
+    assert(ring != NULL);
+
+    osal_uint32_t tail = __atomic_load_n(&ring->ctrl->tail, __ATOMIC_ACQUIRE);
+    osal_uint32_t head = __atomic_load_n(&ring->ctrl->head, __ATOMIC_ACQUIRE);
+
+    return head - tail;
+}
+
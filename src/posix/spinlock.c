@@ -35,9 +35,250 @@
 #include <libosal/osal.h>
 #include <libosal/spinlock.h>
 
-#include <errno.h>
-#include <pthread.h>
 #include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+//! Maximum number of pause instructions between two polls of the lock word.
+#define POSIX_SPINLOCK_BACKOFF_MAX      256u
+//! Pause instructions per ticket holder ahead of a waiting ticket.
+#define POSIX_SPINLOCK_TICKET_PAUSES    64u
+//! Yield the CPU after this many pause instructions, the holder may have been preempted.
+#define POSIX_SPINLOCK_YIELD_PAUSES     2048u
+//! Number of MCS spinlocks a task may hold or wait for at the same time.
+#define POSIX_SPINLOCK_MCS_NODES        8u
+
+#define POSIX_SPINLOCK_ALGORITHM(mtx)   ((mtx)->attr & OSAL_SPINLOCK_ATTR__ALGORITHM__MASK)
+#define POSIX_SPINLOCK_TYPE(mtx)        ((mtx)->attr & OSAL_SPINLOCK_ATTR__TYPE__MASK)
+
+typedef struct posix_spinlock_wait {
+    osal_uint32_t delay;        //!< Pause instructions before next poll.
+    osal_uint32_t max;          //!< Upper bound of delay.
+    osal_uint32_t paused;       //!< Pause instructions since last yield.
+    osal_uint64_t polls;        //!< Number of polls so far.
+} posix_spinlock_wait_t;
+
+static __thread osal_spinlock_mcs_node_t posix_spinlock_mcs_nodes[POSIX_SPINLOCK_MCS_NODES];
+static __thread osal_uint32_t posix_spinlock_tid;
+static pthread_once_t posix_spinlock_tid_once = PTHREAD_ONCE_INIT;
+
+static inline void posix_spinlock_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+//! \brief Forget the cached thread id in a forked child.
+static void posix_spinlock_tid_reset(void) {
+    posix_spinlock_tid = 0u;
+}
+
+//! \brief Register the fork handler once per process.
+static void posix_spinlock_tid_atfork(void) {
+    (void)pthread_atfork(NULL, NULL, posix_spinlock_tid_reset);
+}
+
+//! Thread id, unique across processes for process shared spinlocks.
+static osal_uint32_t posix_spinlock_self(void) {
+    if (posix_spinlock_tid == 0u) {
+        // the child of a fork runs with a new id but inherits the cache
+        (void)pthread_once(&posix_spinlock_tid_once, posix_spinlock_tid_atfork);
+        posix_spinlock_tid = (osal_uint32_t)syscall(SYS_gettid);
+    }
+
+    return posix_spinlock_tid;
+}
+
+static void posix_spinlock_wait_init(posix_spinlock_wait_t *wait, osal_uint32_t delay, osal_uint32_t max) {
+    wait->delay = delay < max ? delay : max;
+    wait->max = max;
+    wait->paused = 0u;
+    wait->polls = 0u;
+}
+
+//! Wait before polling the lock again, doubling the delay every time up to max.
+static void posix_spinlock_wait(posix_spinlock_wait_t *wait) {
+    for (osal_uint32_t i = 0u; i < wait->delay; ++i) {
+        posix_spinlock_cpu_relax();
+    }
+
+    wait->paused += wait->delay;
+    wait->polls++;
+
+    if (wait->delay < wait->max) {
+        wait->delay <<= 1u;
+    }
+
+    if (wait->paused >= POSIX_SPINLOCK_YIELD_PAUSES) {
+        wait->paused = 0u;
+        (void)sched_yield();
+    }
+}
+
+static void posix_spinlock_stats_update(osal_spinlock_t *mtx, osal_uint64_t polls) {
+    // only called by the lock holder, atomics for concurrent readers
+    osal_spinlock_stats_t *stats = &mtx->stats;
+
+    __atomic_store_n(&stats->locks, stats->locks + 1u, __ATOMIC_RELAXED);
+    if (polls != 0u) {
+        __atomic_store_n(&stats->contended, stats->contended + 1u, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats->spins, stats->spins + polls, __ATOMIC_RELAXED);
+        if (polls > stats->max_spins) {
+            __atomic_store_n(&stats->max_spins, polls, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static osal_bool_t posix_spinlock_tas_try(osal_spinlock_t *mtx) {
+    return __atomic_exchange_n(&mtx->word, 1u, __ATOMIC_ACQUIRE) == 0u ? OSAL_TRUE : OSAL_FALSE;
+}
+
+static osal_uint64_t posix_spinlock_tas_lock(osal_spinlock_t *mtx) {
+    posix_spinlock_wait_t wait;
+    posix_spinlock_wait_init(&wait, 1u, POSIX_SPINLOCK_BACKOFF_MAX);
+
+    while (posix_spinlock_tas_try(mtx) == OSAL_FALSE) {
+        // poll read-only, the cache line stays shared until the holder releases it
+        do {
+            posix_spinlock_wait(&wait);
+        } while (__atomic_load_n(&mtx->word, __ATOMIC_RELAXED) != 0u);
+    }
+
+    return wait.polls;
+}
+
+static void posix_spinlock_tas_unlock(osal_spinlock_t *mtx) {
+    __atomic_store_n(&mtx->word, 0u, __ATOMIC_RELEASE);
+}
+
+static osal_bool_t posix_spinlock_ticket_try(osal_spinlock_t *mtx) {
+    osal_uint32_t owner = __atomic_load_n(&mtx->ticket_owner, __ATOMIC_RELAXED);
+    osal_uint32_t next = owner;
+
+    return __atomic_compare_exchange_n(&mtx->ticket_next, &next, owner + 1u, 0,
+            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ? OSAL_TRUE : OSAL_FALSE;
+}
+
+static osal_uint64_t posix_spinlock_ticket_lock(osal_spinlock_t *mtx) {
+    osal_uint32_t ticket = __atomic_fetch_add(&mtx->ticket_next, 1u, __ATOMIC_RELAXED);
+    osal_uint32_t owner = __atomic_load_n(&mtx->ticket_owner, __ATOMIC_ACQUIRE);
+    posix_spinlock_wait_t wait;
+
+    posix_spinlock_wait_init(&wait, 0u, POSIX_SPINLOCK_YIELD_PAUSES);
+
+    while (owner != ticket) {
+        // delay proportional to the number of tasks served before us, no doubling
+        osal_uint32_t ahead = ticket - owner;
+        wait.delay = ahead < (wait.max / POSIX_SPINLOCK_TICKET_PAUSES) ?
+            ahead * POSIX_SPINLOCK_TICKET_PAUSES : wait.max;
+
+        posix_spinlock_wait(&wait);
+        owner = __atomic_load_n(&mtx->ticket_owner, __ATOMIC_ACQUIRE);
+    }
+
+    return wait.polls;
+}
+
+static void posix_spinlock_ticket_unlock(osal_spinlock_t *mtx) {
+    // only the holder writes the owner
+    __atomic_store_n(&mtx->ticket_owner, mtx->ticket_owner + 1u, __ATOMIC_RELEASE);
+}
+
+static osal_spinlock_mcs_node_t *posix_spinlock_mcs_node_get(void) {
+    osal_spinlock_mcs_node_t *node = NULL;
+
+    for (osal_uint32_t i = 0u; (node == NULL) && (i < POSIX_SPINLOCK_MCS_NODES); ++i) {
+        if (posix_spinlock_mcs_nodes[i].in_use == 0u) {
+            node = &posix_spinlock_mcs_nodes[i];
+            node->in_use = 1u;
+            node->next = NULL;
+            node->locked = 1u;
+        }
+    }
+
+    return node;
+}
+
+static osal_bool_t posix_spinlock_mcs_try(osal_spinlock_t *mtx, osal_spinlock_mcs_node_t *node) {
+    osal_spinlock_mcs_node_t *tail = NULL;
+
+    return __atomic_compare_exchange_n(&mtx->mcs_tail, &tail, node, 0,
+            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) ? OSAL_TRUE : OSAL_FALSE;
+}
+
+static osal_uint64_t posix_spinlock_mcs_lock(osal_spinlock_t *mtx, osal_spinlock_mcs_node_t *node) {
+    osal_spinlock_mcs_node_t *pred = __atomic_exchange_n(&mtx->mcs_tail, node, __ATOMIC_ACQ_REL);
+    posix_spinlock_wait_t wait;
+
+    // every waiter polls its own node, no backoff needed
+    posix_spinlock_wait_init(&wait, 1u, 1u);
+
+    if (pred != NULL) {
+        __atomic_store_n(&pred->next, node, __ATOMIC_RELEASE);
+
+        while (__atomic_load_n(&node->locked, __ATOMIC_ACQUIRE) != 0u) {
+            posix_spinlock_wait(&wait);
+        }
+    }
+
+    return wait.polls;
+}
+
+static void posix_spinlock_mcs_unlock(osal_spinlock_t *mtx) {
+    osal_spinlock_mcs_node_t *node = mtx->mcs_owner;
+    osal_spinlock_mcs_node_t *next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+
+    if (next == NULL) {
+        osal_spinlock_mcs_node_t *tail = node;
+
+        if (__atomic_compare_exchange_n(&mtx->mcs_tail, &tail, NULL, 0,
+                    __ATOMIC_RELEASE, __ATOMIC_RELAXED) == 0) {
+            // a successor is enqueuing, wait until it is linked
+            do {
+                posix_spinlock_cpu_relax();
+                next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+            } while (next == NULL);
+        }
+    }
+
+    if (next != NULL) {
+        __atomic_store_n(&next->locked, 0u, __ATOMIC_RELEASE);
+    }
+
+    node->in_use = 0u;
+}
+
+//! Checks ERRORCHECK and RECURSIVE types before locking.
+/*!
+ * \return OSAL_OK to go on locking, OSAL_ERR_BUSY if a recursive lock was
+ *         taken again, OSAL_ERR_DEAD_LOCK if already held by caller.
+ */
+static osal_retval_t posix_spinlock_check_owner(osal_spinlock_t *mtx) {
+    osal_retval_t ret = OSAL_OK;
+
+    if (    (POSIX_SPINLOCK_TYPE(mtx) != OSAL_SPINLOCK_ATTR__TYPE__NORMAL) && 
+            (__atomic_load_n(&mtx->owner, __ATOMIC_RELAXED) == posix_spinlock_self())) {
+        if (POSIX_SPINLOCK_TYPE(mtx) == OSAL_SPINLOCK_ATTR__TYPE__RECURSIVE) {
+            mtx->count++;
+            ret = OSAL_ERR_BUSY;
+        } else {
+            ret = OSAL_ERR_DEAD_LOCK;
+        }
+    }
+
+    return ret;
+}
+
+static void posix_spinlock_set_owner(osal_spinlock_t *mtx) {
+    if (POSIX_SPINLOCK_TYPE(mtx) != OSAL_SPINLOCK_ATTR__TYPE__NORMAL) {
+        __atomic_store_n(&mtx->owner, posix_spinlock_self(), __ATOMIC_RELAXED);
+        mtx->count = 1u;
+    }
+}
 
 //! \brief Initialize a spinlock.
 /*!
@@ -51,101 +292,130 @@ osal_retval_t osal_spinlock_init(osal_spinlock_t *mtx, const osal_spinlock_attr_
     assert(mtx != NULL);
 
     osal_retval_t ret = OSAL_OK;
-    int posix_ret;
-
-    (void)attr;
-/*
-    pthread_spinlockattr_t posix_attr;
-    pthread_spinlockattr_t *pposix_attr = NULL;
+    osal_spinlock_attr_t local_attr = OSAL_SPINLOCK_ATTR__TYPE__NORMAL;
 
     if (attr != NULL) {
-        pthread_spinlockattr_init(&posix_attr);
-
-        if (((*attr) & OSAL_SPINLOCK_ATTR__TYPE__MASK) == OSAL_SPINLOCK_ATTR__TYPE__NORMAL) {
-            pthread_spinlockattr_settype(&posix_attr, PTHREAD_SPINLOCK_NORMAL);
-        } else if (((*attr) & OSAL_SPINLOCK_ATTR__TYPE__MASK) == OSAL_SPINLOCK_ATTR__TYPE__ERRORCHECK) {
-            pthread_spinlockattr_settype(&posix_attr, PTHREAD_SPINLOCK_ERRORCHECK);
-        } else if (((*attr) & OSAL_SPINLOCK_ATTR__TYPE__MASK) == OSAL_SPINLOCK_ATTR__TYPE__RECURSIVE) {
-            pthread_spinlockattr_settype(&posix_attr, PTHREAD_SPINLOCK_RECURSIVE);
-        }
+        local_attr = *attr;
+    }
 
-        if (((*attr) & OSAL_SPINLOCK_ATTR__ROBUST) == OSAL_SPINLOCK_ATTR__ROBUST) {
-            pthread_spinlockattr_setrobust(&posix_attr, PTHREAD_SPINLOCK_ROBUST);
-        }
+    if (    ((local_attr & OSAL_SPINLOCK_ATTR__ROBUST) != 0u) ||
+            ((local_attr & OSAL_SPINLOCK_ATTR__PROTOCOL__MASK) != OSAL_SPINLOCK_ATTR__PROTOCOL__NONE) ||
+            ((local_attr & OSAL_SPINLOCK_ATTR__PRIOCEILING__MASK) != 0u) ||
+            ((local_attr & OSAL_SPINLOCK_ATTR__TYPE__MASK) > OSAL_SPINLOCK_ATTR__TYPE__RECURSIVE) ||
+            ((local_attr & OSAL_SPINLOCK_ATTR__ALGORITHM__MASK) > OSAL_SPINLOCK_ATTR__ALGORITHM__MCS)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else if (((local_attr & OSAL_SPINLOCK_ATTR__ALGORITHM__MASK) == OSAL_SPINLOCK_ATTR__ALGORITHM__MCS) && 
+            ((local_attr & OSAL_SPINLOCK_ATTR__PROCESS_SHARED) != 0u)) {
+        // queue nodes live in the address space of the waiting tasks
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        // no pointers and no process local state for the other algorithms, 
+        // so they can be placed in shared memory as they are
+        mtx->attr           = local_attr;
+        mtx->word           = 0u;
+        mtx->ticket_next    = 0u;
+        mtx->ticket_owner   = 0u;
+        mtx->mcs_tail       = NULL;
+        mtx->mcs_owner      = NULL;
+        mtx->owner          = 0u;
+        mtx->count          = 0u;
+        mtx->stats.locks    = 0u;
+        mtx->stats.contended = 0u;
+        mtx->stats.spins    = 0u;
+        mtx->stats.max_spins = 0u;
+    }
 
-        if (((*attr) & OSAL_SPINLOCK_ATTR__PROCESS_SHARED) == OSAL_SPINLOCK_ATTR__PROCESS_SHARED) {
-            pthread_spinlockattr_setpshared(&posix_attr, PTHREAD_PROCESS_SHARED);
-        }
-        
-        if (((*attr) & OSAL_SPINLOCK_ATTR__PROTOCOL__MASK) == OSAL_SPINLOCK_ATTR__PROTOCOL__NONE) {
-            pthread_spinlockattr_setprotocol(&posix_attr, PTHREAD_PRIO_NONE);
-        } else if (((*attr) & OSAL_SPINLOCK_ATTR__PROTOCOL__MASK) == OSAL_SPINLOCK_ATTR__PROTOCOL__INHERIT) {
-            pthread_spinlockattr_setprotocol(&posix_attr, PTHREAD_PRIO_INHERIT);
-        } else if (((*attr) & OSAL_SPINLOCK_ATTR__PROTOCOL__MASK) == OSAL_SPINLOCK_ATTR__PROTOCOL__PROTECT) {
-            pthread_spinlockattr_setprotocol(&posix_attr, PTHREAD_PRIO_PROTECT);
-        }
+    return ret;
+}
 
-        if (((*attr) & OSAL_SPINLOCK_ATTR__PRIOCEILING__MASK) != 0u) {
-            int prioceiling = (((*attr) & OSAL_SPINLOCK_ATTR__PRIOCEILING__MASK) >> OSAL_SPINLOCK_ATTR__PRIOCEILING__SHIFT);
-            pthread_spinlockattr_setprioceiling(&posix_attr, prioceiling);
-        }
+//! \brief Locks a spinlock.
+/*!
+ * \param[in]   mtx     Pointer to osal spinlock structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_spinlock_lock(osal_spinlock_t *mtx) {
+    assert(mtx != NULL);
 
-        pposix_attr = &posix_attr;
-    }*/
+    osal_retval_t ret = posix_spinlock_check_owner(mtx);
 
-    posix_ret = pthread_spin_init(&mtx->posix_sl, 0);//pposix_attr);
+    if (ret == OSAL_OK) {
+        osal_uint64_t polls = 0u;
 
-    if (posix_ret != 0) {
-        if (posix_ret == EAGAIN) {
-            ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
-        } else if (posix_ret == ENOMEM) {
-            ret = OSAL_ERR_OUT_OF_MEMORY;
-        } else if (posix_ret == EPERM) {
-            ret = OSAL_ERR_PERMISSION_DENIED;
-        } else if (posix_ret == EINVAL) {
-            ret = OSAL_ERR_INVALID_PARAM;
+        if (POSIX_SPINLOCK_ALGORITHM(mtx) == OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET) {
+            polls = posix_spinlock_ticket_lock(mtx);
+        } else if (POSIX_SPINLOCK_ALGORITHM(mtx) == OSAL_SPINLOCK_ATTR__ALGORITHM__MCS) {
+            osal_spinlock_mcs_node_t *node = posix_spinlock_mcs_node_get();
+
+            if (node == NULL) {
+                ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
+            } else {
+                polls = posix_spinlock_mcs_lock(mtx, node);
+                mtx->mcs_owner = node;
+            }
         } else {
-            ret = OSAL_ERR_UNAVAILABLE;
+            polls = posix_spinlock_tas_lock(mtx);
         }
-    } else {
+
+        if (ret == OSAL_OK) {
+            posix_spinlock_set_owner(mtx);
+
+            if ((mtx->attr & OSAL_SPINLOCK_ATTR__STATS) != 0u) {
+                posix_spinlock_stats_update(mtx, polls);
+            }
+        }
+    } else if (ret == OSAL_ERR_BUSY) {
+        // recursive lock already held by caller
         ret = OSAL_OK;
-    }
+    } else {}
 
     return ret;
 }
 
-//! \brief Locks a spinlock.
+//! \brief Tries to lock a spinlock.
 /*!
  * \param[in]   mtx     Pointer to osal spinlock structure. Content is OS dependent.
  *
  * \return OK or ERROR_CODE.
  */
-osal_retval_t osal_spinlock_lock(osal_spinlock_t *mtx) {
+osal_retval_t osal_spinlock_trylock(osal_spinlock_t *mtx) {
     assert(mtx != NULL);
 
-    osal_retval_t ret;
-    int posix_ret;
-
-    posix_ret = pthread_spin_lock(&mtx->posix_sl);
-    if (posix_ret != 0) {
-        if (posix_ret == EAGAIN) {
-            ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
-        } else if (posix_ret == EINVAL) {
-            ret = OSAL_ERR_INVALID_PARAM; 
-#if LIBOSAL_HAVE_ENOTRECOVERABLE == 1
-        } else if (posix_ret == ENOTRECOVERABLE) {
-            ret = OSAL_ERR_NOT_RECOVERABLE;
-#endif
-        } else if (posix_ret == EOWNERDEAD) {
-            ret = OSAL_ERR_OWNER_DEAD;
-        } else if (posix_ret == EDEADLK) {
-            ret = OSAL_ERR_DEAD_LOCK;
+    osal_retval_t ret = posix_spinlock_check_owner(mtx);
+
+    if (ret == OSAL_OK) {
+        osal_bool_t locked = OSAL_FALSE;
+
+        if (POSIX_SPINLOCK_ALGORITHM(mtx) == OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET) {
+            locked = posix_spinlock_ticket_try(mtx);
+        } else if (POSIX_SPINLOCK_ALGORITHM(mtx) == OSAL_SPINLOCK_ATTR__ALGORITHM__MCS) {
+            osal_spinlock_mcs_node_t *node = posix_spinlock_mcs_node_get();
+
+            if (node == NULL) {
+                ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
+            } else if (posix_spinlock_mcs_try(mtx, node) == OSAL_TRUE) {
+                mtx->mcs_owner = node;
+                locked = OSAL_TRUE;
+            } else {
+                node->in_use = 0u;
+            }
         } else {
-            ret = OSAL_ERR_UNAVAILABLE;
+            locked = posix_spinlock_tas_try(mtx);
         }
-    } else {
+
+        if (locked == OSAL_TRUE) {
+            posix_spinlock_set_owner(mtx);
+
+            if ((mtx->attr & OSAL_SPINLOCK_ATTR__STATS) != 0u) {
+                posix_spinlock_stats_update(mtx, 0u);
+            }
+        } else if (ret == OSAL_OK) {
+            ret = OSAL_ERR_BUSY;
+        } else {}
+    } else if (ret == OSAL_ERR_BUSY) {
+        // recursive lock already held by caller
         ret = OSAL_OK;
-    }
+    } else {}
 
     return ret;
 }
@@ -159,18 +429,28 @@ osal_retval_t osal_spinlock_lock(osal_spinlock_t *mtx) {
 osal_retval_t osal_spinlock_unlock(osal_spinlock_t *mtx) {
     assert(mtx != NULL);
 
-    osal_retval_t ret;
-    int posix_ret;
+    osal_retval_t ret = OSAL_OK;
+    osal_bool_t release = OSAL_TRUE;
 
-    posix_ret = pthread_spin_unlock(&mtx->posix_sl);
-    if (posix_ret != 0) {
-        if (posix_ret == EPERM) {
+    if (POSIX_SPINLOCK_TYPE(mtx) != OSAL_SPINLOCK_ATTR__TYPE__NORMAL) {
+        if (__atomic_load_n(&mtx->owner, __ATOMIC_RELAXED) != posix_spinlock_self()) {
             ret = OSAL_ERR_PERMISSION_DENIED;
+            release = OSAL_FALSE;
+        } else if (--mtx->count != 0u) {
+            release = OSAL_FALSE;
         } else {
-            ret = OSAL_ERR_UNAVAILABLE;
+            __atomic_store_n(&mtx->owner, 0u, __ATOMIC_RELAXED);
+        }
+    }
+
+    if (release == OSAL_TRUE) {
+        if (POSIX_SPINLOCK_ALGORITHM(mtx) == OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET) {
+            posix_spinlock_ticket_unlock(mtx);
+        } else if (POSIX_SPINLOCK_ALGORITHM(mtx) == OSAL_SPINLOCK_ATTR__ALGORITHM__MCS) {
+            posix_spinlock_mcs_unlock(mtx);
+        } else {
+            posix_spinlock_tas_unlock(mtx);
         }
-    } else {
-        ret = OSAL_OK;
     }
 
     return ret;
@@ -185,12 +465,30 @@ osal_retval_t osal_spinlock_unlock(osal_spinlock_t *mtx) {
 osal_retval_t osal_spinlock_destroy(osal_spinlock_t *mtx) {
     assert(mtx != NULL);
 
+    // nothing allocated
+    return OSAL_OK;
+}
+
+//! \brief Get statistics of a spinlock.
+/*!
+ * \param[in]   mtx     Pointer to osal spinlock structure. Content is OS dependent.
+ * \param[out]  stats   Returns statistics.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_spinlock_get_stats(osal_spinlock_t *mtx, osal_spinlock_stats_t *stats) {
+    assert(mtx != NULL);
+    assert(stats != NULL);
+
     osal_retval_t ret = OSAL_OK;
-    int posix_ret;
 
-    posix_ret = pthread_spin_destroy(&mtx->posix_sl);
-    if (posix_ret != 0) {
-        ret = OSAL_ERR_OPERATION_FAILED;
+    if ((mtx->attr & OSAL_SPINLOCK_ATTR__STATS) == 0u) {
+        ret = OSAL_ERR_UNAVAILABLE;
+    } else {
+        stats->locks        = __atomic_load_n(&mtx->stats.locks, __ATOMIC_RELAXED);
+        stats->contended    = __atomic_load_n(&mtx->stats.contended, __ATOMIC_RELAXED);
+        stats->spins        = __atomic_load_n(&mtx->stats.spins, __ATOMIC_RELAXED);
+        stats->max_spins    = __atomic_load_n(&mtx->stats.max_spins, __ATOMIC_RELAXED);
     }
 
     return ret;
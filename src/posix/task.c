@@ -40,24 +40,219 @@
 #include <libosal/osal.h>
 #include <libosal/task.h>
 #include <libosal/io.h>
+#include <libosal/rt.h>
+
+#include "futex.h"
 
 #if LIBOSAL_HAVE_SYS_PRCTL_H == 1
 #include <sys/prctl.h>
 #endif
 
+#if LIBOSAL_HAVE_LINUX_MEMPOLICY_H == 1
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <sys/mman.h>
 #include <errno.h>
 #include <assert.h>
 
+#include <stdio.h>
 #include <string.h>
 
+//! NUMA node words passed to the kernel, it rejects masks shorter than its node count.
+#define POSIX_TASK_NODEMASK_WORDS   16u
+
+//! Stack kept untouched by the prefault fallback for the frames below the wrapper.
+#define POSIX_TASK_STACK_RESERVE    8192u
+
+#if LIBOSAL_HAVE_PTHREAD_SETAFFINITY_NP
+//! Native cpu set large enough for every osal cpu set.
+typedef struct posix_cpu_set {
+    cpu_set_t sets[(OSAL_CPUSET_SIZE + CPU_SETSIZE - 1u) / CPU_SETSIZE];
+} posix_cpu_set_t;
+#endif
+
 typedef struct posix_start_args {
-    int running;
+    osal_uint32_t running;              //!< \brief Set to 1 by the new task, futex word.
 
     osal_task_handler_t user_handler;
     osal_task_handler_arg_t user_arg;
     const osal_task_attr_t *user_attr;
 } posix_start_args_t;
 
+#if (LIBOSAL_HAVE_LINUX_MEMPOLICY_H == 1) && defined(SYS_set_mempolicy)
+//! \brief Add the CPUs of a NUMA node from sysfs to a cpu set.
+static osal_retval_t posix_task_add_numa_cpus(osal_uint32_t node, osal_cpuset_t *cpuset) {
+    osal_retval_t ret = OSAL_OK;
+    osal_char_t path[64];
+    osal_char_t list[1024];
+    osal_cpuset_t node_cpus;
+    FILE *fp;
+
+    (void)snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+    fp = fopen(path, "r");
+    if (fp == NULL) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        if (fgets(list, (int)sizeof(list), fp) == NULL) {
+            list[0] = '\0';
+        }
+        (void)fclose(fp);
+
+        ret = osal_cpuset_parse(&node_cpus, list);
+        if (ret == OSAL_OK) {
+            osal_cpuset_or(cpuset, cpuset, &node_cpus);
+        }
+    }
+
+    return ret;
+}
+#endif
+
+//! \brief NUMA nodes the calling thread is bound to, 0 if not bound.
+static osal_uint64_t posix_task_get_numa_nodes(void) {
+    osal_uint64_t ret = 0u;
+
+#if (LIBOSAL_HAVE_LINUX_MEMPOLICY_H == 1) && defined(SYS_get_mempolicy)
+    int mode = 0;
+    osal_uint64_t nodemask[POSIX_TASK_NODEMASK_WORDS] = { 0u };
+
+    if ((syscall(SYS_get_mempolicy, &mode, nodemask, (unsigned long)(POSIX_TASK_NODEMASK_WORDS * 64u), NULL, 0) == 0) &&
+            ((mode & ~(MPOL_F_STATIC_NODES | MPOL_F_RELATIVE_NODES)) == MPOL_BIND)) {
+        ret = nodemask[0];
+    }
+#endif
+
+    return ret;
+}
+
+//! \brief Native policy of an osal policy.
+static int posix_task_map_policy(osal_task_sched_policy_t policy) {
+    int ret;
+
+    if (policy == OSAL_SCHED_POLICY_FIFO) {
+        ret = SCHED_FIFO;
+    } else if (policy == OSAL_SCHED_POLICY_ROUND_ROBIN) {
+        ret = SCHED_RR;
+    } else {
+        ret = SCHED_OTHER;
+    }
+
+    return ret;
+}
+
+//! \brief Put stack and scheduling of the task attributes into thread attributes.
+static osal_retval_t posix_task_setup_attr(pthread_attr_t *pattr, const osal_task_attr_t *attr) {
+    assert(pattr != NULL);
+    assert(attr != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    int local_ret = 0;
+
+    osal_bool_t have_stack = ((attr->flags & OSAL_TASK_ATTR__STACK) != 0u) ? OSAL_TRUE : OSAL_FALSE;
+
+    if (have_stack == OSAL_TRUE) {
+        if (attr->stack != NULL) {
+            local_ret = pthread_attr_setstack(pattr, attr->stack, attr->stack_size);
+        } else if (attr->stack_size != 0u) {
+            local_ret = pthread_attr_setstacksize(pattr, attr->stack_size);
+        }
+    }
+
+    if (local_ret == 0) {
+        if ((attr->flags & OSAL_TASK_ATTR__NO_GUARD) != 0u) {
+            local_ret = pthread_attr_setguardsize(pattr, 0u);
+        } else if ((have_stack == OSAL_TRUE) && (attr->guard_size != 0u)) {
+            local_ret = pthread_attr_setguardsize(pattr, attr->guard_size);
+        }
+    }
+
+    if ((local_ret == 0) && ((attr->policy != 0u) || (attr->priority != 0u))) {
+        // the task has to start with its scheduling, not inherit the one of the caller
+        int policy;
+        struct sched_param param;
+        local_ret = pthread_getschedparam(pthread_self(), &policy, &param);
+
+        if (local_ret == 0) {
+            if (attr->policy != 0u) {
+                policy = posix_task_map_policy(attr->policy);
+            }
+
+            if (attr->priority != 0u) {
+                param.sched_priority = attr->priority;
+            }
+
+            if (sched_get_priority_min(policy) > param.sched_priority) {
+                param.sched_priority = sched_get_priority_min(policy);
+            } else if (sched_get_priority_max(policy) < param.sched_priority) {
+                param.sched_priority = sched_get_priority_max(policy);
+            }
+
+            local_ret = pthread_attr_setinheritsched(pattr, PTHREAD_EXPLICIT_SCHED);
+        }
+
+        if (local_ret == 0) {
+            local_ret = pthread_attr_setschedpolicy(pattr, policy);
+        }
+
+        if (local_ret == 0) {
+            local_ret = pthread_attr_setschedparam(pattr, &param);
+        }
+    }
+
+    if (local_ret != 0) {
+        if (local_ret == EINVAL) {
+            ret = OSAL_ERR_INVALID_PARAM;
+        } else {
+            ret = OSAL_ERR_OPERATION_FAILED;
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Lock the stack of the calling thread, which also faults it in.
+static osal_retval_t posix_task_lock_stack(void) {
+    osal_retval_t ret = OSAL_OK;
+
+#if LIBOSAL_HAVE_PTHREAD_GETATTR_NP
+    pthread_attr_t pattr;
+    void *stack_addr = NULL;
+    size_t stack_size = 0u;
+
+    if (pthread_getattr_np(pthread_self(), &pattr) != 0) {
+        ret = OSAL_ERR_OPERATION_FAILED;
+    } else {
+        if (pthread_attr_getstack(&pattr, &stack_addr, &stack_size) != 0) {
+            ret = OSAL_ERR_OPERATION_FAILED;
+        }
+
+        (void)pthread_attr_destroy(&pattr);
+    }
+
+    if ((ret == OSAL_OK) && (mlock(stack_addr, stack_size) != 0)) {
+        // mlock reports an exceeded RLIMIT_MEMLOCK without CAP_IPC_LOCK as ENOMEM
+        if ((errno == EPERM) || (errno == ENOMEM)) {
+            ret = OSAL_ERR_PERMISSION_DENIED;
+        } else {
+            ret = OSAL_ERR_OPERATION_FAILED;
+        }
+
+        // at least fault in the unused stack, it may still be swapped out later
+        osal_size_t unused = (osal_size_t)((osal_uint8_t *)&stack_size - (osal_uint8_t *)stack_addr);
+        if (unused > POSIX_TASK_STACK_RESERVE) {
+            (void)osal_rt_prefault_stack(unused - POSIX_TASK_STACK_RESERVE);
+        }
+    }
+#else
+    ret = OSAL_ERR_NOT_IMPLEMENTED;
+#endif
+
+    return ret;
+}
+
 static void *posix_task_wrapper(void *args) {
     // cppcheck-suppress misra-c2012-11.5
     posix_start_args_t *start_args = (posix_start_args_t *)args;
@@ -67,50 +262,46 @@ static void *posix_task_wrapper(void *args) {
     osal_task_handler_arg_t user_arg = start_args->user_arg;
     const osal_task_attr_t *user_attr = start_args->user_attr;
 
+    // policy, priority and stack are already set by osal_task_create
     if (user_attr != NULL) {
-        if (user_attr->policy != 0u) {
-            osal_retval_t local_ret = osal_task_set_policy(NULL, user_attr->policy);
+        if (((user_attr->flags & OSAL_TASK_ATTR__NUMA_NODES) != 0u) && (user_attr->numa_nodes != 0u)) {
+            osal_retval_t local_ret = osal_task_bind_numa(user_attr->numa_nodes);
             if (local_ret != OSAL_OK) {
-                switch (local_ret) {
-                    case OSAL_ERR_PERMISSION_DENIED:
-                        fprintf(stderr, "unknown error occured setting policy to %d: PERMISSION DENIED\n", user_attr->policy);
-                        break;
-                    case OSAL_ERR_OPERATION_FAILED:
-                        fprintf(stderr, "unknown error occured setting policy to %d: OPERATION FAILED\n", user_attr->policy);
-                        break;
-                    default:
-                        fprintf(stderr, "unknown error occured setting policy to %d: %d\n", user_attr->policy, local_ret);
-                        break;
-                }
+                fprintf(stderr, "unknown error occured binding to numa nodes 0x%llx: %d\n", 
+                        (unsigned long long)user_attr->numa_nodes, local_ret);
             }
         }
 
-        if (user_attr->priority != 0u) {
-            osal_retval_t local_ret = osal_task_set_priority(NULL, user_attr->priority);
+        if (((user_attr->flags & OSAL_TASK_ATTR__CPUSET) != 0u) && (osal_cpuset_count(&user_attr->cpuset) > 0u)) {
+            osal_retval_t local_ret = osal_task_set_cpuset(NULL, &user_attr->cpuset);
+            if (local_ret != OSAL_OK) {
+                fprintf(stderr, "unknown error occured setting cpu set with %u cpus: %d\n", 
+                        osal_cpuset_count(&user_attr->cpuset), local_ret);
+            }
+        } else if (user_attr->affinity > 0u) {
+            osal_retval_t local_ret = osal_task_set_affinity(NULL, user_attr->affinity);
             if (local_ret != OSAL_OK) {
                 switch (local_ret) {
-                    case OSAL_ERR_PERMISSION_DENIED:
-                        fprintf(stderr, "unknown error occured setting priority to %d: PERMISSION DENIED\n", user_attr->priority);
-                        break;
-                    case OSAL_ERR_OPERATION_FAILED:
-                        fprintf(stderr, "unknown error occured setting priority to %d: OPERATION FAILED\n", user_attr->priority);
+                    case OSAL_ERR_INVALID_PARAM:
+                        fprintf(stderr, "unknown error occured setting affinity to %d: INVALID PARAMETER\n", user_attr->affinity);
                         break;
                     default:
-                        fprintf(stderr, "unknown error occured setting priority to %d: %d\n", user_attr->priority, local_ret);
+                        fprintf(stderr, "unknown error occured setting affinity to %d: %d\n", user_attr->affinity, local_ret);
                         break;
                 }
             }
         }
 
-        if (user_attr->affinity > 0u) {
-            osal_retval_t local_ret = osal_task_set_affinity(NULL, user_attr->affinity);
+        // after the NUMA binding, so the stack pages come from the bound nodes
+        if ((user_attr->flags & OSAL_TASK_ATTR__STACK_PREFAULT) != 0u) {
+            osal_retval_t local_ret = posix_task_lock_stack();
             if (local_ret != OSAL_OK) {
                 switch (local_ret) {
-                    case OSAL_ERR_INVALID_PARAM:
-                        fprintf(stderr, "unknown error occured setting affinity to %d: INVALID PARAMETER\n", user_attr->affinity);
+                    case OSAL_ERR_PERMISSION_DENIED:
+                        fprintf(stderr, "unknown error occured locking stack: PERMISSION DENIED\n");
                         break;
                     default:
-                        fprintf(stderr, "unknown error occured setting affinity to %d: %d\n", user_attr->affinity, local_ret);
+                        fprintf(stderr, "unknown error occured locking stack: %d\n", local_ret);
                         break;
                 }
             }
@@ -123,8 +314,10 @@ static void *posix_task_wrapper(void *args) {
 #endif
     }       
         
-    // after setting running to 1, we start_args will be invalid
-    start_args->running = 1;
+    // after setting running to 1, start_args will be invalid. waking a futex
+    // which may already be gone is harmless, the creator re-checks the word.
+    __atomic_store_n(&start_args->running, 1u, __ATOMIC_RELEASE);
+    posix_futex_wake(&start_args->running, 1u, OSAL_FALSE);
 
     return (*user_handler)(user_arg);
 }
@@ -145,9 +338,21 @@ osal_retval_t osal_task_create(osal_task_t *hdl, const osal_task_attr_t *attr,
 
     osal_retval_t ret = OSAL_OK;
     int local_ret;
+    pthread_attr_t pattr;
     posix_start_args_t start_args = { 0, handler, arg, attr };
 
-    local_ret = pthread_create(&hdl->tid, NULL, posix_task_wrapper, &start_args);
+    local_ret = pthread_attr_init(&pattr);
+    if (local_ret == 0) {
+        if (attr != NULL) {
+            ret = posix_task_setup_attr(&pattr, attr);
+        }
+
+        if (ret == OSAL_OK) {
+            local_ret = pthread_create(&hdl->tid, &pattr, posix_task_wrapper, &start_args);
+        }
+
+        (void)pthread_attr_destroy(&pattr);
+    }
     
     if (local_ret != 0) {
         if (local_ret == EAGAIN) {
@@ -163,8 +368,8 @@ osal_retval_t osal_task_create(osal_task_t *hdl, const osal_task_attr_t *attr,
 
     if (ret == OSAL_OK) {
         // only wait if thread has been started successfully
-        while (start_args.running == 0) {
-            osal_sleep(1000000);
+        while (__atomic_load_n(&start_args.running, __ATOMIC_ACQUIRE) == 0u) {
+            (void)posix_futex_wait(&start_args.running, 0u, NULL, OSAL_FALSE);
         }
     }
 
@@ -259,20 +464,26 @@ osal_retval_t osal_task_set_task_attr(osal_task_t *hdl, osal_task_attr_t *attr)
         }
     }
 
-    if (ret == OSAL_OK) {
-#if LIBOSAL_HAVE_PTHREAD_SETAFFINITY_NP
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
-        for (uint32_t i = 0u; i < (sizeof(attr->affinity) * 8u); ++i) {
-            if ((attr->affinity & ((uint32_t)1u << i)) != 0u) {
-                CPU_SET(i, &cpuset);
-            }
-        }
+    osal_uint64_t numa_nodes = ((attr->flags & OSAL_TASK_ATTR__NUMA_NODES) != 0u) ? attr->numa_nodes : 0u;
 
-        local_ret = pthread_setaffinity_np(hdl->tid, sizeof(cpu_set_t), &cpuset);
-        if (local_ret != 0) {
+    if ((ret == OSAL_OK) && (numa_nodes != 0u)) {
+        // the memory policy can only be changed by the thread itself
+        if (pthread_equal(hdl->tid, pthread_self()) != 0) {
+            ret = osal_task_bind_numa(numa_nodes);
+        } else {
             ret = OSAL_ERR_INVALID_PARAM;
         }
+    }
+
+    if (ret == OSAL_OK) {
+#if LIBOSAL_HAVE_PTHREAD_SETAFFINITY_NP
+        if (((attr->flags & OSAL_TASK_ATTR__CPUSET) != 0u) && (osal_cpuset_count(&attr->cpuset) > 0u)) {
+            ret = osal_task_set_cpuset(hdl, &attr->cpuset);
+        } else if ((attr->affinity != 0u) || (numa_nodes == 0u)) {
+            osal_cpuset_t cpuset;
+            osal_cpuset_from_mask(&cpuset, attr->affinity);
+            ret = osal_task_set_cpuset(hdl, &cpuset);
+        }
 #endif
     }
 
@@ -315,21 +526,42 @@ osal_retval_t osal_task_get_task_attr(osal_task_t *hdl, osal_task_attr_t *attr)
     }
 
     if (ret == OSAL_OK) {
-#if LIBOSAL_HAVE_PTHREAD_SETAFFINITY_NP
         attr->affinity = 0;
+        osal_cpuset_zero(&attr->cpuset);
+        attr->numa_nodes = 0u;
+        attr->flags = 0u;
 
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
+#if LIBOSAL_HAVE_PTHREAD_SETAFFINITY_NP
+        ret = osal_task_get_cpuset(hdl, &attr->cpuset);
+        if (ret == OSAL_OK) {
+            attr->affinity = osal_cpuset_to_mask(&attr->cpuset);
+            attr->flags |= OSAL_TASK_ATTR__CPUSET;
+        }
+#endif
+    }
 
-        local_ret = pthread_getaffinity_np(hdl->tid, sizeof(cpuset), &cpuset);
-        if (local_ret != 0) {
-            ret = OSAL_ERR_INVALID_PARAM;
-        } else {
-            for (osal_uint32_t j = 0; j < CPU_SETSIZE; j++) {
-                if (CPU_ISSET(j, &cpuset) != 0u) {
-                    attr->affinity |= (1u << j);
-                }
+    if ((ret == OSAL_OK) && (pthread_equal(hdl->tid, pthread_self()) != 0)) {
+        attr->numa_nodes = posix_task_get_numa_nodes();
+        attr->flags |= OSAL_TASK_ATTR__NUMA_NODES;
+    }
+
+    if (ret == OSAL_OK) {
+        attr->stack_size = 0u;
+        attr->stack = NULL;
+        attr->guard_size = 0u;
+
+#if LIBOSAL_HAVE_PTHREAD_GETATTR_NP
+        pthread_attr_t pattr;
+        if (pthread_getattr_np(hdl->tid, &pattr) == 0) {
+            size_t size;
+            if (pthread_attr_getstacksize(&pattr, &size) == 0) {
+                attr->stack_size = size;
+            }
+            if (pthread_attr_getguardsize(&pattr, &size) == 0) {
+                attr->guard_size = size;
             }
+            attr->flags |= OSAL_TASK_ATTR__STACK;
+            (void)pthread_attr_destroy(&pattr);
         }
 #endif
     }
@@ -372,13 +604,7 @@ osal_retval_t osal_task_set_policy(osal_task_t *hdl, osal_task_sched_policy_t po
     }
 
     if (ret == OSAL_OK) {
-        if (policy == OSAL_SCHED_POLICY_FIFO) {
-            tmp_policy = SCHED_FIFO;
-        } else if (policy == OSAL_SCHED_POLICY_ROUND_ROBIN) {
-            tmp_policy = SCHED_RR;
-        } else {
-            tmp_policy = SCHED_OTHER;
-        }
+        tmp_policy = posix_task_map_policy(policy);
 
         if (sched_get_priority_min(tmp_policy) > param.sched_priority) {
             param.sched_priority = sched_get_priority_min(tmp_policy);
@@ -546,19 +772,9 @@ osal_retval_t osal_task_set_affinity(osal_task_t *hdl,
     
     if (affinity > 0u) {
 #if LIBOSAL_HAVE_PTHREAD_SETAFFINITY_NP
-        pthread_t tid = hdl != NULL ? hdl->tid : pthread_self();
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
-        for (uint32_t i = 0u; i < (sizeof(affinity) * 8u); ++i) {
-            if ((affinity & ((uint32_t)1u << i)) != 0u) {
-                CPU_SET(i, &cpuset);
-            }
-        }
-
-        int local_ret = pthread_setaffinity_np(tid, sizeof(cpu_set_t), &cpuset);
-        if (local_ret != 0) {
-            ret = OSAL_ERR_INVALID_PARAM;
-        }
+        osal_cpuset_t cpuset;
+        osal_cpuset_from_mask(&cpuset, affinity);
+        ret = osal_task_set_cpuset(hdl, &cpuset);
 #endif
     }
 
@@ -579,24 +795,137 @@ osal_retval_t osal_task_get_affinity(osal_task_t *hdl,
     osal_retval_t ret = OSAL_OK;
 
 #if LIBOSAL_HAVE_PTHREAD_SETAFFINITY_NP
-    int local_ret;
+    osal_cpuset_t cpuset;
+    (*affinity) = 0;
+
+    ret = osal_task_get_cpuset(hdl, &cpuset);
+    if (ret == OSAL_OK) {
+        // CPUs from 32 on do not fit, use osal_task_get_cpuset for them
+        (*affinity) = osal_cpuset_to_mask(&cpuset);
+    }
+#endif
+    return ret;
+}
+
+//! \brief Change the CPU set of the specified thread.
+/*!
+ * \param[in]   hdl     Pointer to osal task structure. Content is OS dependent.
+ *                      If \p hdl is NULL, set CPU set for calling thread.
+ * \param[in]   cpuset  CPUs the thread may run on.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_task_set_cpuset(osal_task_t *hdl, const osal_cpuset_t *cpuset) {
+    assert(cpuset != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+#if LIBOSAL_HAVE_PTHREAD_SETAFFINITY_NP
     pthread_t tid = hdl != NULL ? hdl->tid : pthread_self();
+    posix_cpu_set_t native;
 
-    cpu_set_t cpuset;
-    (*affinity) = 0;
-    CPU_ZERO(&cpuset);
+    CPU_ZERO_S(sizeof(native.sets), native.sets);
+    for (osal_uint32_t cpu = osal_cpuset_next(cpuset, 0u); cpu < OSAL_CPUSET_SIZE; 
+            cpu = osal_cpuset_next(cpuset, cpu + 1u)) {
+        CPU_SET_S(cpu, sizeof(native.sets), native.sets);
+    }
 
-    local_ret = pthread_getaffinity_np(tid, sizeof(cpuset), &cpuset);
-    if (local_ret != 0) {
+    if (CPU_COUNT_S(sizeof(native.sets), native.sets) == 0) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else if (pthread_setaffinity_np(tid, sizeof(native.sets), native.sets) != 0) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    }
+#else
+    (void)hdl;
+    ret = OSAL_ERR_NOT_IMPLEMENTED;
+#endif
+
+    return ret;
+}
+
+//! \brief Get the CPU set of the specified thread.
+/*!
+ * \param[in]   hdl     Pointer to osal task structure. Content is OS dependent.
+ *                      If \p hdl is NULL, get CPU set of calling thread.
+ * \param[out]  cpuset  CPUs the thread may run on.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_task_get_cpuset(osal_task_t *hdl, osal_cpuset_t *cpuset) {
+    assert(cpuset != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    osal_cpuset_zero(cpuset);
+
+#if LIBOSAL_HAVE_PTHREAD_SETAFFINITY_NP
+    pthread_t tid = hdl != NULL ? hdl->tid : pthread_self();
+    posix_cpu_set_t native;
+
+    CPU_ZERO_S(sizeof(native.sets), native.sets);
+    if (pthread_getaffinity_np(tid, sizeof(native.sets), native.sets) != 0) {
         ret = OSAL_ERR_INVALID_PARAM;
     } else {
-        for (osal_uint32_t j = 0; j < CPU_SETSIZE; j++) {
-            if (CPU_ISSET(j, &cpuset) != 0u) {
-                (*affinity) |= (1u << j);
+        for (osal_uint32_t cpu = 0u; cpu < OSAL_CPUSET_SIZE; ++cpu) {
+            if (CPU_ISSET_S(cpu, sizeof(native.sets), native.sets) != 0) {
+                (void)osal_cpuset_set(cpuset, cpu);
+            }
+        }
+    }
+#else
+    (void)hdl;
+    ret = OSAL_ERR_NOT_IMPLEMENTED;
+#endif
+
+    return ret;
+}
+
+//! \brief Bind the calling thread and its memory to NUMA nodes.
+/*!
+ * \param[in]   numa_nodes  Bit n set for NUMA node n.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_task_bind_numa(osal_uint64_t numa_nodes) {
+    osal_retval_t ret = OSAL_OK;
+
+#if (LIBOSAL_HAVE_LINUX_MEMPOLICY_H == 1) && defined(SYS_set_mempolicy)
+    osal_cpuset_t cpuset;
+    osal_cpuset_zero(&cpuset);
+
+    if (numa_nodes == 0u) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    }
+
+    for (osal_uint32_t node = 0u; (node < OSAL_TASK_NUMA_NODES_MAX) && (ret == OSAL_OK); ++node) {
+        if ((numa_nodes & ((osal_uint64_t)1u << node)) != 0u) {
+            ret = posix_task_add_numa_cpus(node, &cpuset);
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        osal_uint64_t nodemask[POSIX_TASK_NODEMASK_WORDS] = { numa_nodes };
+
+        // set the policy first, the task must not touch memory on a foreign node after migrating
+        if (syscall(SYS_set_mempolicy, MPOL_BIND, nodemask, (unsigned long)(POSIX_TASK_NODEMASK_WORDS * 64u)) != 0) {
+            if (errno == EPERM) {
+                ret = OSAL_ERR_PERMISSION_DENIED;
+            } else if (errno == ENOSYS) {
+                ret = OSAL_ERR_NOT_IMPLEMENTED;
+            } else {
+                ret = OSAL_ERR_INVALID_PARAM;
             }
         }
     }
+
+    if (ret == OSAL_OK) {
+        ret = osal_task_set_cpuset(NULL, &cpuset);
+    }
+#else
+    (void)numa_nodes;
+    ret = OSAL_ERR_NOT_IMPLEMENTED;
 #endif
+
     return ret;
 }
 
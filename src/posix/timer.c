@@ -35,6 +35,8 @@
 #include <libosal/osal.h>
 #include <libosal/timer.h>
 
+#include "tsc.h"
+
 // cppcheck-suppress misra-c2012-21.6
 #include <stdio.h>
 // cppcheck-suppress misra-c2012-21.10
@@ -42,10 +44,171 @@
 #include <assert.h>
 #include <errno.h>
 
+#if defined(__x86_64__)
+#define POSIX_TSC_SUPPORTED     1
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
 //! Global configuration option for the clock source used by the timer
 //! functions.
 int global_clock_id = CLOCK_REALTIME;
 
+static osal_uint64_t posix_clock_gettime_nsec(int clock_id) {
+    osal_uint64_t ret = 0u;
+    struct timespec ts;
+
+    if (clock_gettime(clock_id, &ts) == 0) {
+        ret = ((osal_uint64_t)ts.tv_sec * NSEC_PER_SEC) + (osal_uint64_t)ts.tv_nsec;
+    }
+
+    return ret;
+}
+
+#ifdef POSIX_TSC_SUPPORTED
+
+#define POSIX_TSC_CALIBRATION_NSEC  10000000u       //!< Minimum calibration time against CLOCK_MONOTONIC.
+#define POSIX_TSC_RESYNC_NSEC       NSEC_PER_SEC    //!< Interval over which a resync steers out the error to CLOCK_MONOTONIC.
+#define POSIX_TSC_SLOTS             4u              //!< Conversion parameter slots, power of 2.
+
+//! TSC to nanosecond conversion, nsec = base_nsec + (((tsc - base_tsc) * mult) >> 32).
+/*!
+ * After steer_tsc ticks the conversion continues from end_nsec with the
+ * calibrated rate, so the time does not drift if no resync follows.
+ */
+typedef struct posix_tsc_params {
+    osal_uint64_t base_tsc;                         //!< TSC at start of interval.
+    osal_uint64_t base_nsec;                        //!< CLOCK_MONOTONIC time at start of interval.
+    osal_uint64_t mult;                             //!< Nanoseconds per tick while steering, 32.32 fixed-point.
+    osal_uint64_t steer_tsc;                        //!< Ticks of the steering interval.
+    osal_uint64_t end_nsec;                         //!< Time at end of the steering interval.
+    osal_uint64_t rate;                             //!< Calibrated nanoseconds per tick, 32.32 fixed-point.
+} posix_tsc_params_t;
+
+//! Calibrated TSC clock source.
+/*!
+ * Readers never block. The conversion parameters are written to the slot
+ * after the published one, a reader retries if its slot may have been
+ * reused while it was reading.
+ */
+static struct {
+    osal_uint32_t active;                           //!< TSC is the selected clock source.
+    osal_uint32_t invariant;                        //!< CPU has an invariant TSC.
+    osal_uint32_t seq;                              //!< Number of published parameter sets.
+    osal_uint32_t lock;                             //!< Serializes writers.
+    osal_uint64_t ref_tsc;                          //!< First calibration sample, TSC.
+    osal_uint64_t ref_nsec;                         //!< First calibration sample, CLOCK_MONOTONIC.
+    posix_tsc_params_t params[POSIX_TSC_SLOTS];     //!< Conversion parameters.
+} posix_tsc;
+
+//! Sample TSC and CLOCK_MONOTONIC as close together as possible.
+static void posix_tsc_sample(osal_uint64_t *tsc, osal_uint64_t *nsec) {
+    osal_uint64_t best = UINT64_MAX;
+
+    for (osal_uint32_t i = 0u; i < 5u; ++i) {
+        osal_uint64_t t0 = __rdtsc();
+        osal_uint64_t ns = posix_clock_gettime_nsec(CLOCK_MONOTONIC);
+        osal_uint64_t t1 = __rdtsc();
+
+        if ((t1 - t0) < best) {
+            best = t1 - t0;
+            *tsc = t0 + ((t1 - t0) / 2u);
+            *nsec = ns;
+        }
+    }
+}
+
+static osal_uint64_t posix_tsc_mult(osal_uint64_t nsec, osal_uint64_t ticks) {
+    return (osal_uint64_t)(((unsigned __int128)nsec << 32) / ticks);
+}
+
+static osal_uint64_t posix_tsc_convert(const posix_tsc_params_t *params, osal_uint64_t tsc) {
+    osal_uint64_t ret;
+    // TSCs of different CPUs may differ by a few ticks, never go back before base
+    osal_uint64_t delta = tsc > params->base_tsc ? tsc - params->base_tsc : 0u;
+
+    if (delta <= params->steer_tsc) {
+        ret = params->base_nsec + (osal_uint64_t)(((unsigned __int128)delta * params->mult) >> 32);
+    } else {
+        ret = params->end_nsec + (osal_uint64_t)(((unsigned __int128)(delta - params->steer_tsc) * params->rate) >> 32);
+    }
+
+    return ret;
+}
+
+//! Publish new conversion parameters, caller holds the lock.
+static void posix_tsc_publish(const posix_tsc_params_t *params) {
+    osal_uint32_t seq = __atomic_load_n(&posix_tsc.seq, __ATOMIC_RELAXED) + 1u;
+
+    posix_tsc.params[seq & (POSIX_TSC_SLOTS - 1u)] = *params;
+    __atomic_store_n(&posix_tsc.seq, seq, __ATOMIC_RELEASE);
+}
+
+static osal_uint64_t posix_tsc_gettime_nsec(void) {
+    posix_tsc_params_t params;
+    osal_uint32_t seq;
+
+    do {
+        seq = __atomic_load_n(&posix_tsc.seq, __ATOMIC_ACQUIRE);
+        params = posix_tsc.params[seq & (POSIX_TSC_SLOTS - 1u)];
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((__atomic_load_n(&posix_tsc.seq, __ATOMIC_RELAXED) - seq) >= (POSIX_TSC_SLOTS - 1u));
+
+    return posix_tsc_convert(&params, __rdtsc());
+}
+
+//! Finish calibration and publish first conversion parameters.
+static osal_bool_t posix_tsc_enable(void) {
+    osal_bool_t ret = OSAL_FALSE;
+
+    if (posix_tsc.invariant != 0u) {
+        while (__atomic_exchange_n(&posix_tsc.lock, 1u, __ATOMIC_ACQUIRE) != 0u) {
+        }
+
+        if (posix_tsc.ref_tsc == 0u) {
+            // osal_init was replaced by the application
+            posix_tsc_sample(&posix_tsc.ref_tsc, &posix_tsc.ref_nsec);
+        }
+
+        osal_uint64_t end = posix_tsc.ref_nsec + POSIX_TSC_CALIBRATION_NSEC;
+        struct timespec ts = { (time_t)(end / NSEC_PER_SEC), (long)(end % NSEC_PER_SEC) };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        }
+
+        posix_tsc_params_t params;
+        posix_tsc_sample(&params.base_tsc, &params.base_nsec);
+        params.rate = posix_tsc_mult(params.base_nsec - posix_tsc.ref_nsec, params.base_tsc - posix_tsc.ref_tsc);
+        params.mult = params.rate;
+        params.steer_tsc = 0u;
+        params.end_nsec = params.base_nsec;
+        posix_tsc_publish(&params);
+
+        __atomic_store_n(&posix_tsc.lock, 0u, __ATOMIC_RELEASE);
+        ret = OSAL_TRUE;
+    }
+
+    return ret;
+}
+
+#endif
+
+// Check for an invariant TSC and take the first calibration sample.
+void posix_timer_tsc_init(void) {
+#ifdef POSIX_TSC_SUPPORTED
+    unsigned int eax;
+    unsigned int ebx;
+    unsigned int ecx;
+    unsigned int edx;
+
+    // CPUID.80000007H:EDX[8], TSC runs at constant rate in all P-, C- and T-states
+    if (    (__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx) != 0) &&
+            ((edx & (1u << 8)) != 0u) && (posix_tsc.ref_tsc == 0u)) {
+        posix_tsc_sample(&posix_tsc.ref_tsc, &posix_tsc.ref_nsec);
+        posix_tsc.invariant = 1u;
+    }
+#endif
+}
+
 // sleep in nanoseconds
 void osal_sleep(osal_uint64_t nsec) {
     struct timespec ts = { (nsec / NSEC_PER_SEC), (nsec % NSEC_PER_SEC) };
@@ -91,11 +254,104 @@ osal_retval_t osal_sleep_until_nsec(osal_uint64_t nsec) {
 }
 
 //! Sets globally the internal clock source
-void osal_timer_set_clock_source(int clock_id) { global_clock_id = clock_id; }
+void osal_timer_set_clock_source(int clock_id) {
+    if (clock_id == LIBOSAL_CLOCK_TSC) {
+        // sleeps and timeouts use the clock the TSC is calibrated against
+        global_clock_id = CLOCK_MONOTONIC;
+
+#ifdef POSIX_TSC_SUPPORTED
+        if (posix_tsc_enable() == OSAL_TRUE) {
+            __atomic_store_n(&posix_tsc.active, 1u, __ATOMIC_RELEASE);
+        }
+#endif
+    } else {
+#ifdef POSIX_TSC_SUPPORTED
+        __atomic_store_n(&posix_tsc.active, 0u, __ATOMIC_RELEASE);
+#endif
+        global_clock_id = clock_id;
+    }
+}
+
+//! Steer the TSC clock back to CLOCK_MONOTONIC
+osal_retval_t osal_timer_tsc_resync(void) {
+    osal_retval_t ret = OSAL_ERR_UNAVAILABLE;
+
+#ifdef POSIX_TSC_SUPPORTED
+    if (__atomic_load_n(&posix_tsc.active, __ATOMIC_ACQUIRE) != 0u) {
+        while (__atomic_exchange_n(&posix_tsc.lock, 1u, __ATOMIC_ACQUIRE) != 0u) {
+        }
+
+        posix_tsc_params_t old = posix_tsc.params[posix_tsc.seq & (POSIX_TSC_SLOTS - 1u)];
+        posix_tsc_params_t params;
+        osal_uint64_t tsc = 0u;
+        osal_uint64_t nsec = 0u;
+
+        posix_tsc_sample(&tsc, &nsec);
+
+        // keeps the time continuous, the new interval starts at the current TSC
+        // time and its rate meets CLOCK_MONOTONIC at the end of the interval
+        osal_uint64_t est = posix_tsc_convert(&old, tsc);
+
+        params.base_tsc = tsc;
+        params.rate = posix_tsc_mult(nsec - posix_tsc.ref_nsec, tsc - posix_tsc.ref_tsc);
+        params.steer_tsc = (osal_uint64_t)(((unsigned __int128)POSIX_TSC_RESYNC_NSEC << 32) / params.rate);
+
+        if (est > (nsec + (POSIX_TSC_RESYNC_NSEC / 2u))) {
+            // too far ahead to be steered out in one interval, stepping back
+            // would break monotonicity, run at half rate until caught up
+            params.base_nsec = est;
+            params.mult = params.rate / 2u;
+            params.steer_tsc = (osal_uint64_t)(((unsigned __int128)(2u * (est - nsec)) << 32) / params.rate);
+        } else if ((est + (POSIX_TSC_RESYNC_NSEC / 2u)) < nsec) {
+            // too far behind, stepping forward keeps the time monotonic
+            params.base_nsec = nsec;
+            params.mult = params.rate;
+        } else {
+            params.base_nsec = est;
+            params.mult = posix_tsc_mult(nsec + POSIX_TSC_RESYNC_NSEC - est, params.steer_tsc);
+        }
+
+        params.end_nsec = params.base_nsec + (osal_uint64_t)(((unsigned __int128)params.steer_tsc * params.mult) >> 32);
+        posix_tsc_publish(&params);
+
+        __atomic_store_n(&posix_tsc.lock, 0u, __ATOMIC_RELEASE);
+        ret = OSAL_OK;
+    }
+#endif
+
+    return ret;
+}
+
+// Shift the TSC time by offset_nsec to simulate a drifted TSC.
+void posix_timer_tsc_skew(osal_int64_t offset_nsec) {
+#ifdef POSIX_TSC_SUPPORTED
+    if (__atomic_load_n(&posix_tsc.active, __ATOMIC_ACQUIRE) != 0u) {
+        while (__atomic_exchange_n(&posix_tsc.lock, 1u, __ATOMIC_ACQUIRE) != 0u) {
+        }
+
+        posix_tsc_params_t params = posix_tsc.params[posix_tsc.seq & (POSIX_TSC_SLOTS - 1u)];
+        params.base_nsec += (osal_uint64_t)offset_nsec;
+        params.end_nsec += (osal_uint64_t)offset_nsec;
+        posix_tsc_publish(&params);
+
+        __atomic_store_n(&posix_tsc.lock, 0u, __ATOMIC_RELEASE);
+    }
+#else
+    (void)offset_nsec;
+#endif
+}
 
 //! Returns the globally configured internal clock source
 int osal_timer_get_clock_source(){
-    return global_clock_id;
+    int ret = global_clock_id;
+
+#ifdef POSIX_TSC_SUPPORTED
+    if (__atomic_load_n(&posix_tsc.active, __ATOMIC_ACQUIRE) != 0u) {
+        ret = LIBOSAL_CLOCK_TSC;
+    }
+#endif
+
+    return ret;
 }
 
 //! gets timer 
@@ -103,13 +359,23 @@ osal_retval_t osal_timer_gettime(osal_timer_t *timer) {
     assert(timer != NULL);
     osal_retval_t ret = OSAL_OK;
 
-    struct timespec ts;
-    if (clock_gettime(global_clock_id, &ts) == -1) {
-        perror("clock_gettime");
-        ret = OSAL_ERR_UNAVAILABLE;
-    } else {
-        timer->sec = ts.tv_sec;
-        timer->nsec = ts.tv_nsec;
+#ifdef POSIX_TSC_SUPPORTED
+    if (__atomic_load_n(&posix_tsc.active, __ATOMIC_RELAXED) != 0u) {
+        osal_uint64_t nsec = posix_tsc_gettime_nsec();
+
+        timer->sec = nsec / NSEC_PER_SEC;
+        timer->nsec = nsec % NSEC_PER_SEC;
+    } else 
+#endif
+    {
+        struct timespec ts;
+        if (clock_gettime(global_clock_id, &ts) == -1) {
+            perror("clock_gettime");
+            ret = OSAL_ERR_UNAVAILABLE;
+        } else {
+            timer->sec = ts.tv_sec;
+            timer->nsec = ts.tv_nsec;
+        }
     }
 
     return ret;
@@ -117,12 +383,15 @@ osal_retval_t osal_timer_gettime(osal_timer_t *timer) {
 
 // gets time in nanoseconds
 osal_uint64_t osal_timer_gettime_nsec(void) {
-    osal_uint64_t ret = 0;
-    osal_timer_t tmr = { 0, 0 };
-    int local_ret = osal_timer_gettime(&tmr);
+    osal_uint64_t ret;
 
-    if (local_ret == OSAL_OK) {
-        ret = ((tmr.sec * NSEC_PER_SEC) + tmr.nsec);
+#ifdef POSIX_TSC_SUPPORTED
+    if (__atomic_load_n(&posix_tsc.active, __ATOMIC_RELAXED) != 0u) {
+        ret = posix_tsc_gettime_nsec();
+    } else 
+#endif
+    {
+        ret = posix_clock_gettime_nsec(global_clock_id);
     }
 
     return ret;
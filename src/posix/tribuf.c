@@ -0,0 +1,241 @@
+/**
+ * \file posix/tribuf.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL triple buffer posix source.
+ *
+ * OSAL triple buffer posix source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/tribuf.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define LIBOSAL_TRIBUF_MAGIC        0x00781BF0u
+
+#define POSIX_TRIBUF_INDEX_MASK     0x00000003u     //!< Frame index in latest.
+#define POSIX_TRIBUF_FRESH          0x00000004u     //!< Latest frame not yet read.
+
+//! \brief Round frame size up to whole cache lines, producer and consumer frames do not share one.
+static osal_uint32_t posix_tribuf_frame_size(osal_size_t frame_size) {
+    return (osal_uint32_t)((frame_size + OSAL_CACHE_LINE_SIZE - 1u) & ~(osal_size_t)(OSAL_CACHE_LINE_SIZE - 1u));
+}
+
+static void posix_tribuf_setup_handle(osal_tribuf_t *tb, osal_void_t *mem) {
+    tb->ctrl        = (osal_tribuf_ctrl_t *)mem;
+    tb->frames      = (osal_uint8_t *)mem + sizeof(osal_tribuf_ctrl_t);
+    tb->frame_size  = tb->ctrl->frame_size;
+}
+
+//! \brief Get size of memory region needed for a triple buffer.
+/*!
+ * \param[in]   frame_size  Size of one frame in bytes.
+ *
+ * \return Needed size in bytes, 0 on invalid parameters.
+ */
+osal_size_t osal_tribuf_get_size(osal_size_t frame_size) {
+    osal_size_t ret = 0u;
+
+    if ((frame_size > 0u) && (frame_size <= (0xFFFFFFFFu - OSAL_CACHE_LINE_SIZE))) {
+        ret = sizeof(osal_tribuf_ctrl_t) + ((osal_size_t)posix_tribuf_frame_size(frame_size) * 3u);
+    }
+
+    return ret;
+}
+
+//! \brief Initialize a triple buffer in a memory region.
+/*!
+ * \param[out]  tb          Pointer to osal triple buffer handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ * \param[in]   frame_size  Size of one frame in bytes.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_tribuf_init(osal_tribuf_t *tb, osal_void_t *mem, osal_size_t mem_size, osal_size_t frame_size) {
+    assert(tb != NULL);
+    assert(mem != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_size_t needed = osal_tribuf_get_size(frame_size);
+
+    if ((needed == 0u) || (needed > mem_size)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        osal_tribuf_ctrl_t *ctrl = (osal_tribuf_ctrl_t *)mem;
+
+        __atomic_store_n(&ctrl->magic, 0u, __ATOMIC_RELAXED);
+        memset(mem, 0, needed);
+
+        ctrl->frame_size    = posix_tribuf_frame_size(frame_size);
+        ctrl->write_idx     = 0u;
+        ctrl->latest        = 1u;
+        ctrl->read_idx      = 2u;
+
+        // publish initialized control block to attaching side
+        __atomic_store_n(&ctrl->magic, LIBOSAL_TRIBUF_MAGIC, __ATOMIC_RELEASE);
+
+        posix_tribuf_setup_handle(tb, mem);
+    }
+
+    return ret;
+}
+
+//! \brief Attach to a triple buffer initialized by someone else.
+/*!
+ * \param[out]  tb          Pointer to osal triple buffer handle.
+ * \param[in]   mem         Pointer to memory region, e.g. from \ref osal_shm_map.
+ * \param[in]   mem_size    Size of memory region in bytes.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_tribuf_attach(osal_tribuf_t *tb, osal_void_t *mem, osal_size_t mem_size) {
+    assert(tb != NULL);
+    assert(mem != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_tribuf_ctrl_t *ctrl = (osal_tribuf_ctrl_t *)mem;
+
+    if (mem_size < sizeof(osal_tribuf_ctrl_t)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else if (__atomic_load_n(&ctrl->magic, __ATOMIC_ACQUIRE) != LIBOSAL_TRIBUF_MAGIC) {
+        ret = OSAL_ERR_UNAVAILABLE;
+    } else if (osal_tribuf_get_size(ctrl->frame_size) > mem_size) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        posix_tribuf_setup_handle(tb, mem);
+    }
+
+    return ret;
+}
+
+//! \brief Get the frame to be filled (producer).
+/*!
+ * \param[in]   tb          Pointer to osal triple buffer handle.
+ * \param[out]  frame       Returns pointer to the frame to be filled.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_tribuf_reserve(osal_tribuf_t *tb, osal_void_t **frame) {
+    assert(tb != NULL);
+    assert(frame != NULL);
+
+    osal_uint32_t idx = __atomic_load_n(&tb->ctrl->write_idx, __ATOMIC_RELAXED);
+    *frame = &tb->frames[(osal_size_t)idx * tb->frame_size];
+
+    return OSAL_OK;
+}
+
+//! \brief Publish the filled frame as the latest one (producer).
+/*!
+ * \param[in]   tb          Pointer to osal triple buffer handle.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_tribuf_publish(osal_tribuf_t *tb) {
+    assert(tb != NULL);
+
+    osal_uint32_t idx = __atomic_load_n(&tb->ctrl->write_idx, __ATOMIC_RELAXED);
+
+    // release our frame contents, acquire the frame the consumer gave back
+    osal_uint32_t old = __atomic_exchange_n(&tb->ctrl->latest, idx | POSIX_TRIBUF_FRESH, __ATOMIC_ACQ_REL);
+
+    __atomic_store_n(&tb->ctrl->write_idx, old & POSIX_TRIBUF_INDEX_MASK, __ATOMIC_RELAXED);
+    __atomic_store_n(&tb->ctrl->published, tb->ctrl->published + 1u, __ATOMIC_RELEASE);
+
+    return OSAL_OK;
+}
+
+//! \brief Copy data into the producer frame and publish it (producer).
+/*!
+ * \param[in]   tb          Pointer to osal triple buffer handle.
+ * \param[in]   src         Data to publish.
+ * \param[in]   size        Number of bytes, at most the frame size.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_tribuf_write(osal_tribuf_t *tb, const osal_void_t *src, osal_size_t size) {
+    assert(tb != NULL);
+    assert(src != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_void_t *frame = NULL;
+
+    if (size > tb->frame_size) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        (void)osal_tribuf_reserve(tb, &frame);
+        (void)memcpy(frame, src, size);
+        ret = osal_tribuf_publish(tb);
+    }
+
+    return ret;
+}
+
+//! \brief Get the most recent published frame (consumer).
+/*!
+ * \param[in]   tb          Pointer to osal triple buffer handle.
+ * \param[out]  frame       Returns pointer to the most recent frame.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_tribuf_read(osal_tribuf_t *tb, osal_void_t **frame) {
+    assert(tb != NULL);
+    assert(frame != NULL);
+
+    osal_retval_t ret = OSAL_ERR_NO_DATA;
+    osal_uint32_t idx = __atomic_load_n(&tb->ctrl->read_idx, __ATOMIC_RELAXED);
+
+    // only touch the shared word if there is something new
+    if ((__atomic_load_n(&tb->ctrl->latest, __ATOMIC_RELAXED) & POSIX_TRIBUF_FRESH) != 0u) {
+        osal_uint32_t old = __atomic_exchange_n(&tb->ctrl->latest, idx, __ATOMIC_ACQ_REL);
+
+        idx = old & POSIX_TRIBUF_INDEX_MASK;
+        __atomic_store_n(&tb->ctrl->read_idx, idx, __ATOMIC_RELAXED);
+        ret = OSAL_OK;
+    }
+
+    *frame = &tb->frames[(osal_size_t)idx * tb->frame_size];
+
+    return ret;
+}
+
+//! \brief Get number of frames published so far.
+/*!
+ * \param[in]   tb          Pointer to osal triple buffer handle.
+ *
+ * \return Number of published frames, wraps around.
+ */
+osal_uint32_t osal_tribuf_published(osal_tribuf_t *tb) {
+    assert(tb != NULL);
+
+    return __atomic_load_n(&tb->ctrl->published, __ATOMIC_ACQUIRE);
+}
+
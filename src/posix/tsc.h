@@ -0,0 +1,62 @@
+/**
+ * \file posix/tsc.h
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL TSC clock source.
+ *
+ * Internal interface of the calibrated time stamp counter clock source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LIBOSAL_POSIX_TSC__H
+#define LIBOSAL_POSIX_TSC__H
+
+#include <libosal/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! \brief Check for an invariant TSC and take the first calibration sample.
+/*!
+ * Called by \ref osal_init. The calibration is finished when the TSC clock
+ * source is selected, the longer the time in between the better.
+ */
+void posix_timer_tsc_init(void);
+
+//! \brief Shift the TSC time to simulate a drifted TSC, for tests only.
+/*!
+ * The current conversion is moved by \p offset_nsec, the next
+ * \ref osal_timer_tsc_resync has to steer it out. Does nothing without
+ * the TSC clock source.
+ *
+ * \param[in]   offset_nsec     Offset added to the TSC time in [ns].
+ */
+void posix_timer_tsc_skew(osal_int64_t offset_nsec);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* LIBOSAL_POSIX_TSC__H */
+
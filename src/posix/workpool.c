@@ -0,0 +1,572 @@
+/**
+ * \file posix/workpool.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL work pool posix source.
+ *
+ * OSAL work-stealing work pool posix source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#define _GNU_SOURCE
+
+#include <libosal/osal.h>
+#include <libosal/workpool.h>
+#include <assert.h>
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "futex.h"
+
+//! Set in a group's pending count while its waiter is parked.
+#define POSIX_WORKPOOL_WAITER           0x80000000u
+
+//! Read the clock only every this many idle polls.
+#define POSIX_WORKPOOL_CLOCK_POLLS      64u
+
+//! Yield the CPU after this many idle polls, the task with work may share our CPU.
+#define POSIX_WORKPOOL_YIELD_POLLS      1024u
+
+#define POSIX_WORKPOOL_DEQUE_MASK       ((osal_int64_t)OSAL_WORKPOOL_DEQUE_SIZE - 1)
+
+typedef struct posix_workpool_idle {
+    osal_uint32_t polls;
+    osal_uint64_t start;
+} posix_workpool_idle_t;
+
+typedef struct posix_workpool_range {
+    osal_workpool_t *pool;
+    osal_workpool_range_handler_t handler;
+    osal_void_t *arg;
+    osal_size_t grain;
+} posix_workpool_range_t;
+
+typedef struct posix_workpool_split {
+    const posix_workpool_range_t *range;
+    osal_size_t begin;
+    osal_size_t end;
+} posix_workpool_split_t;
+
+// worker of the calling task, NULL for tasks which are not pool workers
+static __thread osal_workpool_worker_t *posix_workpool_self = NULL;
+
+static inline void posix_workpool_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+//! \brief Worker slot of the calling task, all other tasks share slot 0.
+static osal_workpool_worker_t *posix_workpool_current(osal_workpool_t *pool) {
+    osal_workpool_worker_t *self = posix_workpool_self;
+
+    if ((self == NULL) || (self->pool != pool)) {
+        self = &pool->workers[0];
+    }
+
+    return self;
+}
+
+//! \brief Push a job at the bottom, only called by the owner.
+static osal_bool_t posix_workpool_push(osal_workpool_deque_t *dq, osal_workpool_job_t *job) {
+    osal_bool_t ret = OSAL_FALSE;
+    osal_int64_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED);
+    osal_int64_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+
+    if ((b - t) < (osal_int64_t)OSAL_WORKPOOL_DEQUE_SIZE) {
+        __atomic_store_n(&dq->jobs[b & POSIX_WORKPOOL_DEQUE_MASK], job, __ATOMIC_RELAXED);
+        __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELEASE);
+        ret = OSAL_TRUE;
+    }
+
+    return ret;
+}
+
+//! \brief Take the newest job from the bottom, only called by the owner.
+static osal_workpool_job_t *posix_workpool_take(osal_workpool_deque_t *dq) {
+    osal_workpool_job_t *job = NULL;
+    osal_int64_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED);
+
+    // top only grows, a deque seen empty by its owner stays empty
+    if (b > __atomic_load_n(&dq->top, __ATOMIC_RELAXED)) {
+        b = b - 1;
+        __atomic_store_n(&dq->bottom, b, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        osal_int64_t t = __atomic_load_n(&dq->top, __ATOMIC_RELAXED);
+
+        if (t <= b) {
+            job = __atomic_load_n(&dq->jobs[b & POSIX_WORKPOOL_DEQUE_MASK], __ATOMIC_RELAXED);
+
+            if (t == b) {
+                // last job, race against thieves
+                if (!__atomic_compare_exchange_n(&dq->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                    job = NULL;
+                }
+
+                __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+            }
+        } else {
+            __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    return job;
+}
+
+//! \brief Steal the oldest job from the top, called by any task.
+static osal_workpool_job_t *posix_workpool_steal(osal_workpool_deque_t *dq) {
+    osal_workpool_job_t *job = NULL;
+    osal_int64_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    osal_int64_t b = __atomic_load_n(&dq->bottom, __ATOMIC_ACQUIRE);
+
+    if (t < b) {
+        job = __atomic_load_n(&dq->jobs[t & POSIX_WORKPOOL_DEQUE_MASK], __ATOMIC_RELAXED);
+
+        // lost against owner or another thief
+        if (!__atomic_compare_exchange_n(&dq->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            job = NULL;
+        }
+    }
+
+    return job;
+}
+
+//! \brief Take an own job or steal one, starting at a random victim.
+static osal_workpool_job_t *posix_workpool_find(osal_workpool_t *pool, osal_workpool_worker_t *self) {
+    osal_workpool_job_t *job = posix_workpool_take(&self->deque);
+
+    if (job == NULL) {
+        osal_uint32_t cnt = pool->worker_cnt + 1u;
+
+        // xorshift32
+        self->seed ^= self->seed << 13;
+        self->seed ^= self->seed >> 17;
+        self->seed ^= self->seed << 5;
+
+        osal_uint32_t start = self->seed % cnt;
+        for (osal_uint32_t i = 0u; (i < cnt) && (job == NULL); ++i) {
+            osal_workpool_worker_t *victim = &pool->workers[(start + i) % cnt];
+            if (victim != self) {
+                job = posix_workpool_steal(&victim->deque);
+            }
+        }
+    }
+
+    return job;
+}
+
+static osal_bool_t posix_workpool_has_work(osal_workpool_t *pool) {
+    osal_bool_t ret = OSAL_FALSE;
+
+    for (osal_uint32_t i = 0u; (i <= pool->worker_cnt) && (ret == OSAL_FALSE); ++i) {
+        osal_workpool_deque_t *dq = &pool->workers[i].deque;
+        if (__atomic_load_n(&dq->bottom, __ATOMIC_ACQUIRE) > __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE)) {
+            ret = OSAL_TRUE;
+        }
+    }
+
+    return ret;
+}
+
+static void posix_workpool_run(osal_workpool_job_t *job) {
+    osal_workpool_group_t *group = job->group;
+
+    job->handler(job->arg);
+
+    // job and group may be gone after the decrement, a late wake is harmless
+    osal_uint32_t old = __atomic_fetch_sub(&group->pending, 1u, __ATOMIC_ACQ_REL);
+    if (old == (POSIX_WORKPOOL_WAITER | 1u)) {
+        (void)posix_futex_wake(&group->pending, 1u, OSAL_FALSE);
+    }
+}
+
+//! \brief Wake one parked worker for a new job.
+static void posix_workpool_notify(osal_workpool_t *pool) {
+    // pairs with the sleeper registration in posix_workpool_worker
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&pool->sleepers, __ATOMIC_RELAXED) != 0u) {
+        (void)__atomic_fetch_add(&pool->work_seq, 1u, __ATOMIC_RELEASE);
+        (void)posix_futex_wake(&pool->work_seq, 1u, OSAL_FALSE);
+    }
+}
+
+//! \brief Poll once while idle, returns OSAL_FALSE when the spin phase is over.
+static osal_bool_t posix_workpool_spin(osal_workpool_t *pool, posix_workpool_idle_t *idle) {
+    osal_bool_t ret = OSAL_TRUE;
+
+    if (idle->polls == 0u) {
+        idle->start = osal_timer_gettime_nsec();
+    } else if ((idle->polls % POSIX_WORKPOOL_CLOCK_POLLS) == 0u) {
+        if ((osal_timer_gettime_nsec() - idle->start) >= pool->spin_nsec) {
+            ret = OSAL_FALSE;
+        }
+    }
+
+    if (ret == OSAL_TRUE) {
+        idle->polls++;
+
+        if ((idle->polls % POSIX_WORKPOOL_YIELD_POLLS) == 0u) {
+            (void)sched_yield();
+        } else {
+            posix_workpool_cpu_relax();
+        }
+    } else {
+        idle->polls = 0u;
+    }
+
+    return ret;
+}
+
+static void *posix_workpool_worker(void *arg) {
+    osal_workpool_worker_t *self = (osal_workpool_worker_t *)arg;
+    osal_workpool_t *pool = self->pool;
+    posix_workpool_idle_t idle = { 0u, 0u };
+
+    posix_workpool_self = self;
+
+    while (__atomic_load_n(&pool->run, __ATOMIC_ACQUIRE) != 0u) {
+        osal_workpool_job_t *job = posix_workpool_find(pool, self);
+
+        if (job != NULL) {
+            posix_workpool_run(job);
+            idle.polls = 0u;
+        } else if (posix_workpool_spin(pool, &idle) == OSAL_FALSE) {
+            osal_uint32_t seq = __atomic_load_n(&pool->work_seq, __ATOMIC_ACQUIRE);
+
+            // spawners only wake if they see a sleeper, check again after announcing
+            (void)__atomic_fetch_add(&pool->sleepers, 1u, __ATOMIC_SEQ_CST);
+            if ((posix_workpool_has_work(pool) == OSAL_FALSE) &&
+                    (__atomic_load_n(&pool->run, __ATOMIC_ACQUIRE) != 0u)) {
+                (void)posix_futex_wait(&pool->work_seq, seq, NULL, OSAL_FALSE);
+            }
+            (void)__atomic_fetch_sub(&pool->sleepers, 1u, __ATOMIC_RELAXED);
+        }
+    }
+
+    posix_workpool_self = NULL;
+
+    return NULL;
+}
+
+static void posix_workpool_stop(osal_workpool_t *pool, osal_uint32_t started) {
+    __atomic_store_n(&pool->run, 0u, __ATOMIC_RELEASE);
+    (void)__atomic_fetch_add(&pool->work_seq, 1u, __ATOMIC_RELEASE);
+    (void)posix_futex_wake(&pool->work_seq, 0x7FFFFFFFu, OSAL_FALSE);
+
+    for (osal_uint32_t i = 1u; i <= started; ++i) {
+        (void)osal_task_join(&pool->workers[i].task, NULL);
+    }
+
+    free(pool->workers_mem);
+    pool->workers_mem = NULL;
+    pool->workers = NULL;
+}
+
+static void posix_workpool_range_run(const posix_workpool_range_t *range, osal_size_t begin, osal_size_t end);
+
+static void posix_workpool_range_job(osal_void_t *arg) {
+    const posix_workpool_split_t *split = (const posix_workpool_split_t *)arg;
+
+    posix_workpool_range_run(split->range, split->begin, split->end);
+}
+
+//! \brief Spawn the upper half of the chunks, run the lower half, then join.
+static void posix_workpool_range_run(const posix_workpool_range_t *range, osal_size_t begin, osal_size_t end) {
+    osal_size_t chunks = ((end - begin) + range->grain - 1u) / range->grain;
+
+    if (chunks <= 1u) {
+        range->handler(range->arg, begin, end);
+    } else {
+        osal_size_t mid = begin + ((chunks / 2u) * range->grain);
+        posix_workpool_split_t split = { range, mid, end };
+        osal_workpool_group_t group;
+        osal_workpool_job_t job;
+
+        (void)osal_workpool_group_init(&group);
+        (void)osal_workpool_spawn(range->pool, &group, &job, posix_workpool_range_job, &split);
+        posix_workpool_range_run(range, begin, mid);
+        (void)osal_workpool_wait(range->pool, &group);
+    }
+}
+
+//! \brief Create a work pool and start its workers.
+/*!
+ * \param[out]  pool    Pointer to osal work pool structure.
+ * \param[in]   attr    Pointer to work pool attributes. Can be NULL for one
+ *                      worker per online CPU besides the calling one with
+ *                      default task attributes, each pinned to one of the
+ *                      CPUs the caller may run on.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_workpool_init(osal_workpool_t *pool, const osal_workpool_attr_t *attr) {
+    assert(pool != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_workpool_attr_t local_attr;
+    osal_cpuset_t cpus;
+    osal_uint32_t cpu = OSAL_CPUSET_SIZE;
+    osal_uint32_t started = 0u;
+
+    if (attr != NULL) {
+        local_attr = *attr;
+    } else {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+        (void)memset(&local_attr, 0, sizeof(local_attr));
+        (void)osal_task_attr_init(&local_attr.task_attr);
+        local_attr.worker_cnt = online > 1 ? (osal_uint32_t)(online - 1) : 1u;
+        if (local_attr.worker_cnt > OSAL_WORKPOOL_WORKERS_MAX) {
+            local_attr.worker_cnt = OSAL_WORKPOOL_WORKERS_MAX;
+        }
+        local_attr.spin_nsec = OSAL_WORKPOOL_SPIN_NSEC_DEFAULT;
+
+        // spread workers over the allowed CPUs, starting behind the calling one
+        if (osal_task_get_cpuset(NULL, &local_attr.task_attr.cpuset) == OSAL_OK) {
+            local_attr.task_attr.flags |= OSAL_TASK_ATTR__CPUSET;
+            int self = sched_getcpu();
+            if (self >= 0) {
+                cpu = (osal_uint32_t)self;
+            }
+        }
+    }
+
+    // workers cannot share one caller provided stack
+    if ((local_attr.worker_cnt == 0u) || (local_attr.worker_cnt > OSAL_WORKPOOL_WORKERS_MAX) ||
+            (((local_attr.task_attr.flags & OSAL_TASK_ATTR__STACK) != 0u) && (local_attr.task_attr.stack != NULL))) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        osal_size_t size = (local_attr.worker_cnt + 1u) * sizeof(osal_workpool_worker_t);
+
+        pool->workers_mem = malloc(size + OSAL_CACHE_LINE_SIZE);
+        if (pool->workers_mem == NULL) {
+            ret = OSAL_ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        osal_size_t addr = (osal_size_t)pool->workers_mem;
+        addr = (addr + OSAL_CACHE_LINE_SIZE - 1u) & ~(osal_size_t)(OSAL_CACHE_LINE_SIZE - 1u);
+
+        pool->workers = (osal_workpool_worker_t *)addr;
+        pool->work_seq = 0u;
+        pool->sleepers = 0u;
+        pool->run = 1u;
+        pool->worker_cnt = local_attr.worker_cnt;
+        pool->spin_nsec = local_attr.spin_nsec;
+
+        (void)memset(pool->workers, 0, (local_attr.worker_cnt + 1u) * sizeof(osal_workpool_worker_t));
+        for (osal_uint32_t i = 0u; i <= local_attr.worker_cnt; ++i) {
+            pool->workers[i].pool = pool;
+            pool->workers[i].index = i;
+            pool->workers[i].seed = (i * 0x9E3779B9u) | 1u;
+        }
+
+        if (((local_attr.task_attr.flags & OSAL_TASK_ATTR__CPUSET) != 0u) &&
+                (osal_cpuset_count(&local_attr.task_attr.cpuset) > 0u)) {
+            cpus = local_attr.task_attr.cpuset;
+        } else {
+            osal_cpuset_from_mask(&cpus, local_attr.task_attr.affinity);
+        }
+
+        for (osal_uint32_t i = 1u; (i <= local_attr.worker_cnt) && (ret == OSAL_OK); ++i) {
+            osal_task_attr_t task_attr = local_attr.task_attr;
+
+            if (task_attr.task_name[0] != '\0') {
+                (void)snprintf(task_attr.task_name, TASK_NAME_LEN, "%.*s-%u",
+                        (int)(TASK_NAME_LEN - 12u), local_attr.task_attr.task_name, i);
+            }
+
+            if (osal_cpuset_count(&cpus) > 0u) {
+                // round robin over the given CPUs
+                cpu = osal_cpuset_next(&cpus, cpu + 1u);
+                if (cpu == OSAL_CPUSET_SIZE) {
+                    cpu = osal_cpuset_next(&cpus, 0u);
+                }
+
+                task_attr.affinity = 0u;
+                osal_cpuset_zero(&task_attr.cpuset);
+                (void)osal_cpuset_set(&task_attr.cpuset, cpu);
+                task_attr.flags |= OSAL_TASK_ATTR__CPUSET;
+            }
+
+            ret = osal_task_create(&pool->workers[i].task, &task_attr, posix_workpool_worker, &pool->workers[i]);
+            if (ret == OSAL_OK) {
+                started = i;
+            }
+        }
+
+        if (ret != OSAL_OK) {
+            posix_workpool_stop(pool, started);
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Stop the workers and free the work pool.
+/*!
+ * \param[in]   pool    Pointer to osal work pool structure.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_workpool_destroy(osal_workpool_t *pool) {
+    assert(pool != NULL);
+
+    posix_workpool_stop(pool, pool->worker_cnt);
+
+    return OSAL_OK;
+}
+
+//! \brief Initialize an empty job group.
+/*!
+ * \param[out]  group   Pointer to job group.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_workpool_group_init(osal_workpool_group_t *group) {
+    assert(group != NULL);
+
+    group->pending = 0u;
+
+    return OSAL_OK;
+}
+
+//! \brief Spawn a job.
+/*!
+ * \param[in]   pool    Pointer to osal work pool structure.
+ * \param[in]   group   Group to add the job to.
+ * \param[in]   job     Storage of the job.
+ * \param[in]   handler Job handler.
+ * \param[in]   arg     Argument passed to handler.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_workpool_spawn(osal_workpool_t *pool, osal_workpool_group_t *group,
+        osal_workpool_job_t *job, osal_workpool_handler_t handler, osal_void_t *arg)
+{
+    assert(pool != NULL);
+    assert(group != NULL);
+    assert(job != NULL);
+    assert(handler != NULL);
+
+    osal_workpool_worker_t *self = posix_workpool_current(pool);
+
+    job->handler = handler;
+    job->arg = arg;
+    job->group = group;
+    (void)__atomic_fetch_add(&group->pending, 1u, __ATOMIC_RELAXED);
+
+    if (posix_workpool_push(&self->deque, job) == OSAL_TRUE) {
+        posix_workpool_notify(pool);
+    } else {
+        // deque full, no parallelism left to gain
+        posix_workpool_run(job);
+    }
+
+    return OSAL_OK;
+}
+
+//! \brief Wait until all jobs of a group are finished.
+/*!
+ * \param[in]   pool    Pointer to osal work pool structure.
+ * \param[in]   group   Group to wait for.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_workpool_wait(osal_workpool_t *pool, osal_workpool_group_t *group) {
+    assert(pool != NULL);
+    assert(group != NULL);
+
+    osal_workpool_worker_t *self = posix_workpool_current(pool);
+    posix_workpool_idle_t idle = { 0u, 0u };
+    osal_uint32_t pending = __atomic_load_n(&group->pending, __ATOMIC_ACQUIRE);
+
+    while ((pending & ~POSIX_WORKPOOL_WAITER) != 0u) {
+        osal_workpool_job_t *job = posix_workpool_find(pool, self);
+
+        if (job != NULL) {
+            posix_workpool_run(job);
+            idle.polls = 0u;
+        } else if (posix_workpool_spin(pool, &idle) == OSAL_FALSE) {
+            // nothing left to help with, the last job of the group wakes us
+            pending = __atomic_fetch_or(&group->pending, POSIX_WORKPOOL_WAITER, __ATOMIC_ACQ_REL) |
+                POSIX_WORKPOOL_WAITER;
+            if (pending != POSIX_WORKPOOL_WAITER) {
+                (void)posix_futex_wait(&group->pending, pending, NULL, OSAL_FALSE);
+            }
+        }
+
+        pending = __atomic_load_n(&group->pending, __ATOMIC_ACQUIRE);
+    }
+
+    // ready for reuse
+    __atomic_store_n(&group->pending, 0u, __ATOMIC_RELAXED);
+
+    return OSAL_OK;
+}
+
+//! \brief Run a handler over an index range in parallel.
+/*!
+ * \param[in]   pool    Pointer to osal work pool structure.
+ * \param[in]   begin   First index.
+ * \param[in]   end     One past the last index.
+ * \param[in]   grain   Maximum chunk size, 0 for one chunk per worker and
+ *                      the calling task.
+ * \param[in]   handler Handler called for each chunk.
+ * \param[in]   arg     Argument passed to handler.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_parallel_for(osal_workpool_t *pool, osal_size_t begin, osal_size_t end, osal_size_t grain,
+        osal_workpool_range_handler_t handler, osal_void_t *arg)
+{
+    assert(pool != NULL);
+    assert(handler != NULL);
+
+    if (end > begin) {
+        posix_workpool_range_t range = { pool, handler, arg, grain };
+
+        if (range.grain == 0u) {
+            osal_size_t parts = pool->worker_cnt + 1u;
+            range.grain = ((end - begin) + parts - 1u) / parts;
+        }
+
+        posix_workpool_range_run(&range, begin, end);
+    }
+
+    return OSAL_OK;
+}
+
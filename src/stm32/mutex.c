@@ -65,6 +65,25 @@ osal_retval_t osal_mutex_lock(osal_mutex_t *mtx) {
     return ret;
 }
 
+//! \brief Locks a mutex with timeout.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_mutex_timedlock(osal_mutex_t *mtx, const osal_timer_t *to) {
+    assert(mtx != NULL);
+    assert(to != NULL);
+
+    (void)mtx;
+    (void)to;
+
+    // same as osal_mutex_lock, there is nobody to wait for
+    osal_retval_t ret = OSAL_OK;
+    return ret;
+}
+
 //! \brief Tries to lock a mutex.
 /*!
  * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
@@ -91,6 +110,22 @@ osal_retval_t osal_mutex_unlock(osal_mutex_t *mtx) {
     return ret;
 }
 
+//! \brief Marks the state of a robust mutex consistent.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_mutex_consistent(osal_mutex_t *mtx) {
+    assert(mtx != NULL);
+
+    // no robust mutexes, never reports a dead owner
+    (void)mtx;
+
+    osal_retval_t ret = OSAL_OK;
+    return ret;
+}
+
 //! \brief Destroys a mutex.
 /*!
  * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
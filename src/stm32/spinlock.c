@@ -151,6 +151,20 @@ osal_retval_t osal_spinlock_lock(osal_spinlock_t *mtx) {
     return ret;
 }
 
+//! \brief Tries to lock a spinlock.
+/*!
+ * \param[in]   mtx     Pointer to osal spinlock structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_spinlock_trylock(osal_spinlock_t *mtx) {
+    assert(mtx != NULL);
+
+    // same as osal_spinlock_lock, there is nobody to wait for
+    osal_retval_t ret = OSAL_OK;
+    return ret;
+}
+
 //! \brief Unlocks a spinlock.
 /*!
  * \param[in]   mtx     Pointer to osal spinlock structure. Content is OS dependent.
@@ -196,3 +210,23 @@ osal_retval_t osal_spinlock_destroy(osal_spinlock_t *mtx) {
 
     return ret;
 }
+
+//! \brief Get statistics of a spinlock.
+/*!
+ * \param[in]   mtx     Pointer to osal spinlock structure. Content is OS dependent.
+ * \param[out]  stats   Returns statistics.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_spinlock_get_stats(osal_spinlock_t *mtx, osal_spinlock_stats_t *stats) {
+    assert(mtx != NULL);
+    assert(stats != NULL);
+
+    (void)mtx;
+    (void)stats;
+
+    // no statistics are collected on this platform
+    osal_retval_t ret = OSAL_ERR_UNAVAILABLE;
+    return ret;
+}
+
@@ -0,0 +1,53 @@
+/**
+ * \file task.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL task source.
+ *
+ * OSAL platform independent task source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/task.h>
+#include <assert.h>
+#include <string.h>
+
+//! \brief Initialize task attributes with the defaults.
+/*!
+ * \param[out]  attr    Pointer to task attributes.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_task_attr_init(osal_task_attr_t *attr) {
+    assert(attr != NULL);
+
+    // all zero means the defaults of the underlying task for every field
+    (void)memset(attr, 0, sizeof(osal_task_attr_t));
+
+    return OSAL_OK;
+}
@@ -0,0 +1,508 @@
+/**
+ * \file timer_service.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL timer service source.
+ *
+ * OSAL software timer service source.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/timer_service.h>
+#include <assert.h>
+
+#if LIBOSAL_HAVE_STRING_H == 1
+#include <string.h>
+#endif
+
+#define TIMER_SERVICE_SLOT_BITS     8u      //!< log2 of OSAL_TIMER_SERVICE_SLOTS.
+#define TIMER_SERVICE_SLOT_MASK     (OSAL_TIMER_SERVICE_SLOTS - 1u)
+#define TIMER_SERVICE_WORDS         (OSAL_TIMER_SERVICE_SLOTS / 64u)
+#define TIMER_SERVICE_SPAN          ((osal_uint64_t)1u << (TIMER_SERVICE_SLOT_BITS * OSAL_TIMER_SERVICE_LEVELS))
+#define TIMER_SERVICE_EXPIRED       (OSAL_TIMER_SERVICE_LEVELS * OSAL_TIMER_SERVICE_SLOTS)   //!< Slot index of the expired list.
+#define TIMER_SERVICE_NONE          UINT64_MAX
+
+//! \brief Get the first tick starting at or after time \p nsec.
+static osal_uint64_t timer_service_tick_of(const osal_timer_service_t *svc, osal_uint64_t nsec) {
+    osal_uint64_t ret = 0u;
+
+    if (nsec > svc->start) {
+        ret = ((nsec - svc->start) + svc->resolution - 1u) / svc->resolution;
+    }
+
+    return ret;
+}
+
+static void timer_service_link(osal_timer_service_t *svc, osal_timer_service_timer_t *tmr,
+        osal_uint32_t level, osal_uint32_t idx)
+{
+    osal_timer_service_timer_t **head = &svc->slots[level][idx];
+
+    tmr->next = *head;
+    if (tmr->next != NULL) {
+        tmr->next->pprev = &tmr->next;
+    }
+    *head = tmr;
+    tmr->pprev = head;
+    tmr->slot = (level * OSAL_TIMER_SERVICE_SLOTS) + idx;
+
+    svc->used[level][idx / 64u] |= (osal_uint64_t)1u << (idx % 64u);
+}
+
+static void timer_service_unlink(osal_timer_service_t *svc, osal_timer_service_timer_t *tmr) {
+    *tmr->pprev = tmr->next;
+    if (tmr->next != NULL) {
+        tmr->next->pprev = tmr->pprev;
+    }
+
+    if (tmr->slot != TIMER_SERVICE_EXPIRED) {
+        osal_uint32_t level = tmr->slot / OSAL_TIMER_SERVICE_SLOTS;
+        osal_uint32_t idx = tmr->slot % OSAL_TIMER_SERVICE_SLOTS;
+
+        if (svc->slots[level][idx] == NULL) {
+            svc->used[level][idx / 64u] &= ~((osal_uint64_t)1u << (idx % 64u));
+        }
+    }
+
+    tmr->next = NULL;
+    tmr->pprev = NULL;
+}
+
+//! Put a timer into the slot of its expiry tick.
+/*!
+ * Level n takes timers expiring within SLOTS ^ (n + 1) ticks. Expiries in
+ * the past go to the next tick to process, expiries beyond the wheel span
+ * to the farthest slot.
+ */
+static void timer_service_insert(osal_timer_service_t *svc, osal_timer_service_timer_t *tmr) {
+    osal_uint64_t delta = tmr->expires > svc->tick ? tmr->expires - svc->tick : 0u;
+    osal_uint32_t level = 0u;
+
+    if (delta >= TIMER_SERVICE_SPAN) {
+        delta = TIMER_SERVICE_SPAN - 1u;
+    }
+
+    while (delta >= ((osal_uint64_t)1u << (TIMER_SERVICE_SLOT_BITS * (level + 1u)))) {
+        level++;
+    }
+
+    osal_uint64_t expires = svc->tick + delta;
+    timer_service_link(svc, tmr, level,
+            (osal_uint32_t)(expires >> (TIMER_SERVICE_SLOT_BITS * level)) & TIMER_SERVICE_SLOT_MASK);
+}
+
+//! \brief Get distance from \p pos to the next used slot of a level, wrapping around.
+static osal_uint32_t timer_service_find(const osal_uint64_t *used, osal_uint32_t pos) {
+    osal_uint32_t ret = OSAL_TIMER_SERVICE_SLOTS;
+
+    // the word of pos is visited twice, first the bits from pos on, at last the bits below
+    for (osal_uint32_t i = 0u; (i <= TIMER_SERVICE_WORDS) && (ret == OSAL_TIMER_SERVICE_SLOTS); ++i) {
+        osal_uint32_t w = ((pos / 64u) + i) % TIMER_SERVICE_WORDS;
+        osal_uint64_t word = used[w];
+
+        if (i == 0u) {
+            word &= ~(osal_uint64_t)0u << (pos % 64u);
+        } else if (i == TIMER_SERVICE_WORDS) {
+            word &= ((osal_uint64_t)1u << (pos % 64u)) - 1u;
+        }
+
+        if (word != 0u) {
+            ret = ((w * 64u) + (osal_uint32_t)__builtin_ctzll(word) - pos) & TIMER_SERVICE_SLOT_MASK;
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Get the next tick which expires timers or cascades a slot.
+static osal_uint64_t timer_service_next_event(const osal_timer_service_t *svc) {
+    osal_uint64_t ret = TIMER_SERVICE_NONE;
+
+    for (osal_uint32_t level = 0u; level < OSAL_TIMER_SERVICE_LEVELS; ++level) {
+        osal_uint32_t shift = TIMER_SERVICE_SLOT_BITS * level;
+
+        // slot position of level which is cascaded at or after the next tick
+        osal_uint64_t pos = (svc->tick + (((osal_uint64_t)1u << shift) - 1u)) >> shift;
+        osal_uint32_t dist = timer_service_find(svc->used[level], (osal_uint32_t)pos & TIMER_SERVICE_SLOT_MASK);
+
+        if (dist != OSAL_TIMER_SERVICE_SLOTS) {
+            osal_uint64_t event = (pos + dist) << shift;
+
+            if (event < ret) {
+                ret = event;
+            }
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Move the timers of a slot to the lower levels.
+static void timer_service_cascade(osal_timer_service_t *svc, osal_uint32_t level, osal_uint32_t idx) {
+    osal_timer_service_timer_t *tmr = svc->slots[level][idx];
+
+    svc->slots[level][idx] = NULL;
+    svc->used[level][idx / 64u] &= ~((osal_uint64_t)1u << (idx % 64u));
+
+    while (tmr != NULL) {
+        osal_timer_service_timer_t *next = tmr->next;
+
+        timer_service_insert(svc, tmr);
+        tmr = next;
+    }
+}
+
+//! \brief Cascade the slots due at the next tick and move its timers to the expired list.
+static void timer_service_advance(osal_timer_service_t *svc) {
+    osal_uint64_t tick = svc->tick;
+    osal_uint32_t idx = (osal_uint32_t)tick & TIMER_SERVICE_SLOT_MASK;
+
+    // level n is cascaded when all levels below wrap around
+    for (osal_uint32_t level = 1u; (level < OSAL_TIMER_SERVICE_LEVELS) &&
+            (((tick >> (TIMER_SERVICE_SLOT_BITS * (level - 1u))) & TIMER_SERVICE_SLOT_MASK) == 0u); ++level) {
+        timer_service_cascade(svc, level,
+                (osal_uint32_t)(tick >> (TIMER_SERVICE_SLOT_BITS * level)) & TIMER_SERVICE_SLOT_MASK);
+    }
+
+    svc->expired = svc->slots[0][idx];
+    svc->slots[0][idx] = NULL;
+    svc->used[0][idx / 64u] &= ~((osal_uint64_t)1u << (idx % 64u));
+
+    if (svc->expired != NULL) {
+        svc->expired->pprev = &svc->expired;
+    }
+    for (osal_timer_service_timer_t *tmr = svc->expired; tmr != NULL; tmr = tmr->next) {
+        tmr->slot = TIMER_SERVICE_EXPIRED;
+    }
+
+    svc->tick = tick + 1u;
+}
+
+//! Expire a timer, called with the lock held.
+/*!
+ * Periodic timers are re-armed before the handler is called, the timer is
+ * not accessed after the lock was released.
+ */
+static void timer_service_fire(osal_timer_service_t *svc, osal_timer_service_timer_t *tmr) {
+    osal_uint64_t now = osal_timer_gettime_nsec();
+    osal_uint64_t latency = now > tmr->deadline ? now - tmr->deadline : 0u;
+    osal_timer_service_handler_t handler = tmr->handler;
+    osal_void_t *arg = tmr->arg;
+    osal_semaphore_t *sem = tmr->sem;
+
+    svc->stats.expired++;
+    if (latency > svc->stats.max_latency) {
+        svc->stats.max_latency = latency;
+    }
+
+    if (tmr->period != 0u) {
+        tmr->deadline += tmr->period;
+
+        if (tmr->deadline <= now) {
+            osal_uint64_t missed = ((now - tmr->deadline) / tmr->period) + 1u;
+
+            tmr->deadline += missed * tmr->period;
+            svc->stats.missed += missed;
+        }
+
+        tmr->expires = timer_service_tick_of(svc, tmr->deadline);
+        timer_service_insert(svc, tmr);
+    }
+
+    (void)osal_mutex_unlock(&svc->lock);
+
+    if (handler != NULL) {
+        handler(arg);
+    } else {
+        (void)osal_semaphore_post(sem);
+    }
+
+    (void)osal_mutex_lock(&svc->lock);
+}
+
+static osal_void_t *timer_service_loop(osal_void_t *arg) {
+    osal_timer_service_t *svc = (osal_timer_service_t *)arg;
+
+    (void)osal_mutex_lock(&svc->lock);
+
+    while (svc->run != 0u) {
+        osal_uint64_t now = osal_timer_gettime_nsec();
+        osal_uint64_t now_tick = now > svc->start ? (now - svc->start) / svc->resolution : 0u;
+
+        // no wakeups needed while awake
+        svc->wakeup_tick = 0u;
+
+        while (svc->tick <= now_tick) {
+            osal_uint64_t event = timer_service_next_event(svc);
+
+            if (event > now_tick) {
+                // nothing to expire or cascade up to now
+                svc->tick = now_tick + 1u;
+            } else {
+                svc->tick = event;
+                timer_service_advance(svc);
+
+                while (svc->expired != NULL) {
+                    osal_timer_service_timer_t *tmr = svc->expired;
+
+                    timer_service_unlink(svc, tmr);
+
+                    if (tmr->expires >= svc->tick) {
+                        // was parked beyond the wheel span
+                        timer_service_insert(svc, tmr);
+                    } else {
+                        timer_service_fire(svc, tmr);
+                    }
+                }
+            }
+        }
+
+        svc->wakeup_tick = timer_service_next_event(svc);
+        osal_uint64_t wakeup_tick = svc->wakeup_tick;
+
+        (void)osal_mutex_unlock(&svc->lock);
+
+        if (wakeup_tick == TIMER_SERVICE_NONE) {
+            (void)osal_binary_semaphore_wait(&svc->wakeup);
+        } else {
+            osal_uint64_t wakeup = svc->start + (wakeup_tick * svc->resolution);
+            osal_timer_t to = { wakeup / NSEC_PER_SEC, wakeup % NSEC_PER_SEC };
+
+            (void)osal_binary_semaphore_timedwait(&svc->wakeup, &to);
+        }
+
+        (void)osal_mutex_lock(&svc->lock);
+    }
+
+    (void)osal_mutex_unlock(&svc->lock);
+
+    return NULL;
+}
+
+//! \brief Create a timer service and start its task.
+/*!
+ * \param[out]  svc     Pointer to osal timer service structure.
+ * \param[in]   attr    Pointer to timer service attributes. Can be NULL for
+ *                      default task attributes and resolution.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_timer_service_init(osal_timer_service_t *svc, const osal_timer_service_attr_t *attr) {
+    assert(svc != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_task_attr_t task_attr;
+    osal_mutex_attr_t mtx_attr = OSAL_MUTEX_ATTR__PROTOCOL__INHERIT;
+
+    (void)memset(svc, 0, sizeof(osal_timer_service_t));
+    (void)osal_task_attr_init(&task_attr);
+
+    svc->resolution = OSAL_TIMER_SERVICE_RESOLUTION_DEFAULT;
+    if (attr != NULL) {
+        task_attr = attr->task_attr;
+        if (attr->resolution != 0u) {
+            svc->resolution = attr->resolution;
+        }
+    }
+
+    svc->start = osal_timer_gettime_nsec();
+    svc->run = 1u;
+
+    ret = osal_mutex_init(&svc->lock, &mtx_attr);
+    if (ret == OSAL_OK) {
+        ret = osal_binary_semaphore_init(&svc->wakeup, NULL);
+
+        if (ret == OSAL_OK) {
+            ret = osal_task_create(&svc->task, &task_attr, timer_service_loop, svc);
+
+            if (ret != OSAL_OK) {
+                (void)osal_binary_semaphore_destroy(&svc->wakeup);
+            }
+        }
+
+        if (ret != OSAL_OK) {
+            (void)osal_mutex_destroy(&svc->lock);
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Stop the service task and destroy the timer service.
+/*!
+ * \param[in]   svc     Pointer to osal timer service structure.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_timer_service_destroy(osal_timer_service_t *svc) {
+    assert(svc != NULL);
+
+    (void)osal_mutex_lock(&svc->lock);
+    svc->run = 0u;
+    (void)osal_mutex_unlock(&svc->lock);
+
+    (void)osal_binary_semaphore_post(&svc->wakeup);
+    (void)osal_task_join(&svc->task, NULL);
+
+    // dropped timers may be armed again
+    for (osal_uint32_t level = 0u; level < OSAL_TIMER_SERVICE_LEVELS; ++level) {
+        for (osal_uint32_t idx = 0u; idx < OSAL_TIMER_SERVICE_SLOTS; ++idx) {
+            while (svc->slots[level][idx] != NULL) {
+                timer_service_unlink(svc, svc->slots[level][idx]);
+            }
+        }
+    }
+
+    (void)osal_binary_semaphore_destroy(&svc->wakeup);
+    (void)osal_mutex_destroy(&svc->lock);
+
+    return OSAL_OK;
+}
+
+//! \brief Initialize a timer calling a handler.
+/*!
+ * \param[out]  tmr     Pointer to timer.
+ * \param[in]   handler Handler called on expiry.
+ * \param[in]   arg     Argument passed to handler.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_timer_service_timer_init(osal_timer_service_timer_t *tmr,
+        osal_timer_service_handler_t handler, osal_void_t *arg)
+{
+    assert(tmr != NULL);
+    assert(handler != NULL);
+
+    (void)memset(tmr, 0, sizeof(osal_timer_service_timer_t));
+    tmr->handler = handler;
+    tmr->arg = arg;
+
+    return OSAL_OK;
+}
+
+//! \brief Initialize a timer posting a semaphore.
+/*!
+ * \param[out]  tmr     Pointer to timer.
+ * \param[in]   sem     Semaphore posted on expiry.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_timer_service_timer_init_semaphore(osal_timer_service_timer_t *tmr, osal_semaphore_t *sem) {
+    assert(tmr != NULL);
+    assert(sem != NULL);
+
+    (void)memset(tmr, 0, sizeof(osal_timer_service_timer_t));
+    tmr->sem = sem;
+
+    return OSAL_OK;
+}
+
+//! \brief Arm a timer.
+/*!
+ * \param[in]   svc     Pointer to osal timer service structure.
+ * \param[in]   tmr     Pointer to initialized timer.
+ * \param[in]   timeout Time until first expiry in [ns].
+ * \param[in]   period  Period in [ns], 0 for a one-shot timer.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_timer_service_arm(osal_timer_service_t *svc, osal_timer_service_timer_t *tmr,
+        osal_uint64_t timeout, osal_uint64_t period)
+{
+    assert(svc != NULL);
+    assert(tmr != NULL);
+
+    osal_bool_t wake = OSAL_FALSE;
+
+    (void)osal_mutex_lock(&svc->lock);
+
+    if (tmr->pprev != NULL) {
+        timer_service_unlink(svc, tmr);
+    }
+
+    tmr->deadline = osal_timer_gettime_nsec() + timeout;
+    tmr->period = period;
+    tmr->expires = timer_service_tick_of(svc, tmr->deadline);
+    timer_service_insert(svc, tmr);
+
+    if (tmr->expires < svc->wakeup_tick) {
+        svc->wakeup_tick = tmr->expires;
+        wake = OSAL_TRUE;
+    }
+
+    (void)osal_mutex_unlock(&svc->lock);
+
+    if (wake == OSAL_TRUE) {
+        (void)osal_binary_semaphore_post(&svc->wakeup);
+    }
+
+    return OSAL_OK;
+}
+
+//! \brief Cancel a timer.
+/*!
+ * \param[in]   svc     Pointer to osal timer service structure.
+ * \param[in]   tmr     Pointer to timer.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_timer_service_cancel(osal_timer_service_t *svc, osal_timer_service_timer_t *tmr) {
+    assert(svc != NULL);
+    assert(tmr != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    (void)osal_mutex_lock(&svc->lock);
+
+    if (tmr->pprev != NULL) {
+        timer_service_unlink(svc, tmr);
+    } else {
+        ret = OSAL_ERR_NOT_FOUND;
+    }
+
+    (void)osal_mutex_unlock(&svc->lock);
+
+    return ret;
+}
+
+//! \brief Get statistics of a timer service.
+/*!
+ * \param[in]   svc     Pointer to osal timer service structure.
+ * \param[out]  stats   Returns statistics.
+ *
+ * \return N/A
+ */
+void osal_timer_service_get_stats(osal_timer_service_t *svc, osal_timer_service_stats_t *stats) {
+    assert(svc != NULL);
+    assert(stats != NULL);
+
+    (void)osal_mutex_lock(&svc->lock);
+    *stats = svc->stats;
+    (void)osal_mutex_unlock(&svc->lock);
+}
+
@@ -0,0 +1,1166 @@
+/**
+ * \file main.c
+ *
+ * \author Robert Burger <robert.burger@dlr.de>
+ *
+ * \date 16 Oct 2026
+ *
+ * \brief OSAL benchmark.
+ *
+ * Measures the cost of the libosal primitives and writes the results as
+ * JSON or CSV, so that they can be compared across releases.
+ */
+
+/*
+ * This file is part of libosal.
+ *
+ * libosal is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * libosal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libosal; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <libosal/config.h>
+#endif
+
+#include <libosal/osal.h>
+#include <libosal/binary_semaphore.h>
+#include <libosal/condvar.h>
+#include <libosal/eventflags.h>
+#include <libosal/io.h>
+#include <libosal/mq.h>
+#include <libosal/mutex.h>
+#include <libosal/pool.h>
+#include <libosal/rwlock.h>
+#include <libosal/semaphore.h>
+#include <libosal/seqlock.h>
+#include <libosal/spinlock.h>
+#include <libosal/task.h>
+#include <libosal/timer.h>
+#include <libosal/timer_service.h>
+#include <libosal/trace.h>
+#include <libosal/tribuf.h>
+#include <libosal/workpool.h>
+
+#include <inttypes.h>
+#include <mqueue.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef LIBOSAL_VERSION
+#define LIBOSAL_VERSION         "unknown"
+#endif
+
+#define BENCH_BATCH             64u         //!< cheap operations are timed in batches.
+#define BENCH_MQ_NAME           "/libosal_bench_mq"
+#define BENCH_SHM_NAME          "libosal_bench_log"
+
+#define BENCH_FORMAT__JSON      0
+#define BENCH_FORMAT__CSV       1
+
+typedef struct bench_ctx {
+    osal_trace_t *trace;                    //!< collects samples in its histogram.
+    osal_uint64_t iterations;               //!< base number of iterations.
+    osal_uint64_t ops;                      //!< operations done by benchmark.
+    osal_uint64_t elapsed;                  //!< wall time of benchmark in [ns], set by benchmarks with setup outside the measurement.
+} bench_ctx_t;
+
+typedef struct bench {
+    const osal_char_t *name;
+    const osal_char_t *description;
+    osal_retval_t (*run)(bench_ctx_t *ctx);
+} bench_t;
+
+typedef struct bench_result {
+    const osal_char_t *name;
+    osal_uint64_t samples;
+    osal_uint64_t min;
+    osal_uint64_t mean;
+    osal_uint64_t p50;
+    osal_uint64_t p99;
+    osal_uint64_t p999;
+    osal_uint64_t max;
+    osal_uint64_t ops_per_sec;
+} bench_result_t;
+
+static void bench_sample(bench_ctx_t *ctx, osal_uint64_t ns) {
+    osal_trace_time(ctx->trace, ns);
+}
+
+//! Task doing the counterpart of a two task benchmark.
+typedef struct bench_peer {
+    osal_task_t task;
+    osal_uint32_t stop;
+    osal_uint64_t cnt;
+    osal_uint64_t value;
+    osal_mutex_t *mtx;
+    osal_spinlock_t *spin;
+    osal_rwlock_t *rwl;
+    osal_semaphore_t sem[2];
+    osal_binary_semaphore_t bsem[2];
+    osal_condvar_t cv;
+    osal_uint32_t turn;
+    osal_mq_t *mq;
+} bench_peer_t;
+
+static osal_retval_t bench_peer_start(bench_peer_t *peer, osal_task_handler_t handler) {
+    __atomic_store_n(&peer->stop, 0u, __ATOMIC_RELAXED);
+    return osal_task_create(&peer->task, NULL, handler, peer);
+}
+
+static void bench_peer_stop(bench_peer_t *peer) {
+    __atomic_store_n(&peer->stop, 1u, __ATOMIC_RELEASE);
+    (void)osal_task_join(&peer->task, NULL);
+}
+
+static osal_bool_t bench_peer_stopped(bench_peer_t *peer) {
+    return __atomic_load_n(&peer->stop, __ATOMIC_ACQUIRE) != 0u ? OSAL_TRUE : OSAL_FALSE;
+}
+
+//------------------------------------------------------------------------------
+// timer
+
+static osal_retval_t bench_timer_gettime(bench_ctx_t *ctx) {
+    volatile osal_uint64_t sink = 0u;
+
+    for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+        osal_uint64_t start = osal_timer_gettime_nsec();
+        for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+            sink += osal_timer_gettime_nsec();
+        }
+        bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+    }
+
+    (void)sink;
+    ctx->ops = ctx->iterations * BENCH_BATCH;
+    return OSAL_OK;
+}
+
+static osal_retval_t bench_timer_gettime_tsc(bench_ctx_t *ctx) {
+    osal_retval_t ret = OSAL_OK;
+    int old_clock = osal_timer_get_clock_source();
+
+    // blocks for the calibration, keep it out of the measurement
+    osal_timer_set_clock_source(LIBOSAL_CLOCK_TSC);
+    if (osal_timer_get_clock_source() != LIBOSAL_CLOCK_TSC) {
+        ret = OSAL_ERR_NOT_IMPLEMENTED;
+    } else {
+        osal_uint64_t start = osal_timer_gettime_nsec();
+        ret = bench_timer_gettime(ctx);
+        ctx->elapsed = osal_timer_gettime_nsec() - start;
+    }
+
+    osal_timer_set_clock_source(old_clock);
+    return ret;
+}
+
+static osal_retval_t bench_sleep_until(bench_ctx_t *ctx) {
+    const osal_uint64_t period = 1000000u;
+    osal_uint64_t cnt = ctx->iterations / 10u;
+    osal_uint64_t next = osal_timer_gettime_nsec() + period;
+
+    if (cnt < 100u) {
+        cnt = 100u;
+    }
+
+    for (osal_uint64_t i = 0u; i < cnt; ++i) {
+        osal_timer_t timer = { next / NSEC_PER_SEC, next % NSEC_PER_SEC };
+        (void)osal_sleep_until(&timer);
+
+        osal_uint64_t now = osal_timer_gettime_nsec();
+        bench_sample(ctx, now > next ? now - next : 0u);
+        next += period;
+    }
+
+    ctx->ops = cnt;
+    return OSAL_OK;
+}
+
+//------------------------------------------------------------------------------
+// mutex and spinlock
+
+static osal_void_t *bench_mutex_hammer(osal_void_t *arg) {
+    bench_peer_t *peer = (bench_peer_t *)arg;
+
+    while (bench_peer_stopped(peer) == OSAL_FALSE) {
+        (void)osal_mutex_lock(peer->mtx);
+        peer->value++;
+        (void)osal_mutex_unlock(peer->mtx);
+    }
+
+    return NULL;
+}
+
+static osal_retval_t bench_mutex_run(bench_ctx_t *ctx, const osal_mutex_attr_t *attr, osal_bool_t contended) {
+    osal_retval_t ret;
+    osal_mutex_t mtx;
+    bench_peer_t peer;
+
+    memset(&peer, 0, sizeof(peer));
+    peer.mtx = &mtx;
+
+    ret = osal_mutex_init(&mtx, attr);
+    if ((ret == OSAL_OK) && (contended == OSAL_TRUE)) {
+        ret = bench_peer_start(&peer, bench_mutex_hammer);
+    }
+
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                (void)osal_mutex_lock(&mtx);
+                peer.value++;
+                (void)osal_mutex_unlock(&mtx);
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        if (contended == OSAL_TRUE) {
+            bench_peer_stop(&peer);
+        }
+
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+        (void)osal_mutex_destroy(&mtx);
+    }
+
+    return ret;
+}
+
+static osal_retval_t bench_mutex_uncontended(bench_ctx_t *ctx) {
+    return bench_mutex_run(ctx, NULL, OSAL_FALSE);
+}
+
+static osal_retval_t bench_mutex_contended(bench_ctx_t *ctx) {
+    return bench_mutex_run(ctx, NULL, OSAL_TRUE);
+}
+
+static osal_retval_t bench_mutex_adaptive_contended(bench_ctx_t *ctx) {
+    const osal_mutex_attr_t attr = OSAL_MUTEX_ATTR__TYPE__ADAPTIVE;
+    return bench_mutex_run(ctx, &attr, OSAL_TRUE);
+}
+
+static osal_void_t *bench_spinlock_hammer(osal_void_t *arg) {
+    bench_peer_t *peer = (bench_peer_t *)arg;
+
+    while (bench_peer_stopped(peer) == OSAL_FALSE) {
+        (void)osal_spinlock_lock(peer->spin);
+        peer->value++;
+        (void)osal_spinlock_unlock(peer->spin);
+    }
+
+    return NULL;
+}
+
+static osal_retval_t bench_spinlock_run(bench_ctx_t *ctx, const osal_spinlock_attr_t *attr, osal_bool_t contended) {
+    osal_retval_t ret;
+    osal_spinlock_t spin;
+    bench_peer_t peer;
+
+    memset(&peer, 0, sizeof(peer));
+    peer.spin = &spin;
+
+    ret = osal_spinlock_init(&spin, attr);
+    if ((ret == OSAL_OK) && (contended == OSAL_TRUE)) {
+        ret = bench_peer_start(&peer, bench_spinlock_hammer);
+    }
+
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                (void)osal_spinlock_lock(&spin);
+                peer.value++;
+                (void)osal_spinlock_unlock(&spin);
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        if (contended == OSAL_TRUE) {
+            bench_peer_stop(&peer);
+        }
+
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+        (void)osal_spinlock_destroy(&spin);
+    }
+
+    return ret;
+}
+
+static osal_retval_t bench_spinlock_uncontended(bench_ctx_t *ctx) {
+    return bench_spinlock_run(ctx, NULL, OSAL_FALSE);
+}
+
+static osal_retval_t bench_spinlock_contended(bench_ctx_t *ctx) {
+    return bench_spinlock_run(ctx, NULL, OSAL_TRUE);
+}
+
+static osal_retval_t bench_spinlock_ticket_contended(bench_ctx_t *ctx) {
+    const osal_spinlock_attr_t attr = OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET;
+    return bench_spinlock_run(ctx, &attr, OSAL_TRUE);
+}
+
+static osal_retval_t bench_spinlock_mcs_contended(bench_ctx_t *ctx) {
+    const osal_spinlock_attr_t attr = OSAL_SPINLOCK_ATTR__ALGORITHM__MCS;
+    return bench_spinlock_run(ctx, &attr, OSAL_TRUE);
+}
+
+// reader-writer lock
+
+static osal_void_t *bench_rwlock_reader(osal_void_t *arg) {
+    bench_peer_t *peer = (bench_peer_t *)arg;
+
+    while (bench_peer_stopped(peer) == OSAL_FALSE) {
+        (void)osal_rwlock_rdlock(peer->rwl);
+        (void)__atomic_load_n(&peer->value, __ATOMIC_RELAXED);
+        (void)osal_rwlock_unlock(peer->rwl);
+    }
+
+    return NULL;
+}
+
+static osal_retval_t bench_rwlock_run(bench_ctx_t *ctx, const osal_rwlock_attr_t *attr, osal_bool_t contended) {
+    osal_retval_t ret;
+    osal_rwlock_t rwl;
+    bench_peer_t peer;
+
+    memset(&peer, 0, sizeof(peer));
+    peer.rwl = &rwl;
+
+    ret = osal_rwlock_init(&rwl, attr);
+    if ((ret == OSAL_OK) && (contended == OSAL_TRUE)) {
+        ret = bench_peer_start(&peer, bench_rwlock_reader);
+    }
+
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                (void)osal_rwlock_rdlock(&rwl);
+                (void)__atomic_load_n(&peer.value, __ATOMIC_RELAXED);
+                (void)osal_rwlock_unlock(&rwl);
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        if (contended == OSAL_TRUE) {
+            bench_peer_stop(&peer);
+        }
+
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+        (void)osal_rwlock_destroy(&rwl);
+    }
+
+    return ret;
+}
+
+static osal_retval_t bench_rwlock_read_uncontended(bench_ctx_t *ctx) {
+    return bench_rwlock_run(ctx, NULL, OSAL_FALSE);
+}
+
+static osal_retval_t bench_rwlock_read_shared(bench_ctx_t *ctx) {
+    return bench_rwlock_run(ctx, NULL, OSAL_TRUE);
+}
+
+static osal_retval_t bench_rwlock_percpu_read_shared(bench_ctx_t *ctx) {
+    const osal_rwlock_attr_t attr = OSAL_RWLOCK_ATTR__PER_CPU;
+    return bench_rwlock_run(ctx, &attr, OSAL_TRUE);
+}
+
+// sequence lock
+
+//! Size of the published state, like a controller state read by GUIs and loggers.
+#define BENCH_SEQLOCK_STATE     2048u
+
+static osal_retval_t bench_seqlock_run(bench_ctx_t *ctx, osal_bool_t write) {
+    static osal_uint64_t state[BENCH_SEQLOCK_STATE / 8u];
+    static osal_uint64_t local[BENCH_SEQLOCK_STATE / 8u];
+    osal_seqlock_t sl;
+
+    osal_retval_t ret = osal_seqlock_init(&sl);
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                if (write == OSAL_TRUE) {
+                    (void)osal_seqlock_write_copy(&sl, state, local, sizeof(state));
+                } else {
+                    (void)osal_seqlock_read_copy(&sl, local, state, sizeof(state));
+                }
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+    }
+
+    return ret;
+}
+
+static osal_retval_t bench_seqlock_write_copy(bench_ctx_t *ctx) {
+    return bench_seqlock_run(ctx, OSAL_TRUE);
+}
+
+static osal_retval_t bench_seqlock_read_copy(bench_ctx_t *ctx) {
+    return bench_seqlock_run(ctx, OSAL_FALSE);
+}
+
+// triple buffer
+
+static osal_retval_t bench_tribuf_publish_read(bench_ctx_t *ctx) {
+    static osal_uint8_t mem[4096];
+    osal_tribuf_t tb;
+    osal_void_t *frame;
+
+    osal_retval_t ret = osal_tribuf_init(&tb, mem, sizeof(mem), 256u);
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                (void)osal_tribuf_reserve(&tb, &frame);
+                ((osal_uint64_t *)frame)[0] = j;
+                (void)osal_tribuf_publish(&tb);
+                (void)osal_tribuf_read(&tb, &frame);
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+    }
+
+    return ret;
+}
+
+// memory pool
+
+static osal_retval_t bench_pool_run(bench_ctx_t *ctx, osal_bool_t cached) {
+    osal_pool_t pool;
+    osal_pool_cache_t cache;
+    osal_void_t *block = NULL;
+
+    osal_retval_t ret = osal_pool_create(&pool, 256u, 1024u, NULL);
+    if (ret == OSAL_OK) {
+        (void)osal_pool_cache_init(&cache, &pool);
+
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                if (cached == OSAL_TRUE) {
+                    (void)osal_pool_cache_alloc(&cache, &block);
+                    (void)osal_pool_cache_free(&cache, block);
+                } else {
+                    (void)osal_pool_alloc(&pool, &block);
+                    (void)osal_pool_free(&pool, block);
+                }
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+        (void)osal_pool_cache_flush(&cache);
+        (void)osal_pool_destroy(&pool);
+    }
+
+    return ret;
+}
+
+static osal_retval_t bench_pool_alloc_free(bench_ctx_t *ctx) {
+    return bench_pool_run(ctx, OSAL_FALSE);
+}
+
+static osal_retval_t bench_pool_cache_alloc_free(bench_ctx_t *ctx) {
+    return bench_pool_run(ctx, OSAL_TRUE);
+}
+
+static void bench_workpool_chunk(osal_void_t *arg, osal_size_t begin, osal_size_t end) {
+    (void)arg;
+    (void)begin;
+    (void)end;
+}
+
+static osal_retval_t bench_workpool_parallel_for(bench_ctx_t *ctx) {
+    osal_workpool_t pool;
+    osal_workpool_attr_t attr;
+
+    (void)memset(&attr, 0, sizeof(attr));
+    (void)osal_task_attr_init(&attr.task_attr);
+    attr.worker_cnt = 3u;
+    attr.spin_nsec = 1000000u;
+
+    osal_retval_t ret = osal_workpool_init(&pool, &attr);
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            (void)osal_parallel_for(&pool, 0u, attr.worker_cnt + 1u, 1u, bench_workpool_chunk, NULL);
+            bench_sample(ctx, osal_timer_gettime_nsec() - start);
+        }
+
+        ctx->ops = ctx->iterations;
+        (void)osal_workpool_destroy(&pool);
+    }
+
+    return ret;
+}
+
+static void bench_timer_service_handler(osal_void_t *arg) {
+    (void)arg;
+}
+
+static osal_retval_t bench_timer_service_arm_cancel(bench_ctx_t *ctx) {
+    static osal_timer_service_t svc;
+    static osal_timer_service_timer_t timers[4096];
+    osal_timer_service_timer_t tmr;
+
+    osal_retval_t ret = osal_timer_service_init(&svc, NULL);
+    if (ret == OSAL_OK) {
+        // background load spread over the first two wheel levels
+        for (osal_uint32_t i = 0u; i < 4096u; ++i) {
+            (void)osal_timer_service_timer_init(&timers[i], bench_timer_service_handler, NULL);
+            (void)osal_timer_service_arm(&svc, &timers[i], 10000000000u + (i * 10000000u), 0u);
+        }
+
+        (void)osal_timer_service_timer_init(&tmr, bench_timer_service_handler, NULL);
+
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                (void)osal_timer_service_arm(&svc, &tmr, 5000000000u, 0u);
+                (void)osal_timer_service_cancel(&svc, &tmr);
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+        (void)osal_timer_service_destroy(&svc);
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+// tasks
+
+static osal_void_t *bench_task_started(osal_void_t *arg) {
+    __atomic_store_n((osal_uint64_t *)arg, osal_timer_gettime_nsec(), __ATOMIC_RELEASE);
+    return NULL;
+}
+
+//! From the osal_task_create() call until the new task runs, join is not timed.
+static osal_retval_t bench_task_create(bench_ctx_t *ctx) {
+    osal_retval_t ret = OSAL_OK;
+    osal_uint64_t cnt = ctx->iterations / 10u;
+
+    if (cnt < 100u) {
+        cnt = 100u;
+    }
+
+    for (osal_uint64_t i = 0u; (ret == OSAL_OK) && (i < cnt); ++i) {
+        osal_task_t task;
+        osal_uint64_t started = 0u;
+        osal_uint64_t start = osal_timer_gettime_nsec();
+
+        ret = osal_task_create(&task, NULL, bench_task_started, &started);
+        if (ret == OSAL_OK) {
+            ret = osal_task_join(&task, NULL);
+            bench_sample(ctx, __atomic_load_n(&started, __ATOMIC_ACQUIRE) - start);
+        }
+    }
+
+    ctx->ops = cnt;
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+// ping-pong between two tasks, samples are round trip times
+
+static osal_void_t *bench_semaphore_pong(osal_void_t *arg) {
+    bench_peer_t *peer = (bench_peer_t *)arg;
+
+    for (osal_uint64_t i = 0u; i < peer->cnt; ++i) {
+        (void)osal_semaphore_wait(&peer->sem[0]);
+        (void)osal_semaphore_post(&peer->sem[1]);
+    }
+
+    return NULL;
+}
+
+static osal_retval_t bench_semaphore_pingpong(bench_ctx_t *ctx) {
+    osal_retval_t ret;
+    bench_peer_t peer;
+
+    memset(&peer, 0, sizeof(peer));
+    peer.cnt = ctx->iterations;
+
+    ret = osal_semaphore_init(&peer.sem[0], NULL, 0);
+    if (ret == OSAL_OK) {
+        ret = osal_semaphore_init(&peer.sem[1], NULL, 0);
+    }
+    if (ret == OSAL_OK) {
+        ret = bench_peer_start(&peer, bench_semaphore_pong);
+    }
+
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < peer.cnt; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            (void)osal_semaphore_post(&peer.sem[0]);
+            (void)osal_semaphore_wait(&peer.sem[1]);
+            bench_sample(ctx, osal_timer_gettime_nsec() - start);
+        }
+
+        (void)osal_task_join(&peer.task, NULL);
+        (void)osal_semaphore_destroy(&peer.sem[0]);
+        (void)osal_semaphore_destroy(&peer.sem[1]);
+        ctx->ops = peer.cnt;
+    }
+
+    return ret;
+}
+
+static osal_void_t *bench_binary_semaphore_pong(osal_void_t *arg) {
+    bench_peer_t *peer = (bench_peer_t *)arg;
+
+    for (osal_uint64_t i = 0u; i < peer->cnt; ++i) {
+        (void)osal_binary_semaphore_wait(&peer->bsem[0]);
+        (void)osal_binary_semaphore_post(&peer->bsem[1]);
+    }
+
+    return NULL;
+}
+
+static osal_retval_t bench_binary_semaphore_pingpong(bench_ctx_t *ctx) {
+    osal_retval_t ret;
+    bench_peer_t peer;
+
+    memset(&peer, 0, sizeof(peer));
+    peer.cnt = ctx->iterations;
+
+    ret = osal_binary_semaphore_init(&peer.bsem[0], NULL);
+    if (ret == OSAL_OK) {
+        ret = osal_binary_semaphore_init(&peer.bsem[1], NULL);
+    }
+    if (ret == OSAL_OK) {
+        ret = bench_peer_start(&peer, bench_binary_semaphore_pong);
+    }
+
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < peer.cnt; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            (void)osal_binary_semaphore_post(&peer.bsem[0]);
+            (void)osal_binary_semaphore_wait(&peer.bsem[1]);
+            bench_sample(ctx, osal_timer_gettime_nsec() - start);
+        }
+
+        (void)osal_task_join(&peer.task, NULL);
+        (void)osal_binary_semaphore_destroy(&peer.bsem[0]);
+        (void)osal_binary_semaphore_destroy(&peer.bsem[1]);
+        ctx->ops = peer.cnt;
+    }
+
+    return ret;
+}
+
+static osal_retval_t bench_binary_semaphore_uncontended(bench_ctx_t *ctx) {
+    osal_retval_t ret;
+    osal_binary_semaphore_t bsem;
+
+    ret = osal_binary_semaphore_init(&bsem, NULL);
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                (void)osal_binary_semaphore_post(&bsem);
+                (void)osal_binary_semaphore_trywait(&bsem);
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+        (void)osal_binary_semaphore_destroy(&bsem);
+    }
+
+    return ret;
+}
+
+static osal_retval_t bench_eventflags_uncontended(bench_ctx_t *ctx) {
+    osal_retval_t ret;
+    osal_eventflags_t ef;
+
+    ret = osal_eventflags_init(&ef, NULL);
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                (void)osal_eventflags_set(&ef, 0x1u);
+                (void)osal_eventflags_wait(&ef, 0x1u, OSAL_EVENTFLAGS_WAIT__CLEAR, NULL);
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+        (void)osal_eventflags_destroy(&ef);
+    }
+
+    return ret;
+}
+
+//! Waiter stores the latency from signal to its wakeup in value.
+static osal_void_t *bench_condvar_waiter(osal_void_t *arg) {
+    bench_peer_t *peer = (bench_peer_t *)arg;
+
+    (void)osal_mutex_lock(peer->mtx);
+    for (osal_uint64_t i = 0u; i < peer->cnt; ++i) {
+        while (peer->turn != 1u) {
+            (void)osal_condvar_wait(&peer->cv, peer->mtx);
+        }
+
+        peer->value = osal_timer_gettime_nsec() - peer->value;
+        peer->turn = 2u;
+        (void)osal_condvar_broadcast(&peer->cv);
+    }
+    (void)osal_mutex_unlock(peer->mtx);
+
+    return NULL;
+}
+
+static osal_retval_t bench_condvar_wakeup(bench_ctx_t *ctx) {
+    osal_retval_t ret;
+    osal_mutex_t mtx;
+    bench_peer_t peer;
+
+    memset(&peer, 0, sizeof(peer));
+    peer.cnt = ctx->iterations;
+    peer.mtx = &mtx;
+
+    ret = osal_mutex_init(&mtx, NULL);
+    if (ret == OSAL_OK) {
+        ret = osal_condvar_init(&peer.cv, NULL);
+    }
+    if (ret == OSAL_OK) {
+        ret = bench_peer_start(&peer, bench_condvar_waiter);
+    }
+
+    if (ret == OSAL_OK) {
+        (void)osal_mutex_lock(&mtx);
+        for (osal_uint64_t i = 0u; i < peer.cnt; ++i) {
+            peer.turn = 1u;
+            peer.value = osal_timer_gettime_nsec();
+            (void)osal_condvar_broadcast(&peer.cv);
+
+            while (peer.turn != 2u) {
+                (void)osal_condvar_wait(&peer.cv, &mtx);
+            }
+
+            bench_sample(ctx, peer.value);
+        }
+        (void)osal_mutex_unlock(&mtx);
+
+        (void)osal_task_join(&peer.task, NULL);
+        (void)osal_condvar_destroy(&peer.cv);
+        (void)osal_mutex_destroy(&mtx);
+        ctx->ops = peer.cnt;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+// message queues
+
+static osal_void_t *bench_mq_producer(osal_void_t *arg) {
+    bench_peer_t *peer = (bench_peer_t *)arg;
+    osal_uint64_t msg[4] = { 0u, 0u, 0u, 0u };
+
+    for (osal_uint64_t i = 0u; i < peer->cnt; ++i) {
+        msg[0] = i;
+        (void)osal_mq_send(peer->mq, (const osal_char_t *)msg, sizeof(msg), 0u);
+    }
+
+    return NULL;
+}
+
+//! Producer task sends, we receive. Samples are the receive intervals.
+static osal_retval_t bench_mq_run(bench_ctx_t *ctx, osal_uint32_t oflags) {
+    osal_retval_t ret;
+    osal_mq_t mq;
+    osal_mq_attr_t attr;
+    bench_peer_t peer;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.oflags = OSAL_MQ_ATTR__OFLAG__RDWR | OSAL_MQ_ATTR__OFLAG__CREAT | oflags;
+    attr.max_messages = 8u;
+    attr.max_message_size = 4u * sizeof(osal_uint64_t);
+    attr.mode = 0600;
+
+    memset(&peer, 0, sizeof(peer));
+    peer.cnt = ctx->iterations * 10u;
+    peer.mq = &mq;
+
+    ret = osal_mq_open(&mq, BENCH_MQ_NAME, &attr);
+    if (ret == OSAL_OK) {
+        ret = bench_peer_start(&peer, bench_mq_producer);
+
+        if (ret == OSAL_OK) {
+            osal_uint64_t msg[4];
+            osal_uint64_t last = osal_timer_gettime_nsec();
+
+            for (osal_uint64_t i = 0u; i < peer.cnt; ++i) {
+                (void)osal_mq_receive(&mq, (osal_char_t *)msg, sizeof(msg), NULL);
+
+                osal_uint64_t now = osal_timer_gettime_nsec();
+                bench_sample(ctx, now - last);
+                last = now;
+            }
+
+            (void)osal_task_join(&peer.task, NULL);
+            ctx->ops = peer.cnt;
+        }
+
+        (void)osal_mq_close(&mq);
+    }
+
+    if ((oflags & OSAL_MQ_ATTR__OFLAG__USERSPACE) != 0u) {
+        (void)shm_unlink(BENCH_MQ_NAME);
+    } else {
+        (void)mq_unlink(BENCH_MQ_NAME);
+    }
+
+    return ret;
+}
+
+//! Send/receive pairs in one task, the queue never blocks.
+static osal_retval_t bench_mq_pair_run(bench_ctx_t *ctx, osal_uint32_t oflags) {
+    osal_retval_t ret;
+    osal_mq_t mq;
+    osal_mq_attr_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.oflags = OSAL_MQ_ATTR__OFLAG__RDWR | OSAL_MQ_ATTR__OFLAG__CREAT | oflags;
+    attr.max_messages = 8u;
+    attr.max_message_size = 4u * sizeof(osal_uint64_t);
+    attr.mode = 0600;
+
+    ret = osal_mq_open(&mq, BENCH_MQ_NAME, &attr);
+    if (ret == OSAL_OK) {
+        osal_uint64_t msg[4] = { 0u, 0u, 0u, 0u };
+
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                (void)osal_mq_send(&mq, (const osal_char_t *)msg, sizeof(msg), 0u);
+                (void)osal_mq_receive(&mq, (osal_char_t *)msg, sizeof(msg), NULL);
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+        (void)osal_mq_close(&mq);
+    }
+
+    if ((oflags & OSAL_MQ_ATTR__OFLAG__USERSPACE) != 0u) {
+        (void)shm_unlink(BENCH_MQ_NAME);
+    } else {
+        (void)mq_unlink(BENCH_MQ_NAME);
+    }
+
+    return ret;
+}
+
+static osal_retval_t bench_mq_kernel(bench_ctx_t *ctx) {
+    return bench_mq_run(ctx, 0u);
+}
+
+static osal_retval_t bench_mq_userspace(bench_ctx_t *ctx) {
+    return bench_mq_run(ctx, OSAL_MQ_ATTR__OFLAG__USERSPACE);
+}
+
+static osal_retval_t bench_mq_kernel_uncontended(bench_ctx_t *ctx) {
+    return bench_mq_pair_run(ctx, 0u);
+}
+
+static osal_retval_t bench_mq_userspace_uncontended(bench_ctx_t *ctx) {
+    return bench_mq_pair_run(ctx, OSAL_MQ_ATTR__OFLAG__USERSPACE);
+}
+
+//------------------------------------------------------------------------------
+// logging and tracing
+
+static osal_bool_t bench_shm_log_ready = OSAL_FALSE;
+
+static void bench_shm_log_drain(void) {
+    osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE];
+
+    while (osal_io_shm_get_message(msg, NULL) == OSAL_OK) {
+    }
+}
+
+static osal_retval_t bench_shm_log_setup(void) {
+    if (bench_shm_log_ready == OSAL_FALSE) {
+        osal_char_t path[64];
+
+        (void)snprintf(path, sizeof(path), "/dev/shm/%s", BENCH_SHM_NAME);
+        (void)unlink(path);
+
+        // setup reports to stdout, keep machine readable output clean
+        fflush(stdout);
+        int saved = dup(STDOUT_FILENO);
+        if (freopen("/dev/null", "w", stdout) != NULL) {
+            (void)osal_io_shm_setup(BENCH_SHM_NAME, 1024u, 256u);
+            fflush(stdout);
+        }
+        (void)dup2(saved, STDOUT_FILENO);
+        (void)close(saved);
+
+        bench_shm_log_drain();
+        bench_shm_log_ready = OSAL_TRUE;
+    }
+
+    return OSAL_OK;
+}
+
+static osal_retval_t bench_printf_shm(bench_ctx_t *ctx) {
+    osal_retval_t ret = bench_shm_log_setup();
+
+    for (osal_uint64_t i = 0u; (ret == OSAL_OK) && (i < ctx->iterations); ++i) {
+        osal_uint64_t start = osal_timer_gettime_nsec();
+        (void)osal_printf("cycle %" PRIu64 ": position %f, state %s\n", i, 0.001 * (double)i, "running");
+        bench_sample(ctx, osal_timer_gettime_nsec() - start);
+
+        bench_shm_log_drain();
+    }
+
+    ctx->ops = ctx->iterations;
+    return ret;
+}
+
+static osal_retval_t bench_log_shm(bench_ctx_t *ctx) {
+    osal_retval_t ret = bench_shm_log_setup();
+
+    for (osal_uint64_t i = 0u; (ret == OSAL_OK) && (i < ctx->iterations); ++i) {
+        osal_uint64_t start = osal_timer_gettime_nsec();
+        OSAL_LOG("cycle %" PRIu64 ": position %f, state %s\n", i, 0.001 * (double)i, "running");
+        bench_sample(ctx, osal_timer_gettime_nsec() - start);
+
+        bench_shm_log_drain();
+    }
+
+    ctx->ops = ctx->iterations;
+    return ret;
+}
+
+static osal_retval_t bench_trace_point(bench_ctx_t *ctx) {
+    osal_trace_t *trace;
+    osal_retval_t ret = osal_trace_alloc(&trace, 4096u);
+
+    if (ret == OSAL_OK) {
+        for (osal_uint64_t i = 0u; i < ctx->iterations; ++i) {
+            osal_uint64_t start = osal_timer_gettime_nsec();
+            for (osal_uint32_t j = 0u; j < BENCH_BATCH; ++j) {
+                (void)osal_trace_point(trace);
+            }
+            bench_sample(ctx, (osal_timer_gettime_nsec() - start) / BENCH_BATCH);
+        }
+
+        osal_trace_free(trace);
+        ctx->ops = ctx->iterations * BENCH_BATCH;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
+static const bench_t benchmarks[] = {
+    { "timer_gettime_nsec",         "osal_timer_gettime_nsec() per call",               bench_timer_gettime },
+    { "timer_gettime_nsec_tsc",     "osal_timer_gettime_nsec() per call, TSC clock",    bench_timer_gettime_tsc },
+    { "mutex_uncontended",          "lock/unlock pair, single task",                    bench_mutex_uncontended },
+    { "mutex_contended",            "lock/unlock pair, second task hammering",          bench_mutex_contended },
+    { "mutex_adaptive_contended",   "adaptive lock/unlock pair, second task hammering", bench_mutex_adaptive_contended },
+    { "spinlock_uncontended",       "lock/unlock pair, single task",                    bench_spinlock_uncontended },
+    { "spinlock_contended",         "lock/unlock pair, second task hammering",          bench_spinlock_contended },
+    { "spinlock_ticket_contended",  "ticket lock/unlock pair, second task hammering",   bench_spinlock_ticket_contended },
+    { "spinlock_mcs_contended",     "MCS lock/unlock pair, second task hammering",      bench_spinlock_mcs_contended },
+    { "rwlock_read_uncontended",    "read lock/unlock pair, single task",               bench_rwlock_read_uncontended },
+    { "rwlock_read_shared",         "read lock/unlock pair, second task reading",       bench_rwlock_read_shared },
+    { "rwlock_percpu_read_shared",  "per-CPU read lock/unlock, second task reading",    bench_rwlock_percpu_read_shared },
+    { "seqlock_write_copy",         "publish 2 KiB state, no readers",                  bench_seqlock_write_copy },
+    { "seqlock_read_copy",          "snapshot of 2 KiB state, no writer",               bench_seqlock_read_copy },
+    { "tribuf_publish_read",        "publish/read pair of 256 byte frame, single task", bench_tribuf_publish_read },
+    { "pool_alloc_free",            "alloc/free pair of 256 byte block, single task",   bench_pool_alloc_free },
+    { "pool_cache_alloc_free",      "cached alloc/free pair, single task",              bench_pool_cache_alloc_free },
+    { "workpool_parallel_for",      "fan-out/fan-in of 4 empty chunks, 3 workers",      bench_workpool_parallel_for },
+    { "timer_service_arm_cancel",   "arm/cancel pair, 4096 timers pending",             bench_timer_service_arm_cancel },
+    { "task_create",                "latency from osal_task_create() to task running", bench_task_create },
+    { "semaphore_pingpong",         "post/wait round trip between two tasks",           bench_semaphore_pingpong },
+    { "binary_semaphore_pingpong",  "post/wait round trip between two tasks",           bench_binary_semaphore_pingpong },
+    { "binary_semaphore_uncontended", "post/trywait pair, single task",                 bench_binary_semaphore_uncontended },
+    { "eventflags_uncontended",     "set/wait-and-clear pair, single task",             bench_eventflags_uncontended },
+    { "condvar_wakeup",             "latency from broadcast to waiter running",         bench_condvar_wakeup },
+    { "mq_kernel",                  "receive interval, producer task sending",          bench_mq_kernel },
+    { "mq_userspace",               "receive interval, producer task sending",          bench_mq_userspace },
+    { "mq_kernel_uncontended",      "send/receive pair, single task",                   bench_mq_kernel_uncontended },
+    { "mq_userspace_uncontended",   "send/receive pair, single task",                   bench_mq_userspace_uncontended },
+    { "sleep_until_jitter",         "wakeup delay of 1 ms periodic osal_sleep_until()", bench_sleep_until },
+    { "printf_shm",                 "osal_printf() to shm log per call",                bench_printf_shm },
+    { "log_shm",                    "OSAL_LOG() to shm log per call",                   bench_log_shm },
+    { "trace_point",                "osal_trace_point() per call",                      bench_trace_point },
+};
+
+static void bench_get_result(bench_ctx_t *ctx, const bench_t *bench, bench_result_t *res) {
+    static osal_trace_histogram_t hist;
+    const osal_uint32_t ppm[3] = { OSAL_TRACE_P50, OSAL_TRACE_P99, OSAL_TRACE_P999 };
+    osal_uint64_t values[3] = { 0u, 0u, 0u };
+
+    osal_trace_get_histogram(ctx->trace, &hist);
+    (void)osal_trace_get_percentiles(ctx->trace, ppm, values, 3u);
+
+    memset(res, 0, sizeof(bench_result_t));
+    res->name       = bench->name;
+    res->samples    = hist.cnt;
+
+    if (hist.cnt != 0u) {
+        res->min    = hist.min;
+        res->mean   = hist.sum / hist.cnt;
+        res->p50    = values[0];
+        res->p99    = values[1];
+        res->p999   = values[2];
+        res->max    = hist.max;
+    }
+
+    if (ctx->elapsed != 0u) {
+        res->ops_per_sec = (osal_uint64_t)(((double)ctx->ops * 1e9) / (double)ctx->elapsed);
+    }
+}
+
+static void bench_print_result(FILE *out, int format, const bench_result_t *res, osal_bool_t first) {
+    if (format == BENCH_FORMAT__CSV) {
+        fprintf(out, "%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+                res->name, res->samples, res->min, res->mean, res->p50, res->p99, res->p999, res->max, res->ops_per_sec);
+    } else {
+        fprintf(out, "%s    {\"name\": \"%s\", \"samples\": %" PRIu64 ", \"min_ns\": %" PRIu64 ", \"mean_ns\": %" PRIu64
+                ", \"p50_ns\": %" PRIu64 ", \"p99_ns\": %" PRIu64 ", \"p999_ns\": %" PRIu64 ", \"max_ns\": %" PRIu64
+                ", \"ops_per_sec\": %" PRIu64 "}",
+                first == OSAL_TRUE ? "" : ",\n", res->name, res->samples, res->min, res->mean, res->p50, res->p99,
+                res->p999, res->max, res->ops_per_sec);
+    }
+}
+
+static void usage(const char *prog) {
+    printf("usage: %s [-f json|csv] [-o file] [-n iterations] [-b filter] [-l]\n", prog);
+    printf("  -f    output format, default json\n");
+    printf("  -o    write results to file instead of stdout\n");
+    printf("  -n    base number of iterations, default 10000\n");
+    printf("  -b    only run benchmarks whose name contains filter\n");
+    printf("  -l    list benchmarks\n");
+}
+
+extern int main(int argc, char **argv) {
+    int format = BENCH_FORMAT__JSON;
+    const char *filter = NULL;
+    FILE *out = stdout;
+    bench_ctx_t ctx;
+    int opt;
+    int ret = 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.iterations = 10000u;
+
+    while ((opt = getopt(argc, argv, "f:o:n:b:lh")) != -1) {
+        switch (opt) {
+            case 'f':
+                format = strcmp(optarg, "csv") == 0 ? BENCH_FORMAT__CSV : BENCH_FORMAT__JSON;
+                break;
+            case 'o':
+                out = fopen(optarg, "w");
+                if (out == NULL) {
+                    perror(optarg);
+                    return 1;
+                }
+                break;
+            case 'n':
+                ctx.iterations = strtoull(optarg, NULL, 0);
+                break;
+            case 'b':
+                filter = optarg;
+                break;
+            case 'l':
+                for (size_t i = 0u; i < (sizeof(benchmarks) / sizeof(benchmarks[0])); ++i) {
+                    printf("%-28s %s\n", benchmarks[i].name, benchmarks[i].description);
+                }
+                return 0;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    osal_init();
+
+    if (osal_trace_alloc(&ctx.trace, 1024u) != OSAL_OK) {
+        fprintf(stderr, "cannot allocate trace\n");
+        return 1;
+    }
+    (void)osal_trace_set_histogram_mode(ctx.trace, OSAL_TRACE_HISTOGRAM__VALUE);
+
+    if (format == BENCH_FORMAT__CSV) {
+        fprintf(out, "name,samples,min_ns,mean_ns,p50_ns,p99_ns,p999_ns,max_ns,ops_per_sec\n");
+    } else {
+        fprintf(out, "{\n  \"libosal_version\": \"%s\",\n  \"timestamp\": %" PRIu64 ",\n  \"iterations\": %" PRIu64
+                ",\n  \"benchmarks\": [\n", LIBOSAL_VERSION, (osal_uint64_t)time(NULL), ctx.iterations);
+    }
+
+    osal_bool_t first = OSAL_TRUE;
+    for (size_t i = 0u; i < (sizeof(benchmarks) / sizeof(benchmarks[0])); ++i) {
+        const bench_t *bench = &benchmarks[i];
+        bench_result_t res;
+
+        if ((filter != NULL) && (strstr(bench->name, filter) == NULL)) {
+            continue;
+        }
+
+        osal_trace_reset_histogram(ctx.trace);
+        ctx.ops = 0u;
+        ctx.elapsed = 0u;
+
+        osal_uint64_t start = osal_timer_gettime_nsec();
+        osal_retval_t orv = bench->run(&ctx);
+        if (ctx.elapsed == 0u) {
+            ctx.elapsed = osal_timer_gettime_nsec() - start;
+        }
+
+        if (orv != OSAL_OK) {
+            fprintf(stderr, "benchmark %s failed with %d, skipped\n", bench->name, orv);
+            ret = 2;
+        } else {
+            bench_get_result(&ctx, bench, &res);
+            bench_print_result(out, format, &res, first);
+            first = OSAL_FALSE;
+        }
+
+        fflush(out);
+    }
+
+    if (format == BENCH_FORMAT__JSON) {
+        fprintf(out, "\n  ]\n}\n");
+    }
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    osal_trace_free(ctx.trace);
+    return ret;
+}
+
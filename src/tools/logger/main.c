@@ -30,6 +30,7 @@
 #include <libosal/osal.h>
 #include <libosal/io.h>
 
+#include <inttypes.h>
 #include <stdarg.h>
 #include <string.h>
 #include <stdio.h>
@@ -51,9 +52,15 @@ extern int main(int argc, char **argv) {
     while (1) {
         osal_timer_t to;
         (void)osal_timer_init(&to, 10000000);
-        osal_retval_t ret = osal_io_shm_get_message(msg, &to);
+        osal_uint64_t timestamp = 0u;
+        osal_retval_t ret = osal_io_shm_get_record(msg, &timestamp, &to);
         if (ret == OSAL_OK) {
-            printf("%s\n", msg);
+            if (timestamp != 0u) {
+                // deferred OSAL_LOG message, formatted here instead of the realtime task
+                printf("[%" PRIu64 ".%09" PRIu64 "] %s\n", timestamp / NSEC_PER_SEC, timestamp % NSEC_PER_SEC, msg);
+            } else {
+                printf("%s\n", msg);
+            }
         }
     }
 
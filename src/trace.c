@@ -36,6 +36,7 @@
 #include <libosal/trace.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #if LIBOSAL_HAVE_MATH_H == 1
 #include <math.h>
@@ -45,6 +46,194 @@
 #include <string.h>
 #endif
 
+//! Producer sub-buffer of a multi producer trace.
+/*!
+ * The producer announces a record by advancing \p begin, writes it and then
+ * publishes it by advancing \p head. The reader validates a copied record by
+ * checking that \p begin did not wrap onto it in the meantime.
+ */
+typedef struct osal_trace_producer {
+    osal_uint64_t owner;                //!< thread id of registered task, 0 if free.
+    osal_trace_record_t *buf;           //!< record ring.
+    osal_uint32_t mask;                 //!< index mask (size - 1).
+    osal_uint32_t id;                   //!< producer id.
+    osal_uint64_t begin;                //!< position of record being written + 1.
+    osal_uint64_t head;                 //!< number of records written.
+    osal_uint64_t last_time;            //!< last traced time.
+    osal_trace_histogram_t *hist;       //!< streaming histogram of this producer.
+    osal_uint8_t pad0[OSAL_CACHE_LINE_SIZE - 56u];
+
+    osal_uint64_t tail;                 //!< next record to read.
+    osal_uint64_t lost;                 //!< overwritten records.
+    osal_uint8_t pad1[OSAL_CACHE_LINE_SIZE - 16u];
+} osal_trace_producer_t;
+
+static __thread osal_uint64_t trace_thread_id;
+static __thread osal_trace_t *trace_cached_trace;
+static __thread osal_uint64_t trace_cached_generation;
+static __thread osal_trace_producer_t *trace_cached_producer;
+
+//! Last generation handed out, a new trace at the address of a freed one gets another one.
+static osal_uint64_t trace_generation;
+
+//! Last thread id handed out, never reused.
+static osal_uint64_t trace_last_thread_id;
+
+//! Get id of the calling thread, 0 if it never registered.
+/*!
+ * The address of a thread local variable is no owner id, a new thread may get
+ * the one of an exited thread and would take over its sub-buffer.
+ */
+static osal_uint64_t trace_get_thread_id(osal_bool_t assign) {
+    if ((trace_thread_id == 0u) && (assign == OSAL_TRUE)) {
+        trace_thread_id = __atomic_add_fetch(&trace_last_thread_id, 1u, __ATOMIC_RELAXED);
+    }
+
+    return trace_thread_id;
+}
+
+//! Get histogram bucket of value, constant time.
+static osal_uint32_t trace_hist_index(osal_uint64_t value) {
+    osal_uint32_t idx;
+
+    if (value < OSAL_TRACE_HISTOGRAM_SUB_CNT) {
+        idx = (osal_uint32_t)value;
+    } else {
+        osal_uint32_t exp = 63u - (osal_uint32_t)__builtin_clzll(value);
+        osal_uint32_t shift = exp - OSAL_TRACE_HISTOGRAM_SUB_BITS;
+        idx = ((shift + 1u) << OSAL_TRACE_HISTOGRAM_SUB_BITS) + 
+            ((osal_uint32_t)(value >> shift) & (OSAL_TRACE_HISTOGRAM_SUB_CNT - 1u));
+    }
+
+    return idx;
+}
+
+//! Reset histogram to empty.
+static void trace_hist_reset(osal_trace_histogram_t *hist) {
+    memset(hist, 0, sizeof(osal_trace_histogram_t));
+    hist->min = UINT64_MAX;
+}
+
+//! Add one sample to histogram, no allocation and no loops.
+static void trace_hist_add(osal_trace_histogram_t *hist, osal_uint64_t value) {
+    hist->buckets[trace_hist_index(value)]++;
+    hist->sum += value;
+    if (value < hist->min) { hist->min = value; }
+    if (value > hist->max) { hist->max = value; }
+
+    // count last, readers take it as number of complete samples
+    __atomic_store_n(&hist->cnt, hist->cnt + 1u, __ATOMIC_RELEASE);
+}
+
+//! Add trace time to histogram according to histogram mode.
+static void trace_hist_time(osal_trace_t *trace, osal_trace_histogram_t *hist, 
+        osal_uint64_t last, osal_uint64_t time) 
+{
+    if (trace->hist_mode == OSAL_TRACE_HISTOGRAM__VALUE) {
+        trace_hist_add(hist, time);
+    } else if ((last != 0u) && (time >= last)) {
+        trace_hist_add(hist, time - last);
+    }
+}
+
+//! Sum up histogram into another one.
+static void trace_hist_merge(osal_trace_histogram_t *dst, const osal_trace_histogram_t *src) {
+    osal_uint64_t cnt = __atomic_load_n(&src->cnt, __ATOMIC_ACQUIRE);
+
+    if (cnt != 0u) {
+        dst->cnt += cnt;
+        dst->sum += src->sum;
+        if (src->min < dst->min) { dst->min = src->min; }
+        if (src->max > dst->max) { dst->max = src->max; }
+
+        for (osal_uint32_t i = 0u; i < OSAL_TRACE_HISTOGRAM_BUCKETS; ++i) {
+            dst->buckets[i] += src->buckets[i];
+        }
+    }
+}
+
+//! Find the calling task's sub-buffer, only loads.
+static osal_trace_producer_t *trace_get_producer(osal_trace_t *trace) {
+    osal_trace_producer_t *producer = NULL;
+
+    // other threads keep their cache when a trace is freed, the generation tells stale entries
+    if ((trace_cached_trace == trace) && (trace_cached_generation == trace->generation)) {
+        producer = trace_cached_producer;
+    } else if (trace_get_thread_id(OSAL_FALSE) != 0u) {
+        osal_uint32_t cnt = __atomic_load_n(&trace->producer_cnt, __ATOMIC_ACQUIRE);
+        for (osal_uint32_t i = 0u; i < cnt; ++i) {
+            if (__atomic_load_n(&trace->producers[i].owner, __ATOMIC_ACQUIRE) == trace_thread_id) {
+                producer = &trace->producers[i];
+                trace_cached_trace = trace;
+                trace_cached_generation = trace->generation;
+                trace_cached_producer = producer;
+                break;
+            }
+        }
+    }
+
+    return producer;
+}
+
+//! Store one record into the calling task's sub-buffer.
+static void trace_mp_time(osal_trace_t *trace, osal_uint64_t time) {
+    osal_trace_producer_t *producer = trace_get_producer(trace);
+
+    if (producer != NULL) {
+        osal_uint64_t pos = producer->head;
+        osal_trace_record_t *rec = &producer->buf[pos & producer->mask];
+
+        __atomic_store_n(&producer->begin, pos + 1u, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        __atomic_store_n(&rec->time, time, __ATOMIC_RELAXED);
+        __atomic_store_n(&rec->producer, producer->id, __ATOMIC_RELAXED);
+
+        __atomic_store_n(&producer->head, pos + 1u, __ATOMIC_RELEASE);
+
+        trace_hist_time(trace, producer->hist, producer->last_time, time);
+        producer->last_time = time;
+    }
+}
+
+//! Copy oldest unread record of a producer, skipping overwritten ones.
+static osal_retval_t trace_mp_peek(osal_trace_producer_t *producer, osal_trace_record_t *rec) {
+    osal_retval_t ret = OSAL_ERR_NO_DATA;
+    osal_uint64_t size = (osal_uint64_t)producer->mask + 1u;
+
+    for (;;) {
+        osal_uint64_t head = __atomic_load_n(&producer->head, __ATOMIC_ACQUIRE);
+
+        if (head == producer->tail) {
+            break;
+        }
+
+        if ((head - producer->tail) > size) {
+            producer->lost += (head - size) - producer->tail;
+            producer->tail = head - size;
+        }
+
+        osal_trace_record_t *slot = &producer->buf[producer->tail & producer->mask];
+        rec->time = __atomic_load_n(&slot->time, __ATOMIC_RELAXED);
+        rec->producer = __atomic_load_n(&slot->producer, __ATOMIC_RELAXED);
+        rec->reserved = 0u;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        osal_uint64_t begin = __atomic_load_n(&producer->begin, __ATOMIC_RELAXED);
+
+        if ((begin - producer->tail) <= size) {
+            ret = OSAL_OK;
+            break;
+        }
+
+        // overwritten while copying, skip to oldest valid record
+        producer->lost += (begin - size) - producer->tail;
+        producer->tail = begin - size;
+    }
+
+    return ret;
+}
+
 //! \brief Allocate trace struct.
 /*!
  * \param[out]  trace   Pointer to trace* where allocated trace struct is returned.
@@ -69,16 +258,18 @@ osal_retval_t osal_trace_alloc(osal_trace_t **trace, osal_uint32_t cnt) {
 
         ret = osal_binary_semaphore_init(&(*trace)->sync_sem, NULL);
         if (ret != OSAL_OK) {
-            goto error_exit;
+            goto error_free;
         }
         
         (*trace)->time_in_ns[0] = malloc(sizeof(osal_uint64_t) * cnt);
         (*trace)->time_in_ns[1] = malloc(sizeof(osal_uint64_t) * cnt);
         (*trace)->tmp           = malloc(sizeof(osal_uint64_t) * cnt);
+        (*trace)->hist          = malloc(sizeof(osal_trace_histogram_t));
 
         if (    ((*trace)->time_in_ns[0] == NULL) ||
                 ((*trace)->time_in_ns[1] == NULL) ||
-                ((*trace)->tmp           == NULL)) {
+                ((*trace)->tmp           == NULL) ||
+                ((*trace)->hist          == NULL)) {
             ret = OSAL_ERR_OUT_OF_MEMORY;
             goto error_exit;
         }
@@ -86,12 +277,22 @@ osal_retval_t osal_trace_alloc(osal_trace_t **trace, osal_uint32_t cnt) {
         memset((*trace)->time_in_ns[0], 0, sizeof(osal_uint64_t) * cnt);
         memset((*trace)->time_in_ns[1], 0, sizeof(osal_uint64_t) * cnt);
         memset((*trace)->tmp, 0, sizeof(osal_uint64_t) * cnt);
+
+        // also prefaults the histogram pages
+        trace_hist_reset((*trace)->hist);
     }
 
     return ret;
 
 error_exit:
+    (void)osal_binary_semaphore_destroy(&(*trace)->sync_sem);
+
+error_free:
     if ((*trace) != NULL) {
+        if ((*trace)->hist != NULL) {
+            free((*trace)->hist);
+        }
+
         if ((*trace)->tmp != 0) {
             free((*trace)->tmp);
         }
@@ -105,11 +306,212 @@ error_exit:
         }
 
         free((*trace));
+        (*trace) = NULL;
     }
 
     return ret;
 }
 
+//! \brief Allocate multi producer trace struct.
+/*!
+ * \param[out]  trace           Pointer to trace* where allocated trace struct is returned.
+ * \param[in]   max_producers   Maximum number of tasks registering to the trace.
+ * \param[in]   cnt             Number of samples per producer, rounded up to a power of 2.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_trace_alloc_mp(osal_trace_t **trace, osal_uint32_t max_producers, osal_uint32_t cnt) {
+    assert(trace != NULL);
+    osal_retval_t ret = OSAL_OK;
+    osal_uint32_t size = 1u;
+
+    (*trace) = NULL;
+
+    if ((max_producers == 0u) || (cnt == 0u) || (cnt > 0x80000000u)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        while (size < cnt) {
+            size <<= 1u;
+        }
+
+        (*trace) = malloc(sizeof(osal_trace_t));
+        if ((*trace) == NULL) {
+            ret = OSAL_ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        memset((*trace), 0, sizeof(osal_trace_t));
+        (*trace)->cnt           = size;
+        (*trace)->max_producers = max_producers;
+        (*trace)->generation    = __atomic_add_fetch(&trace_generation, 1u, __ATOMIC_RELAXED);
+
+        ret = osal_binary_semaphore_init(&(*trace)->sync_sem, NULL);
+        if (ret != OSAL_OK) {
+            // nothing else allocated, osal_trace_free would destroy the semaphore
+            free((*trace));
+            (*trace) = NULL;
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        // sub-buffers are cache line aligned to avoid false sharing between tasks
+        (*trace)->producers_mem = malloc((sizeof(osal_trace_producer_t) * max_producers) + OSAL_CACHE_LINE_SIZE);
+        if ((*trace)->producers_mem == NULL) {
+            ret = OSAL_ERR_OUT_OF_MEMORY;
+        } else {
+            osal_size_t addr = (osal_size_t)(uintptr_t)(*trace)->producers_mem;
+            addr = (addr + OSAL_CACHE_LINE_SIZE - 1u) & ~(osal_size_t)(OSAL_CACHE_LINE_SIZE - 1u);
+            (*trace)->producers = (osal_trace_producer_t *)(uintptr_t)addr;
+            memset((*trace)->producers, 0, sizeof(osal_trace_producer_t) * max_producers);
+
+            for (osal_uint32_t i = 0u; i < max_producers; ++i) {
+                osal_trace_producer_t *producer = &(*trace)->producers[i];
+                producer->id    = i;
+                producer->mask  = size - 1u;
+                producer->buf   = malloc(sizeof(osal_trace_record_t) * size);
+                producer->hist  = malloc(sizeof(osal_trace_histogram_t));
+                if ((producer->buf == NULL) || (producer->hist == NULL)) {
+                    ret = OSAL_ERR_OUT_OF_MEMORY;
+                    break;
+                }
+
+                // prefault, trace points should not take page faults
+                memset(producer->buf, 0, sizeof(osal_trace_record_t) * size);
+                trace_hist_reset(producer->hist);
+            }
+        }
+    }
+
+    if ((ret != OSAL_OK) && ((*trace) != NULL)) {
+        osal_trace_free((*trace));
+        (*trace) = NULL;
+    }
+
+    return ret;
+}
+
+//! \brief Register calling task as producer of a multi producer trace.
+/*!
+ * \param[in]   trace       Pointer to trace struct.
+ * \param[out]  producer    Returns producer id, can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_trace_register(osal_trace_t *trace, osal_uint32_t *producer) {
+    assert(trace != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_trace_producer_t *act = NULL;
+
+    if (trace->max_producers == 0u) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        act = trace_get_producer(trace);
+    }
+
+    if ((ret == OSAL_OK) && (act == NULL)) {
+        osal_uint32_t idx = __atomic_load_n(&trace->producer_cnt, __ATOMIC_RELAXED);
+
+        do {
+            if (idx >= trace->max_producers) {
+                ret = OSAL_ERR_SYSTEM_LIMIT_REACHED;
+                break;
+            }
+        } while (!__atomic_compare_exchange_n(&trace->producer_cnt, &idx, idx + 1u, 1,
+                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+        if (ret == OSAL_OK) {
+            act = &trace->producers[idx];
+            __atomic_store_n(&act->owner, trace_get_thread_id(OSAL_TRUE), __ATOMIC_RELEASE);
+
+            trace_cached_trace = trace;
+            trace_cached_generation = trace->generation;
+            trace_cached_producer = act;
+        }
+    }
+
+    if ((ret == OSAL_OK) && (producer != NULL)) {
+        (*producer) = act->id;
+    }
+
+    return ret;
+}
+
+//! \brief Read records of a multi producer trace merged by timestamp.
+/*!
+ * \param[in]   trace       Pointer to trace struct.
+ * \param[out]  records     Buffer for returned records.
+ * \param[in]   max_records Size of \p records.
+ * \param[out]  read_cnt    Returns number of records stored in \p records.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_trace_read(osal_trace_t *trace, osal_trace_record_t *records, 
+        osal_uint32_t max_records, osal_uint32_t *read_cnt) 
+{
+    assert(trace != NULL);
+    assert(records != NULL);
+    assert(read_cnt != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    (*read_cnt) = 0u;
+
+    if (trace->max_producers == 0u) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        osal_uint32_t cnt = __atomic_load_n(&trace->producer_cnt, __ATOMIC_ACQUIRE);
+
+        // k-way merge, always take the oldest head record of all producers
+        while ((*read_cnt) < max_records) {
+            osal_trace_producer_t *oldest = NULL;
+
+            for (osal_uint32_t i = 0u; i < cnt; ++i) {
+                osal_trace_record_t rec;
+
+                if (trace_mp_peek(&trace->producers[i], &rec) == OSAL_OK) {
+                    if ((oldest == NULL) || (rec.time < records[(*read_cnt)].time)) {
+                        oldest = &trace->producers[i];
+                        records[(*read_cnt)] = rec;
+                    }
+                }
+            }
+
+            if (oldest == NULL) {
+                break;
+            }
+
+            oldest->tail++;
+            (*read_cnt)++;
+        }
+
+        if ((*read_cnt) == 0u) {
+            ret = OSAL_ERR_NO_DATA;
+        }
+    }
+
+    return ret;
+}
+
+//! \brief Return number of records overwritten before they could be read.
+/*!
+ * \param[in]   trace   Pointer to multi producer trace struct.
+ *
+ * \return Number of lost records.
+ */
+osal_uint64_t osal_trace_get_lost(osal_trace_t *trace) {
+    assert(trace != NULL);
+
+    osal_uint64_t lost = 0u;
+    osal_uint32_t cnt = __atomic_load_n(&trace->producer_cnt, __ATOMIC_ACQUIRE);
+
+    for (osal_uint32_t i = 0u; i < cnt; ++i) {
+        lost += trace->producers[i].lost;
+    }
+
+    return lost;
+}
+
 //! \brief Free trace struct.
 /*!
  * \param[in]   trace   Pointer to trace struct to free.
@@ -119,6 +521,31 @@ error_exit:
 void osal_trace_free(osal_trace_t *trace) {
     assert(trace != NULL);
 
+    if (trace->producers != NULL) {
+        for (osal_uint32_t i = 0u; i < trace->max_producers; ++i) {
+            if (trace->producers[i].buf != NULL) {
+                free(trace->producers[i].buf);
+            }
+
+            if (trace->producers[i].hist != NULL) {
+                free(trace->producers[i].hist);
+            }
+        }
+    }
+
+    if (trace->producers_mem != NULL) {
+        free(trace->producers_mem);
+    }
+
+    if (trace_cached_trace == trace) {
+        trace_cached_trace = NULL;
+        trace_cached_producer = NULL;
+    }
+
+    if (trace->hist != NULL) {
+        free(trace->hist);
+    }
+
     if (trace->tmp != 0) {
         free(trace->tmp);
     }
@@ -131,6 +558,7 @@ void osal_trace_free(osal_trace_t *trace) {
         free(trace->time_in_ns[0]);
     }
 
+    (void)osal_binary_semaphore_destroy(&trace->sync_sem);
     free(trace);
 }
 
@@ -161,14 +589,21 @@ osal_uint64_t osal_trace_point(osal_trace_t *trace) {
 void osal_trace_time(osal_trace_t *trace, osal_uint64_t time) {
     assert(trace != NULL);
 
-    trace->time_in_ns[trace->act_buf][trace->pos] = time;
+    if (trace->max_producers != 0u) {
+        trace_mp_time(trace, time);
+    } else {
+        trace->time_in_ns[trace->act_buf][trace->pos] = time;
+
+        trace_hist_time(trace, trace->hist, trace->hist_last, time);
+        trace->hist_last = time;
 
-    trace->pos++;
-    if (trace->pos >= trace->cnt) {
-        trace->act_buf = trace->act_buf == 0 ? 1 : 0;
-        trace->pos = 0;
+        trace->pos++;
+        if (trace->pos >= trace->cnt) {
+            trace->act_buf = trace->act_buf == 0 ? 1 : 0;
+            trace->pos = 0;
 
-        osal_binary_semaphore_post(&(trace->sync_sem));
+            osal_binary_semaphore_post(&(trace->sync_sem));
+        }
     }
 }
 
@@ -184,7 +619,12 @@ osal_uint64_t osal_trace_get_last_time(osal_trace_t *trace) {
     osal_uint64_t last_time = 0u;
     osal_uint32_t last_buf = trace->act_buf;
 
-    if (trace->pos == 0) {
+    if (trace->max_producers != 0u) {
+        osal_trace_producer_t *producer = trace_get_producer(trace);
+        if (producer != NULL) {
+            last_time = producer->last_time;
+        }
+    } else if (trace->pos == 0) {
         last_buf = trace->act_buf == 0 ? 1 : 0;
         last_time = trace->time_in_ns[last_buf][trace->cnt - 1];
     } else {
@@ -205,6 +645,170 @@ osal_retval_t osal_trace_timedwait(osal_trace_t *trace, osal_timer_t *timeout) {
     return ret;
 }
 
+//! \brief Select what the streaming histogram records.
+/*!
+ * \param[in]   trace   Pointer to trace struct.
+ * \param[in]   mode    OSAL_TRACE_HISTOGRAM__INTERVAL or OSAL_TRACE_HISTOGRAM__VALUE.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_trace_set_histogram_mode(osal_trace_t *trace, osal_uint32_t mode) {
+    assert(trace != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+
+    if ((mode != OSAL_TRACE_HISTOGRAM__INTERVAL) && (mode != OSAL_TRACE_HISTOGRAM__VALUE)) {
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        trace->hist_mode = mode;
+        osal_trace_reset_histogram(trace);
+    }
+
+    return ret;
+}
+
+//! \brief Reset the streaming histogram.
+/*!
+ * \param[in]   trace   Pointer to trace struct.
+ *
+ * \return N/A
+ */
+void osal_trace_reset_histogram(osal_trace_t *trace) {
+    assert(trace != NULL);
+
+    if (trace->max_producers != 0u) {
+        for (osal_uint32_t i = 0u; i < trace->max_producers; ++i) {
+            trace_hist_reset(trace->producers[i].hist);
+            trace->producers[i].last_time = 0u;
+        }
+    } else {
+        trace_hist_reset(trace->hist);
+        trace->hist_last = 0u;
+    }
+}
+
+//! \brief Get a copy of the streaming histogram.
+/*!
+ * \param[in]   trace   Pointer to trace struct.
+ * \param[out]  hist    Returns histogram, summed up over all producers.
+ *
+ * \return N/A
+ */
+void osal_trace_get_histogram(osal_trace_t *trace, osal_trace_histogram_t *hist) {
+    assert(trace != NULL);
+    assert(hist != NULL);
+
+    trace_hist_reset(hist);
+
+    if (trace->max_producers != 0u) {
+        osal_uint32_t cnt = __atomic_load_n(&trace->producer_cnt, __ATOMIC_ACQUIRE);
+
+        for (osal_uint32_t i = 0u; i < cnt; ++i) {
+            trace_hist_merge(hist, trace->producers[i].hist);
+        }
+    } else {
+        trace_hist_merge(hist, trace->hist);
+    }
+}
+
+//! \brief Get value range of a histogram bucket.
+/*!
+ * \param[in]   idx     Bucket index.
+ * \param[out]  low     Returns lowest value counted in bucket.
+ * \param[out]  high    Returns highest value counted in bucket.
+ *
+ * \return N/A
+ */
+void osal_trace_histogram_bucket_bounds(osal_uint32_t idx, osal_uint64_t *low, osal_uint64_t *high) {
+    assert(idx < OSAL_TRACE_HISTOGRAM_BUCKETS);
+    assert(low != NULL);
+    assert(high != NULL);
+
+    if (idx < OSAL_TRACE_HISTOGRAM_SUB_CNT) {
+        (*low) = idx;
+        (*high) = idx;
+    } else {
+        osal_uint32_t shift = (idx >> OSAL_TRACE_HISTOGRAM_SUB_BITS) - 1u;
+        osal_uint64_t sub = (idx & (OSAL_TRACE_HISTOGRAM_SUB_CNT - 1u)) + OSAL_TRACE_HISTOGRAM_SUB_CNT;
+
+        (*low) = sub << shift;
+        (*high) = (*low) + ((1ull << shift) - 1u);
+    }
+}
+
+//! \brief Get percentiles from the streaming histogram.
+/*!
+ * \param[in]   trace       Pointer to trace struct.
+ * \param[in]   ppm         Percentiles in parts per million.
+ * \param[out]  values      Returns one value per requested percentile.
+ * \param[in]   cnt         Number of requested percentiles.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_trace_get_percentiles(osal_trace_t *trace, const osal_uint32_t *ppm, 
+        osal_uint64_t *values, osal_uint32_t cnt) 
+{
+    assert(trace != NULL);
+    assert(ppm != NULL);
+    assert(values != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    osal_trace_histogram_t *hist = trace->hist;
+    osal_trace_histogram_t *merged = NULL;
+
+    if (trace->max_producers != 0u) {
+        merged = malloc(sizeof(osal_trace_histogram_t));
+        if (merged == NULL) {
+            ret = OSAL_ERR_OUT_OF_MEMORY;
+        } else {
+            osal_trace_get_histogram(trace, merged);
+            hist = merged;
+        }
+    }
+
+    for (osal_uint32_t i = 0u; (ret == OSAL_OK) && (i < cnt); ++i) {
+        if (ppm[i] > 1000000u) {
+            ret = OSAL_ERR_INVALID_PARAM;
+        }
+    }
+
+    if (ret == OSAL_OK) {
+        osal_uint64_t samples = __atomic_load_n(&hist->cnt, __ATOMIC_ACQUIRE);
+
+        if (samples == 0u) {
+            ret = OSAL_ERR_NO_DATA;
+        } else {
+            for (osal_uint32_t i = 0u; i < cnt; ++i) {
+                // rank of the sample, rounded up, the first sample has rank 1
+                osal_uint64_t rank = ((samples * ppm[i]) + 999999u) / 1000000u;
+                osal_uint64_t seen = 0u;
+                osal_uint64_t low = 0u;
+                osal_uint64_t high = hist->max;
+
+                if (rank == 0u) {
+                    rank = 1u;
+                }
+
+                for (osal_uint32_t idx = 0u; idx < OSAL_TRACE_HISTOGRAM_BUCKETS; ++idx) {
+                    seen += hist->buckets[idx];
+                    if (seen >= rank) {
+                        osal_trace_histogram_bucket_bounds(idx, &low, &high);
+                        break;
+                    }
+                }
+
+                values[i] = high < hist->max ? high : hist->max;
+            }
+        }
+    }
+
+    if (merged != NULL) {
+        free(merged);
+    }
+
+    return ret;
+}
+
 //! \brief Analyze trace and return average and jitters.
 /*!
  * \param[in]   trace   Pointer to trace struct.
@@ -215,7 +819,7 @@ osal_retval_t osal_trace_timedwait(osal_trace_t *trace, osal_timer_t *timeout) {
  * \return N/A
  */
 void osal_trace_analyze(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *avg_jit, osal_uint64_t *max_jit) {
-    osal_trace_analyze_min_max(trace, avg, avg_jit, max_jit, NULL, NULL);
+    (void)osal_trace_analyze_ex(trace, avg, avg_jit, max_jit, NULL, NULL);
 }
 
 //! \brief Analyze trace and return average and jitters.
@@ -231,42 +835,68 @@ void osal_trace_analyze(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *
  */
 void osal_trace_analyze_min_max(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *avg_jit, 
         osal_uint64_t *max_jit, osal_uint64_t *min_val, osal_uint64_t *max_val)
+{
+    (void)osal_trace_analyze_ex(trace, avg, avg_jit, max_jit, min_val, max_val);
+}
+
+//! \brief Analyze trace and return average and jitters.
+/*!
+ * \param[in]   trace   Pointer to trace struct.
+ * \param[out]  avg     Return average time interval.
+ * \param[out]  avg_jit Return average jitter (std-dev).
+ * \param[out]  max_jit Return maximum jitter.
+ * \param[out]  min_val Return minimum interval value, can be NULL.
+ * \param[out]  max_val Return maximum interval value, can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_trace_analyze_ex(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *avg_jit, 
+        osal_uint64_t *max_jit, osal_uint64_t *min_val, osal_uint64_t *max_val)
 {
     assert(trace != NULL);
     assert(avg != NULL);
     assert(avg_jit != NULL);
     assert(max_jit != NULL);
 
+    osal_retval_t ret = OSAL_OK;
+
     (*avg)     = 0u;
     (*avg_jit) = 0u;
     (*max_jit) = 0u;
 
-    int act_buffer = trace->act_buf == 1 ? 0 : 1;
+    if (trace->max_producers != 0u) {
+        // multi producer traces have no time buffers
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        int act_buffer = trace->act_buf == 1 ? 0 : 1;
+
+        for (unsigned i = 0; i < (trace->cnt - 1u); ++i) {
+            trace->tmp[i] = trace->time_in_ns[act_buffer][i + 1u] - trace->time_in_ns[act_buffer][i];
+            (*avg) += trace->tmp[i];
 
-    for (unsigned i = 0; i < (trace->cnt - 1u); ++i) {
-        trace->tmp[i] = trace->time_in_ns[act_buffer][i + 1u] - trace->time_in_ns[act_buffer][i];
-        (*avg) += trace->tmp[i];
+            if (i == 0) {
+                if (min_val) { *min_val = trace->tmp[i]; }
+                if (max_val) { *max_val = trace->tmp[i]; }
+            }
 
-        if (i == 0) {
-            if (min_val) { *min_val = trace->tmp[i]; }
-            if (max_val) { *max_val = trace->tmp[i]; }
+            if (min_val && (*min_val > trace->tmp[i])) { *min_val = trace->tmp[i]; }
+            if (max_val && (*max_val < trace->tmp[i])) { *max_val = trace->tmp[i]; }
         }
 
-        if (min_val && (*min_val > trace->tmp[i])) { *min_val = trace->tmp[i]; }
-        if (max_val && (*max_val < trace->tmp[i])) { *max_val = trace->tmp[i]; }
-    }
+        (*avg) /= (trace->cnt - 1u);
 
-    (*avg) /= (trace->cnt - 1u);
+        for (unsigned i = 0; i < (trace->cnt - 1u); ++i) {
+            osal_int64_t dev = (osal_int64_t)(*avg) - trace->tmp[i];
+            if (dev < 0) { dev *= -1; }
+            if ((osal_uint64_t)dev > (*max_jit)) { (*max_jit) = dev; }
 
-    for (unsigned i = 0; i < (trace->cnt - 1u); ++i) {
-        osal_int64_t dev = (osal_int64_t)(*avg) - trace->tmp[i];
-        if (dev < 0) { dev *= -1; }
-        if ((osal_uint64_t)dev > (*max_jit)) { (*max_jit) = dev; }
+            (*avg_jit) += (dev * dev);
+        }
 
-        (*avg_jit) += (dev * dev);
+        (*avg_jit) = sqrt((*avg_jit) / trace->cnt);
     }
 
-    (*avg_jit) = sqrt((*avg_jit) / trace->cnt);
+    return ret;
 }
 
 
@@ -280,7 +910,7 @@ void osal_trace_analyze_min_max(osal_trace_t *trace, osal_uint64_t *avg, osal_ui
  * \return N/A
  */
 void osal_trace_analyze_rel(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *avg_jit, osal_uint64_t *max_jit) {
-    osal_trace_analyze_rel_min_max(trace, avg, avg_jit, max_jit, NULL, NULL);
+    (void)osal_trace_analyze_rel_ex(trace, avg, avg_jit, max_jit, NULL, NULL);
 }
 
 //! \brief Analyze trace with relative timestamps and return average and jitters.
@@ -296,39 +926,65 @@ void osal_trace_analyze_rel(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64
  */
 void osal_trace_analyze_rel_min_max(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *avg_jit, 
         osal_uint64_t *max_jit, osal_uint64_t *min_val, osal_uint64_t *max_val)
+{
+    (void)osal_trace_analyze_rel_ex(trace, avg, avg_jit, max_jit, min_val, max_val);
+}
+
+//! \brief Analyze trace with relative timestamps and return average and jitters.
+/*!
+ * \param[in]   trace   Pointer to trace struct.
+ * \param[out]  avg     Return average time interval.
+ * \param[out]  avg_jit Return average jitter (std-dev).
+ * \param[out]  max_jit Return maximum jitter.
+ * \param[out]  min_val Return minimum interval value, can be NULL.
+ * \param[out]  max_val Return maximum interval value, can be NULL.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_trace_analyze_rel_ex(osal_trace_t *trace, osal_uint64_t *avg, osal_uint64_t *avg_jit, 
+        osal_uint64_t *max_jit, osal_uint64_t *min_val, osal_uint64_t *max_val)
 {
     assert(trace != NULL);
     assert(avg != NULL);
     assert(avg_jit != NULL);
     assert(max_jit != NULL);
 
+    osal_retval_t ret = OSAL_OK;
+
     (*avg)     = 0u;
     (*avg_jit) = 0u;
     (*max_jit) = 0u;
 
-    int act_buffer = trace->act_buf == 1 ? 0 : 1;
+    if (trace->max_producers != 0u) {
+        // multi producer traces have no time buffers
+        ret = OSAL_ERR_INVALID_PARAM;
+    } else {
+        int act_buffer = trace->act_buf == 1 ? 0 : 1;
+
+        for (unsigned i = 0; i < trace->cnt; ++i) {
+            (*avg) += trace->time_in_ns[act_buffer][i];
 
-    for (unsigned i = 0; i < trace->cnt; ++i) {
-        (*avg) += trace->time_in_ns[act_buffer][i];
-        
-        if (i == 0) {
-            if (min_val) { *min_val = trace->time_in_ns[act_buffer][i]; }
-            if (max_val) { *max_val = trace->time_in_ns[act_buffer][i]; }
+            if (i == 0) {
+                if (min_val) { *min_val = trace->time_in_ns[act_buffer][i]; }
+                if (max_val) { *max_val = trace->time_in_ns[act_buffer][i]; }
+            }
+
+            if (min_val && (*min_val > trace->time_in_ns[act_buffer][i])) { *min_val = trace->time_in_ns[act_buffer][i]; }
+            if (max_val && (*max_val < trace->time_in_ns[act_buffer][i])) { *max_val = trace->time_in_ns[act_buffer][i]; }
         }
 
-        if (min_val && (*min_val > trace->time_in_ns[act_buffer][i])) { *min_val = trace->time_in_ns[act_buffer][i]; }
-        if (max_val && (*max_val < trace->time_in_ns[act_buffer][i])) { *max_val = trace->time_in_ns[act_buffer][i]; }
-    }
+        (*avg) /= trace->cnt;
 
-    (*avg) /= trace->cnt;
+        for (unsigned i = 0; i < trace->cnt; ++i) {
+            osal_int64_t dev = (osal_int64_t)(*avg) - trace->time_in_ns[act_buffer][i];
+            if (dev < 0) { dev *= -1; }
+            if ((osal_uint64_t)dev > (*max_jit)) { (*max_jit) = dev; }
 
-    for (unsigned i = 0; i < trace->cnt; ++i) {
-        osal_int64_t dev = (osal_int64_t)(*avg) - trace->time_in_ns[act_buffer][i];
-        if (dev < 0) { dev *= -1; }
-        if ((osal_uint64_t)dev > (*max_jit)) { (*max_jit) = dev; }
+            (*avg_jit) += (dev * dev);
+        }
 
-        (*avg_jit) += (dev * dev);
+        (*avg_jit) = sqrt((*avg_jit) / trace->cnt);
     }
 
-    (*avg_jit) = sqrt((*avg_jit) / trace->cnt);
+    return ret;
 }
@@ -33,10 +33,14 @@
 #endif
 
 #include <libosal/osal.h>
+#include <libosal/mutex.h>
 
 #include <pthread.h>
 #include <assert.h>
 
+#include <errnoLib.h>
+#include <sysLib.h>
+
 //! \brief Initialize a mutex.
 /*!
  * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
@@ -88,6 +92,48 @@ int osal_mutex_lock(osal_mutex_t *mtx) {
     return ret;
 }
 
+//! \brief Locks a mutex with timeout.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \return OK or ERROR_CODE.
+ */
+int osal_mutex_timedlock(osal_mutex_t *mtx, const osal_timer_t *to) {
+    assert(mtx != NULL);
+    assert(to != NULL);
+
+    int ret = OSAL_OK;
+    _Vx_ticks_t ticks = NO_WAIT;
+
+    // semTake wants relative ticks, round up to not return before the timeout
+    osal_int64_t rel_nsec = (osal_int64_t)osal_timer_to_nsec(to) - osal_timer_gettime_nsec();
+    if (rel_nsec > 0) {
+        osal_uint64_t rate = (osal_uint64_t)sysClkRateGet();
+        ticks = (_Vx_ticks_t)((((osal_uint64_t)rel_nsec * rate) + NSEC_PER_SEC - 1u) / NSEC_PER_SEC);
+    }
+
+    if (semTake(mtx->vxworks_mtx, ticks) != OK) {
+        switch (errnoGet()) {
+            case S_objLib_OBJ_TIMEOUT:
+                ret = OSAL_ERR_TIMEOUT;
+                break;
+            case S_objLib_OBJ_UNAVAILABLE:
+                // NO_WAIT on a passed timeout
+                ret = OSAL_ERR_TIMEOUT;
+                break;
+            case S_objLib_OBJ_ID_ERROR:
+                ret = OSAL_ERR_INVALID_PARAM;
+                break;
+            default:
+                ret = OSAL_ERR_UNAVAILABLE;
+                break;
+        }
+    }
+
+    return ret;
+}
+
 //! \brief Tries to lock a mutex.
 /*!
  * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
@@ -146,6 +192,22 @@ int osal_mutex_unlock(osal_mutex_t *mtx) {
     return ret;
 }
 
+//! \brief Marks the state of a robust mutex consistent.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+int osal_mutex_consistent(osal_mutex_t *mtx) {
+    assert(mtx != NULL);
+
+    // no robust mutexes, never reports a dead owner
+    (void)mtx;
+
+    int ret = OSAL_OK;
+    return ret;
+}
+
 //! \brief Destroys a mutex.
 /*!
  * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
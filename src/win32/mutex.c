@@ -95,6 +95,43 @@ osal_retval_t osal_mutex_lock(osal_mutex_t *mtx) {
     return ret;
 }
 
+//! \brief Locks a mutex with timeout.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ * \param[in]   to      Absolute timeout.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_mutex_timedlock(osal_mutex_t *mtx, const osal_timer_t *to) {
+    assert(mtx != NULL);
+    assert(to != NULL);
+
+    osal_retval_t ret = OSAL_OK;
+    DWORD local_ret;
+    DWORD timeout_ms = 0;
+    osal_uint64_t to_nsec = osal_timer_to_nsec(to),
+                  act_nsec = osal_timer_gettime_nsec();
+
+    // round up to not return before the timeout, stay below INFINITE
+    if (to_nsec > act_nsec) {
+        osal_uint64_t rel_ms = ((to_nsec - act_nsec) + 1000000u - 1u) / 1000000u;
+        timeout_ms = (rel_ms < (osal_uint64_t)INFINITE) ? (DWORD)rel_ms : (INFINITE - 1u);
+    }
+
+    local_ret = WaitForSingleObject(mtx->win32_mtx, timeout_ms);
+    if (local_ret != WAIT_OBJECT_0) {
+        if (local_ret == WAIT_ABANDONED) {
+            ret = OSAL_ERR_OWNER_DEAD;
+        } else if (local_ret == WAIT_TIMEOUT) {
+            ret = OSAL_ERR_TIMEOUT;
+        } else {
+            ret = OSAL_ERR_OPERATION_FAILED;
+        }
+    }
+
+    return ret;
+}
+
 //! \brief Tries to lock a mutex.
 /*!
  * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
@@ -143,6 +180,22 @@ osal_retval_t osal_mutex_unlock(osal_mutex_t *mtx) {
     return ret;
 }
 
+//! \brief Marks the state of a robust mutex consistent.
+/*!
+ * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
+ *
+ * \return OK or ERROR_CODE.
+ */
+osal_retval_t osal_mutex_consistent(osal_mutex_t *mtx) {
+    assert(mtx != NULL);
+
+    // an abandoned mutex is usable again once it has been acquired
+    (void)mtx;
+
+    osal_retval_t ret = OSAL_OK;
+    return ret;
+}
+
 //! \brief Destroys a mutex.
 /*!
  * \param[in]   mtx     Pointer to osal mutex structure. Content is OS dependent.
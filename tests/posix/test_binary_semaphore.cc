@@ -9,7 +9,9 @@
 #include <sched.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <sys/wait.h>
 #include <time.h>
+#include <unistd.h>
 #include <vector>
 
 namespace test_semaphore {
@@ -1258,6 +1260,78 @@ TEST(BinarySemaphoreFunction, TryCount) {
 }
 } // namespace trywait
 
+TEST(BinarySemaphoreFunction, NoWaiterPostTry) {
+  osal_binary_semaphore_t sema;
+  osal_timer_t to;
+
+  ASSERT_EQ(osal_binary_semaphore_init(&sema, nullptr), OSAL_OK);
+  EXPECT_EQ(osal_binary_semaphore_trywait(&sema), OSAL_ERR_BUSY);
+  EXPECT_EQ(osal_binary_semaphore_timedwait(&sema, nullptr), OSAL_ERR_TIMEOUT);
+
+  // posts without waiter are not counted
+  EXPECT_EQ(osal_binary_semaphore_post(&sema), OSAL_OK);
+  EXPECT_EQ(osal_binary_semaphore_post(&sema), OSAL_OK);
+  EXPECT_EQ(osal_binary_semaphore_trywait(&sema), OSAL_OK);
+  EXPECT_EQ(osal_binary_semaphore_trywait(&sema), OSAL_ERR_BUSY);
+
+  // expired timeout still takes a pending post
+  EXPECT_EQ(osal_binary_semaphore_post(&sema), OSAL_OK);
+  osal_timer_init(&to, 0);
+  EXPECT_EQ(osal_binary_semaphore_timedwait(&sema, &to), OSAL_OK);
+
+  osal_timer_init(&to, 1000000);
+  EXPECT_EQ(osal_binary_semaphore_timedwait(&sema, &to), OSAL_ERR_TIMEOUT);
+  EXPECT_EQ(osal_timer_expired(&to), OSAL_ERR_TIMEOUT)
+      << "returned before timeout";
+
+  // a timed out waiter leaves the semaphore usable
+  EXPECT_EQ(osal_binary_semaphore_post(&sema), OSAL_OK);
+  EXPECT_EQ(osal_binary_semaphore_wait(&sema), OSAL_OK);
+  EXPECT_EQ(osal_binary_semaphore_trywait(&sema), OSAL_ERR_BUSY);
+
+  EXPECT_EQ(osal_binary_semaphore_destroy(&sema), OSAL_OK);
+}
+
+TEST(BinarySemaphoreFunction, ProcessShared) {
+  const int LOOPCOUNT = 1000;
+  const osal_binary_semaphore_attr_t attr =
+      OSAL_BINARY_SEMAPHORE_ATTR__PROCESS_SHARED;
+
+  // ping-pong between parent and child in anonymous shared memory
+  osal_binary_semaphore_t *sems = (osal_binary_semaphore_t *)mmap(
+      nullptr, 2 * sizeof(osal_binary_semaphore_t), PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(sems, MAP_FAILED);
+  ASSERT_EQ(osal_binary_semaphore_init(&sems[0], &attr), OSAL_OK);
+  ASSERT_EQ(osal_binary_semaphore_init(&sems[1], &attr), OSAL_OK);
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+
+  if (pid == 0) {
+    int ret = 0;
+    for (int i = 0; (ret == 0) && (i < LOOPCOUNT); i++) {
+      ret |= osal_binary_semaphore_wait(&sems[0]);
+      ret |= osal_binary_semaphore_post(&sems[1]);
+    }
+    _exit(ret);
+  }
+
+  for (int i = 0; i < LOOPCOUNT; i++) {
+    osal_timer_t to;
+    osal_timer_init(&to, 1000000000);
+    ASSERT_EQ(osal_binary_semaphore_post(&sems[0]), OSAL_OK);
+    ASSERT_EQ(osal_binary_semaphore_timedwait(&sems[1], &to), OSAL_OK)
+        << "no answer from other process in round " << i;
+  }
+
+  int status = -1;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+
+  munmap(sems, 2 * sizeof(osal_binary_semaphore_t));
+}
+
 } // namespace test_semaphore
 
 int main(int argc, char **argv) {
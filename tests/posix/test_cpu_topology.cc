@@ -0,0 +1,279 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sched.h>
+#include <string>
+
+#include "libosal/osal.h"
+#include "libosal/cpu_topology.h"
+#include "libosal/task.h"
+
+namespace test_cpu_topology {
+
+namespace fs = std::filesystem;
+
+/* fake sysfs of 8 possible CPUs, cpu 7 is offline
+
+   package 0: cores {0,4} {1,5}, L2 shared by both cores, node 0
+   package 1: cores {2,6} {3,7}, L2 per core, node 1
+
+   isolcpus=1,3,5 nohz_full=1,5 */
+class FakeSysfs {
+public:
+  FakeSysfs() {
+    char tmpl[] = "/tmp/osal_topology_XXXXXX";
+    root = mkdtemp(tmpl);
+
+    write("cpu/possible", "0-7");
+    write("cpu/online", "0-6");
+    write("cpu/isolated", "1,3,5");
+    write("cpu/nohz_full", "1,5");
+    write("node/online", "0-1");
+    write("node/node0/cpulist", "0-1,4-5");
+    write("node/node1/cpulist", "2-3,6-7");
+
+    for (int cpu = 0; cpu < 8; cpu++) {
+      int package = (cpu / 2) % 2;
+      int core = cpu % 4;
+      std::string dir = "cpu/cpu" + std::to_string(cpu) + "/";
+      std::string siblings =
+          std::to_string(core) + "," + std::to_string(core + 4);
+
+      write(dir + "topology/physical_package_id", std::to_string(package));
+      write(dir + "topology/core_id", std::to_string(core % 2));
+      write(dir + "topology/thread_siblings_list", siblings);
+
+      cache(dir + "cache/index0/", 1, "Data", "48K", siblings);
+      cache(dir + "cache/index1/", 1, "Instruction", "32K", siblings);
+      cache(dir + "cache/index2/", 2, "Unified", "2048K",
+            package == 0 ? "0-1,4-5" : siblings);
+      cache(dir + "cache/index3/", 3, "Unified", "30M",
+            package == 0 ? "0-1,4-5" : "2-3,6-7");
+    }
+  }
+
+  ~FakeSysfs() { fs::remove_all(root); }
+
+  void write(const std::string &file, const std::string &content) {
+    fs::path path = fs::path(root) / file;
+    fs::create_directories(path.parent_path());
+    std::ofstream(path) << content << "\n";
+  }
+
+  std::string root;
+
+private:
+  void cache(const std::string &dir, int level, const char *type,
+             const char *size, const std::string &shared) {
+    write(dir + "level", std::to_string(level));
+    write(dir + "type", type);
+    write(dir + "size", size);
+    write(dir + "coherency_line_size", "64");
+    write(dir + "shared_cpu_list", shared);
+  }
+};
+
+static osal_cpuset_t cpus(std::initializer_list<osal_uint32_t> list) {
+  osal_cpuset_t set;
+  osal_cpuset_zero(&set);
+  for (osal_uint32_t cpu : list) {
+    osal_cpuset_set(&set, cpu);
+  }
+  return set;
+}
+
+static bool equal(const osal_cpuset_t &a, const osal_cpuset_t &b) {
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+TEST(CpuTopologyFunction, Describe) {
+  FakeSysfs sysfs;
+  osal_cpu_topology_t topo;
+  ASSERT_EQ(osal_cpu_topology_init(&topo, sysfs.root.c_str()), OSAL_OK);
+
+  EXPECT_EQ(topo.cpu_cnt, 8u);
+  EXPECT_EQ(topo.package_cnt, 2u);
+  EXPECT_EQ(topo.core_cnt, 4u);
+  EXPECT_EQ(topo.node_cnt, 2u);
+  EXPECT_TRUE(equal(topo.online, cpus({0, 1, 2, 3, 4, 5, 6})));
+  EXPECT_TRUE(equal(topo.isolated, cpus({1, 3, 5})));
+  EXPECT_TRUE(equal(topo.nohz_full, cpus({1, 5})));
+  EXPECT_EQ(topo.cpus[7].package, -1) << "offline cpu";
+  EXPECT_EQ(topo.cpus[6].node, 1);
+
+  osal_cpuset_t set;
+  EXPECT_EQ(osal_cpu_topology_get_core_cpus(&topo, 4, &set), OSAL_OK);
+  EXPECT_TRUE(equal(set, cpus({0, 4})));
+  EXPECT_EQ(osal_cpu_topology_get_package_cpus(&topo, 2, &set), OSAL_OK);
+  EXPECT_TRUE(equal(set, cpus({2, 3, 6})));
+  EXPECT_EQ(osal_cpu_topology_get_node_cpus(&topo, 1, &set), OSAL_OK);
+  EXPECT_TRUE(equal(set, cpus({2, 3, 6})));
+  EXPECT_EQ(osal_cpu_topology_get_node_cpus(&topo, 2, &set),
+            OSAL_ERR_NOT_FOUND);
+
+  osal_cpu_topology_cache_t cache;
+  EXPECT_EQ(osal_cpu_topology_get_cache(&topo, 5, 1, &cache, &set), OSAL_OK);
+  EXPECT_EQ(cache.type, OSAL_CPU_TOPOLOGY_CACHE_DATA);
+  EXPECT_EQ(cache.size, 48u * 1024u);
+  EXPECT_EQ(cache.line_size, 64u);
+  EXPECT_TRUE(equal(set, cpus({1, 5})));
+
+  EXPECT_EQ(osal_cpu_topology_get_cache(&topo, 0, 2, &cache, &set), OSAL_OK);
+  EXPECT_EQ(cache.first_cpu, 0u);
+  EXPECT_TRUE(equal(set, cpus({0, 1, 4, 5})));
+  EXPECT_EQ(osal_cpu_topology_get_cache(&topo, 6, 2, nullptr, &set), OSAL_OK);
+  EXPECT_TRUE(equal(set, cpus({2, 6})));
+  EXPECT_EQ(osal_cpu_topology_get_cache(&topo, 6, 3, &cache, nullptr),
+            OSAL_OK);
+  EXPECT_EQ(cache.size, 30u * 1024u * 1024u);
+
+  EXPECT_EQ(osal_cpu_topology_get_cache(&topo, 0, 4, &cache, &set),
+            OSAL_ERR_NOT_FOUND);
+
+  EXPECT_EQ(osal_cpu_topology_destroy(&topo), OSAL_OK);
+}
+
+TEST(CpuTopologyFunction, Pick) {
+  FakeSysfs sysfs;
+  osal_cpu_topology_t topo;
+  ASSERT_EQ(osal_cpu_topology_init(&topo, sysfs.root.c_str()), OSAL_OK);
+
+  osal_cpu_topology_pick_t pick = {};
+  osal_uint32_t cpu = OSAL_CPUSET_SIZE;
+
+  EXPECT_EQ(osal_cpu_topology_pick(&topo, &pick, &cpu), OSAL_OK);
+  EXPECT_EQ(cpu, 0u) << "any cpu";
+
+  // isolated consumer sharing L2 with producer on cpu 0
+  pick.flags = OSAL_CPU_TOPOLOGY_PICK_ISOLATED;
+  pick.near_cpu = 0;
+  pick.cache_level = 2;
+  EXPECT_EQ(osal_cpu_topology_pick(&topo, &pick, &cpu), OSAL_OK);
+  EXPECT_EQ(cpu, 1u);
+
+  osal_cpuset_set(&pick.exclude, 1);
+  EXPECT_EQ(osal_cpu_topology_pick(&topo, &pick, &cpu), OSAL_OK);
+  EXPECT_EQ(cpu, 5u);
+
+  pick.flags |= OSAL_CPU_TOPOLOGY_PICK_WHOLE_CORE;
+  EXPECT_EQ(osal_cpu_topology_pick(&topo, &pick, &cpu), OSAL_ERR_NOT_FOUND)
+      << "smt sibling of cpu 5 is used";
+
+  // sharing L1 means sharing the core with near cpu
+  pick = {};
+  pick.flags = OSAL_CPU_TOPOLOGY_PICK_WHOLE_CORE;
+  pick.near_cpu = 4;
+  pick.cache_level = 1;
+  EXPECT_EQ(osal_cpu_topology_pick(&topo, &pick, &cpu), OSAL_ERR_NOT_FOUND);
+  pick.flags = 0;
+  EXPECT_EQ(osal_cpu_topology_pick(&topo, &pick, &cpu), OSAL_OK);
+  EXPECT_EQ(cpu, 0u);
+
+  pick = {};
+  pick.flags = OSAL_CPU_TOPOLOGY_PICK_ISOLATED | OSAL_CPU_TOPOLOGY_PICK_SAME_NODE;
+  pick.near_cpu = 2;
+  EXPECT_EQ(osal_cpu_topology_pick(&topo, &pick, &cpu), OSAL_OK);
+  EXPECT_EQ(cpu, 3u);
+
+  pick = {};
+  pick.flags =
+      OSAL_CPU_TOPOLOGY_PICK_NOHZ_FULL | OSAL_CPU_TOPOLOGY_PICK_SAME_PACKAGE;
+  pick.near_cpu = 2;
+  EXPECT_EQ(osal_cpu_topology_pick(&topo, &pick, &cpu), OSAL_ERR_NOT_FOUND);
+  pick.near_cpu = 4;
+  EXPECT_EQ(osal_cpu_topology_pick(&topo, &pick, &cpu), OSAL_OK);
+  EXPECT_EQ(cpu, 1u);
+
+  osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
+  attr.priority = 42;
+  attr.affinity = 0x1u;
+  EXPECT_EQ(osal_cpu_topology_place_task(&topo, 6, &attr), OSAL_OK);
+  EXPECT_TRUE(equal(attr.cpuset, cpus({6})));
+  EXPECT_EQ(attr.affinity, 0u);
+  EXPECT_EQ(attr.numa_nodes, 0x2u);
+  EXPECT_EQ(attr.flags, OSAL_TASK_ATTR__CPUSET | OSAL_TASK_ATTR__NUMA_NODES);
+  EXPECT_EQ(attr.priority, 42u);
+
+  EXPECT_EQ(osal_cpu_topology_destroy(&topo), OSAL_OK);
+}
+
+TEST(CpuTopologyFunction, Host) {
+  osal_cpu_topology_t topo;
+  ASSERT_EQ(osal_cpu_topology_init(&topo, nullptr), OSAL_OK);
+
+  int current = sched_getcpu();
+  EXPECT_EQ(osal_cpuset_isset(&topo.online, current), OSAL_TRUE);
+  EXPECT_GE(topo.package_cnt, 1u);
+  EXPECT_GE(topo.core_cnt, 1u);
+  EXPECT_LE(topo.core_cnt, osal_cpuset_count(&topo.online));
+
+  osal_cpuset_t set;
+  EXPECT_EQ(osal_cpu_topology_get_core_cpus(&topo, current, &set), OSAL_OK);
+  EXPECT_EQ(osal_cpuset_isset(&set, current), OSAL_TRUE);
+
+  printf("%u cpus online, %u packages, %u cores, %u numa nodes, %u isolated\n",
+         osal_cpuset_count(&topo.online), topo.package_cnt, topo.core_cnt,
+         topo.node_cnt, osal_cpuset_count(&topo.isolated));
+
+  EXPECT_EQ(osal_cpu_topology_destroy(&topo), OSAL_OK);
+}
+
+TEST(CpuTopologyReject, InvalidParams) {
+  FakeSysfs sysfs;
+  osal_cpu_topology_t topo;
+  ASSERT_EQ(osal_cpu_topology_init(&topo, sysfs.root.c_str()), OSAL_OK);
+
+  osal_cpuset_t set;
+  EXPECT_EQ(osal_cpu_topology_get_core_cpus(&topo, 7, &set),
+            OSAL_ERR_INVALID_PARAM)
+      << "offline cpu";
+  EXPECT_EQ(osal_cpu_topology_get_package_cpus(&topo, 8, &set),
+            OSAL_ERR_INVALID_PARAM)
+      << "impossible cpu";
+
+  osal_cpu_topology_pick_t pick = {};
+  osal_uint32_t cpu;
+  pick.near_cpu = 7;
+  pick.cache_level = 2;
+  EXPECT_EQ(osal_cpu_topology_pick(&topo, &pick, &cpu), OSAL_ERR_INVALID_PARAM)
+      << "offline near cpu";
+
+  osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
+  EXPECT_EQ(osal_cpu_topology_place_task(&topo, 7, &attr),
+            OSAL_ERR_INVALID_PARAM);
+
+  EXPECT_EQ(osal_cpu_topology_destroy(&topo), OSAL_OK);
+}
+
+TEST(CpuTopologyFunction, UnsetIsolation) {
+  FakeSysfs sysfs;
+  sysfs.write("cpu/isolated", "");
+  sysfs.write("cpu/nohz_full", "(null)");
+
+  osal_cpu_topology_t topo;
+  ASSERT_EQ(osal_cpu_topology_init(&topo, sysfs.root.c_str()), OSAL_OK);
+  EXPECT_EQ(osal_cpuset_count(&topo.isolated), 0u);
+  EXPECT_EQ(osal_cpuset_count(&topo.nohz_full), 0u);
+  EXPECT_EQ(osal_cpu_topology_destroy(&topo), OSAL_OK);
+}
+
+TEST(CpuTopologyError, BrokenSysfs) {
+  osal_cpu_topology_t topo;
+  EXPECT_EQ(osal_cpu_topology_init(&topo, "/nonexistent"), OSAL_ERR_UNAVAILABLE);
+
+  FakeSysfs sysfs;
+  sysfs.write("cpu/cpu3/cache/index2/shared_cpu_list", "2-x");
+  EXPECT_EQ(osal_cpu_topology_init(&topo, sysfs.root.c_str()),
+            OSAL_ERR_OPERATION_FAILED);
+}
+
+} // namespace test_cpu_topology
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
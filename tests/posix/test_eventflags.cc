@@ -0,0 +1,201 @@
+#include "gtest/gtest.h"
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "libosal/eventflags.h"
+#include "libosal/osal.h"
+#include "libosal/timer.h"
+
+namespace test_eventflags {
+
+const osal_uint64_t TIMEOUT = 1000000000; // 1 s
+
+TEST(EventflagsFunction, SetGetClear) {
+  osal_eventflags_t ef;
+  ASSERT_EQ(osal_eventflags_init(&ef, nullptr), OSAL_OK);
+  EXPECT_EQ(osal_eventflags_get(&ef), 0u);
+
+  EXPECT_EQ(osal_eventflags_set(&ef, 0x5), OSAL_OK);
+  EXPECT_EQ(osal_eventflags_set(&ef, 0x100), OSAL_OK);
+  EXPECT_EQ(osal_eventflags_get(&ef), 0x105u);
+
+  EXPECT_EQ(osal_eventflags_clear(&ef, 0x101), OSAL_OK);
+  EXPECT_EQ(osal_eventflags_get(&ef), 0x4u);
+
+  EXPECT_EQ(osal_eventflags_destroy(&ef), OSAL_OK);
+}
+
+TEST(EventflagsFunction, WaitAnyAll) {
+  osal_eventflags_t ef;
+  osal_uint32_t flags = 0;
+  osal_timer_t to;
+  ASSERT_EQ(osal_eventflags_init(&ef, nullptr), OSAL_OK);
+
+  osal_eventflags_set(&ef, 0x2);
+  osal_timer_init(&to, 0);
+  EXPECT_EQ(osal_eventflags_timedwait(&ef, 0x3, OSAL_EVENTFLAGS_WAIT__ANY,
+                                      &flags, &to),
+            OSAL_OK);
+  EXPECT_EQ(flags, 0x2u);
+  EXPECT_EQ(osal_eventflags_timedwait(&ef, 0x3, OSAL_EVENTFLAGS_WAIT__ALL,
+                                      &flags, &to),
+            OSAL_ERR_TIMEOUT)
+      << "only one of two flags is set";
+
+  osal_eventflags_set(&ef, 0x1);
+  EXPECT_EQ(osal_eventflags_wait(&ef, 0x3, OSAL_EVENTFLAGS_WAIT__ALL, &flags),
+            OSAL_OK);
+  EXPECT_EQ(flags, 0x3u);
+  EXPECT_EQ(osal_eventflags_get(&ef), 0x3u) << "flags must not be consumed";
+
+  osal_eventflags_destroy(&ef);
+}
+
+TEST(EventflagsFunction, WaitClear) {
+  osal_eventflags_t ef;
+  osal_uint32_t flags = 0;
+  osal_timer_t to;
+  ASSERT_EQ(osal_eventflags_init(&ef, nullptr), OSAL_OK);
+
+  osal_eventflags_set(&ef, 0x13);
+  EXPECT_EQ(osal_eventflags_wait(&ef, 0x3,
+                                 OSAL_EVENTFLAGS_WAIT__ALL |
+                                     OSAL_EVENTFLAGS_WAIT__CLEAR,
+                                 &flags),
+            OSAL_OK);
+  EXPECT_EQ(flags, 0x13u) << "flags are returned before clearing";
+  EXPECT_EQ(osal_eventflags_get(&ef), 0x10u) << "only mask is consumed";
+
+  osal_timer_init(&to, 1000000);
+  EXPECT_EQ(osal_eventflags_timedwait(&ef, 0x3, OSAL_EVENTFLAGS_WAIT__CLEAR,
+                                      &flags, &to),
+            OSAL_ERR_TIMEOUT)
+      << "event has already been consumed";
+
+  osal_eventflags_destroy(&ef);
+}
+
+TEST(EventflagsFunction, WakeWaiters) {
+  const int LOOPCOUNT = 1000;
+  osal_eventflags_t ef;
+  ASSERT_EQ(osal_eventflags_init(&ef, nullptr), OSAL_OK);
+
+  // each side waits for its own flag, the other one sets it
+  std::thread peer([&ef]() {
+    for (int i = 0; i < LOOPCOUNT; i++) {
+      osal_eventflags_wait(&ef, 0x1, OSAL_EVENTFLAGS_WAIT__CLEAR, nullptr);
+      osal_eventflags_set(&ef, 0x2);
+    }
+  });
+
+  for (int i = 0; i < LOOPCOUNT; i++) {
+    osal_timer_t to;
+    osal_timer_init(&to, TIMEOUT);
+    ASSERT_EQ(osal_eventflags_set(&ef, 0x1), OSAL_OK);
+    ASSERT_EQ(osal_eventflags_timedwait(&ef, 0x2, OSAL_EVENTFLAGS_WAIT__CLEAR,
+                                        nullptr, &to),
+              OSAL_OK)
+        << "no answer from peer in round " << i;
+  }
+
+  peer.join();
+  osal_eventflags_destroy(&ef);
+}
+
+TEST(EventflagsFunction, WakeAllMatching) {
+  const int THREADS = 4;
+  osal_eventflags_t ef;
+  osal_uint32_t woken = 0;
+  ASSERT_EQ(osal_eventflags_init(&ef, nullptr), OSAL_OK);
+
+  std::thread waiters[THREADS];
+  for (int i = 0; i < THREADS; i++) {
+    waiters[i] = std::thread([&ef, &woken]() {
+      osal_timer_t to;
+      osal_timer_init(&to, 5 * TIMEOUT);
+      if (osal_eventflags_timedwait(&ef, 0x8, OSAL_EVENTFLAGS_WAIT__ANY,
+                                    nullptr, &to) == OSAL_OK) {
+        __atomic_fetch_add(&woken, 1, __ATOMIC_RELAXED);
+      }
+    });
+  }
+
+  // other flags must not release the waiters
+  osal_eventflags_set(&ef, 0x7);
+  osal_sleep(10000000);
+  EXPECT_EQ(__atomic_load_n(&woken, __ATOMIC_RELAXED), 0u);
+
+  osal_eventflags_set(&ef, 0x8);
+  for (int i = 0; i < THREADS; i++) {
+    waiters[i].join();
+  }
+  EXPECT_EQ(woken, (osal_uint32_t)THREADS) << "broadcast has to wake all";
+
+  osal_eventflags_destroy(&ef);
+}
+
+TEST(EventflagsFunction, ProcessShared) {
+  const int LOOPCOUNT = 1000;
+  const osal_eventflags_attr_t attr = OSAL_EVENTFLAGS_ATTR__PROCESS_SHARED;
+
+  osal_eventflags_t *ef = (osal_eventflags_t *)mmap(
+      nullptr, sizeof(osal_eventflags_t), PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(ef, MAP_FAILED);
+  ASSERT_EQ(osal_eventflags_init(ef, &attr), OSAL_OK);
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+
+  if (pid == 0) {
+    int ret = 0;
+    for (int i = 0; (ret == 0) && (i < LOOPCOUNT); i++) {
+      ret |= osal_eventflags_wait(ef, 0x1, OSAL_EVENTFLAGS_WAIT__CLEAR,
+                                  nullptr);
+      ret |= osal_eventflags_set(ef, 0x2);
+    }
+    _exit(ret);
+  }
+
+  for (int i = 0; i < LOOPCOUNT; i++) {
+    osal_timer_t to;
+    osal_timer_init(&to, TIMEOUT);
+    ASSERT_EQ(osal_eventflags_set(ef, 0x1), OSAL_OK);
+    ASSERT_EQ(osal_eventflags_timedwait(ef, 0x2, OSAL_EVENTFLAGS_WAIT__CLEAR,
+                                        nullptr, &to),
+              OSAL_OK)
+        << "no answer from other process in round " << i;
+  }
+
+  int status = -1;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+
+  munmap(ef, sizeof(osal_eventflags_t));
+}
+
+TEST(EventflagsReject, EmptyMask) {
+  osal_eventflags_t ef;
+  osal_timer_t to;
+  ASSERT_EQ(osal_eventflags_init(&ef, nullptr), OSAL_OK);
+  osal_eventflags_set(&ef, 0x1);
+
+  osal_timer_init(&to, 0);
+  EXPECT_EQ(osal_eventflags_wait(&ef, 0, OSAL_EVENTFLAGS_WAIT__ANY, nullptr),
+            OSAL_ERR_INVALID_PARAM);
+  EXPECT_EQ(osal_eventflags_timedwait(&ef, 0, OSAL_EVENTFLAGS_WAIT__ALL,
+                                      nullptr, &to),
+            OSAL_ERR_INVALID_PARAM);
+
+  osal_eventflags_destroy(&ef);
+}
+
+} // namespace test_eventflags
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,321 @@
+#include "libosal/mq.h"
+#include "libosal/osal.h"
+#include "test_utils.h"
+#include "gtest/gtest.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace test_messagequeue_userspace {
+
+using testutils::set_deadline;
+
+const char *QUEUE_NAME = "/test_us_mq";
+
+static osal_mq_attr_t make_attr(osal_size_t max_messages,
+                                osal_size_t max_message_size) {
+  osal_mq_attr_t attr = {};
+  attr.oflags = OSAL_MQ_ATTR__OFLAG__RDWR | OSAL_MQ_ATTR__OFLAG__CREAT |
+                OSAL_MQ_ATTR__OFLAG__USERSPACE;
+  attr.max_messages = max_messages;
+  attr.max_message_size = max_message_size;
+  attr.mode = S_IRUSR | S_IWUSR;
+  return attr;
+}
+
+TEST(MessageQueueUserspaceFunction, PriorityOrder) {
+  osal_retval_t orv;
+  osal_mq_t mqueue;
+  osal_mq_attr_t attr = make_attr(8, 16);
+
+  shm_unlink(QUEUE_NAME);
+  orv = osal_mq_open(&mqueue, QUEUE_NAME, &attr);
+  ASSERT_EQ(orv, OSAL_OK) << "osal_mq_open() failed";
+
+  const osal_uint32_t prios[] = {1, 5, 1, 31, 0, 5};
+  for (osal_uint32_t i = 0; i < 6; i++) {
+    osal_char_t buf[16] = {};
+    buf[0] = (osal_char_t)i;
+    orv = osal_mq_send(&mqueue, buf, 1, prios[i]);
+    ASSERT_EQ(orv, OSAL_OK) << "osal_mq_send() failed";
+  }
+
+  // highest priority first, FIFO within a priority
+  const osal_uint32_t expected_idx[] = {3, 1, 5, 0, 2, 4};
+  for (osal_uint32_t i = 0; i < 6; i++) {
+    osal_char_t buf[16] = {};
+    osal_uint32_t prio = 0xFFFF;
+    orv = osal_mq_receive(&mqueue, buf, sizeof(buf), &prio);
+    ASSERT_EQ(orv, OSAL_OK) << "osal_mq_receive() failed";
+    EXPECT_EQ(buf[0], (osal_char_t)expected_idx[i]);
+    EXPECT_EQ(prio, prios[expected_idx[i]]);
+  }
+
+  osal_timer_t deadline;
+  osal_timer_init(&deadline, 10000000);
+  osal_char_t buf[16];
+  orv = osal_mq_timedreceive(&mqueue, buf, sizeof(buf), nullptr, &deadline);
+  EXPECT_EQ(orv, OSAL_ERR_TIMEOUT) << "queue should be empty";
+
+  EXPECT_EQ(osal_mq_close(&mqueue), OSAL_OK);
+  shm_unlink(QUEUE_NAME);
+}
+
+TEST(MessageQueueUserspaceFunction, SharedCapacity) {
+  osal_mq_t mqueue;
+  osal_mq_attr_t attr = make_attr(1000, 1024);
+
+  shm_unlink(QUEUE_NAME);
+  ASSERT_EQ(osal_mq_open(&mqueue, QUEUE_NAME, &attr), OSAL_OK);
+
+  // one slot per message, not one ring of max_messages per priority
+  int fd = shm_open(QUEUE_NAME, O_RDONLY, 0);
+  ASSERT_NE(fd, -1);
+  struct stat st;
+  ASSERT_EQ(fstat(fd, &st), 0);
+  close(fd);
+  EXPECT_LT((osal_size_t)st.st_size,
+            2 * attr.max_messages * attr.max_message_size);
+
+  // all priorities draw from the same capacity
+  osal_char_t buf[1024] = {};
+  for (osal_uint32_t i = 0; i < attr.max_messages; i++) {
+    ASSERT_EQ(osal_mq_send(&mqueue, buf, 8, i % OSAL_MQ_USERSPACE_PRIO_CNT),
+              OSAL_OK);
+  }
+
+  osal_timer_t deadline;
+  osal_timer_init(&deadline, 1000000);
+  EXPECT_EQ(osal_mq_timedsend(&mqueue, buf, 8, 0, &deadline), OSAL_ERR_TIMEOUT)
+      << "queue should be full";
+
+  for (osal_uint32_t i = 0; i < attr.max_messages; i++) {
+    ASSERT_EQ(osal_mq_receive(&mqueue, buf, sizeof(buf), nullptr), OSAL_OK);
+  }
+
+  EXPECT_EQ(osal_mq_close(&mqueue), OSAL_OK);
+  shm_unlink(QUEUE_NAME);
+}
+
+TEST(MessageQueueUserspaceFunction, FullQueueTimeout) {
+  osal_retval_t orv;
+  osal_mq_t mqueue;
+  osal_mq_attr_t attr = make_attr(3, 16);
+
+  shm_unlink(QUEUE_NAME);
+  ASSERT_EQ(osal_mq_open(&mqueue, QUEUE_NAME, &attr), OSAL_OK);
+
+  osal_char_t buf[16] = {};
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(osal_mq_send(&mqueue, buf, sizeof(buf), 0), OSAL_OK);
+  }
+
+  osal_timer_t deadline;
+  osal_timer_init(&deadline, 10000000);
+  orv = osal_mq_timedsend(&mqueue, buf, sizeof(buf), 0, &deadline);
+  EXPECT_EQ(orv, OSAL_ERR_TIMEOUT) << "max_messages has to be enforced";
+
+  ASSERT_EQ(osal_mq_receive(&mqueue, buf, sizeof(buf), nullptr), OSAL_OK);
+  osal_timer_init(&deadline, 10000000);
+  orv = osal_mq_timedsend(&mqueue, buf, sizeof(buf), 0, &deadline);
+  EXPECT_EQ(orv, OSAL_OK) << "space was freed by receive";
+
+  EXPECT_EQ(osal_mq_close(&mqueue), OSAL_OK);
+  shm_unlink(QUEUE_NAME);
+}
+
+TEST(MessageQueueUserspaceDetect, InvalidParams) {
+  osal_mq_t mqueue;
+  osal_mq_attr_t attr = make_attr(4, 16);
+
+  shm_unlink(QUEUE_NAME);
+  ASSERT_EQ(osal_mq_open(&mqueue, QUEUE_NAME, &attr), OSAL_OK);
+
+  osal_char_t buf[32] = {};
+  EXPECT_EQ(osal_mq_send(&mqueue, buf, sizeof(buf), 0), OSAL_ERR_INVALID_PARAM)
+      << "message larger than max_message_size";
+  EXPECT_EQ(osal_mq_send(&mqueue, buf, 16, OSAL_MQ_USERSPACE_PRIO_CNT),
+            OSAL_ERR_INVALID_PARAM)
+      << "priority out of range";
+  EXPECT_EQ(osal_mq_receive(&mqueue, buf, 8, nullptr), OSAL_ERR_INVALID_PARAM)
+      << "receive buffer smaller than max_message_size";
+
+  osal_timer_t deadline = set_deadline(1, 0);
+  deadline.sec = -1;
+  EXPECT_EQ(osal_mq_timedsend(&mqueue, buf, 16, 1, &deadline),
+            OSAL_ERR_INVALID_PARAM);
+
+  osal_mq_attr_t excl_attr = attr;
+  excl_attr.oflags |= OSAL_MQ_ATTR__OFLAG__EXCL;
+  osal_mq_t mqueue2;
+  EXPECT_EQ(osal_mq_open(&mqueue2, QUEUE_NAME, &excl_attr),
+            OSAL_ERR_PERMISSION_DENIED);
+
+  EXPECT_EQ(osal_mq_close(&mqueue), OSAL_OK);
+  shm_unlink(QUEUE_NAME);
+
+  osal_mq_attr_t open_attr = {};
+  open_attr.oflags = OSAL_MQ_ATTR__OFLAG__RDWR | OSAL_MQ_ATTR__OFLAG__USERSPACE;
+  EXPECT_EQ(osal_mq_open(&mqueue2, QUEUE_NAME, &open_attr), OSAL_ERR_NOT_FOUND);
+}
+
+namespace multiwriter_multireader {
+
+const osal_uint32_t N_PRODUCERS = 4;
+const osal_uint32_t M_CONSUMERS = 3;
+const osal_uint32_t NUM_MESSAGES_PER_PRODUCER = 30000;
+
+typedef struct {
+  osal_uint32_t producer;
+  osal_uint32_t seq;
+} message_t;
+
+typedef struct {
+  osal_mq_t *mq;
+  osal_uint32_t id;
+  osal_uint32_t received;
+  std::vector<osal_uint32_t> last_seq;
+  osal_uint32_t order_errors;
+} thread_param_t;
+
+void *producer(void *arg) {
+  thread_param_t *params = (thread_param_t *)arg;
+
+  for (osal_uint32_t i = 0; i < NUM_MESSAGES_PER_PRODUCER; i++) {
+    message_t msg = {params->id, i};
+    if (osal_mq_send(params->mq, (const osal_char_t *)&msg, sizeof(msg), 0) !=
+        OSAL_OK) {
+      return (void *)1;
+    }
+  }
+
+  return nullptr;
+}
+
+void *consumer(void *arg) {
+  thread_param_t *params = (thread_param_t *)arg;
+
+  for (;;) {
+    message_t msg;
+    osal_timer_t deadline;
+    osal_timer_init(&deadline, 200000000);
+    if (osal_mq_timedreceive(params->mq, (osal_char_t *)&msg, sizeof(msg),
+                             nullptr, &deadline) != OSAL_OK) {
+      break;
+    }
+
+    // per producer, every consumer has to see increasing sequence numbers
+    if ((params->last_seq[msg.producer] != 0xFFFFFFFFu) &&
+        (msg.seq <= params->last_seq[msg.producer])) {
+      params->order_errors++;
+    }
+    params->last_seq[msg.producer] = msg.seq;
+    params->received++;
+  }
+
+  return nullptr;
+}
+
+TEST(MessageQueueUserspaceFunction, MultiWriterMultiReader) {
+  osal_mq_t mqueue;
+  osal_mq_attr_t attr = make_attr(64, sizeof(message_t));
+
+  shm_unlink(QUEUE_NAME);
+  ASSERT_EQ(osal_mq_open(&mqueue, QUEUE_NAME, &attr), OSAL_OK);
+
+  thread_param_t prod[N_PRODUCERS];
+  thread_param_t cons[M_CONSUMERS];
+  pthread_t prod_threads[N_PRODUCERS];
+  pthread_t cons_threads[M_CONSUMERS];
+
+  for (osal_uint32_t i = 0; i < M_CONSUMERS; i++) {
+    cons[i].mq = &mqueue;
+    cons[i].id = i;
+    cons[i].received = 0;
+    cons[i].last_seq.assign(N_PRODUCERS, 0xFFFFFFFFu);
+    cons[i].order_errors = 0;
+    ASSERT_EQ(pthread_create(&cons_threads[i], nullptr, consumer, &cons[i]), 0);
+  }
+  for (osal_uint32_t i = 0; i < N_PRODUCERS; i++) {
+    prod[i].mq = &mqueue;
+    prod[i].id = i;
+    ASSERT_EQ(pthread_create(&prod_threads[i], nullptr, producer, &prod[i]), 0);
+  }
+
+  for (osal_uint32_t i = 0; i < N_PRODUCERS; i++) {
+    void *thread_ret;
+    pthread_join(prod_threads[i], &thread_ret);
+    EXPECT_EQ(thread_ret, nullptr) << "producer failed";
+  }
+
+  osal_uint32_t total = 0;
+  for (osal_uint32_t i = 0; i < M_CONSUMERS; i++) {
+    pthread_join(cons_threads[i], nullptr);
+    total += cons[i].received;
+    EXPECT_EQ(cons[i].order_errors, 0u) << "messages reordered";
+  }
+
+  EXPECT_EQ(total, N_PRODUCERS * NUM_MESSAGES_PER_PRODUCER)
+      << "messages lost or duplicated";
+
+  EXPECT_EQ(osal_mq_close(&mqueue), OSAL_OK);
+  shm_unlink(QUEUE_NAME);
+}
+
+} // namespace multiwriter_multireader
+
+TEST(MessageQueueUserspaceFunction, InterProcess) {
+  osal_mq_t mqueue;
+  osal_mq_attr_t attr = make_attr(4, sizeof(osal_uint32_t));
+  const osal_uint32_t num_messages = 10000;
+
+  shm_unlink(QUEUE_NAME);
+  ASSERT_EQ(osal_mq_open(&mqueue, QUEUE_NAME, &attr), OSAL_OK);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    osal_mq_t child_queue;
+    osal_mq_attr_t child_attr = {};
+    child_attr.oflags =
+        OSAL_MQ_ATTR__OFLAG__WRONLY | OSAL_MQ_ATTR__OFLAG__USERSPACE;
+    if (osal_mq_open(&child_queue, QUEUE_NAME, &child_attr) != OSAL_OK) {
+      exit(1);
+    }
+    for (osal_uint32_t i = 0; i < num_messages; i++) {
+      if (osal_mq_send(&child_queue, (const osal_char_t *)&i, sizeof(i), 0) !=
+          OSAL_OK) {
+        exit(2);
+      }
+    }
+    osal_mq_close(&child_queue);
+    exit(0);
+  }
+
+  osal_uint32_t errors = 0;
+  for (osal_uint32_t i = 0; i < num_messages; i++) {
+    osal_uint32_t val;
+    osal_timer_t deadline;
+    osal_timer_init(&deadline, 5000000000);
+    ASSERT_EQ(osal_mq_timedreceive(&mqueue, (osal_char_t *)&val, sizeof(val),
+                                   nullptr, &deadline),
+              OSAL_OK);
+    if (val != i) {
+      errors++;
+    }
+  }
+
+  int status = -1;
+  waitpid(pid, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status) && (WEXITSTATUS(status) == 0))
+      << "sender process failed";
+  EXPECT_EQ(errors, 0u) << "messages lost or out of order";
+
+  EXPECT_EQ(osal_mq_close(&mqueue), OSAL_OK);
+  shm_unlink(QUEUE_NAME);
+}
+
+} // namespace test_messagequeue_userspace
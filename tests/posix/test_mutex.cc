@@ -5,6 +5,7 @@
 
 #include "libosal/mutex.h"
 #include "libosal/osal.h"
+#include "libosal/timer.h"
 #include "test_utils.h"
 
 namespace test_mutex {
@@ -401,6 +402,162 @@ TEST(MutexFunction, TestRecursive) {
   EXPECT_EQ(orv, 0) << "Could not destroy mutex";
 }
 
+TEST(MutexFunction, AdaptiveMultiThreading) {
+  const ulong N_THREADS = 8;
+  const uint LOOPCOUNT = 100000;
+
+  pthread_t thread_ids[N_THREADS];
+  thread_param_t thread_params[N_THREADS];
+  osal_mutex_t count_mutex;
+  osal_mutex_attr_t attr = OSAL_MUTEX_ATTR__TYPE__ADAPTIVE;
+  unsigned long counter = 0;
+
+  ASSERT_EQ(osal_mutex_init(&count_mutex, &attr), OSAL_OK);
+
+  for (ulong i = 0; i < N_THREADS; i++) {
+    thread_params[i].thread_id = i;
+    thread_params[i].p_count_mutex = &count_mutex;
+    thread_params[i].p_counter = &counter;
+    thread_params[i].loopcount = LOOPCOUNT;
+    thread_params[i].max_wait_time_nsec = 0;
+
+    ASSERT_EQ(pthread_create(&(thread_ids[i]), nullptr, test_random,
+                             (void *)&(thread_params[i])),
+              0);
+  }
+  for (ulong i = 0; i < N_THREADS; i++) {
+    ASSERT_EQ(pthread_join(thread_ids[i], nullptr), 0);
+  }
+
+  EXPECT_LE(count_mutex.spins, count_mutex.spin_max)
+      << "spin count has to stay bounded";
+  EXPECT_EQ(osal_mutex_destroy(&count_mutex), OSAL_OK);
+
+  EXPECT_EQ(counter, N_THREADS * LOOPCOUNT)
+      << "multi-threaded counter test failed";
+}
+
+TEST(MutexFunction, AdaptiveAttributes) {
+  const osal_mutex_attr_t attrs[] = {
+      OSAL_MUTEX_ATTR__TYPE__ADAPTIVE | OSAL_MUTEX_ATTR__ROBUST,
+      OSAL_MUTEX_ATTR__TYPE__ADAPTIVE | OSAL_MUTEX_ATTR__PROCESS_SHARED,
+      OSAL_MUTEX_ATTR__TYPE__ADAPTIVE | OSAL_MUTEX_ATTR__PROTOCOL__INHERIT,
+      OSAL_MUTEX_ATTR__TYPE__ADAPTIVE | OSAL_MUTEX_ATTR__ROBUST |
+          OSAL_MUTEX_ATTR__PROCESS_SHARED | OSAL_MUTEX_ATTR__PROTOCOL__INHERIT,
+  };
+
+  for (osal_mutex_attr_t attr : attrs) {
+    osal_mutex_t my_mutex;
+
+    ASSERT_EQ(osal_mutex_init(&my_mutex, &attr), OSAL_OK)
+        << "attributes 0x" << std::hex << attr;
+    EXPECT_EQ(osal_mutex_lock(&my_mutex), OSAL_OK);
+    EXPECT_EQ(osal_mutex_trylock(&my_mutex), OSAL_ERR_BUSY);
+    EXPECT_EQ(osal_mutex_unlock(&my_mutex), OSAL_OK);
+
+    if ((attr & OSAL_MUTEX_ATTR__ROBUST) != 0u) {
+      EXPECT_EQ(osal_mutex_consistent(&my_mutex), OSAL_ERR_INVALID_PARAM)
+          << "mutex is not inconsistent";
+
+      pthread_t thread_id;
+      ASSERT_EQ(pthread_create(&thread_id, nullptr, lock_thread,
+                               (void *)&(my_mutex)),
+                0);
+      ASSERT_EQ(pthread_join(thread_id, nullptr), 0);
+
+      EXPECT_EQ(osal_mutex_lock(&my_mutex), OSAL_ERR_OWNER_DEAD)
+          << "adaptive mutex has to detect dead owner";
+
+      // take the mutex off the robust list of this thread before its
+      // stack memory is reused
+      EXPECT_EQ(osal_mutex_consistent(&my_mutex), OSAL_OK);
+      EXPECT_EQ(osal_mutex_unlock(&my_mutex), OSAL_OK);
+    }
+
+    EXPECT_EQ(osal_mutex_destroy(&my_mutex), OSAL_OK);
+  }
+}
+
+typedef struct {
+  osal_mutex_t *p_mutex;
+  osal_uint64_t timeout;
+  osal_retval_t result;
+  osal_uint64_t waited;
+} timedlock_param_t;
+
+void *timedlock_thread(void *p_params) {
+  timedlock_param_t *params = (timedlock_param_t *)p_params;
+  osal_timer_t to;
+
+  osal_uint64_t start = osal_timer_gettime_nsec();
+  osal_timer_init(&to, params->timeout);
+  params->result = osal_mutex_timedlock(params->p_mutex, &to);
+  params->waited = osal_timer_gettime_nsec() - start;
+
+  if (params->result == OSAL_OK) {
+    osal_mutex_unlock(params->p_mutex);
+  }
+
+  return nullptr;
+}
+
+static void check_timedlock(osal_mutex_attr_t attr) {
+  const osal_uint64_t TIMEOUT = 20000000; // 20 ms
+  osal_mutex_t my_mutex;
+  pthread_t thread_id;
+  timedlock_param_t params = {};
+
+  ASSERT_EQ(osal_mutex_init(&my_mutex, &attr), OSAL_OK);
+  params.p_mutex = &my_mutex;
+
+  // free mutex is taken immediately, also with a timeout in the past
+  osal_timer_t to = {};
+  EXPECT_EQ(osal_mutex_timedlock(&my_mutex, &to), OSAL_OK);
+  EXPECT_EQ(osal_mutex_unlock(&my_mutex), OSAL_OK);
+
+  // locked mutex times out
+  ASSERT_EQ(osal_mutex_lock(&my_mutex), OSAL_OK);
+  params.timeout = TIMEOUT;
+  ASSERT_EQ(pthread_create(&thread_id, nullptr, timedlock_thread, &params), 0);
+  ASSERT_EQ(pthread_join(thread_id, nullptr), 0);
+  EXPECT_EQ(params.result, OSAL_ERR_TIMEOUT);
+  EXPECT_GE(params.waited, TIMEOUT) << "returned before timeout";
+
+  // mutex unlocked before timeout
+  params.timeout = 50 * TIMEOUT;
+  ASSERT_EQ(pthread_create(&thread_id, nullptr, timedlock_thread, &params), 0);
+  osal_sleep(TIMEOUT / 2);
+  EXPECT_EQ(osal_mutex_unlock(&my_mutex), OSAL_OK);
+  ASSERT_EQ(pthread_join(thread_id, nullptr), 0);
+  EXPECT_EQ(params.result, OSAL_OK);
+  EXPECT_LT(params.waited, params.timeout);
+
+  EXPECT_EQ(osal_mutex_destroy(&my_mutex), OSAL_OK);
+}
+
+TEST(MutexFunction, TimedLock) {
+  const osal_mutex_attr_t attrs[] = {
+      OSAL_MUTEX_ATTR__TYPE__NORMAL,
+      OSAL_MUTEX_ATTR__TYPE__ADAPTIVE,
+      OSAL_MUTEX_ATTR__TYPE__ERRORCHECK | OSAL_MUTEX_ATTR__ROBUST,
+      OSAL_MUTEX_ATTR__TYPE__ADAPTIVE | OSAL_MUTEX_ATTR__PROTOCOL__INHERIT,
+  };
+  const int old_clock = osal_timer_get_clock_source();
+  const int clocks[] = {CLOCK_REALTIME, CLOCK_MONOTONIC};
+
+  for (int clock : clocks) {
+    osal_timer_set_clock_source(clock);
+
+    for (osal_mutex_attr_t attr : attrs) {
+      SCOPED_TRACE(testing::Message() << "clock " << clock << " attributes 0x"
+                                      << std::hex << attr);
+      check_timedlock(attr);
+    }
+  }
+
+  osal_timer_set_clock_source(old_clock);
+}
+
 } // namespace test_mutex
 
 int main(int argc, char **argv) {
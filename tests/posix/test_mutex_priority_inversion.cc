@@ -225,7 +225,8 @@ TEST(MutexFunction, TestNoPriorityInheritance) {
 
   osal_mutex_attr_t attr = OSAL_MUTEX_ATTR__ROBUST;
 
-  osal_task_attr_t task_attr = {};
+  osal_task_attr_t task_attr;
+  osal_task_attr_init(&task_attr);
   task_attr.policy = OSAL_SCHED_POLICY_FIFO;
   task_attr.priority = 0;
   task_attr.affinity = 1;
@@ -306,7 +307,8 @@ TEST(MutexFunction, TestPriorityInheritance) {
 
   osal_mutex_attr_t attr = OSAL_MUTEX_ATTR__PROTOCOL__INHERIT;
 
-  osal_task_attr_t task_attr = {};
+  osal_task_attr_t task_attr;
+  osal_task_attr_init(&task_attr);
   task_attr.policy = OSAL_SCHED_POLICY_FIFO;
   task_attr.priority = 0;
   task_attr.affinity = 1;
@@ -380,7 +382,8 @@ TEST(MutexFunc, TestPriorityCeiling) {
   osal_mutex_attr_t attr = (OSAL_MUTEX_ATTR__PROTOCOL__PROTECT |
                             (3 << OSAL_MUTEX_ATTR__PRIOCEILING__SHIFT));
 
-  osal_task_attr_t task_attr = {};
+  osal_task_attr_t task_attr;
+  osal_task_attr_init(&task_attr);
   task_attr.policy = OSAL_SCHED_POLICY_FIFO;
   task_attr.priority = 0;
   task_attr.affinity = 1;
@@ -0,0 +1,322 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <vector>
+
+#include "libosal/osal.h"
+#include "libosal/periodic_task.h"
+#include "libosal/timer.h"
+#include "libosal/trace.h"
+#include "test_utils.h"
+
+namespace test_periodic_task {
+
+const osal_uint64_t PERIOD = 1000000; // 1 ms
+
+typedef struct {
+  osal_uint32_t cycles;       // stop after this many handler calls
+  osal_uint32_t slow_every;   // every n-th cycle takes slow_nsec, 0 for never
+  osal_uint64_t slow_nsec;
+  std::vector<osal_uint64_t> starts;
+  osal_uint64_t overrun_missed;
+  osal_uint32_t overrun_calls;
+} cycle_param_t;
+
+static void init_attr(osal_periodic_task_attr_t *attr) {
+  *attr = {};
+  osal_task_attr_init(&attr->task_attr);
+  attr->period = PERIOD;
+}
+
+static osal_retval_t cycle_handler(osal_void_t *arg) {
+  cycle_param_t *params = (cycle_param_t *)arg;
+  osal_uint64_t now = osal_timer_gettime_nsec();
+
+  params->starts.push_back(now);
+  if ((params->slow_every != 0) &&
+      ((params->starts.size() % params->slow_every) == 0)) {
+    osal_busy_wait_until_nsec(now + params->slow_nsec);
+  }
+
+  return params->starts.size() < params->cycles ? OSAL_OK : OSAL_ERR_NO_DATA;
+}
+
+static osal_retval_t overrun_handler(osal_void_t *arg, osal_uint64_t missed) {
+  cycle_param_t *params = (cycle_param_t *)arg;
+
+  params->overrun_missed += missed;
+  params->overrun_calls++;
+
+  return OSAL_ERR_TIMEOUT;
+}
+
+TEST(PeriodicTaskFunction, CyclesAndTraces) {
+  osal_trace_t *latency;
+  osal_trace_t *exec;
+  ASSERT_EQ(osal_trace_alloc(&latency, 1024), OSAL_OK);
+  ASSERT_EQ(osal_trace_alloc(&exec, 1024), OSAL_OK);
+
+  osal_periodic_task_attr_t attr;
+  init_attr(&attr);
+  attr.phase = PERIOD / 4;
+  attr.latency_trace = latency;
+  attr.exec_trace = exec;
+
+  cycle_param_t params = {};
+  params.cycles = 100;
+
+  osal_periodic_task_t task;
+  ASSERT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_OK);
+  EXPECT_EQ(osal_periodic_task_join(&task), OSAL_ERR_NO_DATA)
+      << "task has to end with handler return value";
+
+  osal_periodic_task_stats_t stats;
+  osal_periodic_task_get_stats(&task, &stats);
+  EXPECT_EQ(stats.cycles, 100u);
+  ASSERT_EQ(params.starts.size(), 100u);
+
+  osal_trace_histogram_t *hist = new osal_trace_histogram_t;
+  osal_trace_get_histogram(latency, hist);
+  EXPECT_EQ(hist->cnt, 100u);
+  EXPECT_EQ(hist->max, stats.max_latency);
+  osal_trace_get_histogram(exec, hist);
+  EXPECT_EQ(hist->cnt, 100u);
+  EXPECT_EQ(hist->max, stats.max_exec);
+  delete hist;
+
+  // handler starts right after the release on the phase shifted grid
+  std::vector<osal_uint64_t> offsets;
+  for (osal_uint64_t start : params.starts) {
+    offsets.push_back((start - attr.phase) % PERIOD);
+  }
+  std::sort(offsets.begin(), offsets.end());
+  EXPECT_LT(offsets[offsets.size() / 2], PERIOD / 2)
+      << "releases are not aligned to period + phase";
+
+  osal_trace_free(latency);
+  osal_trace_free(exec);
+}
+
+TEST(PeriodicTaskFunction, Stop) {
+  osal_periodic_task_attr_t attr;
+  init_attr(&attr);
+
+  cycle_param_t params = {};
+  params.cycles = 0xFFFFFFFF;
+
+  osal_periodic_task_t task;
+  ASSERT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_OK);
+  osal_sleep_until_nsec(osal_timer_gettime_nsec() + 20 * PERIOD);
+  EXPECT_EQ(osal_periodic_task_stop(&task), OSAL_OK);
+
+  osal_periodic_task_stats_t stats;
+  osal_periodic_task_get_stats(&task, &stats);
+  EXPECT_GT(stats.cycles, 0u);
+  EXPECT_EQ(stats.cycles, params.starts.size());
+}
+
+TEST(PeriodicTaskFunction, NoCycleAfterStop) {
+  osal_periodic_task_attr_t attr;
+  init_attr(&attr);
+  attr.period = 100 * PERIOD;
+
+  cycle_param_t params = {};
+  params.cycles = 0xFFFFFFFF;
+
+  osal_periodic_task_t task;
+  ASSERT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_OK);
+
+  // stop while the task sleeps for its next release
+  osal_periodic_task_stats_t stats = {};
+  while (stats.cycles == 0u) {
+    osal_sleep_until_nsec(osal_timer_gettime_nsec() + PERIOD);
+    osal_periodic_task_get_stats(&task, &stats);
+  }
+  osal_uint64_t stop_time = osal_timer_gettime_nsec();
+  EXPECT_EQ(osal_periodic_task_stop(&task), OSAL_OK);
+
+  EXPECT_EQ(std::count_if(params.starts.begin(), params.starts.end(),
+                          [stop_time](osal_uint64_t start) {
+                            return start >= stop_time;
+                          }),
+            0)
+      << "handler must not be called after stop";
+}
+
+TEST(PeriodicTaskFunction, StopInterruptsSleep) {
+  osal_periodic_task_attr_t attr;
+  init_attr(&attr);
+  attr.period = 10000 * PERIOD;
+
+  // first release about 5 s from now
+  osal_uint64_t release = osal_timer_gettime_nsec() + 5000 * PERIOD;
+  attr.phase = release % attr.period;
+
+  cycle_param_t params = {};
+  params.cycles = 0xFFFFFFFF;
+
+  osal_periodic_task_t task;
+  ASSERT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_OK);
+  osal_sleep_until_nsec(osal_timer_gettime_nsec() + 10 * PERIOD);
+  EXPECT_EQ(osal_periodic_task_stop(&task), OSAL_OK);
+
+  EXPECT_LT(osal_timer_gettime_nsec(), release)
+      << "stop has to wake the task instead of waiting for the release";
+  EXPECT_EQ(params.starts.size(), 0u);
+}
+
+TEST(PeriodicTaskFunction, OverrunSkip) {
+  osal_periodic_task_attr_t attr;
+  init_attr(&attr);
+  attr.overrun_policy = OSAL_PERIODIC_TASK_OVERRUN__SKIP;
+
+  cycle_param_t params = {};
+  params.cycles = 20;
+  params.slow_every = 5;
+  params.slow_nsec = 2 * PERIOD + PERIOD / 2;
+
+  osal_periodic_task_t task;
+  ASSERT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_OK);
+  EXPECT_EQ(osal_periodic_task_join(&task), OSAL_ERR_NO_DATA);
+
+  osal_periodic_task_stats_t stats;
+  osal_periodic_task_get_stats(&task, &stats);
+  EXPECT_GE(stats.overruns, 3u) << "slow cycles have to be detected";
+  EXPECT_GE(stats.missed, 2 * stats.overruns)
+      << "each slow cycle spans at least 2 releases";
+
+  // skipped releases do not pile up, handler never runs back to back
+  for (size_t i = 1; i < params.starts.size(); i++) {
+    EXPECT_GT(params.starts[i] - params.starts[i - 1], PERIOD / 4);
+  }
+}
+
+TEST(PeriodicTaskFunction, OverrunCatchUp) {
+  osal_periodic_task_attr_t attr;
+  init_attr(&attr);
+  attr.overrun_policy = OSAL_PERIODIC_TASK_OVERRUN__CATCH_UP;
+
+  cycle_param_t params = {};
+  params.cycles = 12;
+  params.slow_every = 3;
+  params.slow_nsec = 5 * PERIOD;
+
+  osal_periodic_task_t task;
+  ASSERT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_OK);
+  EXPECT_EQ(osal_periodic_task_join(&task), OSAL_ERR_NO_DATA);
+
+  osal_periodic_task_stats_t stats;
+  osal_periodic_task_get_stats(&task, &stats);
+  EXPECT_GE(stats.overruns, 1u);
+  EXPECT_EQ(stats.missed, 0u) << "catch-up must not drop releases";
+
+  // after the first slow cycle the missed releases run back to back
+  ASSERT_GE(params.starts.size(), 4u);
+  EXPECT_LT(params.starts[3] - params.starts[2] - params.slow_nsec, PERIOD / 2);
+}
+
+TEST(PeriodicTaskFunction, OverrunSignal) {
+  osal_periodic_task_attr_t attr;
+  init_attr(&attr);
+  attr.overrun_policy = OSAL_PERIODIC_TASK_OVERRUN__SIGNAL;
+  attr.overrun_handler = overrun_handler;
+
+  cycle_param_t params = {};
+  params.cycles = 100;
+  params.slow_every = 4;
+  params.slow_nsec = 3 * PERIOD;
+
+  osal_periodic_task_t task;
+  ASSERT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_OK);
+  EXPECT_EQ(osal_periodic_task_join(&task), OSAL_ERR_TIMEOUT)
+      << "overrun handler return value has to stop the task";
+
+  EXPECT_EQ(params.overrun_calls, 1u);
+  EXPECT_GE(params.overrun_missed, 1u);
+  EXPECT_LE(params.starts.size(), 4u);
+}
+
+TEST(PeriodicTaskFunction, BusyWaitTail) {
+  osal_trace_t *latency;
+  ASSERT_EQ(osal_trace_alloc(&latency, 1024), OSAL_OK);
+
+  osal_periodic_task_attr_t attr;
+  init_attr(&attr);
+  attr.busy_wait = PERIOD / 5;
+  attr.latency_trace = latency;
+
+  cycle_param_t params = {};
+  params.cycles = 50;
+
+  osal_periodic_task_t task;
+  ASSERT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_OK);
+  EXPECT_EQ(osal_periodic_task_join(&task), OSAL_ERR_NO_DATA);
+
+  const osal_uint32_t ppm = OSAL_TRACE_P50;
+  osal_uint64_t p50 = 0;
+  EXPECT_EQ(osal_trace_get_percentiles(latency, &ppm, &p50, 1), OSAL_OK);
+  printf("wakeup latency with busy-wait tail: p50 %lu ns\n",
+         (unsigned long)p50);
+
+  osal_trace_free(latency);
+}
+
+TEST(PeriodicTaskReject, InvalidParams) {
+  osal_periodic_task_t task;
+  osal_periodic_task_attr_t attr;
+  cycle_param_t params = {};
+
+  init_attr(&attr);
+  attr.period = 0;
+  EXPECT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_ERR_INVALID_PARAM)
+      << "zero period";
+
+  init_attr(&attr);
+  attr.busy_wait = PERIOD;
+  EXPECT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_ERR_INVALID_PARAM)
+      << "busy-wait has to be shorter than period";
+
+  init_attr(&attr);
+  attr.overrun_policy = OSAL_PERIODIC_TASK_OVERRUN__SIGNAL + 1;
+  EXPECT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_ERR_INVALID_PARAM)
+      << "unknown overrun policy";
+
+  init_attr(&attr);
+  attr.overrun_policy = OSAL_PERIODIC_TASK_OVERRUN__SIGNAL;
+  EXPECT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_ERR_INVALID_PARAM)
+      << "signal policy needs overrun handler";
+
+  osal_trace_t *trace;
+  ASSERT_EQ(osal_trace_alloc_mp(&trace, 1, 16), OSAL_OK);
+  init_attr(&attr);
+  attr.latency_trace = trace;
+  EXPECT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_ERR_INVALID_PARAM)
+      << "multi producer latency trace";
+
+  init_attr(&attr);
+  attr.exec_trace = trace;
+  EXPECT_EQ(osal_periodic_task_create(&task, &attr, cycle_handler, &params),
+            OSAL_ERR_INVALID_PARAM)
+      << "multi producer execution time trace";
+  osal_trace_free(trace);
+}
+
+} // namespace test_periodic_task
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,289 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "libosal/osal.h"
+#include "libosal/pool.h"
+#include "libosal/shm.h"
+
+namespace test_pool {
+
+const osal_uint32_t BLOCK_CNT = 64;
+const osal_uint32_t LOOPCOUNT = 100000;
+
+const char *SHM_NAME = "/pool_test";
+
+typedef struct {
+  osal_uint64_t owner;
+  osal_uint64_t payload[5];
+} block_t;
+
+TEST(PoolFunction, AllocFree) {
+  const osal_pool_attr_t attr = OSAL_POOL_ATTR__STATS | OSAL_POOL_ATTR__PREFAULT;
+  osal_pool_t pool;
+  ASSERT_EQ(osal_pool_create(&pool, sizeof(block_t), BLOCK_CNT, &attr),
+            OSAL_OK);
+
+  std::set<osal_void_t *> blocks;
+  for (osal_uint32_t i = 0; i < BLOCK_CNT; i++) {
+    osal_void_t *block;
+    ASSERT_EQ(osal_pool_alloc(&pool, &block), OSAL_OK);
+    EXPECT_EQ((uintptr_t)block % 8, 0u) << "blocks have to be 8-byte aligned";
+    memset(block, 0xA5, sizeof(block_t));
+    blocks.insert(block);
+  }
+  EXPECT_EQ(blocks.size(), (size_t)BLOCK_CNT) << "block handed out twice";
+
+  osal_void_t *block;
+  EXPECT_EQ(osal_pool_alloc(&pool, &block), OSAL_ERR_OUT_OF_MEMORY);
+
+  osal_pool_stats_t stats;
+  ASSERT_EQ(osal_pool_get_stats(&pool, &stats), OSAL_OK);
+  EXPECT_EQ(stats.block_cnt, BLOCK_CNT);
+  EXPECT_GE(stats.block_size, sizeof(block_t));
+  EXPECT_EQ(stats.used, BLOCK_CNT);
+  EXPECT_EQ(stats.high_water, BLOCK_CNT);
+  EXPECT_EQ(stats.failed, 1u);
+
+  for (osal_void_t *b : blocks) {
+    EXPECT_EQ(osal_pool_free(&pool, b), OSAL_OK);
+  }
+
+  ASSERT_EQ(osal_pool_get_stats(&pool, &stats), OSAL_OK);
+  EXPECT_EQ(stats.used, 0u);
+  EXPECT_EQ(stats.high_water, BLOCK_CNT) << "high-water mark has to stay";
+
+  EXPECT_EQ(osal_pool_alloc(&pool, &block), OSAL_OK);
+  EXPECT_EQ(osal_pool_free(&pool, block), OSAL_OK);
+  EXPECT_EQ(osal_pool_destroy(&pool), OSAL_OK);
+}
+
+TEST(PoolFunction, Cache) {
+  const osal_pool_attr_t attr = OSAL_POOL_ATTR__STATS;
+  osal_pool_t pool;
+  ASSERT_EQ(osal_pool_create(&pool, sizeof(block_t), BLOCK_CNT, &attr),
+            OSAL_OK);
+
+  osal_pool_cache_t cache;
+  ASSERT_EQ(osal_pool_cache_init(&cache, &pool), OSAL_OK);
+
+  // all blocks can be allocated through the cache
+  std::vector<osal_void_t *> blocks;
+  osal_void_t *block;
+  while (osal_pool_cache_alloc(&cache, &block) == OSAL_OK) {
+    blocks.push_back(block);
+  }
+  EXPECT_EQ(blocks.size(), (size_t)BLOCK_CNT);
+
+  for (osal_void_t *b : blocks) {
+    EXPECT_EQ(osal_pool_cache_free(&cache, b), OSAL_OK);
+  }
+
+  osal_pool_stats_t stats;
+  ASSERT_EQ(osal_pool_get_stats(&pool, &stats), OSAL_OK);
+  EXPECT_GT(stats.used, 0u) << "cached blocks count as used";
+  EXPECT_LE(stats.used, OSAL_POOL_CACHE_SIZE);
+
+  EXPECT_EQ(osal_pool_cache_flush(&cache), OSAL_OK);
+  ASSERT_EQ(osal_pool_get_stats(&pool, &stats), OSAL_OK);
+  EXPECT_EQ(stats.used, 0u);
+
+  // after flushing every block is in the pool again
+  blocks.clear();
+  while (osal_pool_alloc(&pool, &block) == OSAL_OK) {
+    blocks.push_back(block);
+  }
+  EXPECT_EQ(blocks.size(), (size_t)BLOCK_CNT);
+
+  osal_pool_destroy(&pool);
+}
+
+TEST(PoolFunction, MultiThreading) {
+  const int THREADS = 4;
+  const osal_pool_attr_t attr = OSAL_POOL_ATTR__STATS;
+  osal_pool_t pool;
+  ASSERT_EQ(osal_pool_create(&pool, sizeof(block_t), BLOCK_CNT, &attr),
+            OSAL_OK);
+
+  osal_uint32_t errors = 0;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; t++) {
+    threads.emplace_back([&pool, &errors, t]() {
+      osal_pool_cache_t cache;
+      osal_pool_cache_init(&cache, &pool);
+      std::vector<block_t *> held;
+
+      for (osal_uint32_t i = 0; i < LOOPCOUNT; i++) {
+        osal_void_t *block;
+        osal_retval_t ret = (t % 2) == 0 ? osal_pool_alloc(&pool, &block)
+                                         : osal_pool_cache_alloc(&cache, &block);
+        if (ret == OSAL_OK) {
+          ((block_t *)block)->owner = (osal_uint64_t)t + 1;
+          held.push_back((block_t *)block);
+        }
+
+        // keep a few blocks, check nobody else got them meanwhile
+        if ((held.size() > 4) || ((ret != OSAL_OK) && !held.empty())) {
+          block_t *b = held.front();
+          held.erase(held.begin());
+          if (b->owner != (osal_uint64_t)t + 1) {
+            __atomic_fetch_add(&errors, 1, __ATOMIC_RELAXED);
+          }
+          if ((t % 2) == 0) {
+            osal_pool_free(&pool, b);
+          } else {
+            osal_pool_cache_free(&cache, b);
+          }
+        }
+      }
+
+      for (block_t *b : held) {
+        if ((t % 2) == 0) {
+          osal_pool_free(&pool, b);
+        } else {
+          osal_pool_cache_free(&cache, b);
+        }
+      }
+      osal_pool_cache_flush(&cache);
+    });
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(errors, 0u) << "block was handed out twice";
+
+  osal_pool_stats_t stats;
+  ASSERT_EQ(osal_pool_get_stats(&pool, &stats), OSAL_OK);
+  EXPECT_EQ(stats.used, 0u) << "blocks were lost";
+
+  osal_pool_destroy(&pool);
+}
+
+TEST(PoolFunction, ProcessShared) {
+  osal_size_t size = osal_pool_get_size(sizeof(block_t), BLOCK_CNT);
+  osal_shm_t shm;
+  osal_shm_attr_t attr =
+      (OSAL_SHM_ATTR__FLAG__RDWR | OSAL_SHM_ATTR__FLAG__CREAT |
+       (S_IRWXU << OSAL_SHM_ATTR__MODE__SHIFT));
+  shm_unlink(SHM_NAME);
+  ASSERT_EQ(osal_shm_open(&shm, SHM_NAME, &attr, size), OSAL_OK);
+
+  osal_void_t *mem;
+  osal_shm_map_attr_t map_attr =
+      (OSAL_SHM_MAP_ATTR__PROT_READ | OSAL_SHM_MAP_ATTR__PROT_WRITE |
+       OSAL_SHM_MAP_ATTR__SHARED);
+  ASSERT_EQ(osal_shm_map(&shm, &map_attr, &mem), OSAL_OK);
+
+  osal_pool_t pool;
+  const osal_pool_attr_t pool_attr = OSAL_POOL_ATTR__STATS;
+  ASSERT_EQ(osal_pool_init(&pool, mem, size, sizeof(block_t), BLOCK_CNT,
+                           &pool_attr),
+            OSAL_OK);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    osal_pool_t child_pool;
+    if (osal_pool_attach(&child_pool, mem, size) != OSAL_OK) {
+      exit(1);
+    }
+    for (osal_uint32_t i = 0; i < LOOPCOUNT; i++) {
+      osal_void_t *block;
+      if (osal_pool_alloc(&child_pool, &block) == OSAL_OK) {
+        ((block_t *)block)->owner = 2;
+        sched_yield();
+        if (((block_t *)block)->owner != 2) {
+          exit(2);
+        }
+        osal_pool_free(&child_pool, block);
+      }
+    }
+    exit(0);
+  }
+
+  osal_uint32_t errors = 0;
+  for (osal_uint32_t i = 0; i < LOOPCOUNT; i++) {
+    osal_void_t *block;
+    if (osal_pool_alloc(&pool, &block) == OSAL_OK) {
+      ((block_t *)block)->owner = 1;
+      if ((i % 16) == 0) {
+        sched_yield();
+      }
+      if (((block_t *)block)->owner != 1) {
+        errors++;
+      }
+      osal_pool_free(&pool, block);
+    }
+  }
+
+  int status = -1;
+  waitpid(pid, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status) && (WEXITSTATUS(status) == 0))
+      << "child process failed";
+  EXPECT_EQ(errors, 0u) << "block was handed out twice";
+
+  osal_pool_stats_t stats;
+  ASSERT_EQ(osal_pool_get_stats(&pool, &stats), OSAL_OK);
+  EXPECT_EQ(stats.used, 0u);
+
+  osal_shm_close(&shm);
+  shm_unlink(SHM_NAME);
+}
+
+TEST(PoolReject, InvalidParams) {
+  std::vector<osal_uint8_t> mem(256);
+  osal_pool_t pool;
+
+  EXPECT_EQ(osal_pool_get_size(0, BLOCK_CNT), 0u);
+  EXPECT_EQ(osal_pool_get_size(sizeof(block_t), 0), 0u);
+
+  // largest pool must not wrap around, 0 if it does not fit into size_t
+  osal_size_t max_size = osal_pool_get_size(0xFFFFFFF8u, 0xFFFFFFFEu);
+  if (max_size != 0u) {
+    EXPECT_GT(max_size, (osal_size_t)0xFFFFFFF8u * 0xFFFFFFFEu);
+  }
+  EXPECT_EQ(osal_pool_init(&pool, mem.data(), mem.size(), 0xFFFFFFF8u,
+                           0xFFFFFFFEu, nullptr),
+            OSAL_ERR_INVALID_PARAM)
+      << "size overflow";
+  EXPECT_EQ(osal_pool_init(&pool, mem.data(), mem.size(), sizeof(block_t),
+                           BLOCK_CNT, nullptr),
+            OSAL_ERR_INVALID_PARAM)
+      << "region too small";
+
+  std::vector<osal_uint8_t> empty(4096);
+  EXPECT_EQ(osal_pool_attach(&pool, empty.data(), empty.size()),
+            OSAL_ERR_UNAVAILABLE);
+
+  ASSERT_EQ(osal_pool_create(&pool, sizeof(block_t), BLOCK_CNT, nullptr),
+            OSAL_OK);
+  osal_void_t *block;
+  ASSERT_EQ(osal_pool_alloc(&pool, &block), OSAL_OK);
+  EXPECT_EQ(osal_pool_free(&pool, (osal_uint8_t *)block + 1),
+            OSAL_ERR_INVALID_PARAM)
+      << "pointer into a block";
+  EXPECT_EQ(osal_pool_free(&pool, mem.data()), OSAL_ERR_INVALID_PARAM)
+      << "pointer outside of pool";
+
+  osal_pool_stats_t stats;
+  EXPECT_EQ(osal_pool_get_stats(&pool, &stats), OSAL_ERR_UNAVAILABLE)
+      << "statistics not enabled";
+
+  osal_pool_destroy(&pool);
+}
+
+} // namespace test_pool
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
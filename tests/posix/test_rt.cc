@@ -0,0 +1,208 @@
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "libosal/osal.h"
+#include "libosal/rt.h"
+
+namespace test_rt {
+
+const osal_size_t STACK_PREFAULT = 256 * 1024;
+const osal_size_t STACK_USE = 128 * 1024;
+
+// returns locked memory of this process in kB, -1 if unknown
+static long locked_kb() {
+  long ret = -1;
+  char line[256];
+  FILE *f = fopen("/proc/self/status", "r");
+
+  if (f != NULL) {
+    while (fgets(line, sizeof(line), f) != NULL) {
+      if (strncmp(line, "VmLck:", 6) == 0) {
+        ret = strtol(line + 6, NULL, 10);
+      }
+    }
+    fclose(f);
+  }
+
+  return ret;
+}
+
+// returns number of open file descriptors of this process
+static int open_fds() {
+  int ret = 0;
+  DIR *dir = opendir("/proc/self/fd");
+
+  if (dir != NULL) {
+    while (readdir(dir) != NULL) {
+      ret++;
+    }
+    closedir(dir);
+  }
+
+  return ret;
+}
+
+static long thread_minor_faults() {
+  struct rusage usage;
+  getrusage(RUSAGE_THREAD, &usage);
+  return usage.ru_minflt;
+}
+
+// uses depth * 4 KiB of stack
+static __attribute__((noinline)) int use_stack(int depth) {
+  volatile char frame[4096];
+  frame[0] = (char)depth;
+  frame[sizeof(frame) - 1] = (char)depth;
+
+  return depth > 0 ? use_stack(depth - 1) + frame[0] : frame[sizeof(frame) - 1];
+}
+
+TEST(RtFunction, PrefaultSteps) {
+  osal_rt_setup_attr_t attr = {};
+  attr.steps = OSAL_RT_SETUP__MALLOC_TUNING | OSAL_RT_SETUP__HEAP_PREFAULT |
+               OSAL_RT_SETUP__STACK_PREFAULT;
+  attr.heap_reserve = 4 * 1024 * 1024;
+  attr.stack_prefault = STACK_PREFAULT;
+
+  osal_rt_setup_result_t result;
+  EXPECT_EQ(osal_rt_setup(&attr, &result), OSAL_OK);
+  EXPECT_EQ(result.done, attr.steps);
+  EXPECT_EQ(result.failed, 0u);
+  EXPECT_EQ(result.denied, 0u);
+}
+
+TEST(RtFunction, HeapPrefaultTunesMalloc) {
+  osal_rt_setup_attr_t attr = {};
+  attr.steps = OSAL_RT_SETUP__HEAP_PREFAULT;
+  attr.heap_reserve = 4 * 1024 * 1024;
+
+  osal_rt_setup_result_t result;
+  EXPECT_EQ(osal_rt_setup(&attr, &result), OSAL_OK);
+  EXPECT_EQ(result.done,
+            OSAL_RT_SETUP__HEAP_PREFAULT | OSAL_RT_SETUP__MALLOC_TUNING)
+      << "heap prefault has to tune malloc to keep the reserve";
+}
+
+TEST(RtFunction, AllSteps) {
+  osal_rt_setup_result_t result;
+  osal_retval_t ret = osal_rt_setup(NULL, &result);
+
+  printf("rt setup: done 0x%x, failed 0x%x, denied 0x%x\n", result.done,
+         result.failed, result.denied);
+
+  EXPECT_EQ(result.done | result.failed, OSAL_RT_SETUP__ALL)
+      << "each step has to be reported";
+  EXPECT_EQ(result.done & result.failed, 0u);
+  EXPECT_EQ(result.denied & ~result.failed, 0u)
+      << "denied steps have to be failed steps";
+
+  if (result.denied != 0u) {
+    EXPECT_EQ(ret, OSAL_ERR_PERMISSION_DENIED);
+  } else if (result.failed != 0u) {
+    EXPECT_EQ(ret, OSAL_ERR_OPERATION_FAILED);
+  } else {
+    EXPECT_EQ(ret, OSAL_OK);
+  }
+
+  if ((result.done & OSAL_RT_SETUP__MLOCKALL) != 0u) {
+    EXPECT_GT(locked_kb(), 0) << "mlockall has to lock pages";
+  }
+
+  EXPECT_EQ(osal_rt_release(), OSAL_OK);
+  if ((result.done & OSAL_RT_SETUP__MLOCKALL) != 0u) {
+    EXPECT_EQ(locked_kb(), 0) << "release has to unlock pages";
+  }
+}
+
+TEST(RtFunction, ReleaseKeepsApplicationLocks) {
+  const size_t size = 64 * 1024;
+  void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(mem, MAP_FAILED);
+
+  if (mlock(mem, size) != 0) {
+    munmap(mem, size);
+    GTEST_SKIP() << "mlock not permitted";
+  }
+
+  // nothing locked by osal_rt_setup since the last release
+  EXPECT_EQ(osal_rt_release(), OSAL_OK);
+  EXPECT_GE(locked_kb(), (long)(size / 1024))
+      << "release must not unlock pages locked by the application";
+
+  munlock(mem, size);
+  munmap(mem, size);
+}
+
+TEST(RtFunction, ConcurrentSetupRelease) {
+  const int TASKS = 4;
+  const int LOOPS = 200;
+  std::vector<std::thread> tasks;
+  int fds = open_fds();
+
+  for (int i = 0; i < TASKS; i++) {
+    tasks.emplace_back([]() {
+      osal_rt_setup_attr_t attr = {};
+      attr.steps = OSAL_RT_SETUP__MALLOC_TUNING | OSAL_RT_SETUP__DMA_LATENCY;
+
+      for (int j = 0; j < LOOPS; j++) {
+        osal_rt_setup_result_t result;
+        (void)osal_rt_setup(&attr, &result);
+        EXPECT_EQ(result.done | result.failed, attr.steps);
+        EXPECT_EQ(osal_rt_release(), OSAL_OK);
+      }
+    });
+  }
+
+  for (auto &task : tasks) {
+    task.join();
+  }
+
+  EXPECT_EQ(open_fds(), fds) << "cpu dma latency request leaked";
+}
+
+TEST(RtFunction, PrefaultTaskStack) {
+  long faults = -1;
+
+  std::thread task([&faults]() {
+    EXPECT_EQ(osal_rt_prefault_stack(STACK_PREFAULT), OSAL_OK);
+
+    long before = thread_minor_faults();
+    use_stack(STACK_USE / 4096);
+    faults = thread_minor_faults() - before;
+  });
+  task.join();
+
+  EXPECT_LT(faults, 4) << "prefaulted stack must not fault again";
+}
+
+TEST(RtReject, InvalidParams) {
+  osal_rt_setup_attr_t attr = {};
+  osal_rt_setup_result_t result;
+
+  attr.steps = OSAL_RT_SETUP__ALL + 1;
+  EXPECT_EQ(osal_rt_setup(&attr, &result), OSAL_ERR_INVALID_PARAM)
+      << "unknown step";
+  EXPECT_EQ(result.done, 0u);
+
+  attr.steps = OSAL_RT_SETUP__DMA_LATENCY;
+  attr.dma_latency = -1;
+  EXPECT_EQ(osal_rt_setup(&attr, &result), OSAL_ERR_INVALID_PARAM)
+      << "negative latency";
+}
+
+} // namespace test_rt
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,284 @@
+#include "gtest/gtest.h"
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "libosal/osal.h"
+#include "libosal/rwlock.h"
+#include "libosal/timer.h"
+
+namespace test_rwlock {
+
+const osal_uint64_t TIMEOUT = 1000000000; // 1 s
+
+const osal_rwlock_attr_t variants[] = {
+    0,
+    OSAL_RWLOCK_ATTR__PREFER_WRITER,
+    OSAL_RWLOCK_ATTR__PROCESS_SHARED,
+    OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT,
+    OSAL_RWLOCK_ATTR__PER_CPU,
+    OSAL_RWLOCK_ATTR__PER_CPU | OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT,
+};
+
+TEST(RwlockFunction, SingleThreaded) {
+  for (osal_rwlock_attr_t attr : variants) {
+    osal_rwlock_t rwl;
+    ASSERT_EQ(osal_rwlock_init(&rwl, &attr), OSAL_OK) << "attr " << attr;
+
+    // readers share the lock, writer is excluded
+    EXPECT_EQ(osal_rwlock_rdlock(&rwl), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_tryrdlock(&rwl), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_trywrlock(&rwl), OSAL_ERR_BUSY) << "attr " << attr;
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+
+    // writer excludes everybody
+    EXPECT_EQ(osal_rwlock_trywrlock(&rwl), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_tryrdlock(&rwl), OSAL_ERR_BUSY) << "attr " << attr;
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+
+    EXPECT_EQ(osal_rwlock_wrlock(&rwl), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_tryrdlock(&rwl), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+
+    EXPECT_EQ(osal_rwlock_destroy(&rwl), OSAL_OK);
+  }
+}
+
+TEST(RwlockFunction, Timeout) {
+  for (osal_rwlock_attr_t attr : variants) {
+    osal_rwlock_t rwl;
+    osal_retval_t rd_ret = OSAL_OK;
+    osal_retval_t wr_ret = OSAL_OK;
+    ASSERT_EQ(osal_rwlock_init(&rwl, &attr), OSAL_OK);
+
+    ASSERT_EQ(osal_rwlock_wrlock(&rwl), OSAL_OK);
+    std::thread other([&rwl, &rd_ret, &wr_ret]() {
+      osal_timer_t to;
+      osal_timer_init(&to, 10000000);
+      rd_ret = osal_rwlock_timedrdlock(&rwl, &to);
+      osal_timer_init(&to, 10000000);
+      wr_ret = osal_rwlock_timedwrlock(&rwl, &to);
+    });
+    other.join();
+    EXPECT_EQ(rd_ret, OSAL_ERR_TIMEOUT) << "attr " << attr;
+    EXPECT_EQ(wr_ret, OSAL_ERR_TIMEOUT) << "attr " << attr;
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+
+    // timed writer gives up on a reader and lets new readers in again
+    ASSERT_EQ(osal_rwlock_rdlock(&rwl), OSAL_OK);
+    std::thread writer([&rwl, &wr_ret]() {
+      osal_timer_t to;
+      osal_timer_init(&to, 10000000);
+      wr_ret = osal_rwlock_timedwrlock(&rwl, &to);
+    });
+    writer.join();
+    EXPECT_EQ(wr_ret, OSAL_ERR_TIMEOUT) << "attr " << attr;
+    EXPECT_EQ(osal_rwlock_tryrdlock(&rwl), OSAL_OK) << "attr " << attr;
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+
+    osal_timer_t to;
+    osal_timer_init(&to, TIMEOUT);
+    EXPECT_EQ(osal_rwlock_timedwrlock(&rwl, &to), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+
+    osal_rwlock_destroy(&rwl);
+  }
+}
+
+TEST(RwlockFunction, WriterPreference) {
+  for (osal_rwlock_attr_t attr : variants) {
+    osal_rwlock_t rwl;
+    ASSERT_EQ(osal_rwlock_init(&rwl, &attr), OSAL_OK);
+
+    ASSERT_EQ(osal_rwlock_rdlock(&rwl), OSAL_OK);
+    std::thread writer([&rwl]() {
+      osal_rwlock_wrlock(&rwl);
+      osal_rwlock_unlock(&rwl);
+    });
+
+    // wait until writer is blocked
+    osal_sleep(20000000);
+
+    bool prefer_writer =
+        (attr & (OSAL_RWLOCK_ATTR__PREFER_WRITER |
+                 OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT |
+                 OSAL_RWLOCK_ATTR__PER_CPU)) != 0;
+    osal_retval_t ret = osal_rwlock_tryrdlock(&rwl);
+    if (prefer_writer) {
+      EXPECT_EQ(ret, OSAL_ERR_BUSY) << "waiting writer has to block readers";
+    } else {
+      EXPECT_EQ(ret, OSAL_OK) << "readers may join while writer is waiting";
+      osal_rwlock_unlock(&rwl);
+    }
+
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+    writer.join();
+    osal_rwlock_destroy(&rwl);
+  }
+}
+
+TEST(RwlockFunction, MultiThreading) {
+  const int READERS = 4;
+  const int WRITERS = 2;
+  const int LOOPCOUNT = 2000;
+
+  for (osal_rwlock_attr_t attr : variants) {
+    osal_rwlock_t rwl;
+    volatile osal_uint64_t data[2] = {0, 0};
+    osal_uint32_t torn = 0;
+    ASSERT_EQ(osal_rwlock_init(&rwl, &attr), OSAL_OK);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < WRITERS; i++) {
+      threads.emplace_back([&rwl, &data]() {
+        for (int j = 0; j < LOOPCOUNT; j++) {
+          osal_rwlock_wrlock(&rwl);
+          data[0] = data[0] + 1;
+          sched_yield();
+          data[1] = data[1] + 1;
+          osal_rwlock_unlock(&rwl);
+        }
+      });
+    }
+    for (int i = 0; i < READERS; i++) {
+      threads.emplace_back([&rwl, &data, &torn]() {
+        for (int j = 0; j < LOOPCOUNT; j++) {
+          osal_rwlock_rdlock(&rwl);
+          if (data[0] != data[1]) {
+            __atomic_fetch_add(&torn, 1, __ATOMIC_RELAXED);
+          }
+          osal_rwlock_unlock(&rwl);
+        }
+      });
+    }
+    for (std::thread &t : threads) {
+      t.join();
+    }
+
+    EXPECT_EQ(torn, 0u) << "reader saw half written data, attr " << attr;
+    EXPECT_EQ(data[0], (osal_uint64_t)(WRITERS * LOOPCOUNT))
+        << "writers were not exclusive, attr " << attr;
+    EXPECT_EQ(osal_rwlock_destroy(&rwl), OSAL_OK);
+  }
+}
+
+TEST(RwlockFunction, ProcessShared) {
+  const int LOOPCOUNT = 1000;
+  const osal_rwlock_attr_t shared_variants[] = {
+      OSAL_RWLOCK_ATTR__PROCESS_SHARED,
+      OSAL_RWLOCK_ATTR__PROCESS_SHARED | OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT,
+  };
+
+  for (osal_rwlock_attr_t attr : shared_variants) {
+    typedef struct {
+      osal_rwlock_t rwl;
+      osal_uint64_t data[2];
+    } shared_t;
+
+    shared_t *shared = (shared_t *)mmap(nullptr, sizeof(shared_t),
+                                        PROT_READ | PROT_WRITE,
+                                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(shared, MAP_FAILED);
+    shared->data[0] = shared->data[1] = 0;
+    ASSERT_EQ(osal_rwlock_init(&shared->rwl, &attr), OSAL_OK);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+
+    if (pid == 0) {
+      int ret = 0;
+      for (int i = 0; (ret == 0) && (i < LOOPCOUNT); i++) {
+        ret |= osal_rwlock_wrlock(&shared->rwl);
+        shared->data[0]++;
+        sched_yield();
+        shared->data[1]++;
+        ret |= osal_rwlock_unlock(&shared->rwl);
+      }
+      _exit(ret);
+    }
+
+    int torn = 0;
+    for (int i = 0; i < LOOPCOUNT; i++) {
+      osal_timer_t to;
+      osal_timer_init(&to, TIMEOUT);
+      ASSERT_EQ(osal_rwlock_timedrdlock(&shared->rwl, &to), OSAL_OK);
+      if (__atomic_load_n(&shared->data[0], __ATOMIC_RELAXED) !=
+          __atomic_load_n(&shared->data[1], __ATOMIC_RELAXED)) {
+        torn++;
+      }
+      ASSERT_EQ(osal_rwlock_unlock(&shared->rwl), OSAL_OK);
+    }
+
+    int status = -1;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+    EXPECT_EQ(torn, 0) << "attr " << attr;
+    EXPECT_EQ(shared->data[0], (osal_uint64_t)LOOPCOUNT);
+
+    osal_rwlock_destroy(&shared->rwl);
+    munmap(shared, sizeof(shared_t));
+  }
+}
+
+TEST(RwlockDetect, Relock) {
+  osal_rwlock_t rwl;
+  ASSERT_EQ(osal_rwlock_init(&rwl, nullptr), OSAL_OK);
+
+  ASSERT_EQ(osal_rwlock_wrlock(&rwl), OSAL_OK);
+  EXPECT_EQ(osal_rwlock_wrlock(&rwl), OSAL_ERR_DEAD_LOCK);
+  EXPECT_EQ(osal_rwlock_rdlock(&rwl), OSAL_ERR_DEAD_LOCK);
+  EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+
+  osal_rwlock_destroy(&rwl);
+}
+
+TEST(RwlockDetect, UnlockNotLocked) {
+  const osal_rwlock_attr_t own_variants[] = {
+      OSAL_RWLOCK_ATTR__PROTOCOL__INHERIT,
+      OSAL_RWLOCK_ATTR__PER_CPU,
+  };
+
+  for (osal_rwlock_attr_t attr : own_variants) {
+    osal_rwlock_t rwl;
+    ASSERT_EQ(osal_rwlock_init(&rwl, &attr), OSAL_OK) << "attr " << attr;
+
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_ERR_PERMISSION_DENIED)
+        << "attr " << attr;
+
+    // the stray unlock must not leave the reader count off
+    EXPECT_EQ(osal_rwlock_rdlock(&rwl), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_ERR_PERMISSION_DENIED)
+        << "attr " << attr;
+    EXPECT_EQ(osal_rwlock_trywrlock(&rwl), OSAL_OK) << "attr " << attr;
+    EXPECT_EQ(osal_rwlock_unlock(&rwl), OSAL_OK);
+
+    EXPECT_EQ(osal_rwlock_destroy(&rwl), OSAL_OK);
+  }
+}
+
+TEST(RwlockReject, InvalidAttributes) {
+  osal_rwlock_t rwl;
+  osal_rwlock_attr_t attr;
+
+  attr = OSAL_RWLOCK_ATTR__PER_CPU | OSAL_RWLOCK_ATTR__PROCESS_SHARED;
+  EXPECT_EQ(osal_rwlock_init(&rwl, &attr), OSAL_ERR_INVALID_PARAM)
+      << "per-CPU counters can not be shared";
+
+  attr = 0x80000000u;
+  EXPECT_EQ(osal_rwlock_init(&rwl, &attr), OSAL_ERR_INVALID_PARAM)
+      << "unknown attribute";
+}
+
+} // namespace test_rwlock
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,188 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "libosal/osal.h"
+#include "libosal/seqlock.h"
+
+namespace test_seqlock {
+
+const int STATE_WORDS = 256; // 2 KiB state
+
+typedef struct {
+  osal_seqlock_t sl;
+  osal_uint64_t state[STATE_WORDS];
+  osal_uint32_t stop;
+} shared_t;
+
+static void fill_state(osal_uint64_t *state, osal_uint64_t value) {
+  for (int i = 0; i < STATE_WORDS; i++) {
+    state[i] = value;
+  }
+}
+
+static bool state_consistent(const osal_uint64_t *state) {
+  for (int i = 1; i < STATE_WORDS; i++) {
+    if (state[i] != state[0]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(SeqlockFunction, SingleThreaded) {
+  shared_t shared = {};
+  osal_uint64_t local[STATE_WORDS];
+  osal_uint64_t update[STATE_WORDS];
+  ASSERT_EQ(osal_seqlock_init(&shared.sl), OSAL_OK);
+
+  fill_state(update, 42);
+  EXPECT_EQ(osal_seqlock_write_copy(&shared.sl, shared.state, update,
+                                    sizeof(update)),
+            OSAL_OK);
+  EXPECT_EQ(osal_seqlock_read_copy(&shared.sl, local, shared.state,
+                                   sizeof(local)),
+            OSAL_OK);
+  EXPECT_EQ(local[0], 42u);
+  EXPECT_TRUE(state_consistent(local));
+
+  // begin/retry around direct accesses
+  osal_uint32_t seq = osal_seqlock_read_begin(&shared.sl);
+  EXPECT_EQ(shared.state[7], 42u);
+  EXPECT_EQ(osal_seqlock_read_retry(&shared.sl, seq), OSAL_FALSE);
+
+  seq = osal_seqlock_read_begin(&shared.sl);
+  ASSERT_EQ(osal_seqlock_write_begin(&shared.sl), OSAL_OK);
+  shared.state[7] = 43;
+  ASSERT_EQ(osal_seqlock_write_end(&shared.sl), OSAL_OK);
+  EXPECT_EQ(osal_seqlock_read_retry(&shared.sl, seq), OSAL_TRUE)
+      << "update while reading has to be detected";
+}
+
+TEST(SeqlockFunction, UnalignedCopy) {
+  osal_seqlock_t sl;
+  char src[37];
+  char dst[40] = {};
+  ASSERT_EQ(osal_seqlock_init(&sl), OSAL_OK);
+
+  for (size_t i = 0; i < sizeof(src); i++) {
+    src[i] = (char)i;
+  }
+  EXPECT_EQ(osal_seqlock_write_copy(&sl, &dst[1], src, sizeof(src)), OSAL_OK);
+  EXPECT_EQ(memcmp(&dst[1], src, sizeof(src)), 0);
+  EXPECT_EQ(dst[0], 0);
+  EXPECT_EQ(dst[38], 0);
+}
+
+TEST(SeqlockFunction, ConcurrentReaders) {
+  const int READERS = 3;
+  const int WRITES = 20000;
+  shared_t *shared = new shared_t();
+  osal_uint32_t torn = 0;
+  ASSERT_EQ(osal_seqlock_init(&shared->sl), OSAL_OK);
+
+  std::thread readers[READERS];
+  for (int i = 0; i < READERS; i++) {
+    readers[i] = std::thread([shared, &torn]() {
+      osal_uint64_t local[STATE_WORDS];
+      while (__atomic_load_n(&shared->stop, __ATOMIC_ACQUIRE) == 0) {
+        osal_seqlock_read_copy(&shared->sl, local, shared->state,
+                               sizeof(local));
+        if (!state_consistent(local)) {
+          __atomic_fetch_add(&torn, 1, __ATOMIC_RELAXED);
+        }
+      }
+    });
+  }
+
+  osal_uint64_t update[STATE_WORDS];
+  for (int i = 1; i <= WRITES; i++) {
+    fill_state(update, i);
+    ASSERT_EQ(osal_seqlock_write_copy(&shared->sl, shared->state, update,
+                                      sizeof(update)),
+              OSAL_OK)
+        << "writer must never be refused";
+    if ((i % 100) == 0) {
+      sched_yield();
+    }
+  }
+
+  __atomic_store_n(&shared->stop, 1, __ATOMIC_RELEASE);
+  for (int i = 0; i < READERS; i++) {
+    readers[i].join();
+  }
+
+  EXPECT_EQ(torn, 0u) << "reader got a half written state";
+  delete shared;
+}
+
+TEST(SeqlockFunction, ProcessShared) {
+  const int WRITES = 20000;
+  shared_t *shared = (shared_t *)mmap(nullptr, sizeof(shared_t),
+                                      PROT_READ | PROT_WRITE,
+                                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(shared, MAP_FAILED);
+  ASSERT_EQ(osal_seqlock_init(&shared->sl), OSAL_OK);
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+
+  if (pid == 0) {
+    // child is the reader
+    osal_uint64_t local[STATE_WORDS];
+    osal_uint64_t last = 0;
+    int ret = 0;
+    while ((ret == 0) &&
+           (__atomic_load_n(&shared->stop, __ATOMIC_ACQUIRE) == 0)) {
+      osal_seqlock_read_copy(&shared->sl, local, shared->state,
+                             sizeof(local));
+      if (!state_consistent(local) || (local[0] < last)) {
+        ret = 1;
+      }
+      last = local[0];
+    }
+    _exit(ret);
+  }
+
+  osal_uint64_t update[STATE_WORDS];
+  for (int i = 1; i <= WRITES; i++) {
+    fill_state(update, i);
+    ASSERT_EQ(osal_seqlock_write_copy(&shared->sl, shared->state, update,
+                                      sizeof(update)),
+              OSAL_OK);
+    if ((i % 100) == 0) {
+      sched_yield();
+    }
+  }
+  __atomic_store_n(&shared->stop, 1, __ATOMIC_RELEASE);
+
+  int status = -1;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFEXITED(status) && (WEXITSTATUS(status) == 0))
+      << "reader process got a torn or stale state";
+
+  munmap(shared, sizeof(shared_t));
+}
+
+TEST(SeqlockDetect, ConcurrentWriter) {
+  osal_seqlock_t sl;
+  ASSERT_EQ(osal_seqlock_init(&sl), OSAL_OK);
+
+  ASSERT_EQ(osal_seqlock_write_begin(&sl), OSAL_OK);
+  EXPECT_EQ(osal_seqlock_write_begin(&sl), OSAL_ERR_BUSY)
+      << "second writer has to be refused, not blocked";
+  EXPECT_EQ(osal_seqlock_write_end(&sl), OSAL_OK);
+  EXPECT_EQ(osal_seqlock_write_end(&sl), OSAL_ERR_PERMISSION_DENIED)
+      << "no write in progress";
+}
+
+} // namespace test_seqlock
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -9,6 +9,7 @@
 #include "libosal/osal.h"
 #include "libosal/shm.h"
 #include "libosal/semaphore.h"
+#include "libosal/timer.h"
 #include "test_utils.h"
 #include <sys/mman.h>
 #include <sys/resource.h>
@@ -875,6 +876,166 @@ TEST(SharedmemoryError, TestBadDescriptor) {
 
 } // end namespace test_mmap
 
+namespace test_map_attributes {
+
+const char *SHM_NAME_MAP = "/shm_test_map_attr";
+
+const osal_size_t MAP_SIZE = 4 * 1024 * 1024;
+const osal_size_t PREFAULT_SIZE = 192 * 1024 * 1024;
+
+static osal_retval_t remove_segment(osal_uint32_t flags) {
+  osal_shm_attr_t attr = flags;
+
+  return osal_shm_unlink(SHM_NAME_MAP, &attr);
+}
+
+static osal_retval_t open_segment(osal_shm_t *shm, osal_uint32_t flags,
+                                  osal_size_t size) {
+  osal_shm_attr_t attr =
+      (OSAL_SHM_ATTR__FLAG__RDWR | OSAL_SHM_ATTR__FLAG__CREAT | flags |
+       ((S_IRUSR | S_IWUSR) << OSAL_SHM_ATTR__MODE__SHIFT));
+
+  return osal_shm_open(shm, SHM_NAME_MAP, &attr, size);
+}
+
+// number of resident pages in a mapping
+static size_t resident_pages(void *ptr, size_t size) {
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  size_t pages = (size + page_size - 1) / page_size;
+  std::vector<unsigned char> vec(pages);
+  size_t ret = 0;
+
+  if (mincore(ptr, size, vec.data()) == 0) {
+    for (size_t i = 0; i < pages; i++) {
+      ret += vec[i] & 1u;
+    }
+  }
+
+  return ret;
+}
+
+static long minor_faults() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_minflt;
+}
+
+TEST(SharedmemoryFunction, MapPopulateLocked) {
+  osal_shm_t shm;
+  uint8_t *p_mem;
+
+  (void)remove_segment(0);
+  ASSERT_EQ(open_segment(&shm, 0, MAP_SIZE), OSAL_OK);
+
+  osal_shm_map_attr_t map_attr =
+      (OSAL_SHM_MAP_ATTR__PROT_READ | OSAL_SHM_MAP_ATTR__PROT_WRITE |
+       OSAL_SHM_MAP_ATTR__SHARED | OSAL_SHM_MAP_ATTR__POPULATE |
+       OSAL_SHM_MAP_ATTR__LOCKED);
+  osal_retval_t orv = osal_shm_map(&shm, &map_attr, (osal_void_t **)&p_mem);
+  if (orv == OSAL_ERR_PERMISSION_DENIED) {
+    EXPECT_EQ(p_mem, nullptr) << "failed lock has to remove the mapping";
+    printf("no privileges to lock memory, checking populate only\n");
+    map_attr &= ~OSAL_SHM_MAP_ATTR__LOCKED;
+    orv = osal_shm_map(&shm, &map_attr, (osal_void_t **)&p_mem);
+  }
+  ASSERT_EQ(orv, OSAL_OK);
+
+  EXPECT_EQ(resident_pages(p_mem, MAP_SIZE), MAP_SIZE / sysconf(_SC_PAGESIZE))
+      << "populated mapping has to be resident";
+
+  long faults = minor_faults();
+  for (size_t i = 0; i < MAP_SIZE; i += sysconf(_SC_PAGESIZE)) {
+    p_mem[i] = (uint8_t)i;
+  }
+  EXPECT_LT(minor_faults() - faults, 16) << "populated pages must not fault";
+
+  munmap(p_mem, MAP_SIZE);
+  EXPECT_EQ(osal_shm_close(&shm), OSAL_OK);
+  EXPECT_EQ(remove_segment(0), OSAL_OK);
+}
+
+TEST(SharedmemoryFunction, MapPrefaultParallel) {
+  osal_shm_t shm;
+  uint32_t *p_write;
+  uint32_t *p_read;
+
+  (void)remove_segment(0);
+  ASSERT_EQ(open_segment(&shm, 0, PREFAULT_SIZE), OSAL_OK);
+
+  // write a pattern to some pages, prefault must not change it
+  osal_shm_map_attr_t map_attr =
+      (OSAL_SHM_MAP_ATTR__PROT_READ | OSAL_SHM_MAP_ATTR__PROT_WRITE |
+       OSAL_SHM_MAP_ATTR__SHARED);
+  ASSERT_EQ(osal_shm_map(&shm, &map_attr, (osal_void_t **)&p_write), OSAL_OK);
+  for (size_t i = 0; i < PREFAULT_SIZE / sizeof(uint32_t); i += 1024 * 1024) {
+    p_write[i] = (uint32_t)i + 1;
+  }
+
+  map_attr |= OSAL_SHM_MAP_ATTR__PREFAULT;
+  osal_uint64_t start = osal_timer_gettime_nsec();
+  ASSERT_EQ(osal_shm_map(&shm, &map_attr, (osal_void_t **)&p_read), OSAL_OK);
+  printf("prefault of %lu MiB took %lu us\n",
+         (unsigned long)(PREFAULT_SIZE >> 20),
+         (unsigned long)((osal_timer_gettime_nsec() - start) / 1000));
+
+  EXPECT_EQ(resident_pages(p_read, PREFAULT_SIZE),
+            PREFAULT_SIZE / sysconf(_SC_PAGESIZE))
+      << "prefaulted mapping has to be resident";
+
+  for (size_t i = 0; i < PREFAULT_SIZE / sizeof(uint32_t); i += 1024 * 1024) {
+    EXPECT_EQ(p_read[i], (uint32_t)i + 1) << "prefault changed contents";
+  }
+
+  munmap(p_write, PREFAULT_SIZE);
+  munmap(p_read, PREFAULT_SIZE);
+  EXPECT_EQ(osal_shm_close(&shm), OSAL_OK);
+  EXPECT_EQ(remove_segment(0), OSAL_OK);
+}
+
+TEST(SharedmemoryFunction, Hugepages) {
+  osal_shm_t shm;
+  osal_shm_t shm_other;
+  uint32_t *p_first;
+  uint32_t *p_second;
+
+  (void)remove_segment(OSAL_SHM_ATTR__FLAG__HUGEPAGES);
+  ASSERT_EQ(open_segment(&shm, OSAL_SHM_ATTR__FLAG__HUGEPAGES, MAP_SIZE + 1),
+            OSAL_OK);
+  EXPECT_GE(shm.size, MAP_SIZE + 1);
+  printf("segment backed by %s\n",
+         shm.hugetlb ? "hugetlbfs" : "transparent huge pages");
+
+  // a second user has to find the same segment
+  ASSERT_EQ(open_segment(&shm_other, OSAL_SHM_ATTR__FLAG__HUGEPAGES, MAP_SIZE),
+            OSAL_OK);
+  EXPECT_EQ(shm_other.hugetlb, shm.hugetlb);
+  EXPECT_EQ(shm_other.size, shm.size);
+
+  osal_shm_map_attr_t map_attr =
+      (OSAL_SHM_MAP_ATTR__PROT_READ | OSAL_SHM_MAP_ATTR__PROT_WRITE |
+       OSAL_SHM_MAP_ATTR__SHARED | OSAL_SHM_MAP_ATTR__PREFAULT);
+  ASSERT_EQ(osal_shm_map(&shm, &map_attr, (osal_void_t **)&p_first), OSAL_OK);
+  ASSERT_EQ(osal_shm_map(&shm_other, &map_attr, (osal_void_t **)&p_second),
+            OSAL_OK);
+
+  for (size_t i = 0; i < MAP_SIZE / sizeof(uint32_t); i += 1024) {
+    p_first[i] = (uint32_t)i;
+  }
+  for (size_t i = 0; i < MAP_SIZE / sizeof(uint32_t); i += 1024) {
+    EXPECT_EQ(p_second[i], (uint32_t)i);
+  }
+
+  munmap(p_first, shm.size);
+  munmap(p_second, shm_other.size);
+  EXPECT_EQ(osal_shm_close(&shm), OSAL_OK);
+  EXPECT_EQ(osal_shm_close(&shm_other), OSAL_OK);
+  EXPECT_EQ(remove_segment(OSAL_SHM_ATTR__FLAG__HUGEPAGES), OSAL_OK);
+  EXPECT_EQ(remove_segment(OSAL_SHM_ATTR__FLAG__HUGEPAGES), OSAL_ERR_NOT_FOUND)
+      << "segment left behind";
+}
+
+} // namespace test_map_attributes
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   if (getenv("VERBOSE")) {
@@ -0,0 +1,224 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include <pthread.h>
+#include <vector>
+
+#include "libosal/osal.h"
+#include "libosal/shm.h"
+#include "libosal/shm_ring.h"
+#include "test_utils.h"
+
+namespace test_shm_ring {
+
+const osal_uint32_t FRAME_CNT = 16;
+const osal_uint32_t NUM_FRAMES = 100000;
+
+const char *SHM_NAME = "/shm_ring_test";
+
+typedef struct {
+  osal_uint64_t seq;
+  osal_uint64_t payload[7];
+} frame_t;
+
+TEST(SHMRingFunction, SingleThreaded) {
+  osal_size_t size = osal_shm_ring_get_size(sizeof(frame_t), FRAME_CNT);
+  ASSERT_GT(size, sizeof(osal_shm_ring_ctrl_t));
+
+  std::vector<osal_uint8_t> mem(size);
+  osal_shm_ring_t ring;
+  osal_retval_t orv =
+      osal_shm_ring_init(&ring, mem.data(), size, sizeof(frame_t), FRAME_CNT,
+                         nullptr);
+  ASSERT_EQ(orv, OSAL_OK);
+
+  osal_void_t *frame;
+  EXPECT_EQ(osal_shm_ring_peek(&ring, &frame), OSAL_ERR_NO_DATA)
+      << "new ring has to be empty";
+
+  for (osal_uint32_t i = 0; i < FRAME_CNT; i++) {
+    ASSERT_EQ(osal_shm_ring_reserve(&ring, &frame), OSAL_OK);
+    ((frame_t *)frame)->seq = i;
+    osal_shm_ring_commit(&ring);
+  }
+
+  EXPECT_EQ(osal_shm_ring_reserve(&ring, &frame), OSAL_ERR_BUSY)
+      << "ring should be full";
+  EXPECT_EQ(osal_shm_ring_count(&ring), FRAME_CNT);
+
+  for (osal_uint32_t i = 0; i < FRAME_CNT; i++) {
+    ASSERT_EQ(osal_shm_ring_peek(&ring, &frame), OSAL_OK);
+    EXPECT_EQ(((frame_t *)frame)->seq, i);
+    osal_shm_ring_release(&ring);
+  }
+
+  EXPECT_EQ(osal_shm_ring_peek(&ring, &frame), OSAL_ERR_NO_DATA);
+  EXPECT_EQ(osal_shm_ring_count(&ring), 0u);
+}
+
+TEST(SHMRingReject, InvalidParams) {
+  std::vector<osal_uint8_t> mem(4096);
+  osal_shm_ring_t ring;
+
+  EXPECT_EQ(osal_shm_ring_get_size(sizeof(frame_t), 3), 0u)
+      << "frame count has to be a power of 2";
+  EXPECT_EQ(osal_shm_ring_init(&ring, mem.data(), mem.size(), sizeof(frame_t),
+                               3, nullptr),
+            OSAL_ERR_INVALID_PARAM);
+  EXPECT_EQ(osal_shm_ring_init(&ring, mem.data(), mem.size(), sizeof(frame_t),
+                               1024, nullptr),
+            OSAL_ERR_INVALID_PARAM)
+      << "region too small";
+
+  std::vector<osal_uint8_t> empty(4096);
+  EXPECT_EQ(osal_shm_ring_attach(&ring, empty.data(), empty.size()),
+            OSAL_ERR_UNAVAILABLE);
+
+  ASSERT_EQ(osal_shm_ring_init(&ring, mem.data(), mem.size(), sizeof(frame_t),
+                               4, nullptr),
+            OSAL_OK);
+  osal_void_t *frame;
+  osal_timer_t to;
+  osal_timer_init(&to, 1000000);
+  EXPECT_EQ(osal_shm_ring_timedpeek(&ring, &frame, &to),
+            OSAL_ERR_INVALID_PARAM)
+      << "blocking needs OSAL_SHM_RING_ATTR__BLOCKING";
+}
+
+TEST(SHMRingFunction, TimedPeekTimeout) {
+  osal_size_t size = osal_shm_ring_get_size(sizeof(frame_t), FRAME_CNT);
+  std::vector<osal_uint8_t> mem(size);
+  osal_shm_ring_t ring;
+  osal_shm_ring_attr_t attr = OSAL_SHM_RING_ATTR__BLOCKING;
+  ASSERT_EQ(osal_shm_ring_init(&ring, mem.data(), size, sizeof(frame_t),
+                               FRAME_CNT, &attr),
+            OSAL_OK);
+
+  osal_void_t *frame;
+  osal_timer_t to;
+  osal_timer_init(&to, 10000000);
+  EXPECT_EQ(osal_shm_ring_timedpeek(&ring, &frame, &to), OSAL_ERR_TIMEOUT);
+  EXPECT_EQ(osal_timer_expired(&to), OSAL_ERR_TIMEOUT)
+      << "returned before timeout";
+}
+
+typedef struct {
+  osal_shm_ring_t *ring;
+  osal_uint32_t cnt;
+} producer_param_t;
+
+void *producer(void *arg) {
+  producer_param_t *params = (producer_param_t *)arg;
+
+  for (osal_uint32_t i = 0; i < params->cnt; i++) {
+    osal_void_t *frame;
+    osal_retval_t orv = osal_shm_ring_timedreserve(params->ring, &frame, nullptr);
+    if (orv != OSAL_OK) {
+      return (void *)1;
+    }
+    ((frame_t *)frame)->seq = i;
+    ((frame_t *)frame)->payload[6] = ~(osal_uint64_t)i;
+    osal_shm_ring_commit(params->ring);
+  }
+
+  return nullptr;
+}
+
+TEST(SHMRingFunction, ProducerConsumerThreads) {
+  osal_size_t size = osal_shm_ring_get_size(sizeof(frame_t), FRAME_CNT);
+  std::vector<osal_uint8_t> mem(size);
+  osal_shm_ring_t prod_ring;
+  osal_shm_ring_t cons_ring;
+  osal_shm_ring_attr_t attr = OSAL_SHM_RING_ATTR__BLOCKING;
+  ASSERT_EQ(osal_shm_ring_init(&prod_ring, mem.data(), size, sizeof(frame_t),
+                               FRAME_CNT, &attr),
+            OSAL_OK);
+  ASSERT_EQ(osal_shm_ring_attach(&cons_ring, mem.data(), size), OSAL_OK);
+
+  producer_param_t params = {&prod_ring, NUM_FRAMES};
+  pthread_t thread;
+  ASSERT_EQ(pthread_create(&thread, nullptr, producer, &params), 0);
+
+  osal_uint32_t errors = 0;
+  for (osal_uint32_t i = 0; i < NUM_FRAMES; i++) {
+    osal_void_t *frame;
+    osal_timer_t to;
+    osal_timer_init(&to, 5000000000);
+    ASSERT_EQ(osal_shm_ring_timedpeek(&cons_ring, &frame, &to), OSAL_OK);
+    if ((((frame_t *)frame)->seq != i) ||
+        (((frame_t *)frame)->payload[6] != ~(osal_uint64_t)i)) {
+      errors++;
+    }
+    osal_shm_ring_release(&cons_ring);
+  }
+
+  void *thread_ret;
+  pthread_join(thread, &thread_ret);
+  EXPECT_EQ(thread_ret, nullptr) << "producer failed";
+  EXPECT_EQ(errors, 0u) << "frames lost or out of order";
+}
+
+TEST(SHMRingFunction, ProducerConsumerProcesses) {
+  osal_size_t size = osal_shm_ring_get_size(sizeof(frame_t), FRAME_CNT);
+  osal_shm_t shm;
+  osal_shm_attr_t attr =
+      (OSAL_SHM_ATTR__FLAG__RDWR | OSAL_SHM_ATTR__FLAG__CREAT |
+       (S_IRWXU << OSAL_SHM_ATTR__MODE__SHIFT));
+  shm_unlink(SHM_NAME);
+  ASSERT_EQ(osal_shm_open(&shm, SHM_NAME, &attr, size), OSAL_OK);
+
+  osal_void_t *mem;
+  osal_shm_map_attr_t map_attr =
+      (OSAL_SHM_MAP_ATTR__PROT_READ | OSAL_SHM_MAP_ATTR__PROT_WRITE |
+       OSAL_SHM_MAP_ATTR__SHARED);
+  ASSERT_EQ(osal_shm_map(&shm, &map_attr, &mem), OSAL_OK);
+
+  osal_shm_ring_t ring;
+  osal_shm_ring_attr_t ring_attr = OSAL_SHM_RING_ATTR__BLOCKING;
+  ASSERT_EQ(osal_shm_ring_init(&ring, mem, size, sizeof(frame_t), FRAME_CNT,
+                               &ring_attr),
+            OSAL_OK);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    osal_shm_ring_t child_ring;
+    if (osal_shm_ring_attach(&child_ring, mem, size) != OSAL_OK) {
+      exit(1);
+    }
+    producer_param_t params = {&child_ring, NUM_FRAMES};
+    exit(producer(&params) == nullptr ? 0 : 2);
+  }
+
+  osal_uint32_t errors = 0;
+  for (osal_uint32_t i = 0; i < NUM_FRAMES; i++) {
+    osal_void_t *frame;
+    osal_timer_t to;
+    osal_timer_init(&to, 5000000000);
+    ASSERT_EQ(osal_shm_ring_timedpeek(&ring, &frame, &to), OSAL_OK);
+    if (((frame_t *)frame)->seq != i) {
+      errors++;
+    }
+    osal_shm_ring_release(&ring);
+  }
+
+  int status = -1;
+  waitpid(pid, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status) && (WEXITSTATUS(status) == 0))
+      << "producer process failed";
+  EXPECT_EQ(errors, 0u) << "frames lost or out of order";
+
+  osal_shm_close(&shm);
+  shm_unlink(SHM_NAME);
+}
+
+} // namespace test_shm_ring
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -2,7 +2,11 @@
 
 #include "libosal/io.h"
 #include "libosal/osal.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string>
 #include <unistd.h>
+#include <vector>
 
 namespace test_shmio {
 
@@ -27,6 +31,187 @@ TEST(SHMIOFunction, SimpleMessage) {
                     << "' vs. '" << TEST_MESSAGE << "'";
 }
 
+const osal_uint32_t N_WRITERS = 4;
+const osal_uint32_t NUM_MESSAGES = 20000;
+
+void *writer(void *arg) {
+  osal_uint32_t id = *(osal_uint32_t *)arg;
+
+  for (osal_uint32_t i = 0; i < NUM_MESSAGES; i++) {
+    // variable length, payload is checked by the reader
+    osal_uint32_t pad = (i * 7u) % 64u;
+    while (osal_printf("%u %u %.*s|\n", id, i, (int)pad,
+                       "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"
+                       "xxxxxx") == OSAL_ERR_BUSY) {
+      sched_yield();
+    }
+  }
+
+  return nullptr;
+}
+
+TEST(SHMIOFunction, MultipleWriters) {
+  unlink("/dev/shm/shm_io_mp");
+  ASSERT_EQ(osal_io_shm_setup("shm_io_mp", 64, 128), OSAL_OK);
+
+  // drain setup messages
+  osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE];
+  while (osal_io_shm_get_message(msg, nullptr) == OSAL_OK) {
+  }
+
+  osal_uint32_t ids[N_WRITERS];
+  pthread_t threads[N_WRITERS];
+  for (osal_uint32_t i = 0; i < N_WRITERS; i++) {
+    ids[i] = i;
+    ASSERT_EQ(pthread_create(&threads[i], nullptr, writer, &ids[i]), 0);
+  }
+
+  std::vector<osal_uint32_t> next(N_WRITERS, 0);
+  osal_uint32_t errors = 0;
+  osal_uint32_t received = 0;
+
+  while (received < (N_WRITERS * NUM_MESSAGES)) {
+    osal_timer_t deadline;
+    osal_timer_init(&deadline, 2000000000);
+    if (osal_io_shm_get_message(msg, &deadline) != OSAL_OK) {
+      break;
+    }
+
+    unsigned id, seq;
+    int pad_start = 0, pad_end = 0;
+    if ((sscanf(msg, "%u %u %n%*[x]%n", &id, &seq, &pad_start, &pad_end) < 2) ||
+        (id >= N_WRITERS) || (seq != next[id])) {
+      errors++;
+    } else {
+      osal_uint32_t pad = (seq * 7u) % 64u;
+      osal_uint32_t got = (pad_end > pad_start) ? (pad_end - pad_start) : 0;
+      const char *end = msg + pad_start + got;
+      if ((got != pad) || (strcmp(end, "|\n") != 0)) {
+        errors++;
+      }
+      next[id] = seq + 1;
+    }
+    received++;
+  }
+
+  for (osal_uint32_t i = 0; i < N_WRITERS; i++) {
+    pthread_join(threads[i], nullptr);
+  }
+
+  EXPECT_EQ(received, N_WRITERS * NUM_MESSAGES) << "messages lost";
+  EXPECT_EQ(errors, 0u) << "messages corrupted or reordered";
+  EXPECT_GT(osal_io_shm_get_dropped(), 0u)
+      << "small ring should have been full at least once";
+}
+
+TEST(SHMIOFunction, DeferredLog) {
+  unlink("/dev/shm/shm_io_log");
+  ASSERT_EQ(osal_io_shm_setup("shm_io_log", 64, 256), OSAL_OK);
+
+  osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE];
+  while (osal_io_shm_get_message(msg, nullptr) == OSAL_OK) {
+  }
+
+  osal_char_t expected[LIBOSAL_IO_SHM_MAX_MSG_SIZE];
+  const char *str = "text";
+  void *ptr = (void *)&msg;
+  osal_uint64_t before = osal_timer_gettime_nsec();
+
+  for (int i = 0; i < 3; i++) {
+    // first call registers the format, later ones only store arguments
+    OSAL_LOG("%d %u %ld %lld %c %x|%s|%-6s|%.2s|%8.3f %g %p %*d %.*f %%\n",
+             -i, 42u + i, -123456789l, 1ll << 40, 'a' + i, 0xbeef,
+             str, "ab", "xyz", 3.14159 * i, 1e-10, ptr, 5, i, 2, 2.5);
+    snprintf(expected, sizeof(expected),
+             "%d %u %ld %lld %c %x|%s|%-6s|%.2s|%8.3f %g %p %*d %.*f %%\n",
+             -i, 42u + i, -123456789l, 1ll << 40, 'a' + i, 0xbeef,
+             str, "ab", "xyz", 3.14159 * i, 1e-10, ptr, 5, i, 2, 2.5);
+
+    osal_uint64_t timestamp = 0;
+    ASSERT_EQ(osal_io_shm_get_record(msg, &timestamp, nullptr), OSAL_OK);
+    EXPECT_STREQ(msg, expected);
+    EXPECT_GE(timestamp, before) << "log record has to carry its timestamp";
+  }
+
+  // long strings are cut to fit into one message
+  std::string long_str(1000, 'y');
+  OSAL_LOG("%s|%d\n", long_str.c_str(), 7);
+  ASSERT_EQ(osal_io_shm_get_message(msg, nullptr), OSAL_OK);
+  EXPECT_LT(strlen(msg), 256u);
+  EXPECT_EQ(strncmp(msg, "yyyy", 4), 0);
+  EXPECT_NE(strstr(msg, "|7\n"), nullptr) << "arguments after string lost";
+
+  // context dependent conversions and too many arguments are formatted by
+  // the caller
+  OSAL_LOG("%Lf\n", (long double)1.5);
+  osal_uint64_t timestamp = 1;
+  ASSERT_EQ(osal_io_shm_get_record(msg, &timestamp, nullptr), OSAL_OK);
+  EXPECT_STREQ(msg, "1.500000\n");
+  EXPECT_EQ(timestamp, 0u) << "has to be a text message";
+
+  OSAL_LOG("%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d\n", 1, 2, 3, 4, 5, 6, 7, 8, 9, 0,
+           1, 2, 3, 4, 5, 6, 7);
+  ASSERT_EQ(osal_io_shm_get_record(msg, &timestamp, nullptr), OSAL_OK);
+  EXPECT_STREQ(msg, "12345678901234567\n");
+  EXPECT_EQ(timestamp, 0u) << "has to be a text message";
+
+  // specifications the reader can not rebuild are not cut, built at runtime
+  // since a literal with repeated flags does not pass -Wformat
+  static const std::string long_spec =
+      "%-" + std::string(72, '0') + "8d|%.*f\n";
+  const char *long_fmt = long_spec.c_str();
+  OSAL_LOG(long_fmt, 42, 3, 0.5);
+  ASSERT_EQ(osal_io_shm_get_record(msg, &timestamp, nullptr), OSAL_OK);
+  EXPECT_STREQ(msg, "42      |0.500\n");
+  EXPECT_EQ(timestamp, 0u) << "has to be a text message";
+}
+
+TEST(SHMIOFunction, DeferredLogRestart) {
+  unlink("/dev/shm/shm_io_restart");
+  ASSERT_EQ(osal_io_shm_setup("shm_io_restart", 64, 256), OSAL_OK);
+
+  osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE];
+  while (osal_io_shm_get_message(msg, nullptr) == OSAL_OK) {
+  }
+
+  // every restart of a writer starts with unregistered call sites, more
+  // restarts than format ids must not fill up the dictionary
+  static const char *fmt = "restart %d\n";
+  for (int i = 0; i < (int)LIBOSAL_IO_SHM_LOG_MAX_FORMATS + 10; i++) {
+    osal_log_site_t site = {fmt, 0u, 0u, 0u, {0u}};
+    ASSERT_EQ(osal_log_write(&site, fmt, i), OSAL_OK);
+
+    osal_uint64_t timestamp = 0;
+    ASSERT_EQ(osal_io_shm_get_record(msg, &timestamp, nullptr), OSAL_OK);
+    EXPECT_EQ(site.id, 0u) << "restart " << i;
+    EXPECT_NE(timestamp, 0u) << "restart " << i << " formatted by caller";
+    ASSERT_EQ(msg, "restart " + std::to_string(i) + "\n");
+  }
+}
+
+TEST(SHMIOFunction, DeferredLogSameAsPrintf) {
+  unlink("/dev/shm/shm_io_cost");
+  ASSERT_EQ(osal_io_shm_setup("shm_io_cost", 4096, 256), OSAL_OK);
+
+  osal_char_t msg[LIBOSAL_IO_SHM_MAX_MSG_SIZE];
+  osal_char_t printed[LIBOSAL_IO_SHM_MAX_MSG_SIZE];
+  while (osal_io_shm_get_message(msg, nullptr) == OSAL_OK) {
+  }
+
+  // the cost of both is compared by libosal_bench (log_shm, printf_shm)
+  for (int i = 0; i < 100; i++) {
+    OSAL_LOG("cycle %d: position %f, velocity %f, state %s\n", i, 0.1 * i,
+             0.01 * i, "running");
+    ASSERT_EQ(osal_io_shm_get_message(msg, nullptr), OSAL_OK);
+
+    osal_printf("cycle %d: position %f, velocity %f, state %s\n", i, 0.1 * i,
+                0.01 * i, "running");
+    ASSERT_EQ(osal_io_shm_get_message(printed, nullptr), OSAL_OK);
+
+    EXPECT_STREQ(msg, printed) << "cycle " << i;
+  }
+}
+
 } // namespace test_shmio
 
 int main(int argc, char **argv) {
@@ -1,5 +1,8 @@
 #include "gtest/gtest.h"
 #include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <vector>
 
 #include "libosal/osal.h"
@@ -191,6 +194,235 @@ TEST(SpinlockMultithreading, RandomizedPlusWait) {
       << "multi-threaded counter test failed";
 }
 
+static void run_counter_threads(const osal_spinlock_attr_t attr,
+                                ulong n_threads, uint loopcount) {
+  std::vector<pthread_t> thread_ids(n_threads);
+  std::vector<thread_param_t> thread_params(n_threads);
+  osal_spinlock_t count_spinlock;
+  unsigned long counter = 0;
+
+  ASSERT_EQ(osal_spinlock_init(&count_spinlock, &attr), OSAL_OK);
+
+  for (ulong i = 0; i < n_threads; i++) {
+    thread_params[i].thread_id = i;
+    thread_params[i].p_count_spinlock = &count_spinlock;
+    thread_params[i].p_counter = &counter;
+    thread_params[i].loopcount = loopcount;
+    thread_params[i].max_wait_time_nsec = 0;
+
+    ASSERT_EQ(pthread_create(&thread_ids[i], nullptr, test_random,
+                             (void *)&thread_params[i]),
+              0);
+  }
+  for (ulong i = 0; i < n_threads; i++) {
+    ASSERT_EQ(pthread_join(thread_ids[i], nullptr), 0);
+  }
+
+  osal_spinlock_stats_t stats;
+  if ((attr & OSAL_SPINLOCK_ATTR__STATS) != 0u) {
+    ASSERT_EQ(osal_spinlock_get_stats(&count_spinlock, &stats), OSAL_OK);
+    EXPECT_EQ(stats.locks, n_threads * loopcount);
+    EXPECT_LE(stats.contended, stats.locks);
+    EXPECT_LE(stats.max_spins, stats.spins);
+  } else {
+    EXPECT_EQ(osal_spinlock_get_stats(&count_spinlock, &stats),
+              OSAL_ERR_UNAVAILABLE);
+  }
+
+  EXPECT_EQ(osal_spinlock_destroy(&count_spinlock), OSAL_OK);
+  EXPECT_EQ(counter, n_threads * loopcount)
+      << "multi-threaded counter test failed";
+}
+
+TEST(SpinlockFunction, Algorithms) {
+  const osal_spinlock_attr_t attrs[] = {
+      OSAL_SPINLOCK_ATTR__ALGORITHM__TAS,
+      OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET,
+      OSAL_SPINLOCK_ATTR__ALGORITHM__MCS,
+      OSAL_SPINLOCK_ATTR__ALGORITHM__TAS | OSAL_SPINLOCK_ATTR__STATS,
+      OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET | OSAL_SPINLOCK_ATTR__STATS,
+      OSAL_SPINLOCK_ATTR__ALGORITHM__MCS | OSAL_SPINLOCK_ATTR__STATS,
+  };
+
+  for (osal_spinlock_attr_t attr : attrs) {
+    SCOPED_TRACE(testing::Message() << "attributes 0x" << std::hex << attr);
+    run_counter_threads(attr, 4, 10000);
+  }
+}
+
+TEST(SpinlockFunction, TryLock) {
+  const osal_spinlock_attr_t attrs[] = {
+      OSAL_SPINLOCK_ATTR__ALGORITHM__TAS,
+      OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET,
+      OSAL_SPINLOCK_ATTR__ALGORITHM__MCS,
+  };
+
+  for (osal_spinlock_attr_t attr : attrs) {
+    SCOPED_TRACE(testing::Message() << "attributes 0x" << std::hex << attr);
+    osal_spinlock_t my_spinlock;
+
+    ASSERT_EQ(osal_spinlock_init(&my_spinlock, &attr), OSAL_OK);
+    EXPECT_EQ(osal_spinlock_trylock(&my_spinlock), OSAL_OK);
+    EXPECT_EQ(osal_spinlock_trylock(&my_spinlock), OSAL_ERR_BUSY);
+    EXPECT_EQ(osal_spinlock_unlock(&my_spinlock), OSAL_OK);
+    EXPECT_EQ(osal_spinlock_lock(&my_spinlock), OSAL_OK);
+    EXPECT_EQ(osal_spinlock_unlock(&my_spinlock), OSAL_OK);
+    EXPECT_EQ(osal_spinlock_trylock(&my_spinlock), OSAL_OK);
+    EXPECT_EQ(osal_spinlock_unlock(&my_spinlock), OSAL_OK);
+    EXPECT_EQ(osal_spinlock_destroy(&my_spinlock), OSAL_OK);
+  }
+}
+
+TEST(SpinlockFunction, NestedMCS) {
+  const osal_spinlock_attr_t attr = OSAL_SPINLOCK_ATTR__ALGORITHM__MCS;
+  osal_spinlock_t locks[3];
+
+  for (osal_spinlock_t &lock : locks) {
+    ASSERT_EQ(osal_spinlock_init(&lock, &attr), OSAL_OK);
+    EXPECT_EQ(osal_spinlock_lock(&lock), OSAL_OK);
+  }
+
+  // release out of order
+  EXPECT_EQ(osal_spinlock_unlock(&locks[1]), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_unlock(&locks[0]), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_unlock(&locks[2]), OSAL_OK);
+
+  for (osal_spinlock_t &lock : locks) {
+    EXPECT_EQ(osal_spinlock_trylock(&lock), OSAL_OK);
+    EXPECT_EQ(osal_spinlock_unlock(&lock), OSAL_OK);
+  }
+}
+
+TEST(SpinlockFunction, Recursive) {
+  const osal_spinlock_attr_t attr = OSAL_SPINLOCK_ATTR__TYPE__RECURSIVE |
+                                    OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET;
+  osal_spinlock_t my_spinlock;
+
+  ASSERT_EQ(osal_spinlock_init(&my_spinlock, &attr), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_lock(&my_spinlock), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_lock(&my_spinlock), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_trylock(&my_spinlock), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_unlock(&my_spinlock), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_unlock(&my_spinlock), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_unlock(&my_spinlock), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_unlock(&my_spinlock), OSAL_ERR_PERMISSION_DENIED)
+      << "spinlock has to be released after last unlock";
+  EXPECT_EQ(osal_spinlock_trylock(&my_spinlock), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_unlock(&my_spinlock), OSAL_OK);
+}
+
+TEST(SpinlockFunction, ProcessShared) {
+  const osal_spinlock_attr_t attrs[] = {
+      OSAL_SPINLOCK_ATTR__PROCESS_SHARED | OSAL_SPINLOCK_ATTR__ALGORITHM__TAS,
+      OSAL_SPINLOCK_ATTR__PROCESS_SHARED |
+          OSAL_SPINLOCK_ATTR__ALGORITHM__TICKET,
+  };
+  const uint LOOPCOUNT = 20000;
+
+  typedef struct {
+    osal_spinlock_t lock;
+    unsigned long counter;
+  } shared_t;
+
+  shared_t *shared =
+      (shared_t *)mmap(nullptr, sizeof(shared_t), PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(shared, MAP_FAILED);
+
+  for (osal_spinlock_attr_t attr : attrs) {
+    SCOPED_TRACE(testing::Message() << "attributes 0x" << std::hex << attr);
+    shared->counter = 0;
+    ASSERT_EQ(osal_spinlock_init(&shared->lock, &attr), OSAL_OK);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+
+    for (uint i = 0; i < LOOPCOUNT; i++) {
+      osal_spinlock_lock(&shared->lock);
+      shared->counter = shared->counter + 1;
+      osal_spinlock_unlock(&shared->lock);
+    }
+
+    if (pid == 0) {
+      _exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_EQ(shared->counter, 2 * LOOPCOUNT);
+  }
+
+  munmap(shared, sizeof(shared_t));
+}
+
+TEST(SpinlockDetect, Relock) {
+  const osal_spinlock_attr_t attr = OSAL_SPINLOCK_ATTR__TYPE__ERRORCHECK;
+  osal_spinlock_t my_spinlock;
+
+  ASSERT_EQ(osal_spinlock_init(&my_spinlock, &attr), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_unlock(&my_spinlock), OSAL_ERR_PERMISSION_DENIED)
+      << "unlocked spinlock released";
+  EXPECT_EQ(osal_spinlock_lock(&my_spinlock), OSAL_OK);
+  EXPECT_EQ(osal_spinlock_lock(&my_spinlock), OSAL_ERR_DEAD_LOCK);
+  EXPECT_EQ(osal_spinlock_trylock(&my_spinlock), OSAL_ERR_DEAD_LOCK);
+  EXPECT_EQ(osal_spinlock_unlock(&my_spinlock), OSAL_OK);
+}
+
+TEST(SpinlockDetect, ForkedChild) {
+  const osal_spinlock_attr_t attr = OSAL_SPINLOCK_ATTR__PROCESS_SHARED |
+                                    OSAL_SPINLOCK_ATTR__TYPE__ERRORCHECK;
+
+  osal_spinlock_t *shared = (osal_spinlock_t *)mmap(
+      nullptr, sizeof(osal_spinlock_t), PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(shared, MAP_FAILED);
+  ASSERT_EQ(osal_spinlock_init(shared, &attr), OSAL_OK);
+
+  // parent holds the lock, the child is a different owner
+  ASSERT_EQ(osal_spinlock_lock(shared), OSAL_OK);
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+
+  if (pid == 0) {
+    int failed = 0;
+    if (osal_spinlock_trylock(shared) != OSAL_ERR_BUSY) {
+      failed |= 1;
+    }
+    if (osal_spinlock_unlock(shared) != OSAL_ERR_PERMISSION_DENIED) {
+      failed |= 2;
+    }
+    _exit(failed);
+  }
+
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0)
+      << "child must not be taken for the parent owning the lock";
+  EXPECT_EQ(osal_spinlock_unlock(shared), OSAL_OK);
+
+  munmap(shared, sizeof(osal_spinlock_t));
+}
+
+TEST(SpinlockReject, InvalidAttributes) {
+  const osal_spinlock_attr_t attrs[] = {
+      OSAL_SPINLOCK_ATTR__ROBUST,
+      OSAL_SPINLOCK_ATTR__PROTOCOL__INHERIT,
+      OSAL_SPINLOCK_ATTR__PROTOCOL__PROTECT |
+          (1u << OSAL_SPINLOCK_ATTR__PRIOCEILING__SHIFT),
+      OSAL_SPINLOCK_ATTR__ALGORITHM__MASK,
+      OSAL_SPINLOCK_ATTR__TYPE__MASK,
+      OSAL_SPINLOCK_ATTR__ALGORITHM__MCS | OSAL_SPINLOCK_ATTR__PROCESS_SHARED,
+  };
+
+  for (osal_spinlock_attr_t attr : attrs) {
+    osal_spinlock_t my_spinlock;
+    EXPECT_EQ(osal_spinlock_init(&my_spinlock, &attr), OSAL_ERR_INVALID_PARAM)
+        << "attributes 0x" << std::hex << attr;
+  }
+}
+
 } // namespace test_spinlock
 
 int main(int argc, char **argv) {
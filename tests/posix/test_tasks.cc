@@ -1,8 +1,13 @@
 #include "gtest/gtest.h"
+#include <cstring>
 #include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
 #include <vector>
 
 #include "libosal/osal.h"
+#include "libosal/cpuset.h"
 #include "libosal/task.h"
 #include "libosal/condvar.h"
 #include "libosal/mutex.h"
@@ -441,6 +446,7 @@ TEST(TasksMultithreadingConfig, TaskAttributes) {
   ASSERT_EQ(orv, OSAL_OK) << "osal_task_set_priority() failed";
 
   osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
   orv = osal_task_get_task_attr(&thread_id, &attr);
   ASSERT_EQ(orv, OSAL_OK) << "osal_task_get_task_attr() failed";
 
@@ -538,6 +544,377 @@ TEST(TasksMultithreadingFunction, SuspendResume) {
 
 } // namespace test_getattrs
 
+namespace test_create_join {
+
+const uint NUM_ITERATIONS = 200;
+
+void *test_set_flag(void *arg) {
+  __atomic_store_n((int *)arg, 1, __ATOMIC_RELEASE);
+  return nullptr;
+}
+
+/* creates and joins many short-lived tasks back to back. Every
+   task has to run and every create/join has to succeed, the
+   create latency is measured by libosal_bench (task_create). */
+TEST(TasksMultithreadingFunction, CreateJoinRepeated) {
+  osal_retval_t orv;
+
+  for (uint i = 0; i < NUM_ITERATIONS; i++) {
+    osal_task_t task;
+    int ran = 0;
+
+    orv = osal_task_create(&task, nullptr, test_set_flag, &ran);
+    ASSERT_EQ(orv, OSAL_OK) << "osal_task_create() failed";
+    orv = osal_task_join(&task, nullptr);
+    ASSERT_EQ(orv, OSAL_OK) << "osal_task_join() failed";
+
+    EXPECT_EQ(__atomic_load_n(&ran, __ATOMIC_ACQUIRE), 1) << "task did not run";
+  }
+}
+
+} // namespace test_create_join
+
+namespace test_cpuset {
+
+TEST(CpusetFunction, SetClearIterate) {
+  osal_cpuset_t set;
+  osal_cpuset_zero(&set);
+  EXPECT_EQ(osal_cpuset_count(&set), 0u);
+  EXPECT_EQ(osal_cpuset_next(&set, 0), OSAL_CPUSET_SIZE);
+
+  const osal_uint32_t cpus[] = {0, 31, 32, 63, 64, 1000, OSAL_CPUSET_SIZE - 1};
+  for (osal_uint32_t cpu : cpus) {
+    EXPECT_EQ(osal_cpuset_set(&set, cpu), OSAL_OK) << "cpu " << cpu;
+  }
+  EXPECT_EQ(osal_cpuset_count(&set), 7u);
+  EXPECT_EQ(osal_cpuset_isset(&set, 1000), OSAL_TRUE);
+  EXPECT_EQ(osal_cpuset_isset(&set, 999), OSAL_FALSE);
+
+  std::vector<osal_uint32_t> found;
+  for (osal_uint32_t cpu = osal_cpuset_next(&set, 0); cpu < OSAL_CPUSET_SIZE;
+       cpu = osal_cpuset_next(&set, cpu + 1)) {
+    found.push_back(cpu);
+  }
+  EXPECT_EQ(found, std::vector<osal_uint32_t>(std::begin(cpus), std::end(cpus)));
+
+  EXPECT_EQ(osal_cpuset_clear(&set, 1000), OSAL_OK);
+  EXPECT_EQ(osal_cpuset_next(&set, 65), OSAL_CPUSET_SIZE - 1);
+
+  // only the first 32 cpus fit into an affinity mask
+  EXPECT_EQ(osal_cpuset_to_mask(&set), 0x80000001u);
+  osal_cpuset_t mask;
+  osal_cpuset_from_mask(&mask, 0x80000001u);
+  osal_cpuset_t both;
+  osal_cpuset_and(&both, &set, &mask);
+  EXPECT_EQ(osal_cpuset_count(&both), 2u);
+  osal_cpuset_or(&both, &set, &mask);
+  EXPECT_EQ(osal_cpuset_count(&both), 6u);
+}
+
+TEST(CpusetFunction, ParseList) {
+  osal_cpuset_t set;
+
+  EXPECT_EQ(osal_cpuset_parse(&set, "0-3,8,10-15:2,100\n"), OSAL_OK);
+  EXPECT_EQ(osal_cpuset_count(&set), 9u);
+  EXPECT_EQ(osal_cpuset_isset(&set, 3), OSAL_TRUE);
+  EXPECT_EQ(osal_cpuset_isset(&set, 12), OSAL_TRUE);
+  EXPECT_EQ(osal_cpuset_isset(&set, 13), OSAL_FALSE);
+  EXPECT_EQ(osal_cpuset_isset(&set, 100), OSAL_TRUE);
+
+  EXPECT_EQ(osal_cpuset_parse(&set, "\n"), OSAL_OK) << "empty list";
+  EXPECT_EQ(osal_cpuset_count(&set), 0u);
+}
+
+TEST(CpusetReject, InvalidInput) {
+  osal_cpuset_t set;
+  osal_cpuset_zero(&set);
+
+  EXPECT_EQ(osal_cpuset_set(&set, OSAL_CPUSET_SIZE), OSAL_ERR_INVALID_PARAM);
+  EXPECT_EQ(osal_cpuset_clear(&set, OSAL_CPUSET_SIZE), OSAL_ERR_INVALID_PARAM);
+  EXPECT_EQ(osal_cpuset_isset(&set, OSAL_CPUSET_SIZE), OSAL_FALSE);
+
+  const char *lists[] = {"a", "1-", "3-1", "1,", "1,,2", "1-4:0", "4096",
+                         "99999999999", "0-3 x"};
+  for (const char *list : lists) {
+    EXPECT_EQ(osal_cpuset_parse(&set, list), OSAL_ERR_INVALID_PARAM)
+        << "list \"" << list << "\"";
+  }
+}
+
+typedef struct {
+  int cpu;
+  osal_retval_t ret;
+  osal_task_attr_t attr;
+} cpuset_param_t;
+
+void *test_report(void *p_params) {
+  cpuset_param_t *params = (cpuset_param_t *)p_params;
+  osal_task_t self;
+
+  self.tid = pthread_self();
+  params->cpu = sched_getcpu();
+  params->ret = osal_task_get_task_attr(&self, &params->attr);
+
+  return nullptr;
+}
+
+TEST(TasksMultithreadingConfig, Cpuset) {
+  osal_cpuset_t allowed;
+  ASSERT_EQ(osal_task_get_cpuset(nullptr, &allowed), OSAL_OK);
+  ASSERT_GT(osal_cpuset_count(&allowed), 0u);
+  EXPECT_EQ(osal_cpuset_isset(&allowed, sched_getcpu()), OSAL_TRUE);
+
+  // 32 bit api wraps the cpu set
+  osal_task_sched_affinity_t affinity;
+  EXPECT_EQ(osal_task_get_affinity(nullptr, &affinity), OSAL_OK);
+  EXPECT_EQ(affinity, osal_cpuset_to_mask(&allowed));
+
+  // pin a task to the last allowed cpu
+  osal_uint32_t last = 0;
+  for (osal_uint32_t cpu = osal_cpuset_next(&allowed, 0); cpu < OSAL_CPUSET_SIZE;
+       cpu = osal_cpuset_next(&allowed, cpu + 1)) {
+    last = cpu;
+  }
+
+  osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
+  osal_cpuset_set(&attr.cpuset, last);
+  attr.flags = OSAL_TASK_ATTR__CPUSET;
+  attr.affinity = 0x1u; // ignored, cpu set takes precedence
+
+  cpuset_param_t params = {};
+  osal_task_t task;
+  ASSERT_EQ(osal_task_create(&task, &attr, test_report, &params), OSAL_OK);
+  EXPECT_EQ(osal_task_join(&task, nullptr), OSAL_OK);
+
+  EXPECT_EQ(params.cpu, (int)last);
+  EXPECT_EQ(params.ret, OSAL_OK);
+  EXPECT_EQ(osal_cpuset_count(&params.attr.cpuset), 1u);
+  EXPECT_EQ(osal_cpuset_isset(&params.attr.cpuset, last), OSAL_TRUE);
+  EXPECT_EQ(params.attr.numa_nodes, 0u);
+
+  osal_cpuset_t empty;
+  osal_cpuset_zero(&empty);
+  EXPECT_EQ(osal_task_set_cpuset(nullptr, &empty), OSAL_ERR_INVALID_PARAM);
+  EXPECT_EQ(osal_task_set_cpuset(nullptr, &allowed), OSAL_OK);
+}
+
+TEST(TasksMultithreadingConfig, NumaNode) {
+  if (access("/sys/devices/system/node/node0", F_OK) != 0) {
+    GTEST_SKIP() << "no numa support";
+  }
+
+  osal_cpuset_t node_cpus;
+  FILE *fp = fopen("/sys/devices/system/node/node0/cpulist", "r");
+  ASSERT_NE(fp, nullptr);
+  char list[1024] = "";
+  ASSERT_NE(fgets(list, sizeof(list), fp), nullptr);
+  fclose(fp);
+  ASSERT_EQ(osal_cpuset_parse(&node_cpus, list), OSAL_OK);
+
+  osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
+  attr.numa_nodes = 0x1u;
+  attr.flags = OSAL_TASK_ATTR__NUMA_NODES;
+
+  cpuset_param_t params = {};
+  osal_task_t task;
+  ASSERT_EQ(osal_task_create(&task, &attr, test_report, &params), OSAL_OK);
+  EXPECT_EQ(osal_task_join(&task, nullptr), OSAL_OK);
+
+  EXPECT_EQ(params.ret, OSAL_OK);
+  EXPECT_EQ(params.attr.numa_nodes, 0x1u) << "memory not bound to node 0";
+  EXPECT_EQ(memcmp(&params.attr.cpuset, &node_cpus, sizeof(node_cpus)), 0)
+      << "task not bound to cpus of node 0";
+  EXPECT_EQ(osal_cpuset_isset(&node_cpus, params.cpu), OSAL_TRUE);
+
+  EXPECT_EQ(osal_task_bind_numa(0), OSAL_ERR_INVALID_PARAM) << "no node";
+  EXPECT_EQ(osal_task_bind_numa((osal_uint64_t)1 << 63),
+            OSAL_ERR_INVALID_PARAM)
+      << "missing node";
+}
+
+} // namespace test_cpuset
+
+namespace test_stack {
+
+#define STACK_SIZE (1024 * 1024)
+#define STACK_USE (512 * 1024)
+
+typedef struct {
+  int policy;
+  int priority;
+  char *stack_pos;
+  long faults;
+  osal_retval_t ret;
+  osal_task_attr_t attr;
+} stack_param_t;
+
+static long thread_minor_faults() {
+  struct rusage usage;
+  getrusage(RUSAGE_THREAD, &usage);
+  return usage.ru_minflt;
+}
+
+// uses depth * 4 KiB of stack
+static __attribute__((noinline)) int use_stack(int depth) {
+  volatile char frame[4096];
+  frame[0] = (char)depth;
+  frame[sizeof(frame) - 1] = (char)depth;
+
+  return depth > 0 ? use_stack(depth - 1) + frame[0] : frame[sizeof(frame) - 1];
+}
+
+void *test_report(void *p_params) {
+  stack_param_t *params = (stack_param_t *)p_params;
+  struct sched_param param;
+  osal_task_t self;
+  char local = 0;
+
+  // scheduling has to be set before the handler runs
+  pthread_getschedparam(pthread_self(), &params->policy, &param);
+  params->priority = param.sched_priority;
+  params->stack_pos = &local;
+
+  long before = thread_minor_faults();
+  use_stack(STACK_USE / 4096);
+  params->faults = thread_minor_faults() - before;
+
+  self.tid = pthread_self();
+  params->ret = osal_task_get_task_attr(&self, &params->attr);
+
+  return nullptr;
+}
+
+TEST(TasksMultithreadingConfig, StackSize) {
+  osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
+  attr.stack_size = STACK_SIZE;
+  attr.guard_size = 64 * 1024;
+  attr.flags = OSAL_TASK_ATTR__STACK;
+
+  stack_param_t params = {};
+  osal_task_t task;
+  ASSERT_EQ(osal_task_create(&task, &attr, test_report, &params), OSAL_OK);
+  EXPECT_EQ(osal_task_join(&task, nullptr), OSAL_OK);
+
+  EXPECT_EQ(params.ret, OSAL_OK);
+  EXPECT_GE(params.attr.stack_size, (osal_size_t)STACK_SIZE - attr.guard_size);
+  EXPECT_LE(params.attr.stack_size, (osal_size_t)STACK_SIZE);
+  EXPECT_EQ(params.attr.guard_size, attr.guard_size);
+
+  attr.flags = OSAL_TASK_ATTR__STACK | OSAL_TASK_ATTR__NO_GUARD;
+  ASSERT_EQ(osal_task_create(&task, &attr, test_report, &params), OSAL_OK);
+  EXPECT_EQ(osal_task_join(&task, nullptr), OSAL_OK);
+  EXPECT_EQ(params.attr.guard_size, 0u);
+}
+
+TEST(TasksMultithreadingConfig, CallerStack) {
+  void *stack = nullptr;
+  ASSERT_EQ(posix_memalign(&stack, 4096, STACK_SIZE), 0);
+
+  osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
+  attr.stack = stack;
+  attr.stack_size = STACK_SIZE;
+  attr.flags = OSAL_TASK_ATTR__STACK;
+
+  stack_param_t params = {};
+  osal_task_t task;
+  ASSERT_EQ(osal_task_create(&task, &attr, test_report, &params), OSAL_OK);
+  EXPECT_EQ(osal_task_join(&task, nullptr), OSAL_OK);
+
+  EXPECT_GE(params.stack_pos, (char *)stack);
+  EXPECT_LT(params.stack_pos, (char *)stack + STACK_SIZE)
+      << "task does not run on the caller stack";
+
+  free(stack);
+}
+
+TEST(TasksMultithreadingConfig, StackPrefault) {
+  osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
+  attr.stack_size = STACK_SIZE;
+  attr.flags = OSAL_TASK_ATTR__STACK | OSAL_TASK_ATTR__STACK_PREFAULT;
+
+  stack_param_t params = {};
+  osal_task_t task;
+  ASSERT_EQ(osal_task_create(&task, &attr, test_report, &params), OSAL_OK);
+  EXPECT_EQ(osal_task_join(&task, nullptr), OSAL_OK);
+
+  EXPECT_LT(params.faults, 4) << "prefaulted stack must not fault";
+}
+
+TEST(TasksMultithreadingConfig, PolicyAtCreation) {
+  osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
+  attr.policy = OSAL_SCHED_POLICY_FIFO;
+  attr.priority = 10;
+
+  stack_param_t params = {};
+  osal_task_t task;
+  osal_retval_t orv = osal_task_create(&task, &attr, test_report, &params);
+  if (orv == OSAL_ERR_PERMISSION_DENIED) {
+    GTEST_SKIP() << "no permission for real-time policy";
+  }
+  ASSERT_EQ(orv, OSAL_OK);
+  EXPECT_EQ(osal_task_join(&task, nullptr), OSAL_OK);
+
+  EXPECT_EQ(params.policy, SCHED_FIFO);
+  EXPECT_EQ(params.priority, 10);
+
+  // out of range priorities are clamped
+  attr.policy = OSAL_SCHED_POLICY_OTHER;
+  ASSERT_EQ(osal_task_create(&task, &attr, test_report, &params), OSAL_OK);
+  EXPECT_EQ(osal_task_join(&task, nullptr), OSAL_OK);
+
+  EXPECT_EQ(params.policy, SCHED_OTHER);
+  EXPECT_EQ(params.priority, 0);
+}
+
+TEST(TasksMultithreadingReject, InvalidStack) {
+  osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
+  stack_param_t params = {};
+  osal_task_t task;
+  char stack[64];
+
+  attr.flags = OSAL_TASK_ATTR__STACK;
+  attr.stack_size = 1;
+  EXPECT_EQ(osal_task_create(&task, &attr, test_report, &params),
+            OSAL_ERR_INVALID_PARAM)
+      << "stack below minimum";
+
+  attr.stack = stack;
+  attr.stack_size = 0;
+  EXPECT_EQ(osal_task_create(&task, &attr, test_report, &params),
+            OSAL_ERR_INVALID_PARAM)
+      << "caller stack without size";
+}
+
+TEST(TasksMultithreadingConfig, UnsetFieldsIgnored) {
+  osal_task_attr_t attr;
+  osal_task_attr_init(&attr);
+  stack_param_t params = {};
+  osal_task_t task;
+
+  // fields without their flag bit are never read
+  attr.stack = &params;
+  attr.stack_size = 1;
+  attr.guard_size = 1;
+  attr.numa_nodes = (osal_uint64_t)1 << 63;
+  osal_cpuset_set(&attr.cpuset, OSAL_CPUSET_SIZE - 1);
+
+  ASSERT_EQ(osal_task_create(&task, &attr, test_report, &params), OSAL_OK);
+  EXPECT_EQ(osal_task_join(&task, nullptr), OSAL_OK);
+
+  EXPECT_EQ(params.ret, OSAL_OK);
+  EXPECT_NE(params.attr.stack_size, 1u);
+  EXPECT_NE(params.attr.flags & OSAL_TASK_ATTR__STACK, 0u);
+}
+
+} // namespace test_stack
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
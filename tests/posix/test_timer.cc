@@ -4,11 +4,13 @@
 #include <stdlib.h>
 #include <sys/mman.h>
 #include <time.h>
+#include <algorithm>
 #include <vector>
 
 #include "libosal/osal.h"
 #include "libosal/timer.h"
 #include "test_utils.h"
+#include "posix/tsc.h"
 #include <sched.h>
 
 namespace test_timer {
@@ -469,6 +471,163 @@ TEST(TimerFunction, BusyWait) {
   EXPECT_GE(stop, now + delta) << "osal_busy_wait incorrect delta";
 }
 
+TEST(TimerFunction, TscClockSource) {
+  const int old_clock = osal_timer_get_clock_source();
+
+  osal_timer_set_clock_source(LIBOSAL_CLOCK_TSC);
+  if (osal_timer_get_clock_source() != LIBOSAL_CLOCK_TSC) {
+    EXPECT_EQ(osal_timer_get_clock_source(), CLOCK_MONOTONIC)
+        << "without invariant TSC CLOCK_MONOTONIC has to be selected";
+    osal_timer_set_clock_source(old_clock);
+    GTEST_SKIP() << "no invariant TSC";
+  }
+
+  // has to follow CLOCK_MONOTONIC closely and never go back. The filter
+  // only drops samples preempted between the readings, so a round disturbed
+  // otherwise is retried before failing on the difference.
+  osal_uint64_t max_diff = 0;
+  osal_uint32_t backwards = 0;
+  for (int round = 0; round < 3; round++) {
+    osal_uint64_t last = 0;
+    const osal_uint64_t end = osal_timer_gettime_nsec() + 1500000000;
+    osal_uint64_t next_resync = 0;
+
+    max_diff = 0;
+    for (osal_uint64_t now = 0; now < end;) {
+      if (now >= next_resync) {
+        EXPECT_EQ(osal_timer_tsc_resync(), OSAL_OK);
+        next_resync = now + 100000000;
+      }
+
+      timespec ts[2];
+      clock_gettime(CLOCK_MONOTONIC, &ts[0]);
+      now = osal_timer_gettime_nsec();
+      clock_gettime(CLOCK_MONOTONIC, &ts[1]);
+      if (now < last) {
+        backwards++;
+      }
+      last = now;
+
+      osal_uint64_t mono[2];
+      for (int i = 0; i < 2; i++) {
+        mono[i] = ts[i].tv_sec * 1000000000ull + ts[i].tv_nsec;
+      }
+      if ((mono[1] - mono[0]) > 10000) {
+        continue; // preempted, sample is not meaningful
+      }
+      osal_uint64_t diff = now < mono[0]   ? mono[0] - now
+                           : now > mono[1] ? now - mono[1]
+                                           : 0;
+      max_diff = std::max(max_diff, diff);
+    }
+
+    if (max_diff < 50000u) {
+      break;
+    }
+  }
+
+  EXPECT_EQ(backwards, 0u) << "TSC time went backwards";
+  EXPECT_LT(max_diff, 50000u) << "TSC time differs from CLOCK_MONOTONIC";
+
+  // both interfaces read the same clock
+  osal_timer_t tmr;
+  osal_uint64_t before = osal_timer_gettime_nsec();
+  EXPECT_EQ(osal_timer_gettime(&tmr), OSAL_OK);
+  osal_uint64_t after = osal_timer_gettime_nsec();
+  EXPECT_GE(osal_timer_to_nsec(&tmr), before);
+  EXPECT_LE(osal_timer_to_nsec(&tmr), after);
+
+  const int loops = 1000000;
+  osal_uint64_t start = osal_timer_gettime_nsec();
+  for (int i = 0; i < loops; i++) {
+    osal_timer_gettime_nsec();
+  }
+  osal_uint64_t tsc_cost = (osal_timer_gettime_nsec() - start) / loops;
+
+  osal_timer_set_clock_source(old_clock);
+  EXPECT_EQ(osal_timer_get_clock_source(), old_clock);
+  EXPECT_EQ(osal_timer_tsc_resync(), OSAL_ERR_UNAVAILABLE);
+
+  start = osal_timer_gettime_nsec();
+  for (int i = 0; i < loops; i++) {
+    osal_timer_gettime_nsec();
+  }
+  osal_uint64_t clock_cost = (osal_timer_gettime_nsec() - start) / loops;
+
+  printf("osal_timer_gettime_nsec: TSC %lu ns, clock_gettime %lu ns, max "
+         "diff to CLOCK_MONOTONIC %lu ns\n",
+         (unsigned long)tsc_cost, (unsigned long)clock_cost,
+         (unsigned long)max_diff);
+}
+
+// difference of TSC time and CLOCK_MONOTONIC in [ns]
+static osal_int64_t tsc_offset() {
+  osal_int64_t best = INT64_MAX;
+  osal_int64_t ret = 0;
+
+  for (int i = 0; i < 5; i++) {
+    timespec ts[2];
+    clock_gettime(CLOCK_MONOTONIC, &ts[0]);
+    osal_uint64_t now = osal_timer_gettime_nsec();
+    clock_gettime(CLOCK_MONOTONIC, &ts[1]);
+
+    osal_int64_t mono[2];
+    for (int j = 0; j < 2; j++) {
+      mono[j] = ts[j].tv_sec * 1000000000ll + ts[j].tv_nsec;
+    }
+    if ((mono[1] - mono[0]) < best) {
+      best = mono[1] - mono[0];
+      ret = (osal_int64_t)now - ((mono[0] + mono[1]) / 2);
+    }
+  }
+
+  return ret;
+}
+
+TEST(TimerFunction, TscResyncAfterFastDrift) {
+  const int old_clock = osal_timer_get_clock_source();
+
+  osal_timer_set_clock_source(LIBOSAL_CLOCK_TSC);
+  if (osal_timer_get_clock_source() != LIBOSAL_CLOCK_TSC) {
+    osal_timer_set_clock_source(old_clock);
+    GTEST_SKIP() << "no invariant TSC";
+  }
+
+  // TSC time 800 ms ahead, too far to be steered out in one interval
+  EXPECT_EQ(osal_timer_tsc_resync(), OSAL_OK);
+  posix_timer_tsc_skew(800000000);
+  osal_int64_t before = tsc_offset();
+  EXPECT_GT(before, 700000000);
+
+  osal_uint64_t last = osal_timer_gettime_nsec();
+  EXPECT_EQ(osal_timer_tsc_resync(), OSAL_OK);
+
+  osal_uint32_t backwards = 0;
+  const osal_uint64_t end = last + 200000000;
+  for (osal_uint64_t now = last; now < end;) {
+    now = osal_timer_gettime_nsec();
+    if (now < last) {
+      backwards++;
+    }
+    last = now;
+  }
+  EXPECT_EQ(backwards, 0u) << "resync stepped the TSC time back";
+
+  // half rate for 200 ms catches up 100 ms
+  osal_int64_t after = tsc_offset();
+  EXPECT_LT(after, before - 50000000) << "offset is not steered out";
+  EXPECT_GT(after, 0) << "caught up too fast";
+
+  // TSC time behind is stepped forward
+  posix_timer_tsc_skew(-2 * after - 800000000);
+  last = osal_timer_gettime_nsec();
+  EXPECT_EQ(osal_timer_tsc_resync(), OSAL_OK);
+  EXPECT_GE(osal_timer_gettime_nsec(), last);
+  EXPECT_LT(std::abs(tsc_offset()), 10000000) << "offset is not stepped out";
+
+  osal_timer_set_clock_source(old_clock);
+}
+
 } // namespace test_timer
 
 int main(int argc, char **argv) {
@@ -0,0 +1,286 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include "libosal/osal.h"
+#include "libosal/semaphore.h"
+#include "libosal/timer.h"
+#include "libosal/timer_service.h"
+
+namespace test_timer_service {
+
+const osal_uint64_t MSEC = 1000000;
+
+typedef struct {
+  osal_uint64_t deadline;
+  std::atomic<osal_uint64_t> fired; // time of last expiry, 0 if none
+  std::atomic<osal_uint32_t> count;
+} record_t;
+
+static void record_handler(osal_void_t *arg) {
+  record_t *rec = (record_t *)arg;
+
+  rec->fired = osal_timer_gettime_nsec();
+  rec->count++;
+}
+
+static void init_service(osal_timer_service_t *svc, osal_uint64_t resolution) {
+  osal_timer_service_attr_t attr = {};
+  osal_task_attr_init(&attr.task_attr);
+  attr.resolution = resolution;
+  ASSERT_EQ(osal_timer_service_init(svc, &attr), OSAL_OK);
+}
+
+TEST(TimerServiceFunction, OneShotHandlers) {
+  osal_timer_service_t svc;
+  init_service(&svc, 0);
+
+  const osal_uint64_t timeouts[] = {0, 1 * MSEC, 5 * MSEC, 20 * MSEC,
+                                    300 * MSEC};
+  const int cnt = sizeof(timeouts) / sizeof(timeouts[0]);
+  std::vector<osal_timer_service_timer_t> timers(cnt);
+  std::vector<record_t> records(cnt);
+
+  for (int i = 0; i < cnt; i++) {
+    osal_timer_service_timer_init(&timers[i], record_handler, &records[i]);
+    records[i].deadline = osal_timer_gettime_nsec() + timeouts[i];
+    EXPECT_EQ(osal_timer_service_arm(&svc, &timers[i], timeouts[i], 0),
+              OSAL_OK);
+  }
+
+  osal_sleep_until_nsec(records[cnt - 1].deadline + 100 * MSEC);
+
+  for (int i = 0; i < cnt; i++) {
+    EXPECT_EQ(records[i].count.load(), 1u) << "timer " << i;
+    EXPECT_GE(records[i].fired.load(), records[i].deadline)
+        << "timer " << i << " expired early";
+    EXPECT_EQ(osal_timer_service_cancel(&svc, &timers[i]),
+              OSAL_ERR_NOT_FOUND)
+        << "expired one-shot timer is not armed";
+  }
+
+  osal_timer_service_stats_t stats;
+  osal_timer_service_get_stats(&svc, &stats);
+  EXPECT_EQ(stats.expired, (osal_uint64_t)cnt);
+  printf("max latency %lu ns\n", (unsigned long)stats.max_latency);
+
+  EXPECT_EQ(osal_timer_service_destroy(&svc), OSAL_OK);
+}
+
+TEST(TimerServiceFunction, PeriodicAndCancel) {
+  osal_timer_service_t svc;
+  init_service(&svc, 100000);
+
+  osal_timer_service_timer_t tmr;
+  record_t rec = {};
+  osal_timer_service_timer_init(&tmr, record_handler, &rec);
+
+  osal_uint64_t start = osal_timer_gettime_nsec();
+  EXPECT_EQ(osal_timer_service_arm(&svc, &tmr, 2 * MSEC, 2 * MSEC), OSAL_OK);
+  osal_sleep_until_nsec(start + 101 * MSEC);
+  EXPECT_EQ(osal_timer_service_cancel(&svc, &tmr), OSAL_OK)
+      << "periodic timer stays armed";
+  osal_uint64_t end = osal_timer_gettime_nsec();
+
+  osal_timer_service_stats_t stats;
+  osal_timer_service_get_stats(&svc, &stats);
+  osal_uint32_t count = rec.count.load();
+  // the last expiry at 100 ms may still be pending
+  EXPECT_GE(count + stats.missed, 49u) << "one expiry per period";
+  EXPECT_LE(count + stats.missed, (end - start) / (2 * MSEC))
+      << "one expiry per period";
+
+  osal_sleep_until_nsec(osal_timer_gettime_nsec() + 10 * MSEC);
+  EXPECT_EQ(rec.count.load(), count) << "cancelled timer expired";
+
+  EXPECT_EQ(osal_timer_service_destroy(&svc), OSAL_OK);
+}
+
+TEST(TimerServiceFunction, PostSemaphore) {
+  osal_timer_service_t svc;
+  init_service(&svc, 0);
+
+  osal_semaphore_t sem;
+  ASSERT_EQ(osal_semaphore_init(&sem, NULL, 0), OSAL_OK);
+
+  osal_timer_service_timer_t tmr;
+  osal_timer_service_timer_init_semaphore(&tmr, &sem);
+
+  osal_uint64_t start = osal_timer_gettime_nsec();
+  EXPECT_EQ(osal_timer_service_arm(&svc, &tmr, 5 * MSEC, 5 * MSEC), OSAL_OK);
+
+  for (int i = 1; i <= 10; i++) {
+    osal_timer_t to;
+    osal_timer_init(&to, 1000 * MSEC);
+    ASSERT_EQ(osal_semaphore_timedwait(&sem, &to), OSAL_OK);
+    EXPECT_GE(osal_timer_gettime_nsec(), start + i * 5 * MSEC)
+        << "post " << i << " came early";
+  }
+
+  EXPECT_EQ(osal_timer_service_cancel(&svc, &tmr), OSAL_OK);
+  EXPECT_EQ(osal_timer_service_destroy(&svc), OSAL_OK);
+  EXPECT_EQ(osal_semaphore_destroy(&sem), OSAL_OK);
+}
+
+typedef struct {
+  osal_timer_service_t *svc;
+  osal_timer_service_timer_t tmr;
+  std::atomic<osal_uint32_t> count;
+} chain_t;
+
+static void chain_handler(osal_void_t *arg) {
+  chain_t *chain = (chain_t *)arg;
+
+  if (++chain->count < 10u) {
+    osal_timer_service_arm(chain->svc, &chain->tmr, MSEC, 0);
+  }
+}
+
+TEST(TimerServiceFunction, ArmFromHandler) {
+  osal_timer_service_t svc;
+  init_service(&svc, 0);
+
+  chain_t chain;
+  chain.svc = &svc;
+  chain.count = 0;
+  osal_timer_service_timer_init(&chain.tmr, chain_handler, &chain);
+
+  osal_uint64_t start = osal_timer_gettime_nsec();
+  osal_timer_service_arm(&svc, &chain.tmr, MSEC, 0);
+  while ((chain.count.load() < 10u) &&
+         (osal_timer_gettime_nsec() < start + 1000 * MSEC)) {
+    osal_sleep(MSEC);
+  }
+
+  EXPECT_EQ(chain.count.load(), 10u);
+  EXPECT_GE(osal_timer_gettime_nsec(), start + 10 * MSEC);
+
+  EXPECT_EQ(osal_timer_service_destroy(&svc), OSAL_OK);
+}
+
+TEST(TimerServiceFunction, ManyTimersAllLevels) {
+  // 1 us ticks, timeouts of 50 to 200 ms are put to the second and third
+  // wheel level and cascaded down to the first
+  osal_timer_service_t svc;
+  init_service(&svc, 1000);
+
+  const int cnt = 4000;
+  std::vector<osal_timer_service_timer_t> timers(cnt);
+  std::vector<record_t> records(cnt);
+  std::mt19937 gen(4711);
+  std::uniform_int_distribution<osal_uint64_t> timeout(50 * MSEC, 200 * MSEC);
+
+  for (int i = 0; i < cnt; i++) {
+    osal_timer_service_timer_init(&timers[i], record_handler, &records[i]);
+    osal_uint64_t to = timeout(gen);
+    records[i].deadline = osal_timer_gettime_nsec() + to;
+    osal_timer_service_arm(&svc, &timers[i], to, 0);
+  }
+
+  // cancel every third timer, re-arm every fifth of the others
+  for (int i = 0; i < cnt; i++) {
+    if ((i % 3) == 0) {
+      EXPECT_EQ(osal_timer_service_cancel(&svc, &timers[i]), OSAL_OK);
+    } else if ((i % 5) == 0) {
+      osal_uint64_t to = timeout(gen);
+      records[i].deadline = osal_timer_gettime_nsec() + to;
+      osal_timer_service_arm(&svc, &timers[i], to, 0);
+    }
+  }
+
+  osal_sleep_until_nsec(osal_timer_gettime_nsec() + 300 * MSEC);
+
+  int wrong = 0;
+  int early = 0;
+  for (int i = 0; i < cnt; i++) {
+    osal_uint32_t expected = (i % 3) == 0 ? 0u : 1u;
+
+    if (records[i].count.load() != expected) {
+      wrong++;
+    } else if ((expected == 1u) &&
+               (records[i].fired.load() < records[i].deadline)) {
+      early++;
+    }
+  }
+
+  EXPECT_EQ(wrong, 0) << "timers have to expire once, cancelled ones never";
+  EXPECT_EQ(early, 0) << "timers expired early";
+
+  EXPECT_EQ(osal_timer_service_destroy(&svc), OSAL_OK);
+}
+
+TEST(TimerServiceFunction, BeyondWheelSpan) {
+  // 1 ns ticks, the wheel spans about 4.3 s
+  osal_timer_service_t svc;
+  init_service(&svc, 1);
+
+  osal_timer_service_timer_t tmr;
+  record_t rec = {};
+  osal_timer_service_timer_init(&tmr, record_handler, &rec);
+
+  rec.deadline = osal_timer_gettime_nsec() + 4500 * MSEC;
+  osal_timer_service_arm(&svc, &tmr, 4500 * MSEC, 0);
+
+  osal_sleep_until_nsec(rec.deadline - 10 * MSEC);
+  EXPECT_EQ(rec.count.load(), 0u) << "parked timer expired early";
+
+  osal_sleep_until_nsec(rec.deadline + 100 * MSEC);
+  EXPECT_EQ(rec.count.load(), 1u);
+  EXPECT_GE(rec.fired.load(), rec.deadline);
+
+  EXPECT_EQ(osal_timer_service_destroy(&svc), OSAL_OK);
+}
+
+TEST(TimerServiceConfig, ClockSources) {
+  const int old_clock = osal_timer_get_clock_source();
+  const int clocks[] = {CLOCK_REALTIME, CLOCK_MONOTONIC, LIBOSAL_CLOCK_TSC};
+
+  for (int clock : clocks) {
+    osal_timer_set_clock_source(clock);
+
+    osal_timer_service_t svc;
+    init_service(&svc, 0);
+
+    osal_timer_service_timer_t tmr;
+    record_t rec = {};
+    osal_timer_service_timer_init(&tmr, record_handler, &rec);
+
+    rec.deadline = osal_timer_gettime_nsec() + 10 * MSEC;
+    osal_timer_service_arm(&svc, &tmr, 10 * MSEC, 0);
+    osal_sleep_until_nsec(rec.deadline + 50 * MSEC);
+
+    EXPECT_EQ(rec.count.load(), 1u) << "clock " << clock;
+    EXPECT_GE(rec.fired.load(), rec.deadline) << "clock " << clock;
+
+    EXPECT_EQ(osal_timer_service_destroy(&svc), OSAL_OK);
+  }
+
+  osal_timer_set_clock_source(old_clock);
+}
+
+TEST(TimerServiceReject, CancelNotArmed) {
+  osal_timer_service_t svc;
+  init_service(&svc, 0);
+
+  osal_timer_service_timer_t tmr;
+  record_t rec = {};
+  osal_timer_service_timer_init(&tmr, record_handler, &rec);
+
+  EXPECT_EQ(osal_timer_service_cancel(&svc, &tmr), OSAL_ERR_NOT_FOUND);
+
+  osal_timer_service_arm(&svc, &tmr, 1000 * MSEC, 0);
+  EXPECT_EQ(osal_timer_service_cancel(&svc, &tmr), OSAL_OK);
+  EXPECT_EQ(osal_timer_service_cancel(&svc, &tmr), OSAL_ERR_NOT_FOUND)
+      << "second cancel";
+
+  EXPECT_EQ(osal_timer_service_destroy(&svc), OSAL_OK);
+}
+
+} // namespace test_timer_service
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
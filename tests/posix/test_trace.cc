@@ -49,6 +49,391 @@ TEST(TraceFunction, SingleThreaded) {
 
 } // namespace test_trace
 
+namespace test_trace_mp {
+
+const osal_uint32_t N_PRODUCERS = 4;
+const osal_uint32_t NUM_POINTS = 20000;
+
+typedef struct {
+  osal_trace_t *trace;
+  osal_uint32_t id;
+  osal_retval_t orv;
+  osal_uint32_t *p_finished;
+} producer_param_t;
+
+void *producer(void *arg) {
+  producer_param_t *params = (producer_param_t *)arg;
+
+  params->orv = osal_trace_register(params->trace, &params->id);
+  if (params->orv == OSAL_OK) {
+    for (osal_uint32_t i = 0; i < NUM_POINTS; i++) {
+      osal_trace_point(params->trace);
+    }
+  }
+
+  if (params->p_finished != nullptr) {
+    __atomic_fetch_add(params->p_finished, 1, __ATOMIC_RELEASE);
+  }
+
+  return nullptr;
+}
+
+TEST(TraceFunction, MultiProducerMerge) {
+  osal_trace_t *tracep;
+  osal_retval_t orv;
+
+  orv = osal_trace_alloc_mp(&tracep, N_PRODUCERS, NUM_POINTS);
+  ASSERT_EQ(orv, OSAL_OK) << "osal_trace_alloc_mp() failed";
+
+  producer_param_t params[N_PRODUCERS];
+  pthread_t threads[N_PRODUCERS];
+  for (osal_uint32_t i = 0; i < N_PRODUCERS; i++) {
+    params[i].trace = tracep;
+    params[i].p_finished = nullptr;
+    ASSERT_EQ(pthread_create(&threads[i], nullptr, producer, &params[i]), 0);
+  }
+  for (osal_uint32_t i = 0; i < N_PRODUCERS; i++) {
+    pthread_join(threads[i], nullptr);
+    EXPECT_EQ(params[i].orv, OSAL_OK) << "osal_trace_register() failed";
+  }
+
+  std::vector<osal_trace_record_t> records(N_PRODUCERS * NUM_POINTS + 1);
+  osal_uint32_t read_cnt = 0;
+  orv = osal_trace_read(tracep, records.data(), records.size(), &read_cnt);
+  ASSERT_EQ(orv, OSAL_OK);
+  EXPECT_EQ(read_cnt, N_PRODUCERS * NUM_POINTS) << "records lost";
+  EXPECT_EQ(osal_trace_get_lost(tracep), 0u);
+
+  std::vector<osal_uint32_t> per_producer(N_PRODUCERS, 0);
+  for (osal_uint32_t i = 0; i < read_cnt; i++) {
+    ASSERT_LT(records[i].producer, N_PRODUCERS);
+    per_producer[records[i].producer]++;
+    if (i > 0) {
+      ASSERT_LE(records[i - 1].time, records[i].time)
+          << "records not merged by timestamp";
+    }
+  }
+  for (osal_uint32_t i = 0; i < N_PRODUCERS; i++) {
+    EXPECT_EQ(per_producer[i], NUM_POINTS);
+  }
+
+  orv = osal_trace_read(tracep, records.data(), records.size(), &read_cnt);
+  EXPECT_EQ(orv, OSAL_ERR_NO_DATA);
+
+  osal_trace_free(tracep);
+}
+
+TEST(TraceFunction, MultiProducerOverwrite) {
+  osal_trace_t *tracep;
+  const osal_uint32_t size = 64;
+
+  ASSERT_EQ(osal_trace_alloc_mp(&tracep, 1, size), OSAL_OK);
+  ASSERT_EQ(osal_trace_register(tracep, nullptr), OSAL_OK);
+
+  for (osal_uint64_t i = 0; i < 1000; i++) {
+    osal_trace_time(tracep, i);
+  }
+  EXPECT_EQ(osal_trace_get_last_time(tracep), 999u);
+
+  osal_trace_record_t records[2 * size];
+  osal_uint32_t read_cnt = 0;
+  ASSERT_EQ(osal_trace_read(tracep, records, 2 * size, &read_cnt), OSAL_OK);
+  EXPECT_EQ(read_cnt, size) << "only the newest records are kept";
+  EXPECT_EQ(records[0].time, 1000u - size);
+  EXPECT_EQ(records[read_cnt - 1].time, 999u);
+  EXPECT_EQ(osal_trace_get_lost(tracep), 1000u - size);
+
+  osal_trace_free(tracep);
+}
+
+TEST(TraceFunction, MultiProducerConcurrentReader) {
+  osal_trace_t *tracep;
+
+  ASSERT_EQ(osal_trace_alloc_mp(&tracep, N_PRODUCERS, 256), OSAL_OK);
+
+  osal_uint32_t finished = 0;
+  producer_param_t params[N_PRODUCERS];
+  pthread_t threads[N_PRODUCERS];
+  for (osal_uint32_t i = 0; i < N_PRODUCERS; i++) {
+    params[i].trace = tracep;
+    params[i].p_finished = &finished;
+    ASSERT_EQ(pthread_create(&threads[i], nullptr, producer, &params[i]), 0);
+  }
+
+  // read while the producers are running, records may be lost but
+  // every producer's records have to stay in order
+  std::vector<osal_uint64_t> last_time(N_PRODUCERS, 0);
+  osal_uint64_t total = 0;
+  osal_uint32_t order_errors = 0;
+  for (;;) {
+    osal_trace_record_t records[128];
+    osal_uint32_t read_cnt = 0;
+    osal_uint32_t act_finished = __atomic_load_n(&finished, __ATOMIC_ACQUIRE);
+
+    if (osal_trace_read(tracep, records, 128, &read_cnt) != OSAL_OK) {
+      if (act_finished == N_PRODUCERS) {
+        break;
+      }
+      continue;
+    }
+
+    for (osal_uint32_t i = 0; i < read_cnt; i++) {
+      if (records[i].time < last_time[records[i].producer]) {
+        order_errors++;
+      }
+      last_time[records[i].producer] = records[i].time;
+    }
+    total += read_cnt;
+  }
+
+  for (osal_uint32_t i = 0; i < N_PRODUCERS; i++) {
+    pthread_join(threads[i], nullptr);
+  }
+
+  EXPECT_EQ(order_errors, 0u);
+  EXPECT_EQ(total + osal_trace_get_lost(tracep),
+            (osal_uint64_t)N_PRODUCERS * NUM_POINTS)
+      << "read and lost records do not add up";
+
+  osal_trace_free(tracep);
+}
+
+TEST(TraceReject, MultiProducerLimits) {
+  osal_trace_t *tracep;
+
+  EXPECT_EQ(osal_trace_alloc_mp(&tracep, 0, 16), OSAL_ERR_INVALID_PARAM);
+
+  ASSERT_EQ(osal_trace_alloc(&tracep, 16), OSAL_OK);
+  EXPECT_EQ(osal_trace_register(tracep, nullptr), OSAL_ERR_INVALID_PARAM)
+      << "single producer trace";
+  osal_trace_free(tracep);
+
+  ASSERT_EQ(osal_trace_alloc_mp(&tracep, 1, 16), OSAL_OK);
+  producer_param_t params = {tracep, 0, OSAL_OK, nullptr};
+  pthread_t thread;
+  ASSERT_EQ(pthread_create(&thread, nullptr, producer, &params), 0);
+  pthread_join(thread, nullptr);
+  EXPECT_EQ(params.orv, OSAL_OK);
+
+  EXPECT_EQ(osal_trace_register(tracep, nullptr),
+            OSAL_ERR_SYSTEM_LIMIT_REACHED);
+
+  osal_uint64_t avg, avg_jit, max_jit;
+  EXPECT_EQ(osal_trace_analyze_ex(tracep, &avg, &avg_jit, &max_jit, nullptr,
+                                  nullptr),
+            OSAL_ERR_INVALID_PARAM)
+      << "multi producer trace has no time buffers";
+  EXPECT_EQ(osal_trace_analyze_rel_ex(tracep, &avg, &avg_jit, &max_jit,
+                                      nullptr, nullptr),
+            OSAL_ERR_INVALID_PARAM);
+  osal_trace_analyze(tracep, &avg, &avg_jit, &max_jit);
+  EXPECT_EQ(avg, 0u);
+  EXPECT_EQ(max_jit, 0u);
+  osal_trace_free(tracep);
+}
+
+void *realloc_trace(void *arg) {
+  osal_trace_t **p_trace = (osal_trace_t **)arg;
+
+  // malloc of this thread likely hands out the freed address again
+  osal_trace_free(*p_trace);
+  EXPECT_EQ(osal_trace_alloc_mp(p_trace, 2, 16), OSAL_OK);
+
+  return nullptr;
+}
+
+TEST(TraceFunction, MultiProducerFreedByOtherThread) {
+  osal_trace_t *tracep;
+  ASSERT_EQ(osal_trace_alloc_mp(&tracep, 2, 16), OSAL_OK);
+  ASSERT_EQ(osal_trace_register(tracep, nullptr), OSAL_OK);
+  osal_trace_point(tracep);
+
+  pthread_t thread;
+  ASSERT_EQ(pthread_create(&thread, nullptr, realloc_trace, &tracep), 0);
+  pthread_join(thread, nullptr);
+
+  // this thread is not registered to the new trace
+  osal_trace_point(tracep);
+  osal_trace_record_t record;
+  osal_uint32_t read_cnt;
+  EXPECT_EQ(osal_trace_read(tracep, &record, 1, &read_cnt), OSAL_ERR_NO_DATA);
+
+  osal_uint32_t id = 1;
+  EXPECT_EQ(osal_trace_register(tracep, &id), OSAL_OK);
+  EXPECT_EQ(id, 0u);
+  EXPECT_EQ(tracep->producer_cnt, 1u) << "stale producer of freed trace used";
+  osal_trace_free(tracep);
+}
+
+TEST(TraceFunction, MultiProducerExitedThread) {
+  osal_trace_t *tracep;
+  ASSERT_EQ(osal_trace_alloc_mp(&tracep, 2, 16), OSAL_OK);
+
+  producer_param_t params = {tracep, 0, OSAL_OK, nullptr};
+  pthread_t thread;
+  ASSERT_EQ(pthread_create(&thread, nullptr, producer, &params), 0);
+  pthread_join(thread, nullptr);
+  ASSERT_EQ(params.orv, OSAL_OK);
+
+  // the new thread likely gets the thread local storage of the exited one
+  producer_param_t unregistered = {tracep, 0, OSAL_OK, nullptr};
+  ASSERT_EQ(pthread_create(&thread, nullptr,
+                           [](void *arg) -> void * {
+                             producer_param_t *p = (producer_param_t *)arg;
+                             osal_trace_point(p->trace);
+                             p->orv = osal_trace_register(p->trace, &p->id);
+                             return nullptr;
+                           },
+                           &unregistered),
+            0);
+  pthread_join(thread, nullptr);
+  EXPECT_EQ(unregistered.orv, OSAL_OK);
+  EXPECT_EQ(unregistered.id, 1u) << "sub-buffer of exited thread taken over";
+
+  osal_trace_record_t records[32];
+  osal_uint32_t read_cnt;
+  ASSERT_EQ(osal_trace_read(tracep, records, 32, &read_cnt), OSAL_OK);
+  EXPECT_EQ(read_cnt, 16u);
+  for (osal_uint32_t i = 0; i < read_cnt; i++) {
+    EXPECT_EQ(records[i].producer, params.id);
+  }
+  osal_trace_free(tracep);
+}
+
+} // namespace test_trace_mp
+
+namespace test_trace_histogram {
+
+TEST(TraceFunction, HistogramPercentiles) {
+  osal_trace_t *tracep;
+  ASSERT_EQ(osal_trace_alloc(&tracep, 1024), OSAL_OK);
+  ASSERT_EQ(osal_trace_set_histogram_mode(tracep, OSAL_TRACE_HISTOGRAM__VALUE),
+            OSAL_OK);
+
+  osal_uint64_t values[5];
+  const osal_uint32_t ppm[5] = {OSAL_TRACE_P50, OSAL_TRACE_P99, OSAL_TRACE_P999,
+                                OSAL_TRACE_P9999, 1000000u};
+  EXPECT_EQ(osal_trace_get_percentiles(tracep, ppm, values, 5),
+            OSAL_ERR_NO_DATA);
+
+  // uniform 1..100000, percentiles are known exactly
+  for (osal_uint64_t i = 1; i <= 100000; i++) {
+    osal_trace_time(tracep, i);
+  }
+
+  ASSERT_EQ(osal_trace_get_percentiles(tracep, ppm, values, 5), OSAL_OK);
+  const osal_uint64_t exact[5] = {50000, 99000, 99900, 99990, 100000};
+  for (int i = 0; i < 5; i++) {
+    EXPECT_GE(values[i], exact[i]) << "percentile reported too optimistic";
+    EXPECT_LE(values[i], exact[i] + exact[i] / 32) << "bucket too coarse";
+  }
+  EXPECT_EQ(values[4], 100000u) << "p100 has to be the maximum";
+
+  osal_trace_histogram_t hist;
+  osal_trace_get_histogram(tracep, &hist);
+  EXPECT_EQ(hist.cnt, 100000u);
+  EXPECT_EQ(hist.min, 1u);
+  EXPECT_EQ(hist.max, 100000u);
+  EXPECT_EQ(hist.sum, 100000ull * 100001ull / 2ull);
+
+  osal_uint64_t total = 0;
+  for (osal_uint32_t i = 0; i < OSAL_TRACE_HISTOGRAM_BUCKETS; i++) {
+    total += hist.buckets[i];
+  }
+  EXPECT_EQ(total, hist.cnt);
+
+  osal_trace_reset_histogram(tracep);
+  EXPECT_EQ(osal_trace_get_percentiles(tracep, ppm, values, 5),
+            OSAL_ERR_NO_DATA);
+
+  osal_trace_free(tracep);
+}
+
+TEST(TraceFunction, HistogramIntervals) {
+  osal_trace_t *tracep;
+  ASSERT_EQ(osal_trace_alloc(&tracep, 16), OSAL_OK);
+
+  // default mode records differences of consecutive times
+  for (osal_uint64_t i = 0; i < 1000; i++) {
+    osal_trace_time(tracep, 1000000 + (i * 1000) + ((i % 10) == 9 ? 500 : 0));
+  }
+
+  osal_trace_histogram_t hist;
+  osal_trace_get_histogram(tracep, &hist);
+  EXPECT_EQ(hist.cnt, 999u) << "first time has no interval";
+  EXPECT_EQ(hist.min, 500u);
+  EXPECT_EQ(hist.max, 1500u);
+
+  osal_uint64_t p50;
+  osal_uint32_t ppm = OSAL_TRACE_P50;
+  ASSERT_EQ(osal_trace_get_percentiles(tracep, &ppm, &p50, 1), OSAL_OK);
+  EXPECT_GE(p50, 1000u);
+  EXPECT_LT(p50, 1032u);
+
+  ppm = 1000001u;
+  EXPECT_EQ(osal_trace_get_percentiles(tracep, &ppm, &p50, 1),
+            OSAL_ERR_INVALID_PARAM);
+  EXPECT_EQ(osal_trace_set_histogram_mode(tracep, 2), OSAL_ERR_INVALID_PARAM);
+
+  osal_trace_free(tracep);
+}
+
+TEST(TraceFunction, HistogramBucketBounds) {
+  osal_uint64_t prev_high = 0;
+
+  for (osal_uint32_t i = 0; i < OSAL_TRACE_HISTOGRAM_BUCKETS; i++) {
+    osal_uint64_t low, high;
+    osal_trace_histogram_bucket_bounds(i, &low, &high);
+
+    if (i > 0) {
+      ASSERT_EQ(low, prev_high + 1) << "buckets have to be contiguous";
+    }
+    ASSERT_GE(high, low);
+    // relative bucket width is bounded by 1/SUB_CNT
+    ASSERT_LE(high - low, low / OSAL_TRACE_HISTOGRAM_SUB_CNT);
+    prev_high = high;
+  }
+
+  EXPECT_EQ(prev_high, UINT64_MAX) << "buckets have to cover 64 bit";
+}
+
+TEST(TraceFunction, HistogramMultiProducer) {
+  osal_trace_t *tracep;
+  ASSERT_EQ(osal_trace_alloc_mp(&tracep, test_trace_mp::N_PRODUCERS, 1024),
+            OSAL_OK);
+
+  test_trace_mp::producer_param_t params[test_trace_mp::N_PRODUCERS];
+  pthread_t threads[test_trace_mp::N_PRODUCERS];
+  for (osal_uint32_t i = 0; i < test_trace_mp::N_PRODUCERS; i++) {
+    params[i] = {tracep, 0, OSAL_OK, nullptr};
+    ASSERT_EQ(pthread_create(&threads[i], nullptr, test_trace_mp::producer,
+                             &params[i]),
+              0);
+  }
+  for (osal_uint32_t i = 0; i < test_trace_mp::N_PRODUCERS; i++) {
+    pthread_join(threads[i], nullptr);
+    EXPECT_EQ(params[i].orv, OSAL_OK);
+  }
+
+  // every producer contributes its own intervals, no cross-task intervals
+  osal_trace_histogram_t hist;
+  osal_trace_get_histogram(tracep, &hist);
+  EXPECT_EQ(hist.cnt,
+            test_trace_mp::N_PRODUCERS * (test_trace_mp::NUM_POINTS - 1));
+
+  osal_uint64_t values[2];
+  const osal_uint32_t ppm[2] = {OSAL_TRACE_P50, OSAL_TRACE_P99};
+  ASSERT_EQ(osal_trace_get_percentiles(tracep, ppm, values, 2), OSAL_OK);
+  EXPECT_LE(values[0], values[1]);
+  EXPECT_LE(values[1], hist.max);
+  printf("multi producer trace point interval p50: %lu, p99: %lu, max: %lu\n",
+         values[0], values[1], hist.max);
+
+  osal_trace_free(tracep);
+}
+
+} // namespace test_trace_histogram
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
 
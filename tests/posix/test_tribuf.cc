@@ -0,0 +1,204 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+#include "libosal/osal.h"
+#include "libosal/shm.h"
+#include "libosal/tribuf.h"
+
+namespace test_tribuf {
+
+const osal_uint64_t NUM_FRAMES = 100000;
+const int FRAME_WORDS = 32;
+
+const char *SHM_NAME = "/tribuf_test";
+
+typedef struct {
+  osal_uint64_t seq;
+  osal_uint64_t payload[FRAME_WORDS];
+} frame_t;
+
+static void fill_frame(frame_t *frame, osal_uint64_t seq) {
+  frame->seq = seq;
+  for (int i = 0; i < FRAME_WORDS; i++) {
+    frame->payload[i] = seq;
+  }
+}
+
+//! Returns false on torn frames or if frames go back in time.
+static bool check_frame(const frame_t *frame, osal_uint64_t *last) {
+  bool ok = frame->seq >= *last;
+  for (int i = 0; i < FRAME_WORDS; i++) {
+    ok = ok && (frame->payload[i] == frame->seq);
+  }
+  *last = frame->seq;
+  return ok;
+}
+
+static void produce(osal_tribuf_t *tb) {
+  for (osal_uint64_t i = 1; i <= NUM_FRAMES; i++) {
+    osal_void_t *frame;
+    osal_tribuf_reserve(tb, &frame);
+    fill_frame((frame_t *)frame, i);
+    osal_tribuf_publish(tb);
+    if ((i % 64) == 0) {
+      sched_yield();
+    }
+  }
+}
+
+TEST(TribufFunction, SingleThreaded) {
+  osal_size_t size = osal_tribuf_get_size(sizeof(frame_t));
+  ASSERT_GE(size, sizeof(osal_tribuf_ctrl_t) + 3 * sizeof(frame_t));
+
+  std::vector<osal_uint8_t> mem(size);
+  osal_tribuf_t tb;
+  ASSERT_EQ(osal_tribuf_init(&tb, mem.data(), size, sizeof(frame_t)),
+            OSAL_OK);
+
+  osal_void_t *frame;
+  EXPECT_EQ(osal_tribuf_read(&tb, &frame), OSAL_ERR_NO_DATA)
+      << "nothing published yet";
+  EXPECT_EQ(((frame_t *)frame)->seq, 0u) << "initial frame has to be zeroed";
+
+  // only the latest of several frames is seen
+  frame_t data;
+  for (osal_uint64_t i = 1; i <= 5; i++) {
+    fill_frame(&data, i);
+    ASSERT_EQ(osal_tribuf_write(&tb, &data, sizeof(data)), OSAL_OK);
+  }
+  EXPECT_EQ(osal_tribuf_published(&tb), 5u);
+
+  ASSERT_EQ(osal_tribuf_read(&tb, &frame), OSAL_OK);
+  EXPECT_EQ(((frame_t *)frame)->seq, 5u);
+  osal_void_t *again;
+  EXPECT_EQ(osal_tribuf_read(&tb, &again), OSAL_ERR_NO_DATA);
+  EXPECT_EQ(again, frame) << "previous frame has to be returned again";
+
+  // producer frame is never the one held by the consumer
+  osal_void_t *write_frame;
+  for (int i = 0; i < 4; i++) {
+    osal_tribuf_reserve(&tb, &write_frame);
+    EXPECT_NE(write_frame, frame);
+    osal_tribuf_publish(&tb);
+  }
+  EXPECT_EQ(((frame_t *)frame)->seq, 5u) << "consumer frame was overwritten";
+}
+
+TEST(TribufFunction, ProducerConsumerThreads) {
+  osal_size_t size = osal_tribuf_get_size(sizeof(frame_t));
+  std::vector<osal_uint8_t> mem(size);
+  osal_tribuf_t tb;
+  ASSERT_EQ(osal_tribuf_init(&tb, mem.data(), size, sizeof(frame_t)),
+            OSAL_OK);
+
+  std::thread producer([&tb]() { produce(&tb); });
+
+  osal_uint64_t last = 0;
+  osal_uint32_t errors = 0;
+  osal_uint32_t fresh = 0;
+  while (last < NUM_FRAMES) {
+    osal_void_t *frame;
+    if (osal_tribuf_read(&tb, &frame) == OSAL_OK) {
+      fresh++;
+    }
+    if (!check_frame((const frame_t *)frame, &last)) {
+      errors++;
+    }
+  }
+  producer.join();
+
+  EXPECT_EQ(errors, 0u) << "torn or out of order frames";
+  EXPECT_GT(fresh, 0u);
+  EXPECT_LE(fresh, NUM_FRAMES);
+}
+
+TEST(TribufFunction, ProducerConsumerProcesses) {
+  osal_size_t size = osal_tribuf_get_size(sizeof(frame_t));
+  osal_shm_t shm;
+  osal_shm_attr_t attr =
+      (OSAL_SHM_ATTR__FLAG__RDWR | OSAL_SHM_ATTR__FLAG__CREAT |
+       (S_IRWXU << OSAL_SHM_ATTR__MODE__SHIFT));
+  shm_unlink(SHM_NAME);
+  ASSERT_EQ(osal_shm_open(&shm, SHM_NAME, &attr, size), OSAL_OK);
+
+  osal_void_t *mem;
+  osal_shm_map_attr_t map_attr =
+      (OSAL_SHM_MAP_ATTR__PROT_READ | OSAL_SHM_MAP_ATTR__PROT_WRITE |
+       OSAL_SHM_MAP_ATTR__SHARED);
+  ASSERT_EQ(osal_shm_map(&shm, &map_attr, &mem), OSAL_OK);
+
+  osal_tribuf_t tb;
+  ASSERT_EQ(osal_tribuf_init(&tb, mem, size, sizeof(frame_t)), OSAL_OK);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    osal_tribuf_t child_tb;
+    if (osal_tribuf_attach(&child_tb, mem, size) != OSAL_OK) {
+      exit(1);
+    }
+    produce(&child_tb);
+    exit(0);
+  }
+
+  osal_uint64_t last = 0;
+  osal_uint32_t errors = 0;
+  while (last < NUM_FRAMES) {
+    osal_void_t *frame;
+    osal_tribuf_read(&tb, &frame);
+    if (!check_frame((const frame_t *)frame, &last)) {
+      errors++;
+    }
+  }
+
+  int status = -1;
+  waitpid(pid, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status) && (WEXITSTATUS(status) == 0))
+      << "producer process failed";
+  EXPECT_EQ(errors, 0u) << "torn or out of order frames";
+  EXPECT_EQ(osal_tribuf_published(&tb), (osal_uint32_t)NUM_FRAMES);
+
+  osal_shm_close(&shm);
+  shm_unlink(SHM_NAME);
+}
+
+TEST(TribufReject, InvalidParams) {
+  std::vector<osal_uint8_t> mem(256);
+  osal_tribuf_t tb;
+
+  EXPECT_EQ(osal_tribuf_get_size(0), 0u);
+  EXPECT_EQ(osal_tribuf_init(&tb, mem.data(), mem.size(), 0),
+            OSAL_ERR_INVALID_PARAM);
+  EXPECT_EQ(osal_tribuf_init(&tb, mem.data(), mem.size(), sizeof(frame_t)),
+            OSAL_ERR_INVALID_PARAM)
+      << "region too small";
+
+  std::vector<osal_uint8_t> empty(4096);
+  EXPECT_EQ(osal_tribuf_attach(&tb, empty.data(), empty.size()),
+            OSAL_ERR_UNAVAILABLE);
+
+  osal_size_t size = osal_tribuf_get_size(sizeof(frame_t));
+  std::vector<osal_uint8_t> ok(size);
+  ASSERT_EQ(osal_tribuf_init(&tb, ok.data(), size, sizeof(frame_t)), OSAL_OK);
+  std::vector<osal_uint8_t> big(size * 2);
+  EXPECT_EQ(osal_tribuf_write(&tb, big.data(), big.size()),
+            OSAL_ERR_INVALID_PARAM)
+      << "data larger than a frame";
+  EXPECT_EQ(osal_tribuf_attach(&tb, ok.data(), sizeof(osal_tribuf_ctrl_t)),
+            OSAL_ERR_INVALID_PARAM)
+      << "region too small for frames";
+}
+
+} // namespace test_tribuf
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,231 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include "libosal/osal.h"
+#include "libosal/cpuset.h"
+#include "libosal/task.h"
+#include "libosal/timer.h"
+#include "libosal/workpool.h"
+
+namespace test_workpool {
+
+const osal_uint32_t WORKERS = 3;
+
+static void init_attr(osal_workpool_attr_t *attr, osal_uint64_t spin_nsec) {
+  *attr = {};
+  osal_task_attr_init(&attr->task_attr);
+  attr->worker_cnt = WORKERS;
+  attr->spin_nsec = spin_nsec;
+}
+
+static void count_job(osal_void_t *arg) {
+  std::atomic<osal_uint32_t> *counter = (std::atomic<osal_uint32_t> *)arg;
+  (*counter)++;
+}
+
+static void increment_range(osal_void_t *arg, osal_size_t begin,
+                            osal_size_t end) {
+  osal_uint32_t *values = (osal_uint32_t *)arg;
+  for (osal_size_t i = begin; i < end; i++) {
+    values[i]++;
+  }
+}
+
+typedef struct {
+  osal_workpool_t *pool;
+  osal_uint32_t n;
+  osal_uint64_t result;
+} fib_t;
+
+// naive fibonacci with fork-join in every step
+static void fib_job(osal_void_t *arg) {
+  fib_t *fib = (fib_t *)arg;
+
+  if (fib->n < 2) {
+    fib->result = fib->n;
+  } else {
+    fib_t left = {fib->pool, fib->n - 1, 0};
+    fib_t right = {fib->pool, fib->n - 2, 0};
+    osal_workpool_group_t group;
+    osal_workpool_job_t job;
+
+    osal_workpool_group_init(&group);
+    osal_workpool_spawn(fib->pool, &group, &job, fib_job, &left);
+    fib_job(&right);
+    osal_workpool_wait(fib->pool, &group);
+
+    fib->result = left.result + right.result;
+  }
+}
+
+static void empty_range(osal_void_t *arg, osal_size_t begin, osal_size_t end) {
+  (void)arg;
+  (void)begin;
+  (void)end;
+}
+
+TEST(WorkpoolFunction, SpawnWait) {
+  osal_workpool_attr_t attr;
+  init_attr(&attr, OSAL_WORKPOOL_SPIN_NSEC_DEFAULT);
+
+  osal_workpool_t pool;
+  ASSERT_EQ(osal_workpool_init(&pool, &attr), OSAL_OK);
+
+  std::atomic<osal_uint32_t> counter(0);
+  std::vector<osal_workpool_job_t> jobs(100);
+  osal_workpool_group_t group;
+  ASSERT_EQ(osal_workpool_group_init(&group), OSAL_OK);
+
+  // group is reusable after wait
+  for (int round = 1; round <= 3; round++) {
+    for (auto &job : jobs) {
+      EXPECT_EQ(osal_workpool_spawn(&pool, &group, &job, count_job, &counter),
+                OSAL_OK);
+    }
+    EXPECT_EQ(osal_workpool_wait(&pool, &group), OSAL_OK);
+    EXPECT_EQ(counter.load(), round * jobs.size());
+  }
+
+  // more jobs than fit into a deque run directly
+  std::vector<osal_workpool_job_t> many(4 * OSAL_WORKPOOL_DEQUE_SIZE);
+  counter = 0;
+  for (auto &job : many) {
+    osal_workpool_spawn(&pool, &group, &job, count_job, &counter);
+  }
+  osal_workpool_wait(&pool, &group);
+  EXPECT_EQ(counter.load(), many.size());
+
+  EXPECT_EQ(osal_workpool_destroy(&pool), OSAL_OK);
+}
+
+TEST(WorkpoolFunction, ParallelFor) {
+  osal_workpool_t pool;
+  ASSERT_EQ(osal_workpool_init(&pool, NULL), OSAL_OK);
+
+  std::vector<osal_uint32_t> values(100000, 0);
+  const osal_size_t grains[] = {0, 1000, 777, 100000, 200000};
+
+  for (osal_size_t grain : grains) {
+    std::fill(values.begin(), values.end(), 0);
+    EXPECT_EQ(osal_parallel_for(&pool, 10, values.size(), grain,
+                                increment_range, values.data()),
+              OSAL_OK);
+
+    for (size_t i = 0; i < values.size(); i++) {
+      ASSERT_EQ(values[i], i < 10 ? 0u : 1u)
+          << "index " << i << " with grain " << grain;
+    }
+  }
+
+  EXPECT_EQ(osal_parallel_for(&pool, 5, 5, 0, increment_range, values.data()),
+            OSAL_OK)
+      << "empty range";
+
+  EXPECT_EQ(osal_workpool_destroy(&pool), OSAL_OK);
+}
+
+TEST(WorkpoolFunction, NestedForkJoin) {
+  osal_workpool_attr_t attr;
+  init_attr(&attr, OSAL_WORKPOOL_SPIN_NSEC_DEFAULT);
+
+  osal_workpool_t pool;
+  ASSERT_EQ(osal_workpool_init(&pool, &attr), OSAL_OK);
+
+  fib_t fib = {&pool, 20, 0};
+  fib_job(&fib);
+  EXPECT_EQ(fib.result, 6765u);
+
+  EXPECT_EQ(osal_workpool_destroy(&pool), OSAL_OK);
+}
+
+TEST(WorkpoolFunction, ParkAndWake) {
+  osal_workpool_attr_t attr;
+  init_attr(&attr, 0);
+  strcpy(attr.task_attr.task_name, "workpool");
+
+  osal_workpool_t pool;
+  ASSERT_EQ(osal_workpool_init(&pool, &attr), OSAL_OK);
+
+  // workers park right away, every cycle has to wake them
+  std::vector<osal_uint32_t> values(4096, 0);
+  for (int cycle = 1; cycle <= 100; cycle++) {
+    osal_sleep_until_nsec(osal_timer_gettime_nsec() + 100000);
+    osal_parallel_for(&pool, 0, values.size(), 64, increment_range,
+                      values.data());
+  }
+
+  for (size_t i = 0; i < values.size(); i++) {
+    ASSERT_EQ(values[i], 100u) << "index " << i;
+  }
+
+  EXPECT_EQ(osal_workpool_destroy(&pool), OSAL_OK);
+}
+
+TEST(WorkpoolFunction, FanOutFanIn) {
+  osal_workpool_attr_t attr;
+  init_attr(&attr, 1000000);
+
+  osal_workpool_t pool;
+  ASSERT_EQ(osal_workpool_init(&pool, &attr), OSAL_OK);
+
+  std::vector<osal_uint64_t> durations;
+  for (int cycle = 0; cycle < 1000; cycle++) {
+    osal_uint64_t start = osal_timer_gettime_nsec();
+    osal_parallel_for(&pool, 0, WORKERS + 1, 1, empty_range, NULL);
+    durations.push_back(osal_timer_gettime_nsec() - start);
+  }
+
+  std::sort(durations.begin(), durations.end());
+  printf("fan-out/fan-in of %u chunks: p50 %lu ns, p99 %lu ns\n", WORKERS + 1,
+         (unsigned long)durations[durations.size() / 2],
+         (unsigned long)durations[durations.size() * 99 / 100]);
+
+  EXPECT_EQ(osal_workpool_destroy(&pool), OSAL_OK);
+}
+
+TEST(WorkpoolFunction, DefaultPinning) {
+  osal_workpool_t pool;
+  ASSERT_EQ(osal_workpool_init(&pool, nullptr), OSAL_OK);
+
+  // every worker runs on exactly one CPU without attributes
+  for (osal_uint32_t i = 1; i <= pool.worker_cnt; i++) {
+    osal_cpuset_t cpus;
+    ASSERT_EQ(osal_task_get_cpuset(&pool.workers[i].task, &cpus), OSAL_OK);
+    EXPECT_EQ(osal_cpuset_count(&cpus), 1u) << "worker " << i;
+  }
+
+  std::vector<osal_uint32_t> values(1000, 0);
+  EXPECT_EQ(osal_parallel_for(&pool, 0, values.size(), 0, increment_range,
+                              values.data()),
+            OSAL_OK);
+  EXPECT_EQ(std::count(values.begin(), values.end(), 1u),
+            (std::ptrdiff_t)values.size());
+
+  EXPECT_EQ(osal_workpool_destroy(&pool), OSAL_OK);
+}
+
+TEST(WorkpoolReject, InvalidParams) {
+  osal_workpool_attr_t attr;
+  osal_workpool_t pool;
+
+  init_attr(&attr, 0);
+  attr.worker_cnt = 0;
+  EXPECT_EQ(osal_workpool_init(&pool, &attr), OSAL_ERR_INVALID_PARAM)
+      << "no workers";
+
+  init_attr(&attr, 0);
+  attr.worker_cnt = OSAL_WORKPOOL_WORKERS_MAX + 1;
+  EXPECT_EQ(osal_workpool_init(&pool, &attr), OSAL_ERR_INVALID_PARAM)
+      << "too many workers";
+}
+
+} // namespace test_workpool
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}